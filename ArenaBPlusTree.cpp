@@ -0,0 +1,415 @@
+/*!
+ * @brief This file contains the implementation of class methods of <em>NodeArena</em> and <em>ArenaBPlusTree</em>.
+ */
+#include "ArenaBPlusTree.h"
+
+/*!
+ * @brief This method constructs an object of type `T` in a free slot.
+ * @tparam T is type of the object (must fit in a slot).
+ * @return index of the slot.
+ */
+template<size_t SlotSize, size_t SlotAlign>
+template<typename T>
+typename NodeArena<SlotSize, SlotAlign>::node_id NodeArena<SlotSize, SlotAlign>::create() {
+    static_assert(sizeof(T) <= SlotSize && alignof(T) <= SlotAlign, "Object does not fit in a slot.");
+    node_id id;
+    if (!free_.empty()) {
+        id = free_.back();
+        free_.pop_back();
+    } else {
+        if (next_ >> kPageShift == pages_.size()) {
+            pages_.emplace_back(new Slot[kPageSlots]);
+        }
+        id = next_++;
+    }
+    new(pages_[id >> kPageShift][id & (kPageSlots - 1)].bytes_) T();
+    return id;
+}
+
+/*!
+ * @brief This method destroys the object in a slot and recycles the slot.
+ * @tparam T is type of the object.
+ * @param id is index of the slot.
+ */
+template<size_t SlotSize, size_t SlotAlign>
+template<typename T>
+void NodeArena<SlotSize, SlotAlign>::destroy(node_id id) {
+    get<T>(id)->~T();
+    free_.push_back(id);
+}
+
+/*!
+ * @brief This method returns the object stored in a slot.
+ * @tparam T is type of the object.
+ * @param id is index of the slot.
+ * @return pointer to the object.
+ */
+template<size_t SlotSize, size_t SlotAlign>
+template<typename T>
+T* NodeArena<SlotSize, SlotAlign>::get(node_id id) const {
+    return std::launder(reinterpret_cast<T*>(pages_[id >> kPageShift][id & (kPageSlots - 1)].bytes_));
+}
+
+/*!
+ * @brief This method returns number of live slots.
+ * @return number of live slots.
+ */
+template<size_t SlotSize, size_t SlotAlign>
+size_t NodeArena<SlotSize, SlotAlign>::size() const {
+    return next_ - free_.size();
+}
+
+/*!
+ * @brief This method returns number of allocated slots.
+ * @return number of allocated slots.
+ */
+template<size_t SlotSize, size_t SlotAlign>
+size_t NodeArena<SlotSize, SlotAlign>::capacity() const {
+    return pages_.size() * kPageSlots;
+}
+
+/*!
+ * @brief This method releases all pages. Live objects are not destroyed.
+ */
+template<size_t SlotSize, size_t SlotAlign>
+void NodeArena<SlotSize, SlotAlign>::clear() {
+    pages_.clear();
+    free_.clear();
+    next_ = 0;
+}
+
+/*!
+ * @brief The destructor destroys all nodes before the arena releases its pages.
+ */
+template<typename K, typename V, int D>
+ArenaBPlusTree<K, V, D>::~ArenaBPlusTree() {
+    clear();
+}
+
+/*!
+ * @brief This method returns the node base of a slot. The tag tells which derived type it is.
+ * @param id is index of the node.
+ * @return pointer to the node.
+ */
+template<typename K, typename V, int D>
+typename ArenaBPlusTree<K, V, D>::Node* ArenaBPlusTree<K, V, D>::_node(node_id id) const {
+    return arena_.template get<Node>(id);
+}
+
+/*!
+ * @brief This method returns an internal node.
+ * @param id is index of the node (must be an internal node).
+ * @return pointer to the node.
+ */
+template<typename K, typename V, int D>
+typename ArenaBPlusTree<K, V, D>::Internal* ArenaBPlusTree<K, V, D>::_internal(node_id id) const {
+    return static_cast<Internal*>(_node(id));
+}
+
+/*!
+ * @brief This method returns a leaf node.
+ * @param id is index of the node (must be a leaf).
+ * @return pointer to the node.
+ */
+template<typename K, typename V, int D>
+typename ArenaBPlusTree<K, V, D>::Leaf* ArenaBPlusTree<K, V, D>::_leaf(node_id id) const {
+    return static_cast<Leaf*>(_node(id));
+}
+
+/*!
+ * @brief This method picks the child to descend into. Keys equal to a separator go right.
+ * @param p is pointer to the internal node.
+ * @param k is the key object.
+ * @return index of the child.
+ */
+template<typename K, typename V, int D>
+int ArenaBPlusTree<K, V, D>::_child_index(const Internal* p, const K& k) {
+    return keyUpperBound(p->key_.data(), p->n_, k);
+}
+
+/*!
+ * @brief This method splits the full child `i` of `p` into two and inserts the separator into `p`.
+ * @param p is pointer to the parent (must not be full).
+ * @param i is index of the child to split.
+ */
+template<typename K, typename V, int D>
+void ArenaBPlusTree<K, V, D>::_split(Internal* p, int i) {
+    node_id cid = p->c_[i];
+    node_id rid;
+    K separator;
+    if (_node(cid)->leaf_) {
+        rid = arena_.template create<Leaf>();
+        auto c = _leaf(cid);
+        auto r = _leaf(rid);
+        c->n_ = D - 1;
+        r->n_ = D;
+        std::move(c->key_.begin() + D - 1, c->key_.begin() + 2 * D - 1, r->key_.begin());
+        std::move(c->val_.begin() + D - 1, c->val_.begin() + 2 * D - 1, r->val_.begin());
+        r->l_ = cid;
+        r->r_ = c->r_;
+        if (Arena::null_id != c->r_) { _leaf(c->r_)->l_ = rid; }
+        c->r_ = rid;
+        separator = r->key_[0];
+    } else {
+        rid = arena_.template create<Internal>();
+        auto c = _internal(cid);
+        auto r = _internal(rid);
+        c->n_ = r->n_ = D - 1;
+        std::move(c->key_.begin() + D, c->key_.begin() + 2 * D - 1, r->key_.begin());
+        std::copy(c->c_.begin() + D, c->c_.begin() + 2 * D, r->c_.begin());
+        separator = std::move(c->key_[D - 1]);
+    }
+    std::move_backward(p->key_.begin() + i, p->key_.begin() + p->n_, p->key_.begin() + p->n_ + 1);
+    std::copy_backward(p->c_.begin() + i + 1, p->c_.begin() + p->n_ + 1, p->c_.begin() + p->n_ + 2);
+    p->key_[i] = std::move(separator);
+    p->c_[i + 1] = rid;
+    p->n_++;
+}
+
+/*!
+ * @brief This method merges child `i + 1` of `p` into child `i` and frees the right one.
+ * @param p is pointer to the parent.
+ * @param i is index of the left child.
+ */
+template<typename K, typename V, int D>
+void ArenaBPlusTree<K, V, D>::_merge(Internal* p, int i) {
+    node_id lid = p->c_[i];
+    node_id rid = p->c_[i + 1];
+    if (_node(lid)->leaf_) {
+        auto l = _leaf(lid);
+        auto r = _leaf(rid);
+        std::move(r->key_.begin(), r->key_.begin() + r->n_, l->key_.begin() + l->n_);
+        std::move(r->val_.begin(), r->val_.begin() + r->n_, l->val_.begin() + l->n_);
+        l->n_ += r->n_;
+        l->r_ = r->r_;
+        if (Arena::null_id != r->r_) { _leaf(r->r_)->l_ = lid; }
+        arena_.template destroy<Leaf>(rid);
+    } else {
+        auto l = _internal(lid);
+        auto r = _internal(rid);
+        l->key_[l->n_] = p->key_[i];
+        std::move(r->key_.begin(), r->key_.begin() + r->n_, l->key_.begin() + l->n_ + 1);
+        std::copy(r->c_.begin(), r->c_.begin() + r->n_ + 1, l->c_.begin() + l->n_ + 1);
+        l->n_ += r->n_ + 1;
+        arena_.template destroy<Internal>(rid);
+    }
+    std::move(p->key_.begin() + i + 1, p->key_.begin() + p->n_, p->key_.begin() + i);
+    std::copy(p->c_.begin() + i + 2, p->c_.begin() + p->n_ + 1, p->c_.begin() + i + 1);
+    p->n_--;
+}
+
+/*!
+ * @brief This method moves the last entry of child `i - 1` of `p` into child `i`.
+ * @param p is pointer to the parent.
+ * @param i is index of the child that borrows.
+ */
+template<typename K, typename V, int D>
+void ArenaBPlusTree<K, V, D>::_borrow_from_left(Internal* p, int i) {
+    if (_node(p->c_[i])->leaf_) {
+        auto c = _leaf(p->c_[i]);
+        auto l = _leaf(p->c_[i - 1]);
+        std::move_backward(c->key_.begin(), c->key_.begin() + c->n_, c->key_.begin() + c->n_ + 1);
+        std::move_backward(c->val_.begin(), c->val_.begin() + c->n_, c->val_.begin() + c->n_ + 1);
+        c->key_[0] = std::move(l->key_[l->n_ - 1]);
+        c->val_[0] = std::move(l->val_[l->n_ - 1]);
+        c->n_++;
+        l->n_--;
+        p->key_[i - 1] = c->key_[0];
+    } else {
+        auto c = _internal(p->c_[i]);
+        auto l = _internal(p->c_[i - 1]);
+        std::move_backward(c->key_.begin(), c->key_.begin() + c->n_, c->key_.begin() + c->n_ + 1);
+        std::copy_backward(c->c_.begin(), c->c_.begin() + c->n_ + 1, c->c_.begin() + c->n_ + 2);
+        c->key_[0] = std::move(p->key_[i - 1]);
+        c->c_[0] = l->c_[l->n_];
+        c->n_++;
+        p->key_[i - 1] = std::move(l->key_[l->n_ - 1]);
+        l->n_--;
+    }
+}
+
+/*!
+ * @brief This method moves the first entry of child `i + 1` of `p` into child `i`.
+ * @param p is pointer to the parent.
+ * @param i is index of the child that borrows.
+ */
+template<typename K, typename V, int D>
+void ArenaBPlusTree<K, V, D>::_borrow_from_right(Internal* p, int i) {
+    if (_node(p->c_[i])->leaf_) {
+        auto c = _leaf(p->c_[i]);
+        auto r = _leaf(p->c_[i + 1]);
+        c->key_[c->n_] = std::move(r->key_[0]);
+        c->val_[c->n_] = std::move(r->val_[0]);
+        c->n_++;
+        std::move(r->key_.begin() + 1, r->key_.begin() + r->n_, r->key_.begin());
+        std::move(r->val_.begin() + 1, r->val_.begin() + r->n_, r->val_.begin());
+        r->n_--;
+        p->key_[i] = r->key_[0];
+    } else {
+        auto c = _internal(p->c_[i]);
+        auto r = _internal(p->c_[i + 1]);
+        c->key_[c->n_] = std::move(p->key_[i]);
+        c->c_[c->n_ + 1] = r->c_[0];
+        c->n_++;
+        p->key_[i] = std::move(r->key_[0]);
+        std::move(r->key_.begin() + 1, r->key_.begin() + r->n_, r->key_.begin());
+        std::copy(r->c_.begin() + 1, r->c_.begin() + r->n_ + 1, r->c_.begin());
+        r->n_--;
+    }
+}
+
+/*!
+ * @brief This method recursively destroys a subtree.
+ * @param id is index of the root of the subtree.
+ */
+template<typename K, typename V, int D>
+void ArenaBPlusTree<K, V, D>::_destroy(node_id id) {
+    if (_node(id)->leaf_) {
+        arena_.template destroy<Leaf>(id);
+        return;
+    }
+    auto p = _internal(id);
+    for (int j = 0; j <= p->n_; ++j) {
+        _destroy(p->c_[j]);
+    }
+    arena_.template destroy<Internal>(id);
+}
+
+/*!
+ * @brief This method attempts to insert the given key-value pair into the tree.
+ * Full nodes are split on the way down, so a single pass suffices.
+ * @param k is the key object.
+ * @param v is the value object.
+ */
+template<typename K, typename V, int D>
+void ArenaBPlusTree<K, V, D>::insert(K k, V v) {
+    if (Arena::null_id == root_) {
+        root_ = arena_.template create<Leaf>();
+    }
+    if (2 * D - 1 == _node(root_)->n_) {
+        node_id rid = arena_.template create<Internal>();
+        _internal(rid)->c_[0] = root_;
+        _split(_internal(rid), 0);
+        root_ = rid;  // Update root index.
+    }
+    node_id id = root_;
+    while (!_node(id)->leaf_) {
+        auto p = _internal(id);
+        int ci = _child_index(p, k);
+        if (2 * D - 1 == _node(p->c_[ci])->n_) {
+            _split(p, ci);
+            if (!(k < p->key_[ci])) { ci++; }  // Update child node if necessary.
+        }
+        id = p->c_[ci];
+    }
+    auto l = _leaf(id);
+    int j = l->n_ - 1;
+    for (; j >= 0 && k < l->key_[j]; --j) {
+        l->key_[j + 1] = std::move(l->key_[j]);
+        l->val_[j + 1] = std::move(l->val_[j]);
+    }
+    l->key_[j + 1] = std::move(k);
+    l->val_[j + 1] = std::move(v);
+    l->n_++;
+    size_++;
+}
+
+/*!
+ * @brief This API tries to remove the input key from the tree. Every node on the path is topped up
+ * to at least `D` keys before descending, so the leaf can lose one key without rebalancing upwards.
+ * @param k is the key object.
+ * @return true if succeeded, false if failed.
+ */
+template<typename K, typename V, int D>
+bool ArenaBPlusTree<K, V, D>::remove(const K& k) {
+    if (!find(k)) { return false; }
+    node_id id = root_;
+    while (!_node(id)->leaf_) {
+        auto p = _internal(id);
+        int ci = _child_index(p, k);
+        if (D - 1 == _node(p->c_[ci])->n_) {
+            if (ci > 0 && _node(p->c_[ci - 1])->n_ > D - 1) {
+                _borrow_from_left(p, ci);
+            } else if (ci < p->n_ && _node(p->c_[ci + 1])->n_ > D - 1) {
+                _borrow_from_right(p, ci);
+            } else if (ci > 0) {
+                _merge(p, --ci);
+            } else {
+                _merge(p, ci);
+            }
+        }
+        node_id next = p->c_[ci];
+        if (0 == p->n_) {  // Only the root can run out of keys: its children were merged.
+            arena_.template destroy<Internal>(id);
+            root_ = next;
+        }
+        id = next;
+    }
+    auto l = _leaf(id);
+    int i = keyLowerBound(l->key_.data(), l->n_, k);
+    std::move(l->key_.begin() + i + 1, l->key_.begin() + l->n_, l->key_.begin() + i);
+    std::move(l->val_.begin() + i + 1, l->val_.begin() + l->n_, l->val_.begin() + i);
+    l->n_--;
+    size_--;
+    return true;
+}
+
+/*!
+ * @brief This method checks if the given key exists in the tree.
+ * @param k is the key object.
+ * @return true if exists, false if not exists.
+ */
+template<typename K, typename V, int D>
+bool ArenaBPlusTree<K, V, D>::contains(const K& k) const {
+    return nullptr != find(k);
+}
+
+/*!
+ * @brief This method looks up a key without copying the value.
+ * @param k is the key object.
+ * @return pointer to the value stored in the tree, or nullptr if not found.
+ * It is invalidated by the next modification of the tree.
+ */
+template<typename K, typename V, int D>
+const V* ArenaBPlusTree<K, V, D>::find(const K& k) const {
+    if (Arena::null_id == root_) { return nullptr; }
+    node_id id = root_;
+    while (!_node(id)->leaf_) {
+        auto p = _internal(id);
+        id = p->c_[_child_index(p, k)];
+    }
+    auto l = _leaf(id);
+    int i = keyLowerBound(l->key_.data(), l->n_, k);
+    return i < l->n_ && !(k < l->key_[i]) ? &l->val_[i] : nullptr;
+}
+
+/*!
+ * @brief This API searches for the given key, with the same interface as <em>BPlusTree</em>.
+ * @param k is the key object.
+ * @return a shared pointer to a copy of the value object, or nullptr if not found.
+ */
+template<typename K, typename V, int D>
+std::shared_ptr<V> ArenaBPlusTree<K, V, D>::search(const K& k) const {
+    auto v = find(k);
+    return v ? std::make_shared<V>(*v) : nullptr;
+}
+
+/*!
+ * @brief This method returns number of key-value pairs in the tree.
+ * @return number of key-value pairs.
+ */
+template<typename K, typename V, int D>
+size_t ArenaBPlusTree<K, V, D>::size() const {
+    return size_;
+}
+
+/*!
+ * @brief This method removes all key-value pairs and releases the arena.
+ */
+template<typename K, typename V, int D>
+void ArenaBPlusTree<K, V, D>::clear() {
+    if (Arena::null_id != root_) { _destroy(root_); }
+    arena_.clear();
+    root_ = Arena::null_id;
+    size_ = 0;
+}
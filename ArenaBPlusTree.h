@@ -0,0 +1,113 @@
+/*!
+ * @brief This file contains the class definitions of <em>NodeArena</em> and <em>ArenaBPlusTree</em>.
+ */
+#ifndef CS225_SP22_C2_ARENABPLUSTREE_H_
+#define CS225_SP22_C2_ARENABPLUSTREE_H_
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include "keySearch.h"
+
+/*!
+ * @brief This class hands out fixed-size slots from contiguous pages. Slots are addressed by 32-bit indices
+ * and recycled through a free list; pages are never moved, so pointers to live nodes stay valid.
+ * @tparam SlotSize is size of one slot in bytes.
+ * @tparam SlotAlign is alignment of one slot.
+ */
+template<size_t SlotSize, size_t SlotAlign>
+class NodeArena {
+public:
+    using node_id = uint32_t;
+    static constexpr node_id null_id{UINT32_MAX};
+
+    NodeArena() = default;
+    NodeArena(const NodeArena& node_arena) = delete;
+    NodeArena& operator=(const NodeArena& node_arena) = delete;
+    virtual ~NodeArena() = default;  // Objects must be destroyed by the owner before.
+
+    template<typename T> node_id create();
+    template<typename T> void destroy(node_id id);
+    template<typename T> [[nodiscard]] T* get(node_id id) const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] size_t capacity() const;
+    void clear();
+
+private:
+    static constexpr int kPageShift{10};
+    static constexpr node_id kPageSlots{1u << kPageShift};  // Slots per page.
+
+    struct alignas(SlotAlign) Slot {
+        std::byte bytes_[SlotSize];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> pages_{};
+    std::vector<node_id> free_{};  // Recycled slots.
+    node_id next_{};  // First never-used slot.
+};
+
+/*!
+ * @brief This class implements a B+-tree whose nodes live in a <em>NodeArena</em>. Children and sibling links
+ * are 32-bit node indices and every node carries a leaf/internal tag, so traversal needs neither reference
+ * counting nor RTTI. Unlike <em>BPlusTree</em>, leaves have no overflow block.
+ * @tparam K is type of key objects.
+ * @tparam V is type of value objects.
+ * @tparam D is the minimum degree of the tree.
+ */
+template<typename K, typename V, int D = 32>
+class ArenaBPlusTree {
+    static_assert(D >= 2, "The minimum degree must be at least 2.");
+public:
+    ArenaBPlusTree() = default;
+    ArenaBPlusTree(const ArenaBPlusTree& tree) = delete;
+    ArenaBPlusTree& operator=(const ArenaBPlusTree& tree) = delete;
+    virtual ~ArenaBPlusTree();
+
+    void insert(K k, V v);
+    bool remove(const K& k);
+    [[nodiscard]] bool contains(const K& k) const;
+    [[nodiscard]] const V* find(const K& k) const;
+    std::shared_ptr<V> search(const K& k) const;
+    [[nodiscard]] size_t size() const;
+    void clear();
+
+private:
+    struct Node {
+        explicit Node(bool leaf) : leaf_{leaf} {}
+        bool leaf_{};
+        int n_{};
+        std::array<K, 2 * D - 1> key_{};
+    };
+    struct Internal : Node {
+        Internal() : Node(false) {}
+        std::array<uint32_t, 2 * D> c_{};
+    };
+    struct Leaf : Node {
+        Leaf() : Node(true) {}
+        std::array<V, 2 * D - 1> val_{};
+        uint32_t l_{UINT32_MAX};
+        uint32_t r_{UINT32_MAX};
+    };
+    using Arena = NodeArena<std::max(sizeof(Internal), sizeof(Leaf)), std::max(alignof(Internal), alignof(Leaf))>;
+    using node_id = typename Arena::node_id;
+
+    [[nodiscard]] Node* _node(node_id id) const;
+    [[nodiscard]] Internal* _internal(node_id id) const;
+    [[nodiscard]] Leaf* _leaf(node_id id) const;
+    static int _child_index(const Internal* p, const K& k);
+    void _split(Internal* p, int i);
+    void _merge(Internal* p, int i);
+    void _borrow_from_left(Internal* p, int i);
+    void _borrow_from_right(Internal* p, int i);
+    void _destroy(node_id id);
+
+    Arena arena_{};
+    node_id root_{Arena::null_id};
+    size_t size_{};
+};
+
+#endif //CS225_SP22_C2_ARENABPLUSTREE_H_
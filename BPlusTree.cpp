@@ -9,8 +9,8 @@
  * @tparam V is type of value objects.
  * @param isLeaf is 1 if derived class is leaves, 0 otherwise.
  */
-template<typename K, typename V>
-NodeBase<K, V>::NodeBase(bool isLeaf) :leaf_{isLeaf} {}
+template<typename K, typename V, int Degree, int OverflowSize>
+NodeBase<K, V, Degree, OverflowSize>::NodeBase(bool isLeaf) :leaf_{isLeaf} {}
 
 /*!
  * @brief This method evaluates the index to which the key should present or
@@ -18,17 +18,36 @@ NodeBase<K, V>::NodeBase(bool isLeaf) :leaf_{isLeaf} {}
  * @param k is the key object.
  * @return the desired index.
  */
-template<typename K, typename V>
-int NodeBase<K, V>::_get_key_index(K k) const {
-    auto it = std::lower_bound(key_.begin(), key_.begin() + n_, k);
-    return it - key_.begin() <= n_ - 1 ? it - key_.begin() : n_ - 1;
+template<typename K, typename V, int Degree, int OverflowSize>
+int NodeBase<K, V, Degree, OverflowSize>::_get_key_index(K k) const {
+    int i = keyLowerBound(key_.data(), n_, k);
+    return i <= n_ - 1 ? i : n_ - 1;
+}
+
+/*!
+ * @brief This method makes the node in the given slot modifiable by the given version of the tree. A node of
+ * another version may be shared with a copy of the tree, so it is copied and the slot is pointed at the copy.
+ * @param slot is the child pointer (or root pointer) that refers to the node.
+ * @param epoch is the epoch of the version that is about to modify the node.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+void NodeBase<K, V, Degree, OverflowSize>::_own(node_ptr& slot, uint64_t epoch) {
+    if (epoch == slot->epoch_) { return; }
+    if (slot->leaf_) {
+        slot = std::make_shared<LeafNode<K, V, Degree, OverflowSize>>(
+            static_cast<const LeafNode<K, V, Degree, OverflowSize>&>(*slot));
+    } else {
+        slot = std::make_shared<InternalNode<K, V, Degree, OverflowSize>>(
+            static_cast<const InternalNode<K, V, Degree, OverflowSize>&>(*slot));
+    }
+    slot->epoch_ = epoch;
 }
 
 /*!
  * @brief The no-arg constructor of internal nodes.
  */
-template<typename K, typename V>
-InternalNode<K, V>::InternalNode() : NodeBase<K, V>(false) {}
+template<typename K, typename V, int Degree, int OverflowSize>
+InternalNode<K, V, Degree, OverflowSize>::InternalNode() : NodeBase<K, V, Degree, OverflowSize>(false) {}
 
 /*!
  * @brief This method recursively inserts a new key into an internal node.
@@ -37,8 +56,8 @@ InternalNode<K, V>::InternalNode() : NodeBase<K, V>(false) {}
  * @param c is pointer to the child node to which the key will be inserted.
  * @param ci is the index of the child node in the parent node's child list.
  */
-template<typename K, typename V>
-void InternalNode<K, V>::_insert(K k, int ki, node_ptr c, int ci) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void InternalNode<K, V, Degree, OverflowSize>::_insert(K k, int ki, node_ptr c, int ci) {
     for (int j = this->n_ - 1; j >= ki; --j) {
         this->key_[j + 1] = this->key_[j];
     }
@@ -55,18 +74,19 @@ void InternalNode<K, V>::_insert(K k, int ki, node_ptr c, int ci) {
  * @param p is pointer to the parent of the current node.
  * @param i is the index of the current node in the child list of the parent.
  */
-template<typename K, typename V>
-void InternalNode<K, V>::_split(node_ptr p, int i) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void InternalNode<K, V, Degree, OverflowSize>::_split(node_ptr p, int i) {
     auto r = std::make_shared<InternalNode>();
-    this->n_ = r->n_ = d - 1;
-    for (int j = 0; j < d - 1; ++j) {
-        r->key_[j] = this->key_[j + d];
+    r->epoch_ = this->epoch_;
+    this->n_ = r->n_ = Degree - 1;
+    for (int j = 0; j < Degree - 1; ++j) {
+        r->key_[j] = this->key_[j + Degree];
     }
-    for (int j = 0; j < d; ++j) {
-        r->c_[j] = this->c_[j + d];
+    for (int j = 0; j < Degree; ++j) {
+        r->c_[j] = this->c_[j + Degree];
     }
     auto tp = std::dynamic_pointer_cast<InternalNode>(p);
-    tp->_insert(this->key_[d - 1], i, r, i + 1);
+    tp->_insert(this->key_[Degree - 1], i, r, i + 1);
 }
 
 /*!
@@ -75,13 +95,13 @@ void InternalNode<K, V>::_split(node_ptr p, int i) {
  * @param i is index of the current node in the child list of the parent node.
  * @param r is pointer to the right neighbor.
  */
-template<typename K, typename V>
-void InternalNode<K, V>::_merge(node_ptr p, int i, node_ptr r) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void InternalNode<K, V, Degree, OverflowSize>::_merge(node_ptr p, int i, node_ptr r) {
     auto tp = std::dynamic_pointer_cast<InternalNode>(p);
     auto tr = std::dynamic_pointer_cast<InternalNode>(r);
-    _insert(p->key_[i], d - 1, tr->c_[0], d);
+    _insert(p->key_[i], Degree - 1, tr->c_[0], Degree);
     for (int j = 1; j <= tr->n_; ++j) {
-        _insert(tr->key_[j - 1], d + j - 1, tr->c_[j], d + j);
+        _insert(tr->key_[j - 1], Degree + j - 1, tr->c_[j], Degree + j);
     }
     tp->_remove(i, i + 1);
 }
@@ -92,8 +112,8 @@ void InternalNode<K, V>::_merge(node_ptr p, int i, node_ptr r) {
  * @param ki is index of the key to be removed.
  * @param ci is index of the child pointer to be removed.
  */
-template<typename K, typename V>
-void InternalNode<K, V>::_remove(int ki, int ci) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void InternalNode<K, V, Degree, OverflowSize>::_remove(int ki, int ci) {
     for (int j = ki + 1; j < this->n_; ++j) {
         this->key_[j - 1] = this->key_[j];
     }
@@ -109,11 +129,12 @@ void InternalNode<K, V>::_remove(int ki, int ci) {
  * @param i is index of the current node in the child list of the parent.
  * @param l is pointer to the left neighbor.
  */
-template<typename K, typename V>
-void InternalNode<K, V>::_borrow_from_left(node_ptr p, int i, node_ptr l) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void InternalNode<K, V, Degree, OverflowSize>::_borrow_from_left(node_ptr p, int i, node_ptr l) {
     auto tl = std::dynamic_pointer_cast<InternalNode>(l);
+    NodeBase<K, V, Degree, OverflowSize>::_own(tl->c_[tl->n_], this->epoch_);  // It is modified below.
     if (tl->c_[tl->n_]->leaf_) {
-        auto t = std::dynamic_pointer_cast<LeafNode<K, V>>(tl->c_[tl->n_]);
+        auto t = std::dynamic_pointer_cast<LeafNode<K, V, Degree, OverflowSize>>(tl->c_[tl->n_]);
         t->_load_overflow();
     }
     _insert(p->key_[i], 0, tl->c_[tl->n_], 0);
@@ -127,11 +148,12 @@ void InternalNode<K, V>::_borrow_from_left(node_ptr p, int i, node_ptr l) {
  * @param i is index of the current node in the child list of the parent.
  * @param l is pointer to the right neighbor.
  */
-template<typename K, typename V>
-void InternalNode<K, V>::_borrow_from_right(node_ptr p, int i, node_ptr r) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void InternalNode<K, V, Degree, OverflowSize>::_borrow_from_right(node_ptr p, int i, node_ptr r) {
     auto tr = std::dynamic_pointer_cast<InternalNode>(r);
+    NodeBase<K, V, Degree, OverflowSize>::_own(tr->c_[0], this->epoch_);  // It is modified below.
     if (tr->c_[0]->leaf_) {
-        auto t = std::dynamic_pointer_cast<LeafNode<K, V>>(tr->c_[0]);
+        auto t = std::dynamic_pointer_cast<LeafNode<K, V, Degree, OverflowSize>>(tr->c_[0]);
         t->_load_overflow();
     }
     _insert(p->key_[i], this->n_, tr->c_[0], this->n_ + 1);
@@ -145,22 +167,22 @@ void InternalNode<K, V>::_borrow_from_right(node_ptr p, int i, node_ptr r) {
  * @param i is index of the key in the current node.
  * @return index of the appropriate child index.
  */
-template<typename K, typename V>
-int InternalNode<K, V>::_get_child_index(K k, int i) {
+template<typename K, typename V, int Degree, int OverflowSize>
+int InternalNode<K, V, Degree, OverflowSize>::_get_child_index(K k, int i) const {
     return k < this->key_[i] ? i : i + 1;
 }
 
 /*!
  * @brief No-arg constructor of the leaf nodes.
  */
-template<typename K, typename V>
-LeafNode<K, V>::LeafNode() : NodeBase<K, V>(true) {}
+template<typename K, typename V, int Degree, int OverflowSize>
+LeafNode<K, V, Degree, OverflowSize>::LeafNode() : NodeBase<K, V, Degree, OverflowSize>(true) {}
 
 /*!
  * @brief This method attempts to sort the key-value pair of the overflow block.
  */
-template<typename K, typename V>
-void LeafNode<K, V>::_sort_overflow() {
+template<typename K, typename V, int Degree, int OverflowSize>
+void LeafNode<K, V, Degree, OverflowSize>::_sort_overflow() {
     std::vector<std::pair<K, V>> pairs(overflow_n_);
     for (int j = 0; j < overflow_n_; ++j) {
         pairs[j] = std::make_pair(overflow_key_[j], overflow_val_[j]);
@@ -177,8 +199,8 @@ void LeafNode<K, V>::_sort_overflow() {
 /*!
  * @brief This method moves all key-value pairs from the overflow list to the main page.
  */
-template<typename K, typename V>
-void LeafNode<K, V>::_load_overflow() {
+template<typename K, typename V, int Degree, int OverflowSize>
+void LeafNode<K, V, Degree, OverflowSize>::_load_overflow() {
     if (0 == overflow_n_) { return; }
     _sort_overflow();
     for (int j = 0; j < overflow_n_; ++j) {
@@ -187,22 +209,42 @@ void LeafNode<K, V>::_load_overflow() {
     overflow_n_ = 0;
 }
 
+/*!
+ * @brief This method looks up a key in the main page and then in the overflow block, without loading
+ * the overflow block (the leaf is left untouched).
+ * @param k is the key object.
+ * @return pointer to the value object, or nullptr if not found.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+const V* LeafNode<K, V, Degree, OverflowSize>::_find(const K& k) const {
+    int i = keyLowerBound(this->key_.data(), this->n_, k);
+    if (i < this->n_ && k == this->key_[i]) {
+        return &val_[i];
+    }
+    int j = keyFind(overflow_key_.data(), overflow_n_, k);  // The overflow block is unsorted.
+    return j >= 0 ? &overflow_val_[j] : nullptr;
+}
+
 /*!
  * @brief This method inserts a given key-value pair into the current leaf node.
  * @param k is the key object.
  * @param v is the value object.
  */
-template<typename K, typename V>
-void LeafNode<K, V>::_insert(K k, V v) {
-    if (2 * d - 1 - d / 2 < this->n_) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void LeafNode<K, V, Degree, OverflowSize>::_insert(K k, V v) {
+    if constexpr (0 == OverflowSize) {  // Overflow block disabled.
         _insert_main(k, v);
-        return;
-    }
-    if (d / 2 == overflow_n_) {
-        _load_overflow();
+    } else {
+        if (2 * Degree - 1 - OverflowSize < this->n_) {
+            _insert_main(k, v);
+            return;
+        }
+        if (OverflowSize == overflow_n_) {
+            _load_overflow();
+        }
+        overflow_key_[overflow_n_] = k;
+        overflow_val_[overflow_n_++] = v;
     }
-    overflow_key_[overflow_n_] = k;
-    overflow_val_[overflow_n_++] = v;
 }
 
 /*!
@@ -210,8 +252,8 @@ void LeafNode<K, V>::_insert(K k, V v) {
  * @param k is the key object.
  * @param v is the value object.
  */
-template<typename K, typename V>
-void LeafNode<K, V>::_insert_main(K k, V v) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void LeafNode<K, V, Degree, OverflowSize>::_insert_main(K k, V v) {
     int j = this->n_ - 1;
     for (; j >= 0 && k < this->key_[j]; --j) {
         this->key_[j + 1] = this->key_[j];
@@ -226,8 +268,8 @@ void LeafNode<K, V>::_insert_main(K k, V v) {
  * @brief This method removes the `i`th key-value pair from the current leaf node.
  * @param i is index of the node to be removed.
  */
-template<typename K, typename V>
-void LeafNode<K, V>::_remove(int i) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void LeafNode<K, V, Degree, OverflowSize>::_remove(int i) {
     _load_overflow();
     for (int j = i + 1; j < this->n_; ++j) {
         this->key_[j - 1] = this->key_[j];
@@ -241,25 +283,19 @@ void LeafNode<K, V>::_remove(int i) {
  * @param p is pointer to the parent of the current node.
  * @param i is index of the current node in the parent's child list.
  */
-template<typename K, typename V>
-void LeafNode<K, V>::_split(node_ptr p, int i) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void LeafNode<K, V, Degree, OverflowSize>::_split(node_ptr p, int i) {
     _load_overflow();
     auto r = std::make_shared<LeafNode>();
-    this->n_ = d - 1;
-    r->n_ = d;
-    if (r_) {
-        auto tr = std::dynamic_pointer_cast<LeafNode>(r_);
-        tr->l_ = r;
-        r->r_ = tr;
-    }
-    r_ = r;
-    r->l_ = this->shared_from_this();
-    for (int j = 0; j < d; ++j) {
-        r->key_[j] = this->key_[j + d - 1];
-        r->val_[j] = this->val_[j + d - 1];
+    r->epoch_ = this->epoch_;
+    this->n_ = Degree - 1;
+    r->n_ = Degree;
+    for (int j = 0; j < Degree; ++j) {
+        r->key_[j] = this->key_[j + Degree - 1];
+        r->val_[j] = this->val_[j + Degree - 1];
     }
-    auto tp = std::dynamic_pointer_cast<InternalNode<K, V>>(p);
-    tp->_insert(this->key_[d - 1], i, r, i + 1);
+    auto tp = std::dynamic_pointer_cast<InternalNode<K, V, Degree, OverflowSize>>(p);
+    tp->_insert(this->key_[Degree - 1], i, r, i + 1);
 }
 
 /*!
@@ -268,9 +304,9 @@ void LeafNode<K, V>::_split(node_ptr p, int i) {
  * @param i is index of the current node in the parent's child list.
  * @param r is pointer to the right neighbor of the current node.
  */
-template<typename K, typename V>
-void LeafNode<K, V>::_merge(node_ptr p, int i, node_ptr r) {
-    auto tp = std::dynamic_pointer_cast<InternalNode<K, V>>(p);
+template<typename K, typename V, int Degree, int OverflowSize>
+void LeafNode<K, V, Degree, OverflowSize>::_merge(node_ptr p, int i, node_ptr r) {
+    auto tp = std::dynamic_pointer_cast<InternalNode<K, V, Degree, OverflowSize>>(p);
     auto tr = std::dynamic_pointer_cast<LeafNode>(r);
     _load_overflow();
     tr->_load_overflow();
@@ -278,11 +314,6 @@ void LeafNode<K, V>::_merge(node_ptr p, int i, node_ptr r) {
         _insert(tr->key_[j], tr->val_[j]);
     }
     _load_overflow();
-    r_ = tr->r_;
-    if (tr->r_) {
-        auto trr = std::dynamic_pointer_cast<LeafNode>(tr->r_);
-        trr->l_ = this->shared_from_this();
-    }
     tp->_remove(i, i + 1);
 }
 
@@ -292,8 +323,8 @@ void LeafNode<K, V>::_merge(node_ptr p, int i, node_ptr r) {
  * @param i is index of the current node in the child list of the parent.
  * @param l is pointer to the right neighbor.
  */
-template<typename K, typename V>
-void LeafNode<K, V>::_borrow_from_left(node_ptr p, int i, node_ptr l) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void LeafNode<K, V, Degree, OverflowSize>::_borrow_from_left(node_ptr p, int i, node_ptr l) {
     auto tl = std::dynamic_pointer_cast<LeafNode>(l);
     tl->_load_overflow();
     _load_overflow();
@@ -308,8 +339,8 @@ void LeafNode<K, V>::_borrow_from_left(node_ptr p, int i, node_ptr l) {
  * @param i is index of the current node in the child list of the parent.
  * @param l is pointer to the right neighbor.
  */
-template<typename K, typename V>
-void LeafNode<K, V>::_borrow_from_right(node_ptr p, int i, node_ptr r) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void LeafNode<K, V, Degree, OverflowSize>::_borrow_from_right(node_ptr p, int i, node_ptr r) {
     auto tr = std::dynamic_pointer_cast<LeafNode>(r);
     tr->_load_overflow();
     _load_overflow();
@@ -318,26 +349,113 @@ void LeafNode<K, V>::_borrow_from_right(node_ptr p, int i, node_ptr r) {
     p->key_[i] = tr->key_[0];
 }
 
+/*!
+ * @brief This copy constructor shares the nodes of the given tree in O(1) time. From now on, neither tree modifies
+ * a shared node in place: both copy the nodes they modify (copy-on-write).
+ * @param tree is the tree to copy. It must not be modified concurrently.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+BPlusTree<K, V, Degree, OverflowSize>::BPlusTree(const BPlusTree& tree) : root_(tree.root_), epoch_(next_epoch_++) {
+    tree.epoch_ = next_epoch_++;  // Every existing node now belongs to an older version.
+}
+
+/*!
+ * @brief This copy assignment operator shares the nodes of the given tree in O(1) time, like the copy constructor.
+ * The nodes of the old content are freed unless another version still refers to them.
+ * @param tree is the tree to copy. It must not be modified concurrently.
+ * @return reference to this tree.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+BPlusTree<K, V, Degree, OverflowSize>& BPlusTree<K, V, Degree, OverflowSize>::operator=(const BPlusTree& tree) {
+    if (this != &tree) {
+        root_ = tree.root_;
+        epoch_ = next_epoch_++;
+        tree.epoch_ = next_epoch_++;
+    }
+    return *this;
+}
+
+/*!
+ * @brief This method takes a snapshot of the tree: a frozen copy that can be read (e.g. iterated) from another
+ * thread while this tree keeps being modified. It takes O(1) time; the versions share every node that has not
+ * been modified since, and the nodes only the snapshot refers to are freed with the last copy of the snapshot.
+ * It must not be called concurrently with a modification of this tree.
+ * @return the snapshot.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+BPlusTree<K, V, Degree, OverflowSize> BPlusTree<K, V, Degree, OverflowSize>::snapshot() const {
+    return BPlusTree{*this};
+}
+
+/*!
+ * @brief This method replaces the contents of the tree with the given pairs, building it bottom-up in O(n) time:
+ * the pairs are dealt to the fewest leaves that hold them, then each level to the fewest parents that hold it.
+ * Every node gets an even share, so no node (but the root) is less than half full.
+ * @param entries are the pairs, sorted by key and with distinct keys.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+void BPlusTree<K, V, Degree, OverflowSize>::bulk_load(std::vector<std::pair<K, V>> entries) {
+    root_ = nullptr;
+    if (entries.empty()) { return; }
+    std::vector<node_ptr> level;
+    std::vector<K> lows;  // Smallest key of each subtree of `level`.
+    size_t n = entries.size();
+    size_t count = (n + 2 * Degree - 2) / (2 * Degree - 1);
+    for (size_t j = 0, next = 0; j < count; ++j) {
+        auto leaf = std::make_shared<leaf_type>();
+        leaf->epoch_ = epoch_;
+        lows.push_back(entries[next].first);
+        for (size_t end = n * (j + 1) / count; next < end; ++next, ++leaf->n_) {
+            leaf->key_[leaf->n_] = std::move(entries[next].first);
+            leaf->val_[leaf->n_] = std::move(entries[next].second);
+        }
+        level.push_back(std::move(leaf));
+    }
+    while (level.size() > 1) {
+        std::vector<node_ptr> parents;
+        std::vector<K> parent_lows;
+        size_t m = level.size();
+        count = (m + 2 * Degree - 1) / (2 * Degree);
+        for (size_t j = 0, next = 0; j < count; ++j) {
+            auto p = std::make_shared<InternalNode<K, V, Degree, OverflowSize>>();
+            p->epoch_ = epoch_;
+            parent_lows.push_back(lows[next]);
+            p->c_[0] = std::move(level[next++]);
+            for (size_t end = m * (j + 1) / count; next < end; ++next) {
+                p->key_[p->n_++] = lows[next];  // Keys not less than the smallest key of a child go right.
+                p->c_[p->n_] = std::move(level[next]);
+            }
+            parents.push_back(std::move(p));
+        }
+        level = std::move(parents);
+        lows = std::move(parent_lows);
+    }
+    root_ = std::move(level.front());
+}
+
 /*!
  * @brief This method attempts to insert the given key-value pair into the tree.
  * @param k is the key object.
  * @param v is the value object.
  */
-template<typename K, typename V>
-void BPlusTree<K, V>::insert(K k, V v) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void BPlusTree<K, V, Degree, OverflowSize>::insert(K k, V v) {
     if (nullptr == root_) {
-        auto tr = std::make_shared<LeafNode<K, V>>();
-        root_ = std::dynamic_pointer_cast<NodeBase<K, V>>(tr);
+        auto tr = std::make_shared<LeafNode<K, V, Degree, OverflowSize>>();
+        tr->epoch_ = epoch_;
+        root_ = std::dynamic_pointer_cast<NodeBase<K, V, Degree, OverflowSize>>(tr);
     }
+    _own(root_);
     if (root_->leaf_) {
-        auto tr = std::dynamic_pointer_cast<LeafNode<K, V>>(root_);
+        auto tr = std::dynamic_pointer_cast<LeafNode<K, V, Degree, OverflowSize>>(root_);
         tr->_load_overflow();
     }
-    if (root_->n_ == 2 * d - 1) {
-        auto r = std::make_shared<InternalNode<K, V>>();
+    if (root_->n_ == 2 * Degree - 1) {
+        auto r = std::make_shared<InternalNode<K, V, Degree, OverflowSize>>();
+        r->epoch_ = epoch_;
         r->c_[0] = root_;
         root_->_split(r, 0);  // This is a leaf node.
-        root_ = std::dynamic_pointer_cast<NodeBase<K, V>>(r);  // Update root pointer.
+        root_ = std::dynamic_pointer_cast<NodeBase<K, V, Degree, OverflowSize>>(r);  // Update root pointer.
     }
     _insert(root_, k, v);
 }
@@ -348,23 +466,24 @@ void BPlusTree<K, V>::insert(K k, V v) {
  * @param k is the key object.
  * @param v is the value object.
  */
-template<typename K, typename V>
-void BPlusTree<K, V>::_insert(node_ptr p, K k, V v) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void BPlusTree<K, V, Degree, OverflowSize>::_insert(node_ptr p, K k, V v) {
     if (p->leaf_) {
-        auto tp = std::dynamic_pointer_cast<LeafNode<K, V>>(p);
+        auto tp = std::dynamic_pointer_cast<LeafNode<K, V, Degree, OverflowSize>>(p);
         tp->_insert(k, v);
         return;
     }
     // p is an internal node!
-    auto tp = std::dynamic_pointer_cast<InternalNode<K, V>>(p);
+    auto tp = std::dynamic_pointer_cast<InternalNode<K, V, Degree, OverflowSize>>(p);
     int ki = tp->_get_key_index(k);
     int ci = tp->_get_child_index(k, ki);
+    _own(tp->c_[ci]);
     auto c = tp->c_[ci];
     if (c->leaf_) {
-        auto tc = std::dynamic_pointer_cast<LeafNode<K, V>>(c);
+        auto tc = std::dynamic_pointer_cast<LeafNode<K, V, Degree, OverflowSize>>(c);
         tc->_load_overflow();
     }
-    if (c->n_ >= 2 * d - 1) {
+    if (c->n_ >= 2 * Degree - 1) {
         c->_split(tp, ci);
         if (tp->key_[ci] <= k) {
             c = tp->c_[ci + 1];  // Update child node if necessary.
@@ -374,47 +493,178 @@ void BPlusTree<K, V>::_insert(node_ptr p, K k, V v) {
 }
 
 /*!
- * @brief This method checks if the given key exists in the tree.
+ * @brief This method checks if the given key exists in the tree. The value is never copied.
  * @param k is the key object.
  * @return true if exists, false if not exists.
  */
-template<typename K, typename V>
-bool BPlusTree<K, V>::contains(K k) {
-    return nullptr != search(k);
+template<typename K, typename V, int Degree, int OverflowSize>
+bool BPlusTree<K, V, Degree, OverflowSize>::contains(const K& k) const {
+    return nullptr != find(k);
 }
 
 /*!
- * @brief This API attempts to remove the given key from the tree.
+ * @brief This method looks up a key without copying the value or modifying the tree.
  * @param k is the key object.
- * @return a shared pointer to the desired value object.
+ * @return pointer to the value object stored in the tree, or nullptr if not found.
+ * The pointer is invalidated by the next insertion or removal.
  */
-template<typename K, typename V>
-std::shared_ptr<V> BPlusTree<K, V>::search(K k) {
-    return _search(root_, k);
+template<typename K, typename V, int Degree, int OverflowSize>
+const V* BPlusTree<K, V, Degree, OverflowSize>::find(const K& k) const {
+    auto leaf = _find_leaf(k);
+    return leaf ? leaf->_find(k) : nullptr;
 }
 
 /*!
- * @brief This method recursively searches for a given key in the given subtree.
- * @param p is pointer to the root of the subtree to perform searching.
+ * @brief This method descends to the leaf that holds (or would hold) the given key.
  * @param k is the key object.
- * @return a shared pointer to the desired value object.
+ * @return pointer to the leaf, or nullptr if the tree is empty.
  */
-template<typename K, typename V>
-std::shared_ptr<V> BPlusTree<K, V>::_search(node_ptr p, K k) {
+template<typename K, typename V, int Degree, int OverflowSize>
+const LeafNode<K, V, Degree, OverflowSize>* BPlusTree<K, V, Degree, OverflowSize>::_find_leaf(const K& k) const {
+    const NodeBase<K, V, Degree, OverflowSize>* p = root_.get();
     if (nullptr == p) { return nullptr; }
-    if (p->leaf_) {  // Directly search and return pointer-to-value.
-        auto tp = std::dynamic_pointer_cast<LeafNode<K, V>>(p);
-        tp->_load_overflow();
+    while (!p->leaf_) {  // The tag tells the node type, so no RTTI is needed.
+        auto tp = static_cast<const InternalNode<K, V, Degree, OverflowSize>*>(p);
         int i = tp->_get_key_index(k);
-        if (i < tp->n_ && k == tp->key_[i]) {  // Found in leaf node!
-            return std::make_shared<V>(tp->val_[i]);
+        p = tp->c_[tp->_get_child_index(k, i)].get();
+    }
+    return static_cast<const leaf_type*>(p);
+}
+
+/*!
+ * @brief This method makes the node in the given slot modifiable by this tree, copying it if it may be shared.
+ * @param slot is the root pointer or a child pointer of a node this tree may modify.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+void BPlusTree<K, V, Degree, OverflowSize>::_own(node_ptr& slot) {
+    NodeBase<K, V, Degree, OverflowSize>::_own(slot, epoch_);
+}
+
+/*!
+ * @brief This method descends to the leaf that holds (or would hold) the given key, copying the shared nodes on
+ * the way so that the leaf can be modified (path copying).
+ * @param k is the key object.
+ * @return pointer to the leaf. The tree must not be empty.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+LeafNode<K, V, Degree, OverflowSize>* BPlusTree<K, V, Degree, OverflowSize>::_own_leaf(const K& k) {
+    _own(root_);
+    NodeBase<K, V, Degree, OverflowSize>* p = root_.get();
+    while (!p->leaf_) {
+        auto tp = static_cast<InternalNode<K, V, Degree, OverflowSize>*>(p);
+        auto& slot = tp->c_[tp->_get_child_index(k, tp->_get_key_index(k))];
+        _own(slot);
+        p = slot.get();
+    }
+    return static_cast<leaf_type*>(p);
+}
+
+/*!
+ * @brief This method calls `f` on the value of the given key, if present, without copying it.
+ * @tparam F is type of the callable, invoked as `f(const V&)`.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+template<typename F>
+bool BPlusTree<K, V, Degree, OverflowSize>::visit(const K& k, F&& f) const {
+    auto v = find(k);
+    if (nullptr == v) { return false; }
+    std::forward<F>(f)(*v);
+    return true;
+}
+
+/*!
+ * @brief This method modifies the value of the given key in place. The tree is not restructured.
+ * @tparam F is type of the callable, invoked as `f(V&)`. It must not change anything the key depends on.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+template<typename F>
+bool BPlusTree<K, V, Degree, OverflowSize>::update(const K& k, F&& f) {
+    if (!contains(k)) { return false; }
+    auto v = const_cast<V*>(_own_leaf(k)->_find(k));  // The leaf belongs to this version now.
+    std::forward<F>(f)(*v);
+    return true;
+}
+
+/*!
+ * @brief This method modifies the values of many keys in place in one pass: the keys are split between the
+ * children of each node, so every node on the way is visited (and copied, if shared) once, however many of the
+ * keys are below it. The tree is not restructured.
+ * @tparam F is type of the callable, invoked as `f(i, V&)` with the index of the key in `keys`.
+ * @param keys are the keys, in ascending order. Duplicates are allowed and visited in order.
+ * @param n is number of keys.
+ * @param f is the callable.
+ * @return the number of keys found (and `f` calls).
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+template<typename F>
+size_t BPlusTree<K, V, Degree, OverflowSize>::update_sorted(const K* keys, size_t n, F&& f) {
+    if (nullptr == root_ || 0 == n) { return 0; }
+    return _update_sorted(root_, keys, 0, n, f);
+}
+
+/*!
+ * @brief This method recursively modifies the values of the keys `keys[lo, hi)`, which all belong to the given
+ * subtree.
+ * @param slot is the pointer to the root of the subtree.
+ * @param keys are the keys, in ascending order.
+ * @param lo is index of the first key.
+ * @param hi is index past the last key.
+ * @param f is the callable.
+ * @return the number of keys found.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+template<typename F>
+size_t BPlusTree<K, V, Degree, OverflowSize>::_update_sorted(node_ptr& slot, const K* keys, size_t lo, size_t hi,
+                                                              F& f) {
+    _own(slot);
+    size_t found{};
+    if (slot->leaf_) {
+        auto leaf = static_cast<leaf_type*>(slot.get());
+        for (size_t i = lo; i < hi; ++i) {
+            if (auto v = const_cast<V*>(leaf->_find(keys[i]))) {
+                f(i, *v);
+                ++found;
+            }
         }
-        return nullptr;  // Not found.
+        return found;
     }
-    auto tp = std::dynamic_pointer_cast<InternalNode<K, V>>(p);
-    int i = tp->_get_key_index(k);
-    int ci = tp->_get_child_index(k, i);
-    return _search(tp->c_[ci], k);
+    auto tp = static_cast<InternalNode<K, V, Degree, OverflowSize>*>(slot.get());
+    for (int c = 0; c <= tp->n_ && lo < hi; ++c) {  // Child c holds the keys in [key_[c - 1], key_[c]).
+        size_t mid = c < tp->n_ ? std::lower_bound(keys + lo, keys + hi, tp->key_[c]) - keys : hi;
+        if (lo < mid) { found += _update_sorted(tp->c_[c], keys, lo, mid, f); }
+        lo = mid;
+    }
+    return found;
+}
+
+/*!
+ * @brief This method overwrites the value of the given key in place, or inserts the pair if the key is absent.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if a new pair was inserted, false if an existing value was overwritten.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+bool BPlusTree<K, V, Degree, OverflowSize>::upsert(K k, V v) {
+    if (update(k, [&v](V& slot) { slot = std::move(v); })) { return false; }
+    insert(std::move(k), std::move(v));
+    return true;
+}
+
+/*!
+ * @brief This API searches for the given key.
+ * @param k is the key object.
+ * @return a shared pointer to a copy of the desired value object, or nullptr if not found.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+std::shared_ptr<V> BPlusTree<K, V, Degree, OverflowSize>::search(const K& k) const {
+    auto v = find(k);
+    return v ? std::make_shared<V>(*v) : nullptr;
 }
 
 /*!
@@ -422,14 +672,17 @@ std::shared_ptr<V> BPlusTree<K, V>::_search(node_ptr p, K k) {
  * @param k is the key object.
  * @return true if succeeded, false if failed.
  */
-template<typename K, typename V>
-bool BPlusTree<K, V>::remove(K k) {
-    if (!search(k)) { return false; }
+template<typename K, typename V, int Degree, int OverflowSize>
+bool BPlusTree<K, V, Degree, OverflowSize>::remove(K k) {
+    if (!contains(k)) { return false; }
+    _own(root_);
     if (1 == root_->n_ && !root_->leaf_) {  // `root_` is an internal node with only one key.
-        auto tr = std::dynamic_pointer_cast<InternalNode<K, V>>(root_);
-        auto l = tr->c_[0];
-        auto r = tr->c_[1];
-        if (d - 1 == l->n_ && d - 1 == r->n_) {
+        auto tr = std::dynamic_pointer_cast<InternalNode<K, V, Degree, OverflowSize>>(root_);
+        if (Degree - 1 == _key_count(tr->c_[0]) && Degree - 1 == _key_count(tr->c_[1])) {
+            _own(tr->c_[0]);
+            _own(tr->c_[1]);
+            auto l = tr->c_[0];
+            auto r = tr->c_[1];
             l->_merge(tr, 0, r);
             root_ = l;  // Make the left child the root.
         }
@@ -438,42 +691,57 @@ bool BPlusTree<K, V>::remove(K k) {
     return true;
 }
 
+/*!
+ * @brief This method counts the keys of a node, including those still in the overflow block of a leaf, which are
+ * moved to the main page before the node is merged.
+ * @param p is pointer to the node.
+ * @return number of keys.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+int BPlusTree<K, V, Degree, OverflowSize>::_key_count(const node_ptr& p) {
+    if (!p->leaf_) { return p->n_; }
+    return p->n_ + static_cast<const leaf_type*>(p.get())->overflow_n_;
+}
+
 /*!
  * @brief This method recursively remove the given key from given subtree.
  * @param p is pointer to the root of the subtree to perform removal.
  * @param k is the key object.
  */
-template<typename K, typename V>
-void BPlusTree<K, V>::_remove(node_ptr p, K k) {
+template<typename K, typename V, int Degree, int OverflowSize>
+void BPlusTree<K, V, Degree, OverflowSize>::_remove(node_ptr p, K k) {
     if (p->leaf_) {
-        auto tp = std::dynamic_pointer_cast<LeafNode<K, V>>(p);
+        auto tp = std::dynamic_pointer_cast<LeafNode<K, V, Degree, OverflowSize>>(p);
         tp->_load_overflow();
         int i = tp->_get_key_index(k);
         tp->_remove(i);  // Mission accomplished.
         return;
     }
-    auto tp = std::dynamic_pointer_cast<InternalNode<K, V>>(p);
+    auto tp = std::dynamic_pointer_cast<InternalNode<K, V, Degree, OverflowSize>>(p);
     int i = tp->_get_key_index(k);
     int ci = tp->_get_child_index(k, i);
+    _own(tp->c_[ci]);
     auto c = tp->c_[ci];
     if (c->leaf_) {
-        auto tc = std::dynamic_pointer_cast<LeafNode<K, V>>(c);
+        auto tc = std::dynamic_pointer_cast<LeafNode<K, V, Degree, OverflowSize>>(c);
         tc->_load_overflow();
     }
-    if (d - 1 == c->n_) {
+    if (Degree - 1 == c->n_) {
+        if (ci > 0) { _own(tp->c_[ci - 1]); }  // Either neighbor may lend or merge.
+        if (ci < tp->n_) { _own(tp->c_[ci + 1]); }
         auto l = ci > 0 ? tp->c_[ci - 1] : nullptr;
         auto r = ci < tp->n_ ? tp->c_[ci + 1] : nullptr;
         if (l && l->leaf_) {
-            auto tl = std::dynamic_pointer_cast<LeafNode<K, V>>(l);
+            auto tl = std::dynamic_pointer_cast<LeafNode<K, V, Degree, OverflowSize>>(l);
             tl->_load_overflow();
         }
         if (r && r->leaf_) {
-            auto tr = std::dynamic_pointer_cast<LeafNode<K, V>>(r);
+            auto tr = std::dynamic_pointer_cast<LeafNode<K, V, Degree, OverflowSize>>(r);
             tr->_load_overflow();
         }
-        if (l && l->n_ > d - 1) {
+        if (l && l->n_ > Degree - 1) {
             c->_borrow_from_left(tp, ci - 1, l);
-        } else if (r && r->n_ > d - 1) {
+        } else if (r && r->n_ > Degree - 1) {
             c->_borrow_from_right(tp, ci, r);
         } else if (l) {
             l->_merge(tp, ci - 1, c);  // Perform the merge operation on the left child and then overwrite.
@@ -485,4 +753,323 @@ void BPlusTree<K, V>::_remove(node_ptr p, K k) {
     _remove(c, k);
 }
 
+/*!
+ * @brief This method returns an iterator to the smallest key.
+ * @return an iterator.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstIterator BPlusTree<K, V, Degree, OverflowSize>::begin() const {
+    ConstIterator iter{this};
+    if (nullptr == root_) { return iter; }
+    iter._descend(root_.get(), true);
+    iter._skip_forward();  // Only an empty root.
+    return iter;
+}
+
+/*!
+ * @brief This method returns the past-the-end iterator.
+ * @return an iterator.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstIterator BPlusTree<K, V, Degree, OverflowSize>::end() const {
+    return ConstIterator{this};
+}
+
+/*!
+ * @brief This method returns a reverse iterator to the largest key.
+ * @return a reverse iterator.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstReverseIterator BPlusTree<K, V, Degree, OverflowSize>::rbegin() const {
+    return ConstReverseIterator{end()};
+}
+
+/*!
+ * @brief This method returns the past-the-end reverse iterator.
+ * @return a reverse iterator.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstReverseIterator BPlusTree<K, V, Degree, OverflowSize>::rend() const {
+    return ConstReverseIterator{begin()};
+}
+
+/*!
+ * @brief This method returns an iterator to the first key not less than `k`.
+ * @param k is the key object.
+ * @return an iterator (past-the-end if every key is less than `k`).
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstIterator BPlusTree<K, V, Degree, OverflowSize>::lower_bound(const K& k) const {
+    ConstIterator iter{this};
+    const NodeBase<K, V, Degree, OverflowSize>* p = root_.get();
+    if (nullptr == p) { return iter; }
+    while (!p->leaf_) {
+        auto tp = static_cast<const InternalNode<K, V, Degree, OverflowSize>*>(p);
+        int ci = tp->_get_child_index(k, tp->_get_key_index(k));
+        iter.path_[iter.depth_++] = typename ConstIterator::Step{tp, ci};
+        p = tp->c_[ci].get();
+    }
+    iter.leaf_ = static_cast<const leaf_type*>(p);
+    iter.m_ = keyLowerBound(iter.leaf_->key_.data(), iter.leaf_->n_, k);
+    iter.o_ = iter._overflow_above(&k, true);
+    iter._skip_forward();  // Every key of this leaf may be less than `k`.
+    return iter;
+}
+
+/*!
+ * @brief This method returns the half-open range of keys in `[lo, hi)`.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the exclusive upper bound.
+ * @return the range (empty if `hi` is not greater than `lo`).
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::Range BPlusTree<K, V, Degree, OverflowSize>::range(const K& lo, const K& hi) const {
+    if (!(lo < hi)) { return Range{end(), end()}; }
+    return Range{lower_bound(lo), lower_bound(hi)};
+}
+
+/*!
+ * @brief This constructor creates the past-the-end iterator of a tree.
+ * @param tree is pointer to the tree.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::ConstIterator(const BPlusTree* tree) : tree_(tree) {}
+
+/*!
+ * @brief This copy constructor copies the used part of the path only.
+ * @param iter is the iterator to copy.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::ConstIterator(const ConstIterator& iter)
+    : tree_(iter.tree_), leaf_(iter.leaf_), m_(iter.m_), o_(iter.o_), depth_(iter.depth_) {
+    std::copy_n(iter.path_.begin(), depth_, path_.begin());
+}
+
+/*!
+ * @brief This copy assignment operator copies the used part of the path only.
+ * @param iter is the iterator to copy.
+ * @return reference to this iterator.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstIterator& BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::operator=(
+    const ConstIterator& iter) {
+    tree_ = iter.tree_;
+    leaf_ = iter.leaf_;
+    m_ = iter.m_;
+    o_ = iter.o_;
+    depth_ = iter.depth_;
+    std::copy_n(iter.path_.begin(), depth_, path_.begin());
+    return *this;
+}
+
+/*!
+ * @brief This method descends from a node to its leftmost or rightmost leaf, extending the path, and positions the
+ * iterator before the first entry or after the last entry of that leaf.
+ * @param p is pointer to the node.
+ * @param front is true to descend to the leftmost leaf, false to descend to the rightmost leaf.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+void BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::_descend(const NodeBase<K, V, Degree, OverflowSize>* p,
+                                                                    bool front) {
+    while (!p->leaf_) {
+        auto tp = static_cast<const InternalNode<K, V, Degree, OverflowSize>*>(p);
+        int ci = front ? 0 : tp->n_;
+        path_[depth_++] = Step{tp, ci};
+        p = tp->c_[ci].get();
+    }
+    leaf_ = static_cast<const leaf_type*>(p);
+    m_ = front ? 0 : leaf_->n_;
+    o_ = front ? _overflow_above(nullptr, false) : -1;
+}
+
+/*!
+ * @brief This method moves to the first entry of the next leaf. The path is climbed only as far as the nearest
+ * node with a subtree to the right, so a full scan visits each node twice: amortized O(1) time per leaf.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+void BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::_next_leaf() {
+    while (depth_ > 0 && path_[depth_ - 1].ci == path_[depth_ - 1].node->n_) { --depth_; }
+    if (0 == depth_) {  // It was the rightmost leaf.
+        *this = ConstIterator{tree_};
+        return;
+    }
+    auto& step = path_[depth_ - 1];
+    ++step.ci;
+    _descend(step.node->c_[step.ci].get(), true);
+}
+
+/*!
+ * @brief This method moves after the last entry of the previous leaf.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+void BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::_prev_leaf() {
+    while (depth_ > 0 && 0 == path_[depth_ - 1].ci) { --depth_; }
+    if (0 == depth_) {  // It was the leftmost leaf.
+        *this = ConstIterator{tree_};
+        return;
+    }
+    auto& step = path_[depth_ - 1];
+    --step.ci;
+    _descend(step.node->c_[step.ci].get(), false);
+}
+
+/*!
+ * @brief This method moves past the end of the current leaf to the first entry of the next non-empty leaf.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+void BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::_skip_forward() {
+    while (leaf_ && leaf_->n_ == m_ && o_ < 0) {
+        _next_leaf();
+    }
+}
+
+/*!
+ * @brief This method checks whether the current entry is in the overflow block rather than in the main page.
+ * @return true if it is, false otherwise.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+bool BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::_on_overflow() const {
+    return o_ >= 0 && (leaf_->n_ == m_ || leaf_->overflow_key_[o_] < leaf_->key_[m_]);
+}
+
+/*!
+ * @brief This method scans the overflow block of the current leaf for the smallest key after a given key.
+ * @param k is pointer to the key, or nullptr to find the smallest key of the block.
+ * @param inclusive is true to accept `*k` itself.
+ * @return the overflow slot, or -1 if there is none.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+int BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::_overflow_above(const K* k, bool inclusive) const {
+    int o{-1};
+    for (int j = 0; j < leaf_->overflow_n_; ++j) {
+        const K& key = leaf_->overflow_key_[j];
+        if (k && (inclusive ? key < *k : !(*k < key))) { continue; }
+        if (o < 0 || key < leaf_->overflow_key_[o]) { o = j; }
+    }
+    return o;
+}
+
+/*!
+ * @brief This method scans the overflow block of the current leaf for the largest key before a given key.
+ * @param k is pointer to the key, or nullptr to find the largest key of the block.
+ * @return the overflow slot, or -1 if there is none.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+int BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::_overflow_below(const K* k) const {
+    int o{-1};
+    for (int j = 0; j < leaf_->overflow_n_; ++j) {
+        const K& key = leaf_->overflow_key_[j];
+        if (k && !(key < *k)) { continue; }
+        if (o < 0 || leaf_->overflow_key_[o] < key) { o = j; }
+    }
+    return o;
+}
+
+/*!
+ * @brief This overloaded dereference operator returns the current key-value pair.
+ * @return a pair of references into the tree.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::reference BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::operator*() const {
+    return reference{key(), value()};
+}
+
+/*!
+ * @brief This method returns the current key.
+ * @return reference to the key.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+const K& BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::key() const {
+    return _on_overflow() ? leaf_->overflow_key_[o_] : leaf_->key_[m_];
+}
+
+/*!
+ * @brief This method returns the current value.
+ * @return reference to the value.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+const V& BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::value() const {
+    return _on_overflow() ? leaf_->overflow_val_[o_] : leaf_->val_[m_];
+}
+
+/*!
+ * @brief This overloaded pre-increment operator moves to the next key. Only a step past an overflow key scans the
+ * overflow block again.
+ * @return reference to the incremented iterator.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstIterator& BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::operator++() {
+    if (_on_overflow()) {
+        o_ = _overflow_above(&leaf_->overflow_key_[o_], false);
+    } else {
+        ++m_;
+    }
+    _skip_forward();
+    return *this;
+}
+
+/*!
+ * @brief This overloaded post-increment operator moves to the next key.
+ * @return the original iterator.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstIterator BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::operator++(int) {
+    ConstIterator temp{*this};
+    operator++();
+    return temp;
+}
 
+/*!
+ * @brief This overloaded pre-decrement operator moves to the previous key. Decrementing the
+ * past-the-end iterator moves to the largest key.
+ * @return reference to the decremented iterator.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstIterator& BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::operator--() {
+    if (nullptr == leaf_) { _descend(tree_->root_.get(), false); }
+    while (leaf_) {  // Skip empty leaves.
+        const K* k = leaf_->n_ == m_ && o_ < 0 ? nullptr : &key();
+        int o = _overflow_below(k);
+        if (m_ > 0 && (o < 0 || leaf_->overflow_key_[o] < leaf_->key_[m_ - 1])) {
+            --m_;  // No overflow key lies in between, so `o_` stays.
+            return *this;
+        }
+        if (o >= 0) {
+            o_ = o;
+            return *this;
+        }
+        _prev_leaf();
+    }
+    return *this;
+}
+
+/*!
+ * @brief This overloaded post-decrement operator moves to the previous key.
+ * @return the original iterator.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+typename BPlusTree<K, V, Degree, OverflowSize>::ConstIterator BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::operator--(int) {
+    ConstIterator temp{*this};
+    operator--();
+    return temp;
+}
+
+/*!
+ * @brief This overloaded operator checks if two iterators point to the same entry.
+ * @param rhs is the other iterator.
+ * @return true if equal, false otherwise.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+bool BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::operator==(const ConstIterator& rhs) const {
+    return leaf_ == rhs.leaf_ && m_ == rhs.m_ && o_ == rhs.o_;
+}
+
+/*!
+ * @brief This overloaded operator checks if two iterators point to different entries.
+ * @param rhs is the other iterator.
+ * @return true if not equal, false otherwise.
+ */
+template<typename K, typename V, int Degree, int OverflowSize>
+bool BPlusTree<K, V, Degree, OverflowSize>::ConstIterator::operator!=(const ConstIterator& rhs) const {
+    return !(*this == rhs);
+}
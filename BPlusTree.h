@@ -7,10 +7,13 @@
 #include <iostream>
 #include <algorithm>
 #include <memory>
+#include <iterator>
+#include <utility>
+#include <atomic>
+#include <cstdint>
+#include "keySearch.h"
 
-inline constexpr int d{32};  // The minimum degree of the B-tree.
-
-template<typename K, typename V>
+template<typename K, typename V, int Degree = 32, int OverflowSize = Degree / 2>
 class NodeBase {
 #ifdef DEBUG
     public:
@@ -22,6 +25,7 @@ protected:
     explicit NodeBase(bool isLeaf);
     virtual ~NodeBase() = default;
     int _get_key_index(K k) const;
+    static void _own(node_ptr& slot, uint64_t epoch);
 
     virtual void _split(node_ptr p, int i) = 0;
     virtual void _merge(node_ptr p, int i, node_ptr r) = 0;
@@ -30,12 +34,13 @@ protected:
 
     bool leaf_{};
     int n_{};
-    std::array<K, 2 * d - 1> key_{};
+    std::array<K, 2 * Degree - 1> key_{};
+    uint64_t epoch_{};  // The version of the tree allowed to modify this node in place.
 };
 
-template<typename K, typename V>
-class InternalNode : public NodeBase<K, V> {
-    using node_ptr = typename NodeBase<K, V>::node_ptr;
+template<typename K, typename V, int Degree = 32, int OverflowSize = Degree / 2>
+class InternalNode : public NodeBase<K, V, Degree, OverflowSize> {
+    using node_ptr = typename NodeBase<K, V, Degree, OverflowSize>::node_ptr;
 public:
     InternalNode();
     virtual ~InternalNode() = default;
@@ -46,19 +51,19 @@ public:
     void _merge(node_ptr p, int i, node_ptr r) override;
     void _borrow_from_left(node_ptr p, int i, node_ptr l) override;
     void _borrow_from_right(node_ptr p, int i, node_ptr r) override;
-    int _get_child_index(K k, int i);
+    int _get_child_index(K k, int i) const;
 
 #ifdef DEBUG
     public:
 #else
 private:
 #endif
-    std::array<node_ptr, 2 * d> c_;
+    std::array<node_ptr, 2 * Degree> c_;
 };
 
-template<typename K, typename V>
-class LeafNode : public NodeBase<K, V>, public std::enable_shared_from_this<LeafNode<K, V>> {
-    using node_ptr = typename NodeBase<K, V>::node_ptr;
+template<typename K, typename V, int Degree = 32, int OverflowSize = Degree / 2>
+class LeafNode : public NodeBase<K, V, Degree, OverflowSize> {
+    using node_ptr = typename NodeBase<K, V, Degree, OverflowSize>::node_ptr;
 public:
     LeafNode();
     virtual ~LeafNode() = default;
@@ -72,38 +77,150 @@ public:
     void _borrow_from_right(node_ptr p, int i, node_ptr r) override;
     void _load_overflow();
     void _sort_overflow();
+    const V* _find(const K& k) const;
 
 #ifdef DEBUG
     public:
 #else
 private:
 #endif
-    std::array<V, 2 * d - 1> val_{};  // Main page.
-    node_ptr l_{};
-    node_ptr r_{};
+    std::array<V, 2 * Degree - 1> val_{};  // Main page.
     int overflow_n_{};
-    std::array<K, d / 2> overflow_key_{};
-    std::array<V, d / 2> overflow_val_{};
+    std::array<K, OverflowSize> overflow_key_{};
+    std::array<V, OverflowSize> overflow_val_{};
 };
 
-template<typename K, typename V>
+/*!
+ * @brief This class defines a B+-tree whose leaves buffer recent insertions in a small unsorted overflow block.
+ * Copies are copy-on-write: copying a tree (or taking a `snapshot()`) takes O(1) time, and the two trees share
+ * their nodes until either is modified, which copies the nodes on the modified root-to-leaf paths only. A node
+ * is freed when no version refers to it any more.
+ * @tparam K is type of key objects.
+ * @tparam V is type of value objects.
+ * @tparam Degree is the minimum degree: nodes hold between `Degree - 1` and `2 * Degree - 1` keys.
+ * @tparam OverflowSize is capacity of the overflow block of each leaf (0 disables it).
+ */
+template<typename K, typename V, int Degree = 32, int OverflowSize = Degree / 2>
 class BPlusTree {
-    using node_ptr = typename NodeBase<K, V>::node_ptr;
+    static_assert(Degree >= 2, "The minimum degree must be at least 2.");
+    static_assert(OverflowSize >= 0 && OverflowSize <= 2 * Degree - 1, "The overflow block must fit in a leaf.");
+    using node_ptr = typename NodeBase<K, V, Degree, OverflowSize>::node_ptr;
+    using leaf_type = LeafNode<K, V, Degree, OverflowSize>;
+    // Bound on the number of internal nodes on a path: below the root, internal nodes have at least `Degree`
+    // children and leaves at least `Degree - 1` keys, so a deeper tree would hold at least 2^48 keys.
+    static constexpr int kMaxDepth = [] {
+        int depth{1};
+        for (uint64_t keys = 2 * (Degree - 1); keys < (uint64_t{1} << 48); keys *= Degree) { ++depth; }
+        return depth;
+    }();
 public:
+    /*!
+     * @brief This class walks the leaves in key order, in both directions. Leaves are shared between copies of the
+     * tree, so they are not linked to their neighbors; the iterator keeps its path from the root instead. The
+     * overflow block of a leaf is unsorted, so the iterator keeps a position in the main page and the slot of the
+     * next overflow key instead of reorganizing the leaf. It is invalidated by any modification of the tree.
+     */
+    class ConstIterator {
+        friend BPlusTree;
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, const V&>;
+        using pointer = void;
+
+        ConstIterator() = default;
+        ConstIterator(const ConstIterator& iter);
+        ConstIterator& operator=(const ConstIterator& iter);
+        reference operator*() const;
+        [[nodiscard]] const K& key() const;
+        [[nodiscard]] const V& value() const;
+        ConstIterator& operator++();
+        ConstIterator operator++(int);
+        ConstIterator& operator--();
+        ConstIterator operator--(int);
+        bool operator==(const ConstIterator& rhs) const;
+        bool operator!=(const ConstIterator& rhs) const;
+
+    private:
+        /*!
+         * @brief This struct is a step of the path from the root: an internal node and the child taken.
+         */
+        struct Step {
+            const InternalNode<K, V, Degree, OverflowSize>* node;
+            int ci;
+        };
+
+        explicit ConstIterator(const BPlusTree* tree);
+        void _descend(const NodeBase<K, V, Degree, OverflowSize>* p, bool front);
+        void _next_leaf();
+        void _prev_leaf();
+        void _skip_forward();
+        [[nodiscard]] bool _on_overflow() const;
+        [[nodiscard]] int _overflow_above(const K* k, bool inclusive) const;
+        [[nodiscard]] int _overflow_below(const K* k) const;
+
+        const BPlusTree* tree_{nullptr};
+        const leaf_type* leaf_{nullptr};  // Null for the past-the-end iterator.
+        int m_{};  // Main page slot of the first key not less than the current key.
+        int o_{-1};  // Overflow slot of the smallest key not less than the current key, or -1.
+        int depth_{};
+        std::array<Step, kMaxDepth> path_;  // Only the first `depth_` steps are set (and copied).
+    };
+    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+    /*!
+     * @brief This class holds a half-open range of the tree, usable in range-based for loops.
+     */
+    class Range {
+    public:
+        Range(ConstIterator first, ConstIterator last) : first_(first), last_(last) {}
+        ConstIterator begin() const { return first_; }
+        ConstIterator end() const { return last_; }
+        ConstReverseIterator rbegin() const { return ConstReverseIterator{last_}; }
+        ConstReverseIterator rend() const { return ConstReverseIterator{first_}; }
+        [[nodiscard]] bool empty() const { return first_ == last_; }
+
+    private:
+        ConstIterator first_;
+        ConstIterator last_;
+    };
+
     BPlusTree() = default;
+    BPlusTree(const BPlusTree& tree);
+    BPlusTree& operator=(const BPlusTree& tree);
     virtual ~BPlusTree() = default;
 
+    [[nodiscard]] BPlusTree snapshot() const;
+    void bulk_load(std::vector<std::pair<K, V>> entries);
     void insert(K k, V v);
     bool remove(K k);
-    bool contains(K k);
-    std::shared_ptr<V> search(K k);
+    [[nodiscard]] bool contains(const K& k) const;
+    [[nodiscard]] const V* find(const K& k) const;
+    template<typename F> bool visit(const K& k, F&& f) const;
+    template<typename F> bool update(const K& k, F&& f);
+    template<typename F> size_t update_sorted(const K* keys, size_t n, F&& f);
+    bool upsert(K k, V v);
+    std::shared_ptr<V> search(const K& k) const;
+    ConstIterator begin() const;
+    ConstIterator end() const;
+    ConstReverseIterator rbegin() const;
+    ConstReverseIterator rend() const;
+    ConstIterator lower_bound(const K& k) const;
+    Range range(const K& lo, const K& hi) const;
 
 private:
+    const leaf_type* _find_leaf(const K& k) const;
+    leaf_type* _own_leaf(const K& k);
+    void _own(node_ptr& slot);
     void _insert(node_ptr p, K k, V v);
     void _remove(node_ptr p, K k);
-    std::shared_ptr<V> _search(node_ptr p, K k);
+    static int _key_count(const node_ptr& p);
+    template<typename F> size_t _update_sorted(node_ptr& slot, const K* keys, size_t lo, size_t hi, F& f);
 
     node_ptr root_{};
+    mutable uint64_t epoch_{};  // Nodes of other epochs may be shared with copies of the tree.
+    inline static std::atomic<uint64_t> next_epoch_{1};
 };
 
 #endif //CS225_SP22_C2_BETA_BPLUSTREE_BPLUSTREE_H_
@@ -1,13 +1,13 @@
 /*!
- * @brief This file contains the implementation of our @em Disk-IO B-Tree.
+ * @brief This file contains the implementation of our in-memory B-tree.
  */
 #include "BTree.h"
 
 /*!
  * @brief This no-arg constructor initializes some fields of the class.
  */
-template<typename K, typename V>
-BTree<K, V>::Node::Node() : leaf_(false), n_(0) {}
+template<typename K, typename V, int MinDegree>
+BTree<K, V, MinDegree>::Node::Node() : leaf_(false), n_(0) {}
 
 /*!
  * @brief This overloaded constructor further initialize the other two properties.
@@ -18,37 +18,234 @@ BTree<K, V>::Node::Node() : leaf_(false), n_(0) {}
 /*!
  * @brief The no-arg constructor of the B-tree.
  */
-template<typename K, typename V>
-BTree<K, V>::BTree() {
+template<typename K, typename V, int MinDegree>
+BTree<K, V, MinDegree>::BTree() {
     root_ = _allocate_node();
     root_->leaf_ = true;
 }
 
+/*!
+ * @brief This copy constructor shares the nodes of the given tree in O(1) time. From now on, neither tree modifies
+ * a shared node in place: both copy the nodes they modify (copy-on-write).
+ * @param tree is the tree to copy. It must not be modified concurrently.
+ */
+template<typename K, typename V, int MinDegree>
+BTree<K, V, MinDegree>::BTree(const BTree& tree) : root_(tree.root_), epoch_(next_epoch_++) {
+    tree.epoch_ = next_epoch_++;  // Every existing node now belongs to an older version.
+}
+
+/*!
+ * @brief This copy assignment operator shares the nodes of the given tree in O(1) time, like the copy constructor.
+ * @param tree is the tree to copy. It must not be modified concurrently.
+ * @return reference to this tree.
+ */
+template<typename K, typename V, int MinDegree>
+BTree<K, V, MinDegree>& BTree<K, V, MinDegree>::operator=(const BTree& tree) {
+    if (this != &tree) {
+        root_ = tree.root_;
+        epoch_ = next_epoch_++;
+        tree.epoch_ = next_epoch_++;
+    }
+    return *this;
+}
+
+/*!
+ * @brief This method takes a snapshot of the tree: a frozen copy that can be read from another thread while this
+ * tree keeps being modified. It takes O(1) time, and the nodes only the snapshot refers to are freed with the last
+ * copy of the snapshot. It must not be called concurrently with a modification of this tree.
+ * @return the snapshot.
+ */
+template<typename K, typename V, int MinDegree>
+BTree<K, V, MinDegree> BTree<K, V, MinDegree>::snapshot() const {
+    return BTree{*this};
+}
+
+/*!
+ * @brief This method replaces the contents of the tree with the given pairs, building it bottom-up in O(n) time:
+ * the pairs are dealt to the fewest leaves that hold them, one pair between each two leaves being kept as their
+ * separator, then the separators go up with each level. Every node gets an even share, so no node (but the root)
+ * is less than half full.
+ * @param entries are the pairs, sorted by key and with distinct keys.
+ */
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::bulk_load(std::vector<std::pair<K, V>> entries) {
+    root_ = _allocate_node();
+    root_->leaf_ = true;
+    if (entries.empty()) { return; }
+    std::vector<std::shared_ptr<Node>> level;
+    std::vector<std::pair<K, V>> separators;  // separators[i] lies between level[i] and level[i + 1].
+    size_t n = entries.size();
+    size_t count = (n + 2 * MinDegree) / (2 * MinDegree);  // A leaf and the separator after it take 2 * MinDegree.
+    size_t keys = n - (count - 1);
+    for (size_t j = 0, next = 0; j < count; ++j) {
+        if (j > 0) { separators.push_back(std::move(entries[next++])); }
+        auto x = _allocate_node();
+        x->leaf_ = true;
+        for (size_t end = next + keys * (j + 1) / count - keys * j / count; next < end; ++next, ++x->n_) {
+            _set_entry(x.get(), x->n_, entries[next].first, entries[next].second);
+        }
+        level.push_back(std::move(x));
+    }
+    while (level.size() > 1) {
+        std::vector<std::shared_ptr<Node>> parents;
+        std::vector<std::pair<K, V>> parent_separators;
+        size_t m = level.size();
+        count = (m + 2 * MinDegree - 1) / (2 * MinDegree);
+        for (size_t j = 0, next = 0; j < count; ++j) {
+            if (j > 0) { parent_separators.push_back(std::move(separators[next - 1])); }
+            auto x = _allocate_node();
+            x->c_[0] = std::move(level[next++]);
+            for (size_t end = m * (j + 1) / count; next < end; ++next) {
+                _set_entry(x.get(), x->n_, separators[next - 1].first, separators[next - 1].second);
+                x->c_[++x->n_] = std::move(level[next]);
+            }
+            parents.push_back(std::move(x));
+        }
+        level = std::move(parents);
+        separators = std::move(parent_separators);
+    }
+    root_ = std::move(level.front());
+}
+
+/*!
+ * @brief This method makes the node in the given slot modifiable by this tree. A node of another version may be
+ * shared with a copy of the tree, so it is copied and the slot is pointed at the copy (path copying).
+ * @param slot is the root pointer or a child pointer of a node this tree may modify.
+ */
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::_own(std::shared_ptr<Node>& slot) {
+    if (epoch_ == slot->epoch_) { return; }
+    slot = std::make_shared<Node>(*slot);
+    slot->epoch_ = epoch_;
+}
+
 /*!
  * @brief This method attempts to search for a key in the tree.
  * @param k is the key object.
- * @return a shared pointer to the value object.
+ * @return a shared pointer to a copy of the value object, or nullptr if not found.
  */
-template<typename K, typename V>
-std::shared_ptr<V> BTree<K, V>::search(K k) {
-    return _search(root_, k);
+template<typename K, typename V, int MinDegree>
+std::shared_ptr<V> BTree<K, V, MinDegree>::search(key_view k) const {
+    auto v = find(k);
+    return v ? std::make_shared<V>(*v) : nullptr;
 }
 
 /*!
- * @brief This method recursively searches for a key in the given subtree.
- * @param x is pointer to the root of the subtree.
+ * @brief This method looks up a key without copying the value.
  * @param k is the key object.
- * @return a shared pointer to the value object.
+ * @return pointer to the value object stored in the tree, or nullptr if not found.
+ * The pointer is invalidated by the next insertion or removal.
  */
-template<typename K, typename V>
-std::shared_ptr<V> BTree<K, V>::_search(std::shared_ptr<Node> x, K& k) {
-    if (nullptr == x) { return nullptr; }
-    int i = _find_key(x, k);
-    if (i < x->n_ && k == x->key_[i]) {
-        return std::make_shared<V>(x->val_[i]);
+template<typename K, typename V, int MinDegree>
+const V* BTree<K, V, MinDegree>::find(key_view k) const {
+    const Node* x = root_.get();
+    while (nullptr != x) {
+        int i = _find_key(x, k);
+        if (i < x->n_ && k == x->key_[i]) {
+            return &x->val_[i];
+        }
+        if (x->leaf_) { return nullptr; }
+        x = x->c_[i].get();
     }
-    if (x->leaf_) { return nullptr; }
-    return _search(x->c_[i], k);
+    return nullptr;
+}
+
+/*!
+ * @brief This method calls `f` on the value of the given key, if present, without copying it.
+ * @tparam F is type of the callable, invoked as `f(const V&)`.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+bool BTree<K, V, MinDegree>::visit(key_view k, F&& f) const {
+    auto v = find(k);
+    if (nullptr == v) { return false; }
+    std::forward<F>(f)(*v);
+    return true;
+}
+
+/*!
+ * @brief This method modifies the value of the given key in place. The tree is not restructured.
+ * @tparam F is type of the callable, invoked as `f(V&)`. It must not change anything the key depends on.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+bool BTree<K, V, MinDegree>::update(key_view k, F&& f) {
+    if (!contains(k)) { return false; }
+    _own(root_);
+    Node* x = root_.get();
+    while (true) {  // Copy the shared nodes on the way down.
+        int i = _find_key(x, k);
+        if (i < x->n_ && k == x->key_[i]) {
+            std::forward<F>(f)(x->val_[i]);
+            return true;
+        }
+        _own(x->c_[i]);
+        x = x->c_[i].get();
+    }
+}
+
+/*!
+ * @brief This method modifies the values of many keys in place in one pass: the keys are split between the
+ * children of each node, so every node on the way is visited (and copied, if shared) once, however many of the
+ * keys are below it. The tree is not restructured.
+ * @tparam F is type of the callable, invoked as `f(i, V&)` with the index of the key in `keys`.
+ * @param keys are the keys, in ascending order. Duplicates are allowed and visited in order.
+ * @param n is number of keys.
+ * @param f is the callable.
+ * @return the number of keys found (and `f` calls).
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+size_t BTree<K, V, MinDegree>::update_sorted(const K* keys, size_t n, F&& f) {
+    if (nullptr == root_ || 0 == n) { return 0; }
+    return _update_sorted(root_, keys, 0, n, f);
+}
+
+/*!
+ * @brief This method recursively modifies the values of the keys `keys[lo, hi)`, which all belong to the given
+ * subtree.
+ * @param slot is the pointer to the root of the subtree.
+ * @param keys are the keys, in ascending order.
+ * @param lo is index of the first key.
+ * @param hi is index past the last key.
+ * @param f is the callable.
+ * @return the number of keys found.
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+size_t BTree<K, V, MinDegree>::_update_sorted(std::shared_ptr<Node>& slot, const K* keys, size_t lo, size_t hi,
+                                              F& f) {
+    _own(slot);
+    Node* x = slot.get();
+    size_t found{};
+    for (int i = 0; i <= x->n_ && lo < hi; ++i) {  // Child i holds the keys between key_[i - 1] and key_[i].
+        size_t mid = i < x->n_ ? std::lower_bound(keys + lo, keys + hi, x->key_[i]) - keys : hi;
+        if (lo < mid && !x->leaf_) { found += _update_sorted(x->c_[i], keys, lo, mid, f); }
+        for (lo = mid; lo < hi && i < x->n_ && !(x->key_[i] < keys[lo]); ++lo) {  // Equal to key_[i].
+            f(lo, x->val_[i]);
+            ++found;
+        }
+    }
+    return found;
+}
+
+/*!
+ * @brief This method overwrites the value of the given key in place, or inserts the pair if the key is absent.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if a new pair was inserted, false if an existing value was overwritten.
+ */
+template<typename K, typename V, int MinDegree>
+bool BTree<K, V, MinDegree>::upsert(K k, V v) {
+    if (update(k, [&v](V& slot) { slot = std::move(v); })) { return false; }
+    insert(std::move(k), std::move(v));
+    return true;
 }
 
 /*!
@@ -56,19 +253,20 @@ std::shared_ptr<V> BTree<K, V>::_search(std::shared_ptr<Node> x, K& k) {
  * @param k is the key object.
  * @param v is the value object.
  */
-template<typename K, typename V>
-void BTree<K, V>::insert(K k, V v) {
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::insert(K k, V v) {
     if (nullptr == root_) {
         root_ = _allocate_node();
         root_->leaf_ = true;
     }
-    if (root_->n_ == 2 * t - 1) {
+    if (root_->n_ == 2 * MinDegree - 1) {
         auto s = _allocate_node();  // New root.
         s->c_[0] = root_;
         s->leaf_ = false;
         _split_child(s, 0);
         root_ = s;
     }
+    _own(root_);
     _insert_non_full(root_, k, v);
 }
 
@@ -77,31 +275,29 @@ void BTree<K, V>::insert(K k, V v) {
  * @param x is pointer to the given node.
  * @param i is index of the child in the child list of the current node.
  */
-template<typename K, typename V>
-void BTree<K, V>::_split_child(std::shared_ptr<Node> x, int i) {
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::_split_child(std::shared_ptr<Node> x, int i) {
+    _own(x->c_[i]);
     auto y = x->c_[i];
     auto z = _allocate_node();
     z->leaf_ = y->leaf_;
-    for (int j = 0; j < t - 1; ++j) {
-        z->key_[j] = y->key_[j + t];
-        z->val_[j] = y->val_[j + t];
+    for (int j = 0; j < MinDegree - 1; ++j) {
+        _copy_entry(z.get(), j, y.get(), j + MinDegree);
     }
     if (!y->leaf_) {
-        for (int j = 0; j < t; ++j) {
-            z->c_[j] = y->c_[j + t];
+        for (int j = 0; j < MinDegree; ++j) {
+            z->c_[j] = y->c_[j + MinDegree];
         }
     }
-    y->n_ = z->n_ = t - 1;
+    y->n_ = z->n_ = MinDegree - 1;
     for (int j = x->n_; j >= i + 1; --j) {
         x->c_[j + 1] = x->c_[j];
     }
     x->c_[i + 1] = z;
     for (int j = x->n_ - 1; j >= i; --j) {
-        x->key_[j + 1] = x->key_[j];
-        x->val_[j + 1] = x->val_[j];
+        _copy_entry(x.get(), j + 1, x.get(), j);
     }
-    x->key_[i] = y->key_[t - 1];
-    x->val_[i] = y->val_[t - 1];
+    _copy_entry(x.get(), i, y.get(), MinDegree - 1);
     ++x->n_;
 }
 
@@ -111,17 +307,15 @@ void BTree<K, V>::_split_child(std::shared_ptr<Node> x, int i) {
  * @param k is reference to the key object.
  * @param v is reference to the value object.
  */
-template<typename K, typename V>
-void BTree<K, V>::_insert_non_full(std::shared_ptr<Node> x, K& k, V& v) {
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::_insert_non_full(std::shared_ptr<Node> x, K& k, V& v) {
     int i = x->n_ - 1;
     if (x->leaf_) {
         while (i >= 0 && k < x->key_[i]) {
-            x->key_[i + 1] = x->key_[i];
-            x->val_[i + 1] = x->val_[i];
+            _copy_entry(x.get(), i + 1, x.get(), i);
             --i;
         }
-        x->key_[i + 1] = k;
-        x->val_[i + 1] = v;
+        _set_entry(x.get(), i + 1, k, v);
         ++x->n_;
         return;
     }
@@ -129,8 +323,9 @@ void BTree<K, V>::_insert_non_full(std::shared_ptr<Node> x, K& k, V& v) {
         --i;
     }
     i++;
+    _own(x->c_[i]);
     auto child = x->c_[i];
-    if (child->n_ == 2 * t - 1) {
+    if (child->n_ == 2 * MinDegree - 1) {
         _split_child(x, i);
         if (k > x->key_[i]) {
             ++i;
@@ -144,19 +339,21 @@ void BTree<K, V>::_insert_non_full(std::shared_ptr<Node> x, K& k, V& v) {
  * @brief This method allocates a new node.
  * @return a shared pointer to the node.
  */
-template<typename K, typename V>
-std::shared_ptr<typename BTree<K, V>::Node> BTree<K, V>::_allocate_node() {
-    return std::make_shared<Node>();
+template<typename K, typename V, int MinDegree>
+std::shared_ptr<typename BTree<K, V, MinDegree>::Node> BTree<K, V, MinDegree>::_allocate_node() {
+    auto x = std::make_shared<Node>();
+    x->epoch_ = epoch_;
+    return x;
 }
 
 /*!
- * @brief This method checks to see if the given key exists in the current tree.
+ * @brief This method checks to see if the given key exists in the current tree. The value is never copied.
  * @param k is the key object.
  * @return true if exists, false otherwise.
  */
-template<typename K, typename V>
-bool BTree<K, V>::contains(K k) {
-    return nullptr != search(k);
+template<typename K, typename V, int MinDegree>
+bool BTree<K, V, MinDegree>::contains(key_view k) const {
+    return nullptr != find(k);
 }
 
 /*!
@@ -164,8 +361,9 @@ bool BTree<K, V>::contains(K k) {
  * @param k is the key object to be removed.
  * @return true if successfully removed, false otherwise.
  */
-template<typename K, typename V>
-bool BTree<K, V>::remove(K k) {
+template<typename K, typename V, int MinDegree>
+bool BTree<K, V, MinDegree>::remove(key_view k) {
+    if (!contains(k)) { return false; }  // Nothing to restructure or copy.
     return _remove_node(root_, k);
 }
 
@@ -175,8 +373,8 @@ bool BTree<K, V>::remove(K k) {
  * @param i is the index of the target node.
  * @return a key-value pair of the desired node.
  */
-template<typename K, typename V>
-std::pair<K, V> BTree<K, V>::_get_pred(std::shared_ptr<Node> p, int i) {
+template<typename K, typename V, int MinDegree>
+std::pair<K, V> BTree<K, V, MinDegree>::_get_pred(std::shared_ptr<Node> p, int i) {
     auto curr = p->c_[i];
     while (!curr->leaf_) {  // Now keep moving to the right most child.
         curr = curr->c_[curr->n_];
@@ -190,8 +388,8 @@ std::pair<K, V> BTree<K, V>::_get_pred(std::shared_ptr<Node> p, int i) {
  * @param i is the index of the target node.
  * @return a key-value pair of the desired node.
  */
-template<typename K, typename V>
-std::pair<K, V> BTree<K, V>::_get_succ(std::shared_ptr<Node> x, int i) {
+template<typename K, typename V, int MinDegree>
+std::pair<K, V> BTree<K, V, MinDegree>::_get_succ(std::shared_ptr<Node> x, int i) {
     auto curr = x->c_[i + 1];
     while (!curr->leaf_) {
         curr = curr->c_[0];
@@ -204,26 +402,25 @@ std::pair<K, V> BTree<K, V>::_get_succ(std::shared_ptr<Node> x, int i) {
  * @param p is pointer to the parent node.
  * @param i is index of the current node in the parent's child list.
  */
-template<typename K, typename V>
-void BTree<K, V>::_borrow_from_prev(std::shared_ptr<Node> p, int i) {
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::_borrow_from_prev(std::shared_ptr<Node> p, int i) {
+    _own(p->c_[i]);
+    _own(p->c_[i - 1]);
     auto c = p->c_[i];
     auto l = p->c_[i - 1];
     for (int j = c->n_; j > 0; --j) {  // Move all keys in c to the left by 1.
-        c->key_[j] = c->key_[j - 1];
-        c->val_[j] = c->val_[j - 1];
+        _copy_entry(c.get(), j, c.get(), j - 1);
     }
     if (!c->leaf_) {
         for (int j = c->n_ + 1; j > 0; --j) {
             c->c_[j] = c->c_[j - 1];
         }
     }
-    c->key_[0] = p->key_[i - 1];
-    c->val_[0] = p->val_[i - 1];
+    _copy_entry(c.get(), 0, p.get(), i - 1);
     if (!c->leaf_) {
         c->c_[0] = l->c_[l->n_];
     }
-    p->key_[i - 1] = l->key_[l->n_ - 1];
-    p->val_[i - 1] = l->val_[l->n_ - 1];
+    _copy_entry(p.get(), i - 1, l.get(), l->n_ - 1);
     c->n_++;
     l->n_--;
 }
@@ -233,21 +430,20 @@ void BTree<K, V>::_borrow_from_prev(std::shared_ptr<Node> p, int i) {
  * @param p is pointer to the parent node.
  * @param i is index of the current node in the parent's child list.
  */
-template<typename K, typename V>
-void BTree<K, V>::_borrow_from_next(std::shared_ptr<Node> x, int i) {
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::_borrow_from_next(std::shared_ptr<Node> x, int i) {
+    _own(x->c_[i]);
+    _own(x->c_[i + 1]);
     auto c = x->c_[i];
     auto r = x->c_[i + 1];
 
-    c->val_[c->n_] = x->val_[i];  // Insert the keys[i] into c.
-    c->key_[c->n_] = x->key_[i];
-    x->val_[i] = r->val_[0];  // Promote the first key of the sibling.
-    x->key_[i] = r->key_[0];
+    _copy_entry(c.get(), c->n_, x.get(), i);  // Insert the keys[i] into c.
+    _copy_entry(x.get(), i, r.get(), 0);  // Promote the first key of the sibling.
     if (!c->leaf_) {
         c->c_[c->n_ + 1] = r->c_[0];  // Make the first child of sibling the last child of c.
     }
     for (int j = 0; j < r->n_ - 1; ++j) {  // Move all keys in the sibling to the left by 1.
-        r->key_[j] = r->key_[j + 1];
-        r->val_[j] = r->val_[j + 1];
+        _copy_entry(r.get(), j, r.get(), j + 1);
     }
     if (!r->leaf_) {  // Move the child pointers to the left by one.
         for (int j = 0; j < r->n_; ++j) {
@@ -264,16 +460,16 @@ void BTree<K, V>::_borrow_from_next(std::shared_ptr<Node> x, int i) {
  * @param p is pointer to the parent node.
  * @param i is index of the current node in the parent's child list.
  */
-template<typename K, typename V>
-void BTree<K, V>::_merge(std::shared_ptr<Node> p, int i) {
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::_merge(std::shared_ptr<Node> p, int i) {
+    _own(p->c_[i]);
+    _own(p->c_[i + 1]);
     auto l = p->c_[i];
     auto r = p->c_[i + 1];
-    l->val_[l->n_] = p->val_[i];  // Demote a key from x.
-    l->key_[l->n_] = p->key_[i];
+    _copy_entry(l.get(), l->n_, p.get(), i);  // Demote a key from x.
     l->n_++;
     for (int j = 0; j < r->n_; ++j) {  // Copy keys from s to c.
-        l->key_[j + l->n_] = r->key_[j];
-        l->val_[j + l->n_] = r->val_[j];
+        _copy_entry(l.get(), j + l->n_, r.get(), j);
     }
     if (!l->leaf_) {  // Copy child pointers from s to c.
         for (int j = 0; j <= r->n_; ++j) {
@@ -283,8 +479,7 @@ void BTree<K, V>::_merge(std::shared_ptr<Node> p, int i) {
     l->n_ += r->n_;
     r->n_ = 0;
     for (int j = i; j < p->n_ - 1; ++j) {  // Move keys in x to the left by 1.
-        p->key_[j] = p->key_[j + 1];
-        p->val_[j] = p->val_[j + 1];
+        _copy_entry(p.get(), j, p.get(), j + 1);
     }
     if (!p->leaf_) {
         for (int j = i + 1; j < p->n_; ++j) {  // Move child pointers in x to the left by 1.
@@ -300,13 +495,13 @@ void BTree<K, V>::_merge(std::shared_ptr<Node> p, int i) {
  * @param p is pointer to the parent node.
  * @param i is index of the current node in the parent's child list.
  */
-template<typename K, typename V>
-void BTree<K, V>::_fill(std::shared_ptr<Node> p, int i) {
-    if (i > 0 && p->c_[i - 1]->n_ > t - 1) {
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::_fill(std::shared_ptr<Node> p, int i) {
+    if (i > 0 && p->c_[i - 1]->n_ > MinDegree - 1) {
         _borrow_from_prev(p, i);
         return;
     }
-    if (i < p->n_ && p->c_[i + 1]->n_ > t - 1) {
+    if (i < p->n_ && p->c_[i + 1]->n_ > MinDegree - 1) {
         _borrow_from_next(p, i);
         return;
     }
@@ -323,20 +518,22 @@ void BTree<K, V>::_fill(std::shared_ptr<Node> p, int i) {
  * @param k is the key object.
  * @return true if succeeded, false otherwise.
  */
-template<typename K, typename V>
-bool BTree<K, V>::_remove_node(std::shared_ptr<Node>& r, K k) {
+template<typename K, typename V, int MinDegree>
+bool BTree<K, V, MinDegree>::_remove_node(std::shared_ptr<Node>& r, key_view k) {
     if (0 == r->n_) {
+        if (r->leaf_) { return false; }  // The tree is empty.
         r = r->c_[0];
     }
-    int i = _find_key(r, k);
-    if (i < r->n_ && r->key_[i] == k) {  // The key k exists in node x.
+    _own(r);
+    int i = _find_key(r.get(), k);
+    if (i < r->n_ && k == r->key_[i]) {  // The key k exists in node x.
         return r->leaf_ ? _remove_from_leaf(r, i) : _remove_from_non_leaf(r, i);
     }
     if (r->leaf_) {
         return false;
     }
     bool temp = i == r->n_;  // Save current child status.
-    if (r->c_[i]->n_ < t) {
+    if (r->c_[i]->n_ < MinDegree) {
         _fill(r, i);
     }
     if (temp && i > r->n_) {  // Merge happened!
@@ -346,18 +543,47 @@ bool BTree<K, V>::_remove_node(std::shared_ptr<Node>& r, K k) {
 }
 
 /*!
- * @brief This finds the appropriate index according to the given key.
+ * @brief This finds the appropriate index according to the given key: the first key of the node not less than it.
+ * String keys are compared by their cached prefixes first.
  * @param x is the target node.
- * @param k is reference to the key object.
+ * @param k is the key object.
  * @return the appropriate index.
  */
-template<typename K, typename V>
-int BTree<K, V>::_find_key(std::shared_ptr<Node> x, K& k) {
-    int i = 0;
-    while (i < x->n_ && x->key_[i] < k) {
-        ++i;
+template<typename K, typename V, int MinDegree>
+int BTree<K, V, MinDegree>::_find_key(const Node* x, key_view k) {
+    if constexpr (kPrefixKeys) {
+        return keyLowerBound(x->key_.data(), x->prefix_.data(), x->n_, k);
+    } else {
+        return keyLowerBound(x->key_.data(), x->n_, k);
     }
-    return i;
+}
+
+/*!
+ * @brief This method copies a key-value pair, with the cached prefix of the key, from one slot to another.
+ * @param dst is the node to copy to.
+ * @param j is index of the slot to copy to.
+ * @param src is the node to copy from (may be `dst`).
+ * @param i is index of the slot to copy from.
+ */
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::_copy_entry(Node* dst, int j, const Node* src, int i) {
+    dst->key_[j] = src->key_[i];
+    dst->val_[j] = src->val_[i];
+    if constexpr (kPrefixKeys) { dst->prefix_[j] = src->prefix_[i]; }
+}
+
+/*!
+ * @brief This method stores a key-value pair in a slot and caches the prefix of the key.
+ * @param x is the node.
+ * @param i is index of the slot.
+ * @param k is the key object.
+ * @param v is the value object.
+ */
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::_set_entry(Node* x, int i, const K& k, const V& v) {
+    x->key_[i] = k;
+    x->val_[i] = v;
+    if constexpr (kPrefixKeys) { x->prefix_[i] = keyPrefix(k); }
 }
 
 /*!
@@ -366,11 +592,10 @@ int BTree<K, V>::_find_key(std::shared_ptr<Node> x, K& k) {
  * @param i is index of the key.
  * @return true if succeeded, false otherwise.
  */
-template<typename K, typename V>
-bool BTree<K, V>::_remove_from_leaf(std::shared_ptr<Node> x, int i) {
+template<typename K, typename V, int MinDegree>
+bool BTree<K, V, MinDegree>::_remove_from_leaf(std::shared_ptr<Node> x, int i) {
     for (int j = i; j < x->n_ - 1; ++j) {
-        x->key_[j] = x->key_[j + 1];  // Overwrite the key.
-        x->val_[j] = x->val_[j + 1];  // Overwrite the key.
+        _copy_entry(x.get(), j, x.get(), j + 1);  // Overwrite the key.
     }
     x->n_--;
     return true;
@@ -382,22 +607,20 @@ bool BTree<K, V>::_remove_from_leaf(std::shared_ptr<Node> x, int i) {
  * @param i is index of the key.
  * @return true if succeeded, false otherwise.
  */
-template<typename K, typename V>
-bool BTree<K, V>::_remove_from_non_leaf(std::shared_ptr<Node>& x, int i) {
+template<typename K, typename V, int MinDegree>
+bool BTree<K, V, MinDegree>::_remove_from_non_leaf(std::shared_ptr<Node>& x, int i) {
     K k = x->key_[i];
     auto l = x->c_[i];
     auto r = x->c_[i + 1];
-    if (l->n_ > t - 1) {
+    if (l->n_ > MinDegree - 1) {
         auto p = _get_pred(x, i);
-        x->key_[i] = p.first;
-        x->val_[i] = p.second;
-        return _remove_node(l, p.first);
+        _set_entry(x.get(), i, p.first, p.second);
+        return _remove_node(x->c_[i], p.first);  // The slot itself, so that a copy of `l` replaces it.
     }
-    if (r->n_ > t - 1) {
+    if (r->n_ > MinDegree - 1) {
         auto s = _get_succ(x, i);
-        x->key_[i] = s.first;
-        x->val_[i] = s.second;
-        return _remove_node(r, s.first);
+        _set_entry(x.get(), i, s.first, s.second);
+        return _remove_node(x->c_[i + 1], s.first);
     }
     _merge(x, i);
     if (0 == x->n_) {
@@ -405,3 +628,195 @@ bool BTree<K, V>::_remove_from_non_leaf(std::shared_ptr<Node>& x, int i) {
     }
     return _remove_node(x, k);
 }
+
+/*!
+ * @brief This method returns an iterator to the smallest key.
+ * @return an iterator.
+ */
+template<typename K, typename V, int MinDegree>
+typename BTree<K, V, MinDegree>::ConstIterator BTree<K, V, MinDegree>::begin() const {
+    ConstIterator iter;
+    iter._descend(root_.get());
+    iter._settle();
+    return iter;
+}
+
+/*!
+ * @brief This method returns the past-the-end iterator.
+ * @return an iterator.
+ */
+template<typename K, typename V, int MinDegree>
+typename BTree<K, V, MinDegree>::ConstIterator BTree<K, V, MinDegree>::end() const {
+    return ConstIterator{};
+}
+
+/*!
+ * @brief This method returns an iterator to the first key not less than `k`.
+ * @param k is the key object.
+ * @return an iterator (past-the-end if every key is less than `k`).
+ */
+template<typename K, typename V, int MinDegree>
+typename BTree<K, V, MinDegree>::ConstIterator BTree<K, V, MinDegree>::lower_bound(key_view k) const {
+    ConstIterator iter;
+    const Node* x = root_.get();
+    while (nullptr != x) {
+        int i = _find_key(x, k);
+        iter.path_.emplace_back(x, i);  // Key i follows every key of child i.
+        if ((i < x->n_ && k == x->key_[i]) || x->leaf_) { break; }
+        x = x->c_[i].get();
+    }
+    iter._settle();
+    return iter;
+}
+
+/*!
+ * @brief This method returns the half-open range of keys in `[lo, hi)`.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the exclusive upper bound.
+ * @return the range (empty if `hi` is not greater than `lo`).
+ */
+template<typename K, typename V, int MinDegree>
+typename BTree<K, V, MinDegree>::Range BTree<K, V, MinDegree>::range(key_view lo, key_view hi) const {
+    if (!(lo < hi)) { return Range{end(), end()}; }
+    return Range{lower_bound(lo), lower_bound(hi)};
+}
+
+/*!
+ * @brief This method calls `f` on the keys in `[lo, hi)` and their values in key order, and stops early after
+ * `limit` of them. It takes O(log n + limit) time.
+ * @tparam F is type of the callable, invoked as `f(const K&, const V&)`.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the exclusive upper bound.
+ * @param limit is the maximum number of keys to visit.
+ * @param f is the callable.
+ * @return the number of keys visited.
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+size_t BTree<K, V, MinDegree>::range(key_view lo, key_view hi, size_t limit, F&& f) const {
+    size_t count{};
+    auto r = range(lo, hi);
+    for (auto iter = r.begin(); count < limit && iter != r.end(); ++iter, ++count) {
+        f(iter.key(), iter.value());
+    }
+    return count;
+}
+
+/*!
+ * @brief This method calls `f` on the keys that start with `prefix` and their values in key order, and stops early
+ * after `limit` of them. Such keys are contiguous from the first key not less than `prefix`, so it takes
+ * O(log n + limit) time. `K` must be `std::string`.
+ * @tparam F is type of the callable, invoked as `f(const K&, const V&)`.
+ * @param prefix is the prefix, which may be empty.
+ * @param limit is the maximum number of keys to visit.
+ * @param f is the callable.
+ * @return the number of keys visited.
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+size_t BTree<K, V, MinDegree>::prefix_scan(std::string_view prefix, size_t limit, F&& f) const {
+    size_t count{};
+    for (auto iter = lower_bound(prefix); count < limit && iter != end(); ++iter, ++count) {
+        if (0 != iter.key().compare(0, prefix.size(), prefix)) { break; }
+        f(iter.key(), iter.value());
+    }
+    return count;
+}
+
+/*!
+ * @brief This method descends along the leftmost path of a subtree, down to its smallest key.
+ * @param x is pointer to the root of the subtree.
+ */
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::ConstIterator::_descend(const Node* x) {
+    while (true) {
+        path_.emplace_back(x, 0);
+        if (x->leaf_) { return; }
+        x = x->c_[0].get();
+    }
+}
+
+/*!
+ * @brief This method pops the nodes whose keys have all been visited, so that the path ends at the next key.
+ */
+template<typename K, typename V, int MinDegree>
+void BTree<K, V, MinDegree>::ConstIterator::_settle() {
+    while (!path_.empty() && path_.back().second == path_.back().first->n_) {
+        path_.pop_back();
+    }
+}
+
+/*!
+ * @brief This overloaded dereference operator returns the current key-value pair.
+ * @return a pair of references into the tree.
+ */
+template<typename K, typename V, int MinDegree>
+typename BTree<K, V, MinDegree>::ConstIterator::reference BTree<K, V, MinDegree>::ConstIterator::operator*() const {
+    return reference{key(), value()};
+}
+
+/*!
+ * @brief This method returns the current key.
+ * @return reference to the key.
+ */
+template<typename K, typename V, int MinDegree>
+const K& BTree<K, V, MinDegree>::ConstIterator::key() const {
+    return path_.back().first->key_[path_.back().second];
+}
+
+/*!
+ * @brief This method returns the current value.
+ * @return reference to the value.
+ */
+template<typename K, typename V, int MinDegree>
+const V& BTree<K, V, MinDegree>::ConstIterator::value() const {
+    return path_.back().first->val_[path_.back().second];
+}
+
+/*!
+ * @brief This overloaded pre-increment operator moves to the next key: the smallest key of the next subtree,
+ * or the next key of an ancestor.
+ * @return reference to the incremented iterator.
+ */
+template<typename K, typename V, int MinDegree>
+typename BTree<K, V, MinDegree>::ConstIterator& BTree<K, V, MinDegree>::ConstIterator::operator++() {
+    const Node* x = path_.back().first;
+    int i = ++path_.back().second;
+    if (!x->leaf_) {
+        _descend(x->c_[i].get());
+    }
+    _settle();
+    return *this;
+}
+
+/*!
+ * @brief This overloaded post-increment operator moves to the next key.
+ * @return the original iterator.
+ */
+template<typename K, typename V, int MinDegree>
+typename BTree<K, V, MinDegree>::ConstIterator BTree<K, V, MinDegree>::ConstIterator::operator++(int) {
+    ConstIterator temp{*this};
+    operator++();
+    return temp;
+}
+
+/*!
+ * @brief This overloaded operator checks if two iterators point to the same entry.
+ * @param rhs is the other iterator.
+ * @return true if equal, false otherwise.
+ */
+template<typename K, typename V, int MinDegree>
+bool BTree<K, V, MinDegree>::ConstIterator::operator==(const ConstIterator& rhs) const {
+    if (path_.empty() || rhs.path_.empty()) { return path_.empty() == rhs.path_.empty(); }
+    return path_.back() == rhs.path_.back();
+}
+
+/*!
+ * @brief This overloaded operator checks if two iterators point to different entries.
+ * @param rhs is the other iterator.
+ * @return true if not equal, false otherwise.
+ */
+template<typename K, typename V, int MinDegree>
+bool BTree<K, V, MinDegree>::ConstIterator::operator!=(const ConstIterator& rhs) const {
+    return !(*this == rhs);
+}
@@ -1,5 +1,5 @@
 /*!
- * @brief This file contains the class definition of our @em Disk-IO B-tree.
+ * @brief This file contains the class definition of our in-memory B-tree.
  */
 #ifndef CS225_SP22_C2_BETA_B_TREE_BTREE_H_
 #define CS225_SP22_C2_BETA_B_TREE_BTREE_H_
@@ -10,16 +10,30 @@
 #include <array>
 #include <utility>
 #include <memory>
-
-inline constexpr int t{16};  // The minimum degree of the B-tree.
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include "keySearch.h"
 
 /*!
- * @brief This class defines a B-tree data structure, which uses the secondary storage! Magic?
+ * @brief This class defines a B-tree data structure kept entirely in memory. See <em>PagedBTree</em> for a B-tree
+ * whose nodes live in a page file. As in <em>BPlusTree</em>, copies (and snapshots) are copy-on-write: they take
+ * O(1) time and share every node that neither version has modified since.
+ * With `std::string` keys, every node caches the first 8 bytes of its keys as big-endian integers, so that a search
+ * compares integers and reads a key only on a tie, and lookups take `std::string_view` so that they never allocate.
  * @tparam K is type of key objects.
  * @tparam V is type of value objects.
+ * @tparam MinDegree is the minimum degree: nodes hold between `MinDegree - 1` and `2 * MinDegree - 1` keys.
  */
-template<typename K, typename V>
+template<typename K, typename V, int MinDegree = 16>
 class BTree {
+    static_assert(MinDegree >= 2, "The minimum degree must be at least 2.");
+    static constexpr bool kPrefixKeys{std::is_same_v<K, std::string>};
+public:
+    using key_view = std::conditional_t<kPrefixKeys, std::string_view, const K&>;  // Key parameter of lookups.
 #ifndef DEBUG
 private:
 #else
@@ -35,20 +49,81 @@ private:
 #endif
         Node();
         virtual ~Node() = default;
-        std::array<K, (size_t) 2 * t - 1> key_{};
+        std::array<K, (size_t) 2 * MinDegree - 1> key_{};
+        std::array<uint64_t, kPrefixKeys ? (size_t) 2 * MinDegree - 1 : 0> prefix_{};  // keyPrefix() of each key.
         bool leaf_;
         int n_;  // Current amount of keys.
-        std::array<V, (size_t) 2 * t - 1> val_{};
-        std::array<std::shared_ptr<Node>, (size_t) 2 * t> c_{};  // Positions of child nodes in second storage.
+        std::array<V, (size_t) 2 * MinDegree - 1> val_{};
+        std::array<std::shared_ptr<Node>, (size_t) 2 * MinDegree> c_{};  // Child nodes.
+        uint64_t epoch_{};  // The version of the tree allowed to modify this node in place.
     };
 
 public:
+    /*!
+     * @brief This class walks the tree in key order. It keeps the path from the root to the current key, so it
+     * does not need links between nodes. It is invalidated by any modification of the tree.
+     */
+    class ConstIterator {
+        friend BTree;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, const V&>;
+        using pointer = void;
+
+        ConstIterator() = default;
+        reference operator*() const;
+        [[nodiscard]] const K& key() const;
+        [[nodiscard]] const V& value() const;
+        ConstIterator& operator++();
+        ConstIterator operator++(int);
+        bool operator==(const ConstIterator& rhs) const;
+        bool operator!=(const ConstIterator& rhs) const;
+
+    private:
+        void _descend(const Node* x);
+        void _settle();
+
+        std::vector<std::pair<const Node*, int>> path_{};  // Nodes and key indices; empty at the end.
+    };
+
+    /*!
+     * @brief This class holds a half-open range of the tree, usable in range-based for loops.
+     */
+    class Range {
+    public:
+        Range(ConstIterator first, ConstIterator last) : first_(std::move(first)), last_(std::move(last)) {}
+        ConstIterator begin() const { return first_; }
+        ConstIterator end() const { return last_; }
+        [[nodiscard]] bool empty() const { return first_ == last_; }
+
+    private:
+        ConstIterator first_;
+        ConstIterator last_;
+    };
+
     BTree();
+    BTree(const BTree& tree);
+    BTree& operator=(const BTree& tree);
     virtual ~BTree() = default;
-    std::shared_ptr<V> search(K k);
+    [[nodiscard]] BTree snapshot() const;
+    void bulk_load(std::vector<std::pair<K, V>> entries);
+    std::shared_ptr<V> search(key_view k) const;
+    [[nodiscard]] const V* find(key_view k) const;
+    template<typename F> bool visit(key_view k, F&& f) const;
+    template<typename F> bool update(key_view k, F&& f);
+    template<typename F> size_t update_sorted(const K* keys, size_t n, F&& f);
+    bool upsert(K k, V v);
     void insert(K k, V v);
-    bool remove(K k);
-    bool contains(K k);
+    bool remove(key_view k);
+    [[nodiscard]] bool contains(key_view k) const;
+    ConstIterator begin() const;
+    ConstIterator end() const;
+    ConstIterator lower_bound(key_view k) const;
+    Range range(key_view lo, key_view hi) const;
+    template<typename F> size_t range(key_view lo, key_view hi, size_t limit, F&& f) const;
+    template<typename F> size_t prefix_scan(std::string_view prefix, size_t limit, F&& f) const;
 
 #ifndef DEBUG
 private:
@@ -56,8 +131,10 @@ private:
     public:
 #endif
     std::shared_ptr<Node> root_;
+    mutable uint64_t epoch_{};  // Nodes of other epochs may be shared with copies of the tree.
+    inline static std::atomic<uint64_t> next_epoch_{1};
 
-    std::shared_ptr<V> _search(std::shared_ptr<Node> x, K& k);
+    void _own(std::shared_ptr<Node>& slot);
     void _split_child(std::shared_ptr<Node> x, int i);
     void _insert_non_full(std::shared_ptr<Node> x, K& k, V& v);
     std::pair<K, V> _get_pred(std::shared_ptr<Node> p, int i);
@@ -66,10 +143,13 @@ private:
     void _borrow_from_next(std::shared_ptr<Node> x, int i);
     void _merge(std::shared_ptr<Node> p, int i);
     void _fill(std::shared_ptr<Node> p, int i);
-    int _find_key(std::shared_ptr<Node> x, K& k);
+    static int _find_key(const Node* x, key_view k);
+    static void _copy_entry(Node* dst, int j, const Node* src, int i);
+    static void _set_entry(Node* x, int i, const K& k, const V& v);
     bool _remove_from_leaf(std::shared_ptr<Node> x, int i);
     bool _remove_from_non_leaf(std::shared_ptr<Node>& x, int i);
-    bool _remove_node(std::shared_ptr<Node>& r, K k);
+    bool _remove_node(std::shared_ptr<Node>& r, key_view k);
+    template<typename F> size_t _update_sorted(std::shared_ptr<Node>& slot, const K* keys, size_t lo, size_t hi, F& f);
     std::shared_ptr<Node> _allocate_node();
 };
 
@@ -0,0 +1,472 @@
+/*!
+ * @brief This file contains the implementation of class methods of <em>ConcurrentBPlusTree</em>.
+ */
+#include "ConcurrentBPlusTree.h"
+
+/*!
+ * @brief Default constructor. The root is an empty leaf, so it is never null.
+ */
+template<typename K, typename V, int Degree>
+ConcurrentBPlusTree<K, V, Degree>::ConcurrentBPlusTree() : root_{new Leaf()} {}
+
+/*!
+ * @brief Destructor. Must not run concurrently with any other method.
+ */
+template<typename K, typename V, int Degree>
+ConcurrentBPlusTree<K, V, Degree>::~ConcurrentBPlusTree() {
+    _destroy(root_.load());
+}
+
+/*!
+ * @brief This method inserts a key-value pair. An existing value of the key is overwritten.
+ * @param k is the key object.
+ * @param v is the value object.
+ */
+template<typename K, typename V, int Degree>
+void ConcurrentBPlusTree<K, V, Degree>::insert(K k, V v) {
+    upsert(std::move(k), std::move(v));
+}
+
+/*!
+ * @brief This method inserts a key-value pair, or overwrites the value if the key is present.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if the key was inserted, false if it was overwritten.
+ */
+template<typename K, typename V, int Degree>
+bool ConcurrentBPlusTree<K, V, Degree>::upsert(K k, V v) {
+    Leaf* leaf = _lock_leaf(k, true);
+    int n = leaf->n_;
+    int i = keyLowerBound(leaf->key_.data(), n, k);
+    bool found = i < n && leaf->key_[i] == k;
+    if (found) {
+        leaf->val_[i] = std::move(v);
+    } else {
+        std::move_backward(leaf->key_.begin() + i, leaf->key_.begin() + n, leaf->key_.begin() + n + 1);
+        std::move_backward(leaf->val_.begin() + i, leaf->val_.begin() + n, leaf->val_.begin() + n + 1);
+        leaf->key_[i] = std::move(k);
+        leaf->val_[i] = std::move(v);
+        ++leaf->n_;
+        size_.fetch_add(1, std::memory_order_relaxed);
+    }
+    leaf->latch_.unlock();
+    return !found;
+}
+
+/*!
+ * @brief This method removes a key. Leaves are allowed to underflow; nodes are never merged.
+ * @param k is the key object.
+ * @return true if the key was found and removed.
+ */
+template<typename K, typename V, int Degree>
+bool ConcurrentBPlusTree<K, V, Degree>::remove(const K& k) {
+    Leaf* leaf = _lock_leaf(k, false);
+    int n = leaf->n_;
+    int i = keyLowerBound(leaf->key_.data(), n, k);
+    bool found = i < n && leaf->key_[i] == k;
+    if (found) {
+        std::move(leaf->key_.begin() + i + 1, leaf->key_.begin() + n, leaf->key_.begin() + i);
+        std::move(leaf->val_.begin() + i + 1, leaf->val_.begin() + n, leaf->val_.begin() + i);
+        leaf->val_[n - 1] = V{};  // Do not keep the resources of a removed value alive.
+        --leaf->n_;
+        size_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    leaf->latch_.unlock();
+    return found;
+}
+
+/*!
+ * @brief This method checks whether a key is present.
+ * @param k is the key object.
+ * @return true if found.
+ */
+template<typename K, typename V, int Degree>
+bool ConcurrentBPlusTree<K, V, Degree>::contains(const K& k) const {
+    return _read(k, [](const V&) {});
+}
+
+/*!
+ * @brief This method looks a key up.
+ * @param k is the key object.
+ * @return a copy of the value, or nothing if not found.
+ */
+template<typename K, typename V, int Degree>
+std::optional<V> ConcurrentBPlusTree<K, V, Degree>::find(const K& k) const {
+    std::optional<V> result{};
+    _read(k, [&result](const V& v) { result = v; });
+    return result;
+}
+
+/*!
+ * @brief This method calls a function on the value of a key. With optimistic values the function sees a
+ * validated copy; otherwise it runs under the shared latch of the leaf and must not call back into the tree.
+ * @tparam F is type of the function (void(const V&)).
+ * @param k is the key object.
+ * @param f is the function.
+ * @return true if found.
+ */
+template<typename K, typename V, int Degree>
+template<typename F>
+bool ConcurrentBPlusTree<K, V, Degree>::visit(const K& k, F&& f) const {
+    return _read(k, std::forward<F>(f));
+}
+
+/*!
+ * @brief This method modifies the value of a key in place. The function runs under the exclusive latch of
+ * the leaf; it must not throw or call back into the tree.
+ * @tparam F is type of the function (void(V&)).
+ * @param k is the key object.
+ * @param f is the function.
+ * @return true if found.
+ */
+template<typename K, typename V, int Degree>
+template<typename F>
+bool ConcurrentBPlusTree<K, V, Degree>::update(const K& k, F&& f) {
+    Leaf* leaf = _lock_leaf(k, false);
+    int n = leaf->n_;
+    int i = keyLowerBound(leaf->key_.data(), n, k);
+    bool found = i < n && leaf->key_[i] == k;
+    if (found) { f(leaf->val_[i]); }
+    leaf->latch_.unlock();
+    return found;
+}
+
+/*!
+ * @brief This method returns number of keys. Under concurrent modification the count is a snapshot.
+ * @return number of keys.
+ */
+template<typename K, typename V, int Degree>
+size_t ConcurrentBPlusTree<K, V, Degree>::size() const {
+    return size_.load(std::memory_order_relaxed);
+}
+
+/*!
+ * @brief This method returns number of keys of a node, clamped to the capacity so that an optimistic
+ * reader never indexes out of bounds, whatever it read.
+ * @param p is pointer to the node.
+ * @return number of keys.
+ */
+template<typename K, typename V, int Degree>
+int ConcurrentBPlusTree<K, V, Degree>::_count(const Node* p) {
+    return std::clamp(p->n_, 0, kMaxKeys);
+}
+
+/*!
+ * @brief This method finds the child of an internal node that covers a key.
+ * @param p is pointer to the internal node.
+ * @param k is the key object.
+ * @return index of the child.
+ */
+template<typename K, typename V, int Degree>
+int ConcurrentBPlusTree<K, V, Degree>::_child_index(const Internal* p, const K& k) {
+    return keyUpperBound(p->key_.data(), _count(p), k);
+}
+
+/*!
+ * @brief This method makes one optimistic attempt at reading a key. Each node is validated after its child
+ * pointer is read and again after the child's version is taken, so a split in between is always noticed.
+ * @tparam F is type of the function (void(const V&)).
+ * @param k is the key object.
+ * @param f is the function, called once the value is known to be consistent.
+ * @return whether the key was found, or nothing if the attempt must be restarted.
+ */
+template<typename K, typename V, int Degree>
+template<typename F>
+std::optional<bool> ConcurrentBPlusTree<K, V, Degree>::_read_optimistic(const K& k, F& f) const {
+    const Node* p = root_.load(std::memory_order_acquire);
+    uint64_t version;
+    if (!p->latch_.readLock(version) || p != root_.load(std::memory_order_acquire)) { return std::nullopt; }
+    while (!p->leaf_) {
+        auto internal = static_cast<const Internal*>(p);
+        const Node* child = internal->c_[_child_index(internal, k)];
+        if (!p->latch_.validate(version)) { return std::nullopt; }
+        uint64_t child_version;
+        if (!child->latch_.readLock(child_version) || !p->latch_.validate(version)) { return std::nullopt; }
+        p = child;
+        version = child_version;
+    }
+    auto leaf = static_cast<const Leaf*>(p);
+    if constexpr (kOptimisticValues) {
+        int n = _count(leaf);
+        int i = keyLowerBound(leaf->key_.data(), n, k);
+        bool found = i < n && leaf->key_[i] == k;
+        V v = found ? leaf->val_[i] : V{};
+        if (!leaf->latch_.validate(version)) { return std::nullopt; }
+        if (found) { f(static_cast<const V&>(v)); }
+        return found;
+    } else {
+        leaf->latch_.lockShared();
+        if (!leaf->latch_.validate(version)) {
+            leaf->latch_.unlockShared();
+            return std::nullopt;
+        }
+        int n = leaf->n_;
+        int i = keyLowerBound(leaf->key_.data(), n, k);
+        bool found = i < n && leaf->key_[i] == k;
+        if (found) { f(leaf->val_[i]); }
+        leaf->latch_.unlockShared();
+        return found;
+    }
+}
+
+/*!
+ * @brief This method reads a key by coupling shared latches from the root down.
+ * @tparam F is type of the function (void(const V&)).
+ * @param k is the key object.
+ * @param f is the function, called under the shared latch of the leaf.
+ * @return true if found.
+ */
+template<typename K, typename V, int Degree>
+template<typename F>
+bool ConcurrentBPlusTree<K, V, Degree>::_read_shared(const K& k, F& f) const {
+    const Node* p;
+    while (true) {  // The root may grow between loading and latching it.
+        p = root_.load(std::memory_order_acquire);
+        p->latch_.lockShared();
+        if (p == root_.load(std::memory_order_acquire)) { break; }
+        p->latch_.unlockShared();
+    }
+    while (!p->leaf_) {
+        auto internal = static_cast<const Internal*>(p);
+        const Node* child = internal->c_[_child_index(internal, k)];
+        child->latch_.lockShared();
+        p->latch_.unlockShared();
+        p = child;
+    }
+    auto leaf = static_cast<const Leaf*>(p);
+    int n = leaf->n_;
+    int i = keyLowerBound(leaf->key_.data(), n, k);
+    bool found = i < n && leaf->key_[i] == k;
+    if (found) { f(leaf->val_[i]); }
+    leaf->latch_.unlockShared();
+    return found;
+}
+
+/*!
+ * @brief This method reads a key with optimistic lock coupling when keys allow it, shared latches otherwise.
+ * @tparam F is type of the function (void(const V&)).
+ * @param k is the key object.
+ * @param f is the function, called on the value if found.
+ * @return true if found.
+ */
+template<typename K, typename V, int Degree>
+template<typename F>
+bool ConcurrentBPlusTree<K, V, Degree>::_read(const K& k, F&& f) const {
+    if constexpr (kOptimisticKeys) {
+        while (true) {
+            if (auto found = _read_optimistic(k, f)) { return *found; }
+            std::this_thread::yield();  // Let a preempted writer finish.
+        }
+    } else {
+        return _read_shared(k, f);
+    }
+}
+
+/*!
+ * @brief This method latches the leaf that covers a key exclusively.
+ * @param k is the key object.
+ * @param room is true if the leaf must not be full (full nodes on the path are split first).
+ * @return pointer to the latched leaf; the caller unlocks it.
+ */
+template<typename K, typename V, int Degree>
+typename ConcurrentBPlusTree<K, V, Degree>::Leaf* ConcurrentBPlusTree<K, V, Degree>::_lock_leaf(const K& k,
+                                                                                               bool room) {
+    if constexpr (kOptimisticKeys) {
+        while (true) {
+            if (Leaf* leaf = _lock_leaf_optimistic(k, room)) { return leaf; }
+            std::this_thread::yield();  // Let a preempted writer finish.
+        }
+    } else {
+        Leaf* leaf = _lock_leaf_shared(k);
+        if (!room || leaf->n_ < kMaxKeys) { return leaf; }
+        leaf->latch_.unlock();
+        return _lock_leaf_exclusive(k, room);  // Rare: the leaf must be split.
+    }
+}
+
+/*!
+ * @brief This method makes one optimistic attempt at latching the leaf that covers a key. Nothing is latched
+ * on the way down except a full node and its parent, which are split before the attempt restarts.
+ * The parent cannot be full: it was seen not full under the version that the upgrade validates.
+ * A leaf only loses keys to a split, which changes its version, so the leaf is still the right one
+ * if its upgrade succeeds.
+ * @param k is the key object.
+ * @param room is true if full nodes must be split.
+ * @return pointer to the latched leaf, or nullptr if the attempt must be restarted.
+ */
+template<typename K, typename V, int Degree>
+typename ConcurrentBPlusTree<K, V, Degree>::Leaf*
+ConcurrentBPlusTree<K, V, Degree>::_lock_leaf_optimistic(const K& k, bool room) {
+    Node* p = root_.load(std::memory_order_acquire);
+    uint64_t version;
+    if (!p->latch_.readLock(version) || p != root_.load(std::memory_order_acquire)) { return nullptr; }
+    Internal* parent{nullptr};
+    uint64_t parent_version{};
+    while (true) {
+        if (room && p->n_ == kMaxKeys) {
+            if (parent && !parent->latch_.tryUpgrade(parent_version)) { return nullptr; }
+            if (!p->latch_.tryUpgrade(version)) {
+                if (parent) { parent->latch_.unlock(); }
+                return nullptr;
+            }
+            if (parent) {
+                _split_child(parent, _child_index(parent, k));
+                parent->latch_.unlock();
+            } else {
+                _split_root(p);  // Still the root: replacing the root changes the version of the old one.
+            }
+            p->latch_.unlock();
+            return nullptr;  // The key may now belong to the new sibling.
+        }
+        if (p->leaf_) { break; }
+        auto internal = static_cast<Internal*>(p);
+        Node* child = internal->c_[_child_index(internal, k)];
+        if (!internal->latch_.validate(version)) { return nullptr; }
+        uint64_t child_version;
+        if (!child->latch_.readLock(child_version) || !internal->latch_.validate(version)) { return nullptr; }
+        parent = internal;
+        parent_version = version;
+        p = child;
+        version = child_version;
+    }
+    if (!p->latch_.tryUpgrade(version)) { return nullptr; }
+    return static_cast<Leaf*>(p);
+}
+
+/*!
+ * @brief This method latches the leaf that covers a key exclusively, coupling shared latches on the way down.
+ * @param k is the key object.
+ * @return pointer to the latched leaf.
+ */
+template<typename K, typename V, int Degree>
+typename ConcurrentBPlusTree<K, V, Degree>::Leaf* ConcurrentBPlusTree<K, V, Degree>::_lock_leaf_shared(const K& k) {
+    Node* p;
+    while (true) {
+        p = root_.load(std::memory_order_acquire);
+        if (p->leaf_) { p->latch_.lock(); } else { p->latch_.lockShared(); }
+        if (p == root_.load(std::memory_order_acquire)) { break; }
+        if (p->leaf_) { p->latch_.unlock(); } else { p->latch_.unlockShared(); }
+    }
+    while (!p->leaf_) {
+        auto internal = static_cast<Internal*>(p);
+        Node* child = internal->c_[_child_index(internal, k)];
+        if (child->leaf_) { child->latch_.lock(); } else { child->latch_.lockShared(); }
+        internal->latch_.unlockShared();
+        p = child;
+    }
+    return static_cast<Leaf*>(p);
+}
+
+/*!
+ * @brief This method latches the leaf that covers a key exclusively, coupling exclusive latches on the way
+ * down and splitting full nodes top-down. At most two nodes are latched at a time.
+ * @param k is the key object.
+ * @param room is true if full nodes must be split.
+ * @return pointer to the latched leaf.
+ */
+template<typename K, typename V, int Degree>
+typename ConcurrentBPlusTree<K, V, Degree>::Leaf* ConcurrentBPlusTree<K, V, Degree>::_lock_leaf_exclusive(const K& k,
+                                                                                                         bool room) {
+    Node* p;
+    while (true) {
+        p = root_.load(std::memory_order_acquire);
+        p->latch_.lock();
+        if (p != root_.load(std::memory_order_acquire)) {
+            p->latch_.unlock();
+        } else if (room && p->n_ == kMaxKeys) {
+            _split_root(p);
+            p->latch_.unlock();
+        } else {
+            break;
+        }
+    }
+    while (!p->leaf_) {
+        auto internal = static_cast<Internal*>(p);
+        int i = _child_index(internal, k);
+        Node* child = internal->c_[i];
+        child->latch_.lock();
+        if (room && child->n_ == kMaxKeys) {
+            _split_child(internal, i);
+            child->latch_.unlock();
+            continue;  // The key may now belong to the new sibling.
+        }
+        internal->latch_.unlock();
+        p = child;
+    }
+    return static_cast<Leaf*>(p);
+}
+
+/*!
+ * @brief This method splits the full root and publishes a new root above it.
+ * @param root is pointer to the root, latched exclusively by the caller.
+ */
+template<typename K, typename V, int Degree>
+void ConcurrentBPlusTree<K, V, Degree>::_split_root(Node* root) {
+    auto new_root = new Internal();
+    new_root->c_[0] = root;
+    new_root->c_[1] = _split(root, new_root->key_[0]);
+    new_root->n_ = 1;
+    root_.store(new_root, std::memory_order_release);
+}
+
+/*!
+ * @brief This method splits the full i-th child of a node.
+ * @param p is pointer to the node, which is not full; it and its child are latched exclusively by the caller.
+ * @param i is index of the child.
+ */
+template<typename K, typename V, int Degree>
+void ConcurrentBPlusTree<K, V, Degree>::_split_child(Internal* p, int i) {
+    K separator{};
+    Node* right = _split(p->c_[i], separator);
+    int n = p->n_;
+    std::move_backward(p->key_.begin() + i, p->key_.begin() + n, p->key_.begin() + n + 1);
+    std::copy_backward(p->c_.begin() + i + 1, p->c_.begin() + n + 1, p->c_.begin() + n + 2);
+    p->key_[i] = std::move(separator);
+    p->c_[i + 1] = right;
+    ++p->n_;
+}
+
+/*!
+ * @brief This method moves the upper half of a full node to a new right sibling.
+ * A leaf keeps `Degree` keys and copies the first key of the sibling up; an internal node keeps
+ * `Degree - 1` keys and moves its middle key up.
+ * @param p is pointer to the node, latched exclusively by the caller.
+ * @param separator is set to the key that separates the two halves.
+ * @return pointer to the new sibling (not yet reachable).
+ */
+template<typename K, typename V, int Degree>
+typename ConcurrentBPlusTree<K, V, Degree>::Node* ConcurrentBPlusTree<K, V, Degree>::_split(Node* p, K& separator) {
+    if (p->leaf_) {
+        auto left = static_cast<Leaf*>(p);
+        auto right = new Leaf();
+        std::move(left->key_.begin() + Degree, left->key_.end(), right->key_.begin());
+        std::move(left->val_.begin() + Degree, left->val_.end(), right->val_.begin());
+        left->n_ = Degree;
+        right->n_ = Degree - 1;
+        separator = right->key_[0];
+        return right;
+    }
+    auto left = static_cast<Internal*>(p);
+    auto right = new Internal();
+    separator = std::move(left->key_[Degree - 1]);
+    std::move(left->key_.begin() + Degree, left->key_.end(), right->key_.begin());
+    std::copy(left->c_.begin() + Degree, left->c_.end(), right->c_.begin());
+    left->n_ = Degree - 1;
+    right->n_ = Degree - 1;
+    return right;
+}
+
+/*!
+ * @brief This method frees a subtree.
+ * @param p is pointer to the root of the subtree.
+ */
+template<typename K, typename V, int Degree>
+void ConcurrentBPlusTree<K, V, Degree>::_destroy(Node* p) {
+    if (p->leaf_) {
+        delete static_cast<Leaf*>(p);
+        return;
+    }
+    auto internal = static_cast<Internal*>(p);
+    for (int i = 0; i <= internal->n_; ++i) { _destroy(internal->c_[i]); }
+    delete internal;
+}
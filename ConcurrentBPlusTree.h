@@ -0,0 +1,92 @@
+/*!
+ * @brief This file contains the class definition of <em>ConcurrentBPlusTree</em>.
+ */
+#ifndef CS225_SP22_C2_CONCURRENTBPLUSTREE_H_
+#define CS225_SP22_C2_CONCURRENTBPLUSTREE_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include "keySearch.h"
+#include "optimisticLatch.h"
+
+/*!
+ * @brief This class implements a thread-safe B+-tree with optimistic lock coupling. Every node carries an
+ * <em>OptimisticLatch</em>. Readers descend without latching, validating each node's version before trusting
+ * what they read and restarting from the root if it changed; they never block writers. Writers descend the
+ * same way and latch only the leaf they modify, plus a node and its parent when the node is full: full nodes
+ * are split top-down on the way, so a split never propagates upwards.
+ * Nodes whose contents cannot be read while being written fall back to shared latches: with keys that are
+ * not trivially copyable (e.g. `std::string`) readers couple shared latches from the root, and with such
+ * values only the leaf is read under a shared latch.
+ * Removal never merges nodes, so a node is only freed when the tree is destroyed and a reader can never
+ * touch freed memory. Unlike <em>BPlusTree</em>, keys are unique and leaves have no overflow block.
+ * @tparam K is type of key objects.
+ * @tparam V is type of value objects.
+ * @tparam Degree is the minimum degree of the tree.
+ */
+template<typename K, typename V, int Degree = 32>
+class ConcurrentBPlusTree {
+    static_assert(Degree >= 2, "The minimum degree must be at least 2.");
+    static constexpr int kMaxKeys{2 * Degree - 1};
+    static constexpr bool kOptimisticKeys{std::is_trivially_copyable_v<K>};
+    static constexpr bool kOptimisticValues{kOptimisticKeys && std::is_trivially_copyable_v<V>};
+public:
+    // Constructors and destructor.
+    ConcurrentBPlusTree();
+    ConcurrentBPlusTree(const ConcurrentBPlusTree& tree) = delete;
+    ConcurrentBPlusTree& operator=(const ConcurrentBPlusTree& tree) = delete;
+    virtual ~ConcurrentBPlusTree();
+
+    // APIs (thread-safe).
+    void insert(K k, V v);
+    bool upsert(K k, V v);
+    bool remove(const K& k);
+    [[nodiscard]] bool contains(const K& k) const;
+    [[nodiscard]] std::optional<V> find(const K& k) const;
+    template<typename F> bool visit(const K& k, F&& f) const;
+    template<typename F> bool update(const K& k, F&& f);
+    [[nodiscard]] size_t size() const;
+
+private:
+    struct Node {
+        explicit Node(bool leaf) : leaf_{leaf} {}
+        mutable OptimisticLatch latch_{};
+        const bool leaf_;
+        int n_{};
+        std::array<K, kMaxKeys> key_{};
+    };
+    struct Internal : Node {
+        Internal() : Node(false) {}
+        std::array<Node*, kMaxKeys + 1> c_{};
+    };
+    struct Leaf : Node {
+        Leaf() : Node(true) {}
+        std::array<V, kMaxKeys> val_{};
+    };
+
+    // Private helper functions.
+    static int _count(const Node* p);
+    static int _child_index(const Internal* p, const K& k);
+    template<typename F> std::optional<bool> _read_optimistic(const K& k, F& f) const;
+    template<typename F> bool _read_shared(const K& k, F& f) const;
+    template<typename F> bool _read(const K& k, F&& f) const;
+    Leaf* _lock_leaf(const K& k, bool room);
+    Leaf* _lock_leaf_optimistic(const K& k, bool room);
+    Leaf* _lock_leaf_shared(const K& k);
+    Leaf* _lock_leaf_exclusive(const K& k, bool room);
+    void _split_root(Node* root);
+    static void _split_child(Internal* p, int i);
+    static Node* _split(Node* p, K& separator);
+    static void _destroy(Node* p);
+
+    // Fields.
+    std::atomic<Node*> root_;
+    std::atomic<size_t> size_{0};
+};
+
+#endif //CS225_SP22_C2_CONCURRENTBPLUSTREE_H_
@@ -0,0 +1,481 @@
+/*!
+ * @brief This file contains the implementation of class methods of <em>ConcurrentBTree</em>.
+ */
+#include "ConcurrentBTree.h"
+
+/*!
+ * @brief Default constructor. The root is an empty leaf, so it is never null.
+ */
+template<typename K, typename V, int MinDegree>
+ConcurrentBTree<K, V, MinDegree>::ConcurrentBTree() : root_{new Node(true)} {}
+
+/*!
+ * @brief Destructor. Must not run concurrently with any other method.
+ */
+template<typename K, typename V, int MinDegree>
+ConcurrentBTree<K, V, MinDegree>::~ConcurrentBTree() {
+    _destroy(root_.load());
+}
+
+/*!
+ * @brief This method inserts a key-value pair. An existing value of the key is overwritten.
+ * @param k is the key object.
+ * @param v is the value object.
+ */
+template<typename K, typename V, int MinDegree>
+void ConcurrentBTree<K, V, MinDegree>::insert(K k, V v) {
+    upsert(std::move(k), std::move(v));
+}
+
+/*!
+ * @brief This method inserts a key-value pair, or overwrites the value if the key is present.
+ * A tombstone of the key is revived.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if the key was inserted, false if it was overwritten.
+ */
+template<typename K, typename V, int MinDegree>
+bool ConcurrentBTree<K, V, MinDegree>::upsert(K k, V v) {
+    Node* p = _lock_node(k, true);
+    bool found;
+    int i = _search(p, k, found);
+    bool inserted = !found || !p->live_[i];
+    if (!found) {  // p is a leaf with room.
+        int n = p->n_;
+        std::move_backward(p->key_.begin() + i, p->key_.begin() + n, p->key_.begin() + n + 1);
+        std::move_backward(p->val_.begin() + i, p->val_.begin() + n, p->val_.begin() + n + 1);
+        std::copy_backward(p->live_.begin() + i, p->live_.begin() + n, p->live_.begin() + n + 1);
+        p->key_[i] = std::move(k);
+        ++p->n_;
+    }
+    p->val_[i] = std::move(v);
+    p->live_[i] = true;
+    if (inserted) { size_.fetch_add(1, std::memory_order_relaxed); }
+    p->latch_.unlock();
+    return inserted;
+}
+
+/*!
+ * @brief This method removes a key. A key of a leaf is erased; a key of an internal node becomes a tombstone.
+ * @param k is the key object.
+ * @return true if the key was found and removed.
+ */
+template<typename K, typename V, int MinDegree>
+bool ConcurrentBTree<K, V, MinDegree>::remove(const K& k) {
+    Node* p = _lock_node(k, false);
+    bool found;
+    int i = _search(p, k, found);
+    found = found && p->live_[i];
+    if (found) {
+        if (p->leaf_) {
+            int n = p->n_;
+            std::move(p->key_.begin() + i + 1, p->key_.begin() + n, p->key_.begin() + i);
+            std::move(p->val_.begin() + i + 1, p->val_.begin() + n, p->val_.begin() + i);
+            std::copy(p->live_.begin() + i + 1, p->live_.begin() + n, p->live_.begin() + i);
+            p->val_[n - 1] = V{};
+            --p->n_;
+        } else {
+            p->val_[i] = V{};  // Do not keep the resources of a removed value alive.
+            p->live_[i] = false;
+        }
+        size_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    p->latch_.unlock();
+    return found;
+}
+
+/*!
+ * @brief This method checks whether a key is present.
+ * @param k is the key object.
+ * @return true if found.
+ */
+template<typename K, typename V, int MinDegree>
+bool ConcurrentBTree<K, V, MinDegree>::contains(const K& k) const {
+    return _read(k, [](const V&) {});
+}
+
+/*!
+ * @brief This method looks a key up.
+ * @param k is the key object.
+ * @return a copy of the value, or nothing if not found.
+ */
+template<typename K, typename V, int MinDegree>
+std::optional<V> ConcurrentBTree<K, V, MinDegree>::find(const K& k) const {
+    std::optional<V> result{};
+    _read(k, [&result](const V& v) { result = v; });
+    return result;
+}
+
+/*!
+ * @brief This method calls a function on the value of a key. With optimistic values the function sees a
+ * validated copy; otherwise it runs under the shared latch of the node and must not call back into the tree.
+ * @tparam F is type of the function (void(const V&)).
+ * @param k is the key object.
+ * @param f is the function.
+ * @return true if found.
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+bool ConcurrentBTree<K, V, MinDegree>::visit(const K& k, F&& f) const {
+    return _read(k, std::forward<F>(f));
+}
+
+/*!
+ * @brief This method modifies the value of a key in place. The function runs under the exclusive latch of
+ * the node; it must not throw or call back into the tree.
+ * @tparam F is type of the function (void(V&)).
+ * @param k is the key object.
+ * @param f is the function.
+ * @return true if found.
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+bool ConcurrentBTree<K, V, MinDegree>::update(const K& k, F&& f) {
+    Node* p = _lock_node(k, false);
+    bool found;
+    int i = _search(p, k, found);
+    found = found && p->live_[i];
+    if (found) { f(p->val_[i]); }
+    p->latch_.unlock();
+    return found;
+}
+
+/*!
+ * @brief This method returns number of keys. Under concurrent modification the count is a snapshot.
+ * @return number of keys.
+ */
+template<typename K, typename V, int MinDegree>
+size_t ConcurrentBTree<K, V, MinDegree>::size() const {
+    return size_.load(std::memory_order_relaxed);
+}
+
+/*!
+ * @brief This method returns number of keys of a node, clamped to the capacity so that an optimistic
+ * reader never indexes out of bounds, whatever it read.
+ * @param p is pointer to the node.
+ * @return number of keys.
+ */
+template<typename K, typename V, int MinDegree>
+int ConcurrentBTree<K, V, MinDegree>::_count(const Node* p) {
+    return std::clamp(p->n_, 0, kMaxKeys);
+}
+
+/*!
+ * @brief This method finds a key in a node.
+ * @param p is pointer to the node.
+ * @param k is the key object.
+ * @param found is set to true if the node holds the key (live or not).
+ * @return index of the key if found, otherwise index of the child that covers it.
+ */
+template<typename K, typename V, int MinDegree>
+int ConcurrentBTree<K, V, MinDegree>::_search(const Node* p, const K& k, bool& found) {
+    int n = _count(p);
+    int i = keyLowerBound(p->key_.data(), n, k);
+    found = i < n && p->key_[i] == k;
+    return i;
+}
+
+/*!
+ * @brief This method makes one optimistic attempt at reading a key. Each node is validated after its child
+ * pointer is read and again after the child's version is taken, so a split in between is always noticed.
+ * @tparam F is type of the function (void(const V&)).
+ * @param k is the key object.
+ * @param f is the function, called once the value is known to be consistent.
+ * @return whether the key was found, or nothing if the attempt must be restarted.
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+std::optional<bool> ConcurrentBTree<K, V, MinDegree>::_read_optimistic(const K& k, F& f) const {
+    const Node* p = root_.load(std::memory_order_acquire);
+    uint64_t version;
+    if (!p->latch_.readLock(version) || p != root_.load(std::memory_order_acquire)) { return std::nullopt; }
+    bool found;
+    int i;
+    while (true) {
+        i = _search(p, k, found);
+        if (found || p->leaf_) { break; }
+        const Node* child = static_cast<const Internal*>(p)->c_[i];
+        if (!p->latch_.validate(version)) { return std::nullopt; }
+        uint64_t child_version;
+        if (!child->latch_.readLock(child_version) || !p->latch_.validate(version)) { return std::nullopt; }
+        p = child;
+        version = child_version;
+    }
+    if constexpr (kOptimisticValues) {
+        bool live = found && p->live_[i];
+        V v = live ? p->val_[i] : V{};
+        if (!p->latch_.validate(version)) { return std::nullopt; }
+        if (live) { f(static_cast<const V&>(v)); }
+        return live;
+    } else {
+        p->latch_.lockShared();
+        if (!p->latch_.validate(version)) {
+            p->latch_.unlockShared();
+            return std::nullopt;
+        }
+        bool live = found && p->live_[i];
+        if (live) { f(p->val_[i]); }
+        p->latch_.unlockShared();
+        return live;
+    }
+}
+
+/*!
+ * @brief This method reads a key by coupling shared latches from the root down.
+ * @tparam F is type of the function (void(const V&)).
+ * @param k is the key object.
+ * @param f is the function, called under the shared latch of the node that holds the key.
+ * @return true if found.
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+bool ConcurrentBTree<K, V, MinDegree>::_read_shared(const K& k, F& f) const {
+    const Node* p;
+    while (true) {  // The root may grow between loading and latching it.
+        p = root_.load(std::memory_order_acquire);
+        p->latch_.lockShared();
+        if (p == root_.load(std::memory_order_acquire)) { break; }
+        p->latch_.unlockShared();
+    }
+    bool found;
+    int i;
+    while (true) {
+        i = _search(p, k, found);
+        if (found || p->leaf_) { break; }
+        const Node* child = static_cast<const Internal*>(p)->c_[i];
+        child->latch_.lockShared();
+        p->latch_.unlockShared();
+        p = child;
+    }
+    bool live = found && p->live_[i];
+    if (live) { f(p->val_[i]); }
+    p->latch_.unlockShared();
+    return live;
+}
+
+/*!
+ * @brief This method reads a key with optimistic lock coupling when keys allow it, shared latches otherwise.
+ * @tparam F is type of the function (void(const V&)).
+ * @param k is the key object.
+ * @param f is the function, called on the value if found.
+ * @return true if found.
+ */
+template<typename K, typename V, int MinDegree>
+template<typename F>
+bool ConcurrentBTree<K, V, MinDegree>::_read(const K& k, F&& f) const {
+    if constexpr (kOptimisticKeys) {
+        while (true) {
+            if (auto found = _read_optimistic(k, f)) { return *found; }
+            std::this_thread::yield();  // Let a preempted writer finish.
+        }
+    } else {
+        return _read_shared(k, f);
+    }
+}
+
+/*!
+ * @brief This method latches exclusively the node that holds a key, or else the leaf that would hold it.
+ * @param k is the key object.
+ * @param room is true if that leaf must not be full (full nodes on the path are split first).
+ * @return pointer to the latched node; the caller unlocks it.
+ */
+template<typename K, typename V, int MinDegree>
+typename ConcurrentBTree<K, V, MinDegree>::Node* ConcurrentBTree<K, V, MinDegree>::_lock_node(const K& k, bool room) {
+    if constexpr (kOptimisticKeys) {
+        while (true) {
+            if (Node* p = _lock_node_optimistic(k, room)) { return p; }
+            std::this_thread::yield();  // Let a preempted writer finish.
+        }
+    } else {
+        Node* p = _lock_node_shared(k);
+        if (p && (!room || p->n_ < kMaxKeys)) { return p; }
+        if (p) { p->latch_.unlock(); }
+        return _lock_node_exclusive(k, room);  // The key is in an internal node, or the leaf must be split.
+    }
+}
+
+/*!
+ * @brief This method makes one optimistic attempt at latching the node of a key. Nothing is latched on the
+ * way down except a full node and its parent, which are split before the attempt restarts.
+ * The parent cannot be full: it was seen not full under the version that the upgrade validates.
+ * A node only loses keys to a split, which changes its version, so the node is still the right one
+ * if its upgrade succeeds.
+ * @param k is the key object.
+ * @param room is true if full nodes must be split.
+ * @return pointer to the latched node, or nullptr if the attempt must be restarted.
+ */
+template<typename K, typename V, int MinDegree>
+typename ConcurrentBTree<K, V, MinDegree>::Node*
+ConcurrentBTree<K, V, MinDegree>::_lock_node_optimistic(const K& k, bool room) {
+    Node* p = root_.load(std::memory_order_acquire);
+    uint64_t version;
+    if (!p->latch_.readLock(version) || p != root_.load(std::memory_order_acquire)) { return nullptr; }
+    Internal* parent{nullptr};
+    uint64_t parent_version{};
+    int parent_i{};
+    while (true) {
+        if (room && p->n_ == kMaxKeys) {
+            if (parent && !parent->latch_.tryUpgrade(parent_version)) { return nullptr; }
+            if (!p->latch_.tryUpgrade(version)) {
+                if (parent) { parent->latch_.unlock(); }
+                return nullptr;
+            }
+            if (parent) {
+                _split_child(parent, parent_i);
+                parent->latch_.unlock();
+            } else {
+                _split_root(p);  // Still the root: replacing the root changes the version of the old one.
+            }
+            p->latch_.unlock();
+            return nullptr;  // The key may now belong to the parent or the new sibling.
+        }
+        bool found;
+        int i = _search(p, k, found);
+        if (found || p->leaf_) { break; }
+        auto internal = static_cast<Internal*>(p);
+        Node* child = internal->c_[i];
+        if (!internal->latch_.validate(version)) { return nullptr; }
+        uint64_t child_version;
+        if (!child->latch_.readLock(child_version) || !internal->latch_.validate(version)) { return nullptr; }
+        parent = internal;
+        parent_version = version;
+        parent_i = i;
+        p = child;
+        version = child_version;
+    }
+    if (!p->latch_.tryUpgrade(version)) { return nullptr; }
+    return p;
+}
+
+/*!
+ * @brief This method couples shared latches down to the leaf that would hold a key and latches it exclusively.
+ * @param k is the key object.
+ * @return pointer to the latched leaf, or nullptr if an internal node holds the key.
+ */
+template<typename K, typename V, int MinDegree>
+typename ConcurrentBTree<K, V, MinDegree>::Node* ConcurrentBTree<K, V, MinDegree>::_lock_node_shared(const K& k) {
+    Node* p;
+    while (true) {
+        p = root_.load(std::memory_order_acquire);
+        if (p->leaf_) { p->latch_.lock(); } else { p->latch_.lockShared(); }
+        if (p == root_.load(std::memory_order_acquire)) { break; }
+        if (p->leaf_) { p->latch_.unlock(); } else { p->latch_.unlockShared(); }
+    }
+    while (!p->leaf_) {
+        bool found;
+        int i = _search(p, k, found);
+        if (found) {
+            p->latch_.unlockShared();
+            return nullptr;
+        }
+        Node* child = static_cast<Internal*>(p)->c_[i];
+        if (child->leaf_) { child->latch_.lock(); } else { child->latch_.lockShared(); }
+        p->latch_.unlockShared();
+        p = child;
+    }
+    return p;
+}
+
+/*!
+ * @brief This method latches exclusively the node of a key, coupling exclusive latches on the way down and
+ * splitting full nodes top-down. At most two nodes are latched at a time.
+ * @param k is the key object.
+ * @param room is true if full nodes must be split.
+ * @return pointer to the latched node.
+ */
+template<typename K, typename V, int MinDegree>
+typename ConcurrentBTree<K, V, MinDegree>::Node* ConcurrentBTree<K, V, MinDegree>::_lock_node_exclusive(const K& k,
+                                                                                                        bool room) {
+    Node* p;
+    while (true) {
+        p = root_.load(std::memory_order_acquire);
+        p->latch_.lock();
+        if (p != root_.load(std::memory_order_acquire)) {
+            p->latch_.unlock();
+        } else if (room && p->n_ == kMaxKeys) {
+            _split_root(p);
+            p->latch_.unlock();
+        } else {
+            break;
+        }
+    }
+    while (true) {
+        bool found;
+        int i = _search(p, k, found);
+        if (found || p->leaf_) { return p; }
+        auto internal = static_cast<Internal*>(p);
+        Node* child = internal->c_[i];
+        child->latch_.lock();
+        if (room && child->n_ == kMaxKeys) {
+            _split_child(internal, i);
+            child->latch_.unlock();
+            continue;  // The key may now be the promoted one, or belong to the new sibling.
+        }
+        internal->latch_.unlock();
+        p = child;
+    }
+}
+
+/*!
+ * @brief This method splits the full root and publishes a new root above it.
+ * @param root is pointer to the root, latched exclusively by the caller.
+ */
+template<typename K, typename V, int MinDegree>
+void ConcurrentBTree<K, V, MinDegree>::_split_root(Node* root) {
+    auto new_root = new Internal();
+    new_root->c_[0] = root;
+    _split_child(new_root, 0);
+    root_.store(new_root, std::memory_order_release);
+}
+
+/*!
+ * @brief This method splits the full i-th child of a node: the child keeps `MinDegree - 1` keys, its middle
+ * key (with its value and tombstone flag) moves up and the rest move to a new right sibling.
+ * @param p is pointer to the node, which is not full; it and its child are latched exclusively by the caller.
+ * @param i is index of the child.
+ */
+template<typename K, typename V, int MinDegree>
+void ConcurrentBTree<K, V, MinDegree>::_split_child(Internal* p, int i) {
+    constexpr int t = MinDegree;
+    Node* left = p->c_[i];
+    Node* right;
+    if (left->leaf_) {
+        right = new Node(true);
+    } else {
+        auto internal = new Internal();
+        auto left_internal = static_cast<Internal*>(left);
+        std::copy(left_internal->c_.begin() + t, left_internal->c_.end(), internal->c_.begin());
+        right = internal;
+    }
+    std::move(left->key_.begin() + t, left->key_.end(), right->key_.begin());
+    std::move(left->val_.begin() + t, left->val_.end(), right->val_.begin());
+    std::copy(left->live_.begin() + t, left->live_.end(), right->live_.begin());
+    right->n_ = t - 1;
+
+    int n = p->n_;
+    std::move_backward(p->key_.begin() + i, p->key_.begin() + n, p->key_.begin() + n + 1);
+    std::move_backward(p->val_.begin() + i, p->val_.begin() + n, p->val_.begin() + n + 1);
+    std::copy_backward(p->live_.begin() + i, p->live_.begin() + n, p->live_.begin() + n + 1);
+    std::copy_backward(p->c_.begin() + i + 1, p->c_.begin() + n + 1, p->c_.begin() + n + 2);
+    p->key_[i] = std::move(left->key_[t - 1]);
+    p->val_[i] = std::move(left->val_[t - 1]);
+    p->live_[i] = left->live_[t - 1];
+    p->c_[i + 1] = right;
+    ++p->n_;
+    left->n_ = t - 1;
+}
+
+/*!
+ * @brief This method frees a subtree.
+ * @param p is pointer to the root of the subtree.
+ */
+template<typename K, typename V, int MinDegree>
+void ConcurrentBTree<K, V, MinDegree>::_destroy(Node* p) {
+    if (p->leaf_) {
+        delete p;
+        return;
+    }
+    auto internal = static_cast<Internal*>(p);
+    for (int i = 0; i <= internal->n_; ++i) { _destroy(internal->c_[i]); }
+    delete internal;
+}
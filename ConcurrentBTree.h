@@ -0,0 +1,86 @@
+/*!
+ * @brief This file contains the class definition of <em>ConcurrentBTree</em>.
+ */
+#ifndef CS225_SP22_C2_CONCURRENTBTREE_H_
+#define CS225_SP22_C2_CONCURRENTBTREE_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include "keySearch.h"
+#include "optimisticLatch.h"
+
+/*!
+ * @brief This class implements a thread-safe B-tree with optimistic lock coupling, following the protocol of
+ * <em>ConcurrentBPlusTree</em>: readers validate node versions instead of latching, and writers latch the node
+ * they modify, plus a full node and its parent while splitting it top-down.
+ * With keys that are not trivially copyable (e.g. `std::string`) readers couple shared latches instead, and
+ * writers couple exclusive latches only when the target node must be split or is an internal node.
+ * As in <em>PagedBTree</em>, removing the key of an internal node leaves a tombstone, which still separates the
+ * subtrees; nodes are never merged, so they are only freed when the tree is destroyed.
+ * @tparam K is type of key objects.
+ * @tparam V is type of value objects.
+ * @tparam MinDegree is the minimum degree: nodes hold at most `2 * MinDegree - 1` keys.
+ */
+template<typename K, typename V, int MinDegree = 16>
+class ConcurrentBTree {
+    static_assert(MinDegree >= 2, "The minimum degree must be at least 2.");
+    static constexpr int kMaxKeys{2 * MinDegree - 1};
+    static constexpr bool kOptimisticKeys{std::is_trivially_copyable_v<K>};
+    static constexpr bool kOptimisticValues{kOptimisticKeys && std::is_trivially_copyable_v<V>};
+public:
+    // Constructors and destructor.
+    ConcurrentBTree();
+    ConcurrentBTree(const ConcurrentBTree& tree) = delete;
+    ConcurrentBTree& operator=(const ConcurrentBTree& tree) = delete;
+    virtual ~ConcurrentBTree();
+
+    // APIs (thread-safe).
+    void insert(K k, V v);
+    bool upsert(K k, V v);
+    bool remove(const K& k);
+    [[nodiscard]] bool contains(const K& k) const;
+    [[nodiscard]] std::optional<V> find(const K& k) const;
+    template<typename F> bool visit(const K& k, F&& f) const;
+    template<typename F> bool update(const K& k, F&& f);
+    [[nodiscard]] size_t size() const;
+
+private:
+    struct Node {
+        explicit Node(bool leaf) : leaf_{leaf} {}
+        mutable OptimisticLatch latch_{};
+        const bool leaf_;
+        int n_{};
+        std::array<K, kMaxKeys> key_{};
+        std::array<V, kMaxKeys> val_{};
+        std::array<bool, kMaxKeys> live_{};  // False for tombstones.
+    };
+    struct Internal : Node {
+        Internal() : Node(false) {}
+        std::array<Node*, kMaxKeys + 1> c_{};
+    };
+
+    // Private helper functions.
+    static int _count(const Node* p);
+    static int _search(const Node* p, const K& k, bool& found);
+    template<typename F> std::optional<bool> _read_optimistic(const K& k, F& f) const;
+    template<typename F> bool _read_shared(const K& k, F& f) const;
+    template<typename F> bool _read(const K& k, F&& f) const;
+    Node* _lock_node(const K& k, bool room);
+    Node* _lock_node_optimistic(const K& k, bool room);
+    Node* _lock_node_shared(const K& k);
+    Node* _lock_node_exclusive(const K& k, bool room);
+    void _split_root(Node* root);
+    static void _split_child(Internal* p, int i);
+    static void _destroy(Node* p);
+
+    // Fields.
+    std::atomic<Node*> root_;
+    std::atomic<size_t> size_{0};
+};
+
+#endif //CS225_SP22_C2_CONCURRENTBTREE_H_
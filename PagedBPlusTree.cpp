@@ -0,0 +1,816 @@
+/*!
+ * @brief This file contains the implementation of class <em>PagedBPlusTree</em>.
+ *
+ * Page layouts (offsets in bytes):
+ *  - Metadata (page 0): magic [0, 8), page size [8, 12), key size [12, 16), root [16, 20), number of keys [24, 32).
+ *  - Every node: leaf tag [0], number of keys [2, 4), previous leaf [4, 8), next leaf [8, 12),
+ *    start of the value heap [12, 14).
+ *  - Internal node: `kMaxKeys` key slots followed by `kMaxKeys + 1` child page numbers.
+ *  - Leaf node: sorted slots (key, value offset, value length) followed by free space and the value heap,
+ *    which grows down from the end of the page.
+ */
+#include "PagedBPlusTree.h"
+#include "utilities.h"
+#include <cstring>
+#include <stdexcept>
+
+/*!
+ * @brief This constructor opens the tree stored in the given file, or creates an empty one.
+ * @param path is path to the database file.
+ * @param frames is number of pages cached in memory.
+ * @throw IOError if the file cannot be opened or was written by an incompatible tree.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::PagedBPlusTree(const std::string& path, size_t frames)
+    : pool_(path, frames) {
+    if (0 == pool_.pageCount()) {  // A new file.
+        auto meta = pool_.allocate();
+        std::memcpy(meta.data(), kMagic, 8);
+        setPageField<uint32_t>(meta.data(), 8, kPageSize);
+        setPageField<uint32_t>(meta.data(), 12, kKeySize);
+        setPageField<uint32_t>(meta.data(), 16, kNullPage);
+        setPageField<uint64_t>(meta.data(), 24, 0);
+        return;
+    }
+    auto meta = pool_.fetch(0);
+    if (0 != std::memcmp(meta.data(), kMagic, 8) || kPageSize != pageField<uint32_t>(meta.data(), 8)
+        || kKeySize != pageField<uint32_t>(meta.data(), 12)) {
+        throw IOError();
+    }
+    root_ = pageField<uint32_t>(meta.data(), 16);
+    size_ = pageField<uint64_t>(meta.data(), 24);
+}
+
+/*!
+ * @brief This destructor checkpoints the tree.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::~PagedBPlusTree() {
+    try {
+        checkpoint();
+    } catch (const IOError& error) {
+        std::cerr << error.what() << std::endl;
+    }
+}
+
+/*!
+ * @brief This method inserts the given key-value pair, overwriting the value if the key already exists.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @throw std::length_error if the encoded value is too large for a page.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBPlusTree<K, V, KeyCodec, ValueCodec>::insert(K k, V v) {
+    _put(k, v);
+}
+
+/*!
+ * @brief This method overwrites the value of the given key, or inserts the pair if the key is absent.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if the pair was inserted, false if an existing value was overwritten.
+ * @throw std::length_error if the encoded value is too large for a page.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBPlusTree<K, V, KeyCodec, ValueCodec>::upsert(K k, V v) {
+    return _put(k, v);
+}
+
+/*!
+ * @brief This method removes the given key from the tree. Leaves are never merged.
+ * @param k is the key object.
+ * @return true if the key was removed, false if not found.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBPlusTree<K, V, KeyCodec, ValueCodec>::remove(const K& k) {
+    if (kNullPage == root_) { return false; }
+    auto leaf = _find_leaf(k);
+    char* p = leaf.data();
+    int i = _leaf_lower_bound(p, k);
+    if (i == _count(p) || !_equal(_leaf_key(p, i), k)) { return false; }
+    _leaf_erase(p, i);
+    leaf.markDirty();
+    --size_;
+    return true;
+}
+
+/*!
+ * @brief This method checks if the given key exists in the tree. The value is not decoded.
+ * @param k is the key object.
+ * @return true if exists, false if not exists.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBPlusTree<K, V, KeyCodec, ValueCodec>::contains(const K& k) const {
+    if (kNullPage == root_) { return false; }
+    auto leaf = _find_leaf(k);
+    int i = _leaf_lower_bound(leaf.data(), k);
+    return i < _count(leaf.data()) && _equal(_leaf_key(leaf.data(), i), k);
+}
+
+/*!
+ * @brief This method looks up a key and decodes its value.
+ * @param k is the key object.
+ * @return copy of the value object, or an empty optional if not found.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+std::optional<V> PagedBPlusTree<K, V, KeyCodec, ValueCodec>::find(const K& k) const {
+    if (kNullPage == root_) { return std::nullopt; }
+    auto leaf = _find_leaf(k);
+    int i = _leaf_lower_bound(leaf.data(), k);
+    if (i == _count(leaf.data()) || !_equal(_leaf_key(leaf.data(), i), k)) { return std::nullopt; }
+    return _leaf_value(leaf.data(), i);
+}
+
+/*!
+ * @brief This method calls `f` on the decoded value of the given key, if present.
+ * @tparam F is type of the callable, invoked as `f(const V&)`.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+template<typename F>
+bool PagedBPlusTree<K, V, KeyCodec, ValueCodec>::visit(const K& k, F&& f) const {
+    auto v = find(k);
+    if (!v) { return false; }
+    std::forward<F>(f)(std::as_const(*v));
+    return true;
+}
+
+/*!
+ * @brief This method decodes the value of the given key, lets `f` modify it and stores it back.
+ * @tparam F is type of the callable, invoked as `f(V&)`.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ * @throw std::length_error if the modified value is too large for a page.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+template<typename F>
+bool PagedBPlusTree<K, V, KeyCodec, ValueCodec>::update(const K& k, F&& f) {
+    auto v = find(k);
+    if (!v) { return false; }
+    std::forward<F>(f)(*v);
+    _put(k, *v);
+    return true;
+}
+
+/*!
+ * @brief This method returns number of keys in the tree.
+ * @return the number of keys.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+size_t PagedBPlusTree<K, V, KeyCodec, ValueCodec>::size() const {
+    return size_;
+}
+
+/*!
+ * @brief This method records the root and size in the metadata page and writes every dirty page back.
+ * When it returns, reopening the file yields the current tree.
+ * @throw IOError if a page cannot be written.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBPlusTree<K, V, KeyCodec, ValueCodec>::checkpoint() {
+    {
+        auto meta = pool_.fetch(0);
+        setPageField<uint32_t>(meta.data(), 16, root_);
+        setPageField<uint64_t>(meta.data(), 24, size_);
+        meta.markDirty();
+    }
+    pool_.flush();
+}
+
+/*!
+ * @brief This method returns the buffer pool, e.g. to read its counters.
+ * @return reference to the buffer pool.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+const BufferPool& PagedBPlusTree<K, V, KeyCodec, ValueCodec>::pool() const {
+    return pool_;
+}
+
+/*!
+ * @brief This method returns an iterator to the smallest key.
+ * @return the iterator.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::begin() const {
+    return ConstIterator{this, _edge_leaf(false), 0};
+}
+
+/*!
+ * @brief This method returns the past-the-end iterator.
+ * @return the iterator.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::end() const {
+    return ConstIterator{this, kNullPage, 0};
+}
+
+/*!
+ * @brief This method returns a reverse iterator to the largest key.
+ * @return the reverse iterator.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstReverseIterator
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::rbegin() const {
+    return ConstReverseIterator{end()};
+}
+
+/*!
+ * @brief This method returns the past-the-end reverse iterator.
+ * @return the reverse iterator.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstReverseIterator
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::rend() const {
+    return ConstReverseIterator{begin()};
+}
+
+/*!
+ * @brief This method returns an iterator to the first key not less than `k`.
+ * @param k is the key object.
+ * @return the iterator.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::lower_bound(const K& k) const {
+    if (kNullPage == root_) { return end(); }
+    auto leaf = _find_leaf(k);
+    int i = _leaf_lower_bound(leaf.data(), k);
+    page_id id = leaf.id();
+    leaf.release();
+    return ConstIterator{this, id, i};
+}
+
+/*!
+ * @brief This method returns the keys in `[lo, hi)`, found with one descent per bound.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the exclusive upper bound.
+ * @return the range.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::Range
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::range(const K& lo, const K& hi) const {
+    return Range{lower_bound(lo), lower_bound(hi)};
+}
+
+/*!
+ * @brief This method returns number of keys in a node.
+ * @param p is pointer to the page.
+ * @return the number of keys.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+int PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_count(const char* p) {
+    return pageField<uint16_t>(p, 2);
+}
+
+/*!
+ * @brief This method checks if a node is a leaf.
+ * @param p is pointer to the page.
+ * @return true if it is, false otherwise.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_is_leaf(const char* p) {
+    return 0 != p[0];
+}
+
+/*!
+ * @brief This method resets the header of a page to an empty, unlinked node.
+ * @param p is pointer to the page.
+ * @param leaf is true for a leaf, false for an internal node.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_init_page(char* p, bool leaf) {
+    std::memset(p, 0, kHeaderSize);
+    p[0] = static_cast<char>(leaf);
+    setPageField<uint32_t>(p, 4, kNullPage);
+    setPageField<uint32_t>(p, 8, kNullPage);
+    setPageField<uint16_t>(p, 12, static_cast<uint16_t>(kPageSize));
+}
+
+/*!
+ * @brief This method decodes a key stored at the given offset.
+ * @param p is pointer to the page.
+ * @param offset is offset of the key.
+ * @return the key object.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+K PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_key(const char* p, size_t offset) {
+    return KeyCodec::decode(p + offset, kKeySize);
+}
+
+/*!
+ * @brief This method checks two keys for equivalence using only `operator<`.
+ * @param a is the first key.
+ * @param b is the second key.
+ * @return true if neither is less than the other.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_equal(const K& a, const K& b) {
+    return !(a < b) && !(b < a);
+}
+
+/*!
+ * @brief This method returns the offset of the `i`-th key of an internal node.
+ * @param i is index of the key.
+ * @return the offset.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+size_t PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_internal_key_offset(int i) {
+    return kHeaderSize + static_cast<size_t>(i) * kKeySize;
+}
+
+/*!
+ * @brief This method returns the offset of the `i`-th child of an internal node.
+ * @param i is index of the child.
+ * @return the offset.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+size_t PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_internal_child_offset(int i) {
+    return kHeaderSize + kMaxKeys * kKeySize + static_cast<size_t>(i) * sizeof(page_id);
+}
+
+/*!
+ * @brief This method returns the `i`-th child of an internal node.
+ * @param p is pointer to the page.
+ * @param i is index of the child.
+ * @return the child page number.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+page_id PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_child(const char* p, int i) {
+    return pageField<page_id>(p, _internal_child_offset(i));
+}
+
+/*!
+ * @brief This method finds the child of an internal node to descend into: the number of keys not greater than `k`.
+ * @param p is pointer to the page.
+ * @param k is the key object.
+ * @return index of the child.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+int PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_child_index(const char* p, const K& k) {
+    int lo = 0, hi = _count(p);
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (k < _key(p, _internal_key_offset(mid))) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+/*!
+ * @brief This method returns the offset of the `i`-th slot of a leaf.
+ * @param i is index of the slot.
+ * @return the offset.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+size_t PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_slot_offset(int i) {
+    return kHeaderSize + static_cast<size_t>(i) * kSlotSize;
+}
+
+/*!
+ * @brief This method decodes the `i`-th key of a leaf.
+ * @param p is pointer to the page.
+ * @param i is index of the slot.
+ * @return the key object.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+K PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_leaf_key(const char* p, int i) {
+    return _key(p, _slot_offset(i));
+}
+
+/*!
+ * @brief This method decodes the `i`-th value of a leaf.
+ * @param p is pointer to the page.
+ * @param i is index of the slot.
+ * @return the value object.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+V PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_leaf_value(const char* p, int i) {
+    size_t slot = _slot_offset(i);
+    return ValueCodec::decode(p + pageField<uint16_t>(p, slot + kKeySize), pageField<uint16_t>(p, slot + kKeySize + 2));
+}
+
+/*!
+ * @brief This method finds the first slot of a leaf whose key is not less than `k`.
+ * @param p is pointer to the page.
+ * @param k is the key object.
+ * @return index of the slot (number of keys if none).
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+int PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_leaf_lower_bound(const char* p, const K& k) {
+    int lo = 0, hi = _count(p);
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (_leaf_key(p, mid) < k) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/*!
+ * @brief This method returns the contiguous free space between the slots and the value heap of a leaf.
+ * @param p is pointer to the page.
+ * @return the free space in bytes.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+size_t PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_leaf_free(const char* p) {
+    return pageField<uint16_t>(p, 12) - _slot_offset(_count(p));
+}
+
+/*!
+ * @brief This method packs the live values of a leaf at the end of the page, reclaiming the space of
+ * removed and overwritten values.
+ * @param p is pointer to the page.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_leaf_compact(char* p) {
+    char copy[kPageSize];
+    std::memcpy(copy, p, kPageSize);
+    size_t heap = kPageSize;
+    for (int i = 0; i < _count(p); ++i) {
+        size_t slot = _slot_offset(i);
+        auto length = pageField<uint16_t>(copy, slot + kKeySize + 2);
+        heap -= length;
+        std::memcpy(p + heap, copy + pageField<uint16_t>(copy, slot + kKeySize), length);
+        setPageField<uint16_t>(p, slot + kKeySize, static_cast<uint16_t>(heap));
+    }
+    setPageField<uint16_t>(p, 12, static_cast<uint16_t>(heap));
+}
+
+/*!
+ * @brief This method inserts an encoded entry into the `i`-th slot of a leaf. The caller guarantees
+ * `kSlotSize + value.size()` bytes of free space.
+ * @param p is pointer to the page.
+ * @param i is index of the slot.
+ * @param key is pointer to the encoded key.
+ * @param value is the encoded value.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_leaf_insert(char* p, int i, const char* key,
+                                                              const std::string& value) {
+    int n = _count(p);
+    size_t slot = _slot_offset(i);
+    std::memmove(p + slot + kSlotSize, p + slot, (n - i) * kSlotSize);
+    auto heap = static_cast<uint16_t>(pageField<uint16_t>(p, 12) - value.size());
+    std::memcpy(p + heap, value.data(), value.size());
+    std::memcpy(p + slot, key, kKeySize);
+    setPageField<uint16_t>(p, slot + kKeySize, heap);
+    setPageField<uint16_t>(p, slot + kKeySize + 2, static_cast<uint16_t>(value.size()));
+    setPageField<uint16_t>(p, 12, heap);
+    setPageField<uint16_t>(p, 2, static_cast<uint16_t>(n + 1));
+}
+
+/*!
+ * @brief This method removes the `i`-th slot of a leaf. Its value stays in the heap until the next compaction.
+ * @param p is pointer to the page.
+ * @param i is index of the slot.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_leaf_erase(char* p, int i) {
+    int n = _count(p);
+    size_t slot = _slot_offset(i);
+    std::memmove(p + slot, p + slot + kSlotSize, (n - i - 1) * kSlotSize);
+    setPageField<uint16_t>(p, 2, static_cast<uint16_t>(n - 1));
+}
+
+/*!
+ * @brief This method descends to the leaf that holds (or would hold) the given key. The tree must not be empty.
+ * @param k is the key object.
+ * @return handle to the pinned leaf.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+PageHandle PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_find_leaf(const K& k) const {
+    auto page = pool_.fetch(root_);
+    while (!_is_leaf(page.data())) {
+        page = pool_.fetch(_child(page.data(), _child_index(page.data(), k)));
+    }
+    return page;
+}
+
+/*!
+ * @brief This method descends along the leftmost or rightmost edge of the tree.
+ * @param last is true for the rightmost leaf, false for the leftmost leaf.
+ * @return the leaf page number, or kNullPage if the tree is empty.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+page_id PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_edge_leaf(bool last) const {
+    if (kNullPage == root_) { return kNullPage; }
+    auto page = pool_.fetch(root_);
+    while (!_is_leaf(page.data())) {
+        page = pool_.fetch(_child(page.data(), last ? _count(page.data()) : 0));
+    }
+    return page.id();
+}
+
+/*!
+ * @brief This method stores a key-value pair, overwriting an existing value. The path from the root is
+ * recorded on the way down, so that splits can propagate upwards without parent pointers.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if the key was new, false if its value was overwritten.
+ * @throw std::length_error if the encoded value is too large for a page.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_put(const K& k, const V& v) {
+    std::string key, value;
+    KeyCodec::encode(k, key);
+    ValueCodec::encode(v, value);
+    if (kSlotSize + value.size() > kMaxEntry) { throw std::length_error("The value is too large for a page!"); }
+    if (kNullPage == root_) {
+        auto page = pool_.allocate();
+        _init_page(page.data(), true);
+        root_ = page.id();
+    }
+    std::vector<std::pair<page_id, int>> path{};  // Internal nodes visited and the child taken.
+    auto leaf = pool_.fetch(root_);
+    while (!_is_leaf(leaf.data())) {
+        int ci = _child_index(leaf.data(), k);
+        path.emplace_back(leaf.id(), ci);
+        leaf = pool_.fetch(_child(leaf.data(), ci));
+    }
+    char* p = leaf.data();
+    int i = _leaf_lower_bound(p, k);
+    bool found = i < _count(p) && _equal(_leaf_key(p, i), k);
+    if (found) { _leaf_erase(p, i); }  // The new value may differ in length.
+    leaf.markDirty();
+    if (_leaf_free(p) < kSlotSize + value.size()) { _leaf_compact(p); }
+    if (_leaf_free(p) >= kSlotSize + value.size()) {
+        _leaf_insert(p, i, key.data(), value);
+    } else {
+        _split_leaf(leaf, i, key, value, path);
+    }
+    if (!found) { ++size_; }
+    return !found;
+}
+
+/*!
+ * @brief This method splits a full leaf while inserting an entry. Entries are divided by bytes rather than by
+ * count, because values vary in length; the first key of the new right leaf is posted to the parent.
+ * @param leaf is the pinned leaf. It is released on return.
+ * @param i is index at which the entry belongs.
+ * @param key is the encoded key.
+ * @param value is the encoded value.
+ * @param path is the internal nodes visited on the way down.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_split_leaf(PageHandle& leaf, int i, const std::string& key,
+                                                             const std::string& value,
+                                                             std::vector<std::pair<page_id, int>>& path) {
+    char* p = leaf.data();
+    int n = _count(p);
+    std::vector<std::pair<std::string, std::string>> entries{};
+    entries.reserve(n + 1);
+    size_t total{};
+    for (int j = 0; j <= n; ++j) {
+        if (j == i) { entries.emplace_back(key, value); }
+        if (j < n) {
+            size_t slot = _slot_offset(j);
+            entries.emplace_back(std::string{p + slot, kKeySize},
+                                 std::string{p + pageField<uint16_t>(p, slot + kKeySize),
+                                             pageField<uint16_t>(p, slot + kKeySize + 2)});
+        }
+    }
+    for (const auto& entry : entries) { total += kSlotSize + entry.second.size(); }
+    int m = static_cast<int>(entries.size());
+    int s{};  // The right leaf starts at entries[s].
+    for (size_t left{}; s < m - 1 && (0 == s || left < total / 2); ++s) {
+        left += kSlotSize + entries[s].second.size();
+    }
+
+    page_id next = pageField<uint32_t>(p, 8);
+    auto right = pool_.allocate();
+    char* q = right.data();
+    _init_page(q, true);
+    setPageField<uint32_t>(q, 4, leaf.id());
+    setPageField<uint32_t>(q, 8, next);
+    for (int j = s; j < m; ++j) { _leaf_insert(q, j - s, entries[j].first.data(), entries[j].second); }
+    page_id prev = pageField<uint32_t>(p, 4);
+    _init_page(p, true);
+    setPageField<uint32_t>(p, 4, prev);
+    setPageField<uint32_t>(p, 8, right.id());
+    for (int j = 0; j < s; ++j) { _leaf_insert(p, j, entries[j].first.data(), entries[j].second); }
+    leaf.markDirty();
+    if (kNullPage != next) {
+        auto sibling = pool_.fetch(next);
+        setPageField<uint32_t>(sibling.data(), 4, right.id());
+        sibling.markDirty();
+    }
+    page_id left = leaf.id(), right_id = right.id();
+    leaf.release();  // The parents may need the frames.
+    right.release();
+    _insert_into_parent(path, left, entries[s].first, right_id);
+}
+
+/*!
+ * @brief This method posts a separator to the parent of a split node, splitting full parents in turn
+ * and growing a new root when the old root splits.
+ * @param path is the internal nodes visited on the way down; it is consumed.
+ * @param left is the split node.
+ * @param key is the encoded separator (the smallest key of `right`).
+ * @param right is the new right sibling of `left`.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBPlusTree<K, V, KeyCodec, ValueCodec>::_insert_into_parent(std::vector<std::pair<page_id, int>>& path,
+                                                                     page_id left, std::string key, page_id right) {
+    while (!path.empty()) {
+        auto [parent, ci] = path.back();
+        path.pop_back();
+        auto page = pool_.fetch(parent);
+        char* p = page.data();
+        int n = _count(p);
+        page.markDirty();
+        if (n < kMaxKeys) {
+            std::memmove(p + _internal_key_offset(ci + 1), p + _internal_key_offset(ci), (n - ci) * kKeySize);
+            std::memmove(p + _internal_child_offset(ci + 2), p + _internal_child_offset(ci + 1),
+                         (n - ci) * sizeof(page_id));
+            std::memcpy(p + _internal_key_offset(ci), key.data(), kKeySize);
+            setPageField<page_id>(p, _internal_child_offset(ci + 1), right);
+            setPageField<uint16_t>(p, 2, static_cast<uint16_t>(n + 1));
+            return;
+        }
+        // The parent is full: the middle of its n + 1 keys moves up.
+        std::string keys{p + _internal_key_offset(0), n * kKeySize};
+        keys.insert(ci * kKeySize, key);
+        std::vector<page_id> children(n + 1);
+        for (int j = 0; j <= n; ++j) { children[j] = _child(p, j); }
+        children.insert(children.begin() + ci + 1, right);
+        int m = (n + 1) / 2;
+        auto sibling = pool_.allocate();
+        char* q = sibling.data();
+        _init_page(q, false);
+        std::memcpy(q + _internal_key_offset(0), keys.data() + (m + 1) * kKeySize, (n - m) * kKeySize);
+        for (int j = m + 1; j <= n + 1; ++j) {
+            setPageField<page_id>(q, _internal_child_offset(j - m - 1), children[j]);
+        }
+        setPageField<uint16_t>(q, 2, static_cast<uint16_t>(n - m));
+        std::memcpy(p + _internal_key_offset(0), keys.data(), m * kKeySize);
+        for (int j = 0; j <= m; ++j) { setPageField<page_id>(p, _internal_child_offset(j), children[j]); }
+        setPageField<uint16_t>(p, 2, static_cast<uint16_t>(m));
+        key = keys.substr(m * kKeySize, kKeySize);
+        left = parent;
+        right = sibling.id();
+    }
+    auto root = pool_.allocate();
+    char* p = root.data();
+    _init_page(p, false);
+    std::memcpy(p + _internal_key_offset(0), key.data(), kKeySize);
+    setPageField<page_id>(p, _internal_child_offset(0), left);
+    setPageField<page_id>(p, _internal_child_offset(1), right);
+    setPageField<uint16_t>(p, 2, 1);
+    root_ = root.id();
+}
+
+/*!
+ * @brief This constructor positions the iterator at the `i`-th slot of a leaf, moving on to the next
+ * non-empty leaf if the slot does not exist.
+ * @param tree is pointer to the tree.
+ * @param leaf is the leaf page number (kNullPage for the end).
+ * @param i is index of the slot.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::ConstIterator(const PagedBPlusTree* tree, page_id leaf,
+                                                                         int i)
+    : tree_(tree), leaf_(leaf), i_(i) {
+    _skip_forward();
+    _load();
+}
+
+/*!
+ * @brief This method moves past the end of the current leaf, and past empty leaves, if needed.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::_skip_forward() {
+    while (kNullPage != leaf_) {
+        auto page = tree_->pool_.fetch(leaf_);
+        if (i_ < _count(page.data())) { return; }
+        leaf_ = pageField<uint32_t>(page.data(), 8);
+        i_ = 0;
+    }
+    i_ = 0;
+}
+
+/*!
+ * @brief This method decodes the current entry.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::_load() {
+    if (kNullPage == leaf_) { return; }
+    auto page = tree_->pool_.fetch(leaf_);
+    entry_ = {_leaf_key(page.data(), i_), _leaf_value(page.data(), i_)};
+}
+
+/*!
+ * @brief This operator returns the current entry.
+ * @return copy of the key-value pair.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::reference
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::operator*() const {
+    return entry_;
+}
+
+/*!
+ * @brief This method returns the current key.
+ * @return reference to the key decoded into the iterator.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+const K& PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::key() const {
+    return entry_.first;
+}
+
+/*!
+ * @brief This method returns the current value.
+ * @return reference to the value decoded into the iterator.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+const V& PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::value() const {
+    return entry_.second;
+}
+
+/*!
+ * @brief This operator advances to the next key.
+ * @return reference to this iterator.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator&
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::operator++() {
+    ++i_;
+    _skip_forward();
+    _load();
+    return *this;
+}
+
+/*!
+ * @brief This operator advances to the next key.
+ * @return copy of the iterator before advancing.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::operator++(int) {
+    auto copy = *this;
+    ++*this;
+    return copy;
+}
+
+/*!
+ * @brief This operator moves back to the previous key, skipping empty leaves. Decrementing the end iterator
+ * yields the largest key.
+ * @return reference to this iterator.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator&
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::operator--() {
+    if (kNullPage == leaf_) {
+        leaf_ = tree_->_edge_leaf(true);
+        i_ = _count(tree_->pool_.fetch(leaf_).data());
+    }
+    while (0 == i_) {
+        leaf_ = pageField<uint32_t>(tree_->pool_.fetch(leaf_).data(), 4);
+        i_ = _count(tree_->pool_.fetch(leaf_).data());
+    }
+    --i_;
+    _load();
+    return *this;
+}
+
+/*!
+ * @brief This operator moves back to the previous key.
+ * @return copy of the iterator before moving.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator
+PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::operator--(int) {
+    auto copy = *this;
+    --*this;
+    return copy;
+}
+
+/*!
+ * @brief This operator checks if two iterators refer to the same slot.
+ * @param rhs is the other iterator.
+ * @return true if equal, false otherwise.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::operator==(const ConstIterator& rhs) const {
+    return tree_ == rhs.tree_ && leaf_ == rhs.leaf_ && i_ == rhs.i_;
+}
+
+/*!
+ * @brief This operator checks if two iterators refer to different slots.
+ * @param rhs is the other iterator.
+ * @return true if not equal, false otherwise.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBPlusTree<K, V, KeyCodec, ValueCodec>::ConstIterator::operator!=(const ConstIterator& rhs) const {
+    return !(*this == rhs);
+}
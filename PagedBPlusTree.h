@@ -0,0 +1,147 @@
+/*!
+ * @brief This file contains the class definition of <em>PagedBPlusTree</em>.
+ */
+#ifndef CS225_SP22_C2_PAGEDBPLUSTREE_H_
+#define CS225_SP22_C2_PAGEDBPLUSTREE_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <iterator>
+#include "bufferPool.h"
+#include "codec.h"
+
+/*!
+ * @brief This class implements a B+-tree stored in fixed-size pages of a file and cached by a <em>BufferPool</em>.
+ * Page 0 holds the metadata, so reopening an existing file reads one page instead of rebuilding the index.
+ * Internal pages hold fixed-size keys and child page numbers; leaf pages hold sorted key slots whose
+ * variable-length values grow from the end of the page. Removal leaves underfull leaves in place (their space
+ * is reused by later insertions), as most disk-based B+-trees do.
+ * Modifications reach the file when pages are evicted and on `checkpoint()`, but reopening the file (even after a
+ * crash) sees the last checkpoint only; the destructor checkpoints.
+ * @tparam K is type of key objects.
+ * @tparam V is type of value objects.
+ * @tparam KeyCodec serializes keys into exactly `KeyCodec::fixed_size` bytes.
+ * @tparam ValueCodec serializes values.
+ */
+template<typename K, typename V, typename KeyCodec = Codec<K>, typename ValueCodec = Codec<V>>
+class PagedBPlusTree {
+    static constexpr size_t kKeySize{KeyCodec::fixed_size};
+    static constexpr size_t kHeaderSize{16};
+    static constexpr size_t kSlotSize{kKeySize + 4};  // Key, value offset and value length.
+    static constexpr size_t kMaxEntry{(kPageSize - kHeaderSize) / 4};  // So that a split always makes room.
+    static constexpr int kMaxKeys{static_cast<int>((kPageSize - kHeaderSize - 4) / (kKeySize + 4))};
+    static_assert(kMaxKeys >= 3, "Keys are too large for a page.");
+    static constexpr char kMagic[9]{"RQRSBPT1"};  // First bytes of the metadata page.
+public:
+    /*!
+     * @brief This class walks the leaf chain in key order, in both directions. The current entry is decoded
+     * into the iterator, so dereferencing yields a copy. It is invalidated by any modification of the tree.
+     */
+    class ConstIterator {
+        friend PagedBPlusTree;
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type;  // Entries are decoded, not referenced.
+        using pointer = void;
+
+        ConstIterator() = default;
+        reference operator*() const;
+        [[nodiscard]] const K& key() const;
+        [[nodiscard]] const V& value() const;
+        ConstIterator& operator++();
+        ConstIterator operator++(int);
+        ConstIterator& operator--();
+        ConstIterator operator--(int);
+        bool operator==(const ConstIterator& rhs) const;
+        bool operator!=(const ConstIterator& rhs) const;
+
+    private:
+        ConstIterator(const PagedBPlusTree* tree, page_id leaf, int i);
+        void _skip_forward();
+        void _load();
+
+        const PagedBPlusTree* tree_{nullptr};
+        page_id leaf_{kNullPage};  // kNullPage for the past-the-end iterator.
+        int i_{};
+        value_type entry_{};
+    };
+    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+    /*!
+     * @brief This class holds a half-open range of the tree, usable in range-based for loops.
+     */
+    class Range {
+    public:
+        Range(ConstIterator first, ConstIterator last) : first_(first), last_(last) {}
+        ConstIterator begin() const { return first_; }
+        ConstIterator end() const { return last_; }
+        ConstReverseIterator rbegin() const { return ConstReverseIterator{last_}; }
+        ConstReverseIterator rend() const { return ConstReverseIterator{first_}; }
+        [[nodiscard]] bool empty() const { return first_ == last_; }
+
+    private:
+        ConstIterator first_;
+        ConstIterator last_;
+    };
+
+    explicit PagedBPlusTree(const std::string& path, size_t frames = 256);
+    PagedBPlusTree(const PagedBPlusTree& tree) = delete;
+    PagedBPlusTree& operator=(const PagedBPlusTree& tree) = delete;
+    virtual ~PagedBPlusTree();
+
+    void insert(K k, V v);
+    bool upsert(K k, V v);
+    bool remove(const K& k);
+    [[nodiscard]] bool contains(const K& k) const;
+    [[nodiscard]] std::optional<V> find(const K& k) const;
+    template<typename F> bool visit(const K& k, F&& f) const;
+    template<typename F> bool update(const K& k, F&& f);
+    [[nodiscard]] size_t size() const;
+    void checkpoint();
+    [[nodiscard]] const BufferPool& pool() const;
+    ConstIterator begin() const;
+    ConstIterator end() const;
+    ConstReverseIterator rbegin() const;
+    ConstReverseIterator rend() const;
+    ConstIterator lower_bound(const K& k) const;
+    Range range(const K& lo, const K& hi) const;
+
+private:
+    static int _count(const char* p);
+    static bool _is_leaf(const char* p);
+    static void _init_page(char* p, bool leaf);
+    static K _key(const char* p, size_t offset);
+    static bool _equal(const K& a, const K& b);
+
+    static size_t _internal_key_offset(int i);
+    static size_t _internal_child_offset(int i);
+    static page_id _child(const char* p, int i);
+    static int _child_index(const char* p, const K& k);
+
+    static size_t _slot_offset(int i);
+    static K _leaf_key(const char* p, int i);
+    static V _leaf_value(const char* p, int i);
+    static int _leaf_lower_bound(const char* p, const K& k);
+    static size_t _leaf_free(const char* p);
+    static void _leaf_compact(char* p);
+    static void _leaf_insert(char* p, int i, const char* key, const std::string& value);
+    static void _leaf_erase(char* p, int i);
+
+    PageHandle _find_leaf(const K& k) const;
+    page_id _edge_leaf(bool last) const;
+    bool _put(const K& k, const V& v);
+    void _split_leaf(PageHandle& leaf, int i, const std::string& key, const std::string& value,
+                     std::vector<std::pair<page_id, int>>& path);
+    void _insert_into_parent(std::vector<std::pair<page_id, int>>& path, page_id left, std::string key,
+                             page_id right);
+
+    mutable BufferPool pool_;  // Lookups change what is cached, not what is stored.
+    page_id root_{kNullPage};
+    size_t size_{};
+};
+
+#endif //CS225_SP22_C2_PAGEDBPLUSTREE_H_
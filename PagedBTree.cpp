@@ -0,0 +1,601 @@
+/*!
+ * @brief This file contains the implementation of class <em>PagedBTree</em>.
+ *
+ * Page layouts (offsets in bytes):
+ *  - Metadata (page 0): magic [0, 8), page size [8, 12), root [16, 20), number of keys [24, 32).
+ *  - Node: leaf tag [0], number of keys [2, 4), leftmost child [4, 8), start of the cell area [8, 10),
+ *    then one 2-byte cell offset per key, in key order.
+ *  - Cell: right child [0, 4), key length [4, 6), value length or `kTombstone` [6, 8), key bytes, value bytes.
+ */
+#include "PagedBTree.h"
+#include "utilities.h"
+#include <cstring>
+#include <stdexcept>
+
+/*!
+ * @brief This constructor opens the tree stored in the given file, or creates an empty one.
+ * @param path is path to the database file.
+ * @param frames is number of pages cached in memory, which bounds the memory used by the tree.
+ * @throw IOError if the file cannot be opened or was not written by this tree.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+PagedBTree<K, V, KeyCodec, ValueCodec>::PagedBTree(const std::string& path, size_t frames) : pool_(path, frames) {
+    if (0 == pool_.pageCount()) {  // A new file.
+        auto meta = pool_.allocate();
+        std::memcpy(meta.data(), kMagic, 8);
+        setPageField<uint32_t>(meta.data(), 8, kPageSize);
+        setPageField<uint32_t>(meta.data(), 16, kNullPage);
+        setPageField<uint64_t>(meta.data(), 24, 0);
+        return;
+    }
+    auto meta = pool_.fetch(0);
+    if (0 != std::memcmp(meta.data(), kMagic, 8) || kPageSize != pageField<uint32_t>(meta.data(), 8)) {
+        throw IOError();
+    }
+    root_ = pageField<uint32_t>(meta.data(), 16);
+    size_ = pageField<uint64_t>(meta.data(), 24);
+}
+
+/*!
+ * @brief This destructor checkpoints the tree.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+PagedBTree<K, V, KeyCodec, ValueCodec>::~PagedBTree() {
+    try {
+        checkpoint();
+    } catch (const IOError& error) {
+        std::cerr << error.what() << std::endl;
+    }
+}
+
+/*!
+ * @brief This method inserts the given key-value pair, overwriting the value if the key already exists.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @throw std::length_error if the encoded pair is too large for a page.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBTree<K, V, KeyCodec, ValueCodec>::insert(K k, V v) {
+    _put(k, v);
+}
+
+/*!
+ * @brief This method overwrites the value of the given key, or inserts the pair if the key is absent.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if the pair was inserted, false if an existing value was overwritten.
+ * @throw std::length_error if the encoded pair is too large for a page.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBTree<K, V, KeyCodec, ValueCodec>::upsert(K k, V v) {
+    return _put(k, v);
+}
+
+/*!
+ * @brief This method removes the given key. A key in a leaf is erased; a key in an internal node becomes a
+ * tombstone, so no node is ever merged or rebalanced.
+ * @param k is the key object.
+ * @return true if the key was removed, false if not found.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBTree<K, V, KeyCodec, ValueCodec>::remove(const K& k) {
+    if (kNullPage == root_) { return false; }
+    int i;
+    bool found;
+    auto page = _locate(k, i, found);
+    char* p = page.data();
+    if (!found || _is_tombstone(p, i)) { return false; }
+    if (_is_leaf(p)) {
+        _erase_cell(p, i);
+    } else {
+        auto cell = _cell(p, i);
+        cell.value_.clear();
+        cell.tombstone_ = true;
+        _erase_cell(p, i);
+        _make_room(p, _cell_size(cell) + 2);  // Always succeeds: the cell shrank.
+        _insert_cell(p, i, cell);
+    }
+    page.markDirty();
+    --size_;
+    return true;
+}
+
+/*!
+ * @brief This method checks if the given key exists in the tree. The value is not decoded.
+ * @param k is the key object.
+ * @return true if exists, false if not exists.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBTree<K, V, KeyCodec, ValueCodec>::contains(const K& k) const {
+    if (kNullPage == root_) { return false; }
+    int i;
+    bool found;
+    auto page = _locate(k, i, found);
+    return found && !_is_tombstone(page.data(), i);
+}
+
+/*!
+ * @brief This method looks up a key and decodes its value.
+ * @param k is the key object.
+ * @return copy of the value object, or an empty optional if not found.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+std::optional<V> PagedBTree<K, V, KeyCodec, ValueCodec>::find(const K& k) const {
+    if (kNullPage == root_) { return std::nullopt; }
+    int i;
+    bool found;
+    auto page = _locate(k, i, found);
+    if (!found || _is_tombstone(page.data(), i)) { return std::nullopt; }
+    return _value(page.data(), i);
+}
+
+/*!
+ * @brief This method calls `f` on the decoded value of the given key, if present.
+ * @tparam F is type of the callable, invoked as `f(const V&)`.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+template<typename F>
+bool PagedBTree<K, V, KeyCodec, ValueCodec>::visit(const K& k, F&& f) const {
+    auto v = find(k);
+    if (!v) { return false; }
+    std::forward<F>(f)(std::as_const(*v));
+    return true;
+}
+
+/*!
+ * @brief This method decodes the value of the given key, lets `f` modify it and stores it back.
+ * @tparam F is type of the callable, invoked as `f(V&)`.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ * @throw std::length_error if the modified value is too large for a page.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+template<typename F>
+bool PagedBTree<K, V, KeyCodec, ValueCodec>::update(const K& k, F&& f) {
+    auto v = find(k);
+    if (!v) { return false; }
+    std::forward<F>(f)(*v);
+    _put(k, *v);
+    return true;
+}
+
+/*!
+ * @brief This method calls `f` on the keys in `[lo, hi)` and their values in key order, and stops early after
+ * `limit` of them. Only the pages on the way to `lo` and those holding the visited keys are read.
+ * @tparam F is type of the callable, invoked as `f(const K&, const V&)`.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the exclusive upper bound.
+ * @param limit is the maximum number of keys to visit.
+ * @param f is the callable.
+ * @return the number of keys visited.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+template<typename F>
+size_t PagedBTree<K, V, KeyCodec, ValueCodec>::range(const K& lo, const K& hi, size_t limit, F&& f) const {
+    size_t count{};
+    if (kNullPage == root_ || 0 == limit || !(lo < hi)) { return count; }
+    auto visitor = [&](const K& k, const V& v) {
+        if (!(k < hi)) { return false; }
+        f(k, v);
+        return ++count < limit;
+    };
+    _scan(root_, lo, visitor);
+    return count;
+}
+
+/*!
+ * @brief This method calls `f` on the keys that start with `prefix` and their values in key order, and stops early
+ * after `limit` of them. Such keys are contiguous from the first key not less than `prefix`, so only the pages on
+ * the way there and those holding the visited keys are read. `K` must be constructible from and comparable to
+ * `std::string_view` (e.g. `std::string`).
+ * @tparam F is type of the callable, invoked as `f(const K&, const V&)`.
+ * @param prefix is the prefix, which may be empty.
+ * @param limit is the maximum number of keys to visit.
+ * @param f is the callable.
+ * @return the number of keys visited.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+template<typename F>
+size_t PagedBTree<K, V, KeyCodec, ValueCodec>::prefix_scan(std::string_view prefix, size_t limit, F&& f) const {
+    size_t count{};
+    if (kNullPage == root_ || 0 == limit) { return count; }
+    auto visitor = [&](const K& k, const V& v) {
+        if (0 != k.compare(0, prefix.size(), prefix)) { return false; }
+        f(k, v);
+        return ++count < limit;
+    };
+    _scan(root_, K{prefix}, visitor);
+    return count;
+}
+
+/*!
+ * @brief This method returns number of keys in the tree (tombstones excluded).
+ * @return the number of keys.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+size_t PagedBTree<K, V, KeyCodec, ValueCodec>::size() const {
+    return size_;
+}
+
+/*!
+ * @brief This method records the root and size in the metadata page and writes every dirty page back.
+ * When it returns, reopening the file yields the current tree.
+ * @throw IOError if a page cannot be written.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBTree<K, V, KeyCodec, ValueCodec>::checkpoint() {
+    {
+        auto meta = pool_.fetch(0);
+        setPageField<uint32_t>(meta.data(), 16, root_);
+        setPageField<uint64_t>(meta.data(), 24, size_);
+        meta.markDirty();
+    }
+    pool_.flush();
+}
+
+/*!
+ * @brief This method returns the buffer pool, e.g. to read its counters.
+ * @return reference to the buffer pool.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+const BufferPool& PagedBTree<K, V, KeyCodec, ValueCodec>::pool() const {
+    return pool_;
+}
+
+/*!
+ * @brief This method returns number of keys in a node, tombstones included.
+ * @param p is pointer to the page.
+ * @return the number of keys.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+int PagedBTree<K, V, KeyCodec, ValueCodec>::_count(const char* p) {
+    return pageField<uint16_t>(p, 2);
+}
+
+/*!
+ * @brief This method checks if a node is a leaf.
+ * @param p is pointer to the page.
+ * @return true if it is, false otherwise.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBTree<K, V, KeyCodec, ValueCodec>::_is_leaf(const char* p) {
+    return 0 != p[0];
+}
+
+/*!
+ * @brief This method resets the header of a page to an empty node.
+ * @param p is pointer to the page.
+ * @param leaf is true for a leaf, false for an internal node.
+ * @param first_child is the leftmost child (kNullPage for a leaf).
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBTree<K, V, KeyCodec, ValueCodec>::_init_page(char* p, bool leaf, page_id first_child) {
+    std::memset(p, 0, kHeaderSize);
+    p[0] = static_cast<char>(leaf);
+    setPageField<uint32_t>(p, 4, first_child);
+    setPageField<uint16_t>(p, 8, static_cast<uint16_t>(kPageSize));
+}
+
+/*!
+ * @brief This method returns the offset of the `i`-th cell of a node.
+ * @param p is pointer to the page.
+ * @param i is index of the key.
+ * @return the offset.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+size_t PagedBTree<K, V, KeyCodec, ValueCodec>::_cell_offset(const char* p, int i) {
+    return pageField<uint16_t>(p, kHeaderSize + 2 * static_cast<size_t>(i));
+}
+
+/*!
+ * @brief This method decodes the `i`-th key of a node.
+ * @param p is pointer to the page.
+ * @param i is index of the key.
+ * @return the key object.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+K PagedBTree<K, V, KeyCodec, ValueCodec>::_key(const char* p, int i) {
+    size_t cell = _cell_offset(p, i);
+    return KeyCodec::decode(p + cell + kCellHeaderSize, pageField<uint16_t>(p, cell + 4));
+}
+
+/*!
+ * @brief This method checks if the `i`-th key of a node has been removed.
+ * @param p is pointer to the page.
+ * @param i is index of the key.
+ * @return true if it is a tombstone, false otherwise.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBTree<K, V, KeyCodec, ValueCodec>::_is_tombstone(const char* p, int i) {
+    return kTombstone == pageField<uint16_t>(p, _cell_offset(p, i) + 6);
+}
+
+/*!
+ * @brief This method decodes the `i`-th value of a node, which must not be a tombstone.
+ * @param p is pointer to the page.
+ * @param i is index of the key.
+ * @return the value object.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+V PagedBTree<K, V, KeyCodec, ValueCodec>::_value(const char* p, int i) {
+    size_t cell = _cell_offset(p, i);
+    return ValueCodec::decode(p + cell + kCellHeaderSize + pageField<uint16_t>(p, cell + 4),
+                              pageField<uint16_t>(p, cell + 6));
+}
+
+/*!
+ * @brief This method returns the `i`-th child of an internal node: the leftmost child for 0, otherwise the
+ * right child of key `i - 1`.
+ * @param p is pointer to the page.
+ * @param i is index of the child.
+ * @return the child page number.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+page_id PagedBTree<K, V, KeyCodec, ValueCodec>::_child(const char* p, int i) {
+    return 0 == i ? pageField<uint32_t>(p, 4) : pageField<uint32_t>(p, _cell_offset(p, i - 1));
+}
+
+/*!
+ * @brief This method finds the first key of a node not less than `k`.
+ * @param p is pointer to the page.
+ * @param k is the key object.
+ * @param found is set to true if that key is equivalent to `k`.
+ * @return index of the key (number of keys if none), which is also the child to descend into.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+int PagedBTree<K, V, KeyCodec, ValueCodec>::_search(const char* p, const K& k, bool& found) {
+    int lo = 0, hi = _count(p);
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (_key(p, mid) < k) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    found = lo < _count(p) && !(k < _key(p, lo));
+    return lo;
+}
+
+/*!
+ * @brief This method copies the `i`-th cell of a node out of the page.
+ * @param p is pointer to the page.
+ * @param i is index of the key.
+ * @return the cell.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+typename PagedBTree<K, V, KeyCodec, ValueCodec>::Cell PagedBTree<K, V, KeyCodec, ValueCodec>::_cell(const char* p,
+                                                                                                     int i) {
+    size_t cell = _cell_offset(p, i);
+    auto key_length = pageField<uint16_t>(p, cell + 4);
+    auto value_length = pageField<uint16_t>(p, cell + 6);
+    const char* key = p + cell + kCellHeaderSize;
+    if (kTombstone == value_length) { return Cell{pageField<uint32_t>(p, cell), {key, key_length}, {}, true}; }
+    return Cell{pageField<uint32_t>(p, cell), {key, key_length}, {key + key_length, value_length}, false};
+}
+
+/*!
+ * @brief This method returns the bytes a cell occupies in the cell area.
+ * @param cell is the cell.
+ * @return the size in bytes.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+size_t PagedBTree<K, V, KeyCodec, ValueCodec>::_cell_size(const Cell& cell) {
+    return kCellHeaderSize + cell.key_.size() + (cell.tombstone_ ? 0 : cell.value_.size());
+}
+
+/*!
+ * @brief This method makes sure a node has the given contiguous free space, compacting it if needed.
+ * @param p is pointer to the page.
+ * @param bytes is the space needed.
+ * @return true if the space is available, false if the node must be split.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBTree<K, V, KeyCodec, ValueCodec>::_make_room(char* p, size_t bytes) {
+    auto free = [p]() { return pageField<uint16_t>(p, 8) - (kHeaderSize + 2 * static_cast<size_t>(_count(p))); };
+    if (free() < bytes) { _compact(p); }
+    return free() >= bytes;
+}
+
+/*!
+ * @brief This method packs the live cells of a node at the end of the page, reclaiming the space of erased
+ * and overwritten cells.
+ * @param p is pointer to the page.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBTree<K, V, KeyCodec, ValueCodec>::_compact(char* p) {
+    char copy[kPageSize];
+    std::memcpy(copy, p, kPageSize);
+    size_t heap = kPageSize;
+    for (int i = 0; i < _count(p); ++i) {
+        size_t cell = _cell_offset(copy, i);
+        auto value_length = pageField<uint16_t>(copy, cell + 6);
+        size_t size = kCellHeaderSize + pageField<uint16_t>(copy, cell + 4);
+        size += kTombstone == value_length ? 0 : value_length;
+        heap -= size;
+        std::memcpy(p + heap, copy + cell, size);
+        setPageField<uint16_t>(p, kHeaderSize + 2 * static_cast<size_t>(i), static_cast<uint16_t>(heap));
+    }
+    setPageField<uint16_t>(p, 8, static_cast<uint16_t>(heap));
+}
+
+/*!
+ * @brief This method inserts a cell as the `i`-th key of a node. The caller guarantees the space.
+ * @param p is pointer to the page.
+ * @param i is index of the key.
+ * @param cell is the cell.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBTree<K, V, KeyCodec, ValueCodec>::_insert_cell(char* p, int i, const Cell& cell) {
+    int n = _count(p);
+    size_t slot = kHeaderSize + 2 * static_cast<size_t>(i);
+    std::memmove(p + slot + 2, p + slot, 2 * static_cast<size_t>(n - i));
+    auto heap = static_cast<uint16_t>(pageField<uint16_t>(p, 8) - _cell_size(cell));
+    setPageField<uint32_t>(p, heap, cell.child_);
+    setPageField<uint16_t>(p, heap + 4, static_cast<uint16_t>(cell.key_.size()));
+    setPageField<uint16_t>(p, heap + 6, cell.tombstone_ ? kTombstone : static_cast<uint16_t>(cell.value_.size()));
+    std::memcpy(p + heap + kCellHeaderSize, cell.key_.data(), cell.key_.size());
+    if (!cell.tombstone_) {
+        std::memcpy(p + heap + kCellHeaderSize + cell.key_.size(), cell.value_.data(), cell.value_.size());
+    }
+    setPageField<uint16_t>(p, slot, heap);
+    setPageField<uint16_t>(p, 8, heap);
+    setPageField<uint16_t>(p, 2, static_cast<uint16_t>(n + 1));
+}
+
+/*!
+ * @brief This method removes the `i`-th key of a node. Its cell stays in place until the next compaction.
+ * @param p is pointer to the page.
+ * @param i is index of the key.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBTree<K, V, KeyCodec, ValueCodec>::_erase_cell(char* p, int i) {
+    int n = _count(p);
+    size_t slot = kHeaderSize + 2 * static_cast<size_t>(i);
+    std::memmove(p + slot, p + slot + 2, 2 * static_cast<size_t>(n - i - 1));
+    setPageField<uint16_t>(p, 2, static_cast<uint16_t>(n - 1));
+}
+
+/*!
+ * @brief This method descends until it finds the given key (possibly a tombstone) or reaches a leaf.
+ * The tree must not be empty.
+ * @param k is the key object.
+ * @param i is set to index of the key in the returned node (or where it would be inserted).
+ * @param found is set to true if the key was found.
+ * @return handle to the pinned node.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+PageHandle PagedBTree<K, V, KeyCodec, ValueCodec>::_locate(const K& k, int& i, bool& found) const {
+    auto page = pool_.fetch(root_);
+    while (true) {
+        i = _search(page.data(), k, found);
+        if (found || _is_leaf(page.data())) { return page; }
+        page = pool_.fetch(_child(page.data(), i));
+    }
+}
+
+/*!
+ * @brief This method visits the keys of a subtree not less than `lo` in key order, skipping tombstones, until the
+ * callable returns false. The pages on the current path stay pinned.
+ * @tparam F is type of the callable, invoked as `bool f(const K&, const V&)`; false stops the scan.
+ * @param id is the root page of the subtree.
+ * @param lo is the inclusive lower bound.
+ * @param f is the callable.
+ * @return false if the scan was stopped, true otherwise.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+template<typename F>
+bool PagedBTree<K, V, KeyCodec, ValueCodec>::_scan(page_id id, const K& lo, F& f) const {
+    auto page = pool_.fetch(id);
+    bool found;
+    int i = _search(page.data(), lo, found);
+    bool leaf = _is_leaf(page.data());
+    if (!leaf && !found && !_scan(_child(page.data(), i), lo, f)) { return false; }  // Child i may hold keys >= lo.
+    for (int n = _count(page.data()); i < n; ++i) {
+        if (!_is_tombstone(page.data(), i) && !f(_key(page.data(), i), _value(page.data(), i))) { return false; }
+        if (!leaf && !_scan(_child(page.data(), i + 1), lo, f)) { return false; }
+    }
+    return true;
+}
+
+/*!
+ * @brief This method stores a key-value pair, overwriting (or reviving) the key where it is found and
+ * inserting it into a leaf otherwise. The path from the root is recorded for splits.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if the key was new, false if its value was overwritten.
+ * @throw std::length_error if the encoded pair is too large for a page.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+bool PagedBTree<K, V, KeyCodec, ValueCodec>::_put(const K& k, const V& v) {
+    Cell cell{};
+    KeyCodec::encode(k, cell.key_);
+    ValueCodec::encode(v, cell.value_);
+    if (_cell_size(cell) + 2 > kMaxEntry) { throw std::length_error("The key and value are too large for a page!"); }
+    if (kNullPage == root_) {
+        auto page = pool_.allocate();
+        _init_page(page.data(), true, kNullPage);
+        root_ = page.id();
+    }
+    std::vector<std::pair<page_id, int>> path{};  // Internal nodes visited and the child taken.
+    auto page = pool_.fetch(root_);
+    while (true) {
+        char* p = page.data();
+        bool found;
+        int i = _search(p, k, found);
+        if (found) {
+            bool revived = _is_tombstone(p, i);
+            cell.child_ = pageField<uint32_t>(p, _cell_offset(p, i));
+            _erase_cell(p, i);
+            _insert(path, std::move(page), i, std::move(cell));
+            if (revived) { ++size_; }
+            return revived;
+        }
+        if (_is_leaf(p)) {
+            _insert(path, std::move(page), i, std::move(cell));
+            ++size_;
+            return true;
+        }
+        path.emplace_back(page.id(), i);
+        page = pool_.fetch(_child(p, i));
+    }
+}
+
+/*!
+ * @brief This method inserts a cell as the `i`-th key of a node. A full node is split by bytes: the middle
+ * cell moves up to the parent, with the new right node as its right child, and full parents split in turn.
+ * @param path is the internal nodes visited on the way down; it is consumed.
+ * @param page is the pinned node.
+ * @param i is index of the key.
+ * @param cell is the cell.
+ */
+template<typename K, typename V, typename KeyCodec, typename ValueCodec>
+void PagedBTree<K, V, KeyCodec, ValueCodec>::_insert(std::vector<std::pair<page_id, int>>& path, PageHandle page,
+                                                     int i, Cell cell) {
+    while (true) {
+        char* p = page.data();
+        page.markDirty();
+        if (_make_room(p, _cell_size(cell) + 2)) {
+            _insert_cell(p, i, cell);
+            return;
+        }
+        int n = _count(p);
+        std::vector<Cell> cells{};
+        cells.reserve(n + 1);
+        size_t total{};
+        for (int j = 0; j < n; ++j) { cells.push_back(_cell(p, j)); }
+        cells.insert(cells.begin() + i, std::move(cell));
+        for (const auto& c : cells) { total += _cell_size(c) + 2; }
+        int m = static_cast<int>(cells.size());
+        int s{};  // cells[s] moves up; at least one cell stays on each side.
+        for (size_t left{}; s < m - 2 && (0 == s || left < total / 2); ++s) {
+            left += _cell_size(cells[s]) + 2;
+        }
+
+        bool leaf = _is_leaf(p);
+        auto right = pool_.allocate();
+        _init_page(right.data(), leaf, cells[s].child_);
+        for (int j = s + 1; j < m; ++j) { _insert_cell(right.data(), j - s - 1, cells[j]); }
+        _init_page(p, leaf, pageField<uint32_t>(p, 4));
+        for (int j = 0; j < s; ++j) { _insert_cell(p, j, cells[j]); }
+        cell = std::move(cells[s]);
+        cell.child_ = right.id();
+        page_id left = page.id();
+        page.release();
+        right.release();
+        if (path.empty()) {  // The root was split.
+            auto root = pool_.allocate();
+            _init_page(root.data(), false, left);
+            _insert_cell(root.data(), 0, cell);
+            root_ = root.id();
+            return;
+        }
+        page = pool_.fetch(path.back().first);
+        i = path.back().second;
+        path.pop_back();
+    }
+}
@@ -0,0 +1,92 @@
+/*!
+ * @brief This file contains the class definition of <em>PagedBTree</em>.
+ */
+#ifndef CS225_SP22_C2_PAGEDBTREE_H_
+#define CS225_SP22_C2_PAGEDBTREE_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <optional>
+#include "bufferPool.h"
+#include "codec.h"
+
+/*!
+ * @brief This class implements a B-tree whose nodes are slotted pages of a file, cached by a bounded
+ * <em>BufferPool</em>: memory use is capped by the number of frames, not by the number of keys.
+ * Keys and values may vary in length. Each page keeps a sorted array of 2-byte cell offsets after its header;
+ * cells (right child, key, value) are packed from the end of the page and compacted when space runs out.
+ * As in any B-tree, keys of internal nodes carry values too. Removing such a key leaves a tombstone, which
+ * still separates the subtrees, so removal never restructures the tree; reinserting the key revives it.
+ * Modifications reach the file when pages are evicted and on `checkpoint()`, but reopening the file (even after a
+ * crash) sees the last checkpoint only; the destructor checkpoints.
+ * @tparam K is type of key objects.
+ * @tparam V is type of value objects.
+ * @tparam KeyCodec serializes keys.
+ * @tparam ValueCodec serializes values.
+ */
+template<typename K, typename V, typename KeyCodec = Codec<K>, typename ValueCodec = Codec<V>>
+class PagedBTree {
+    static constexpr size_t kHeaderSize{16};
+    static constexpr size_t kCellHeaderSize{8};  // Right child, key length and value length.
+    static constexpr size_t kMaxEntry{(kPageSize - kHeaderSize) / 4};  // So that a split always makes room.
+    static constexpr uint16_t kTombstone{UINT16_MAX};  // Value length of a removed key.
+    static constexpr char kMagic[9]{"RQRSBT01"};  // First bytes of the metadata page.
+public:
+    explicit PagedBTree(const std::string& path, size_t frames = 256);
+    PagedBTree(const PagedBTree& tree) = delete;
+    PagedBTree& operator=(const PagedBTree& tree) = delete;
+    virtual ~PagedBTree();
+
+    void insert(K k, V v);
+    bool upsert(K k, V v);
+    bool remove(const K& k);
+    [[nodiscard]] bool contains(const K& k) const;
+    [[nodiscard]] std::optional<V> find(const K& k) const;
+    template<typename F> bool visit(const K& k, F&& f) const;
+    template<typename F> bool update(const K& k, F&& f);
+    template<typename F> size_t range(const K& lo, const K& hi, size_t limit, F&& f) const;
+    template<typename F> size_t prefix_scan(std::string_view prefix, size_t limit, F&& f) const;
+    [[nodiscard]] size_t size() const;
+    void checkpoint();
+    [[nodiscard]] const BufferPool& pool() const;
+
+private:
+    /*!
+     * @brief This struct holds an encoded cell while nodes are split.
+     */
+    struct Cell {
+        page_id child_{kNullPage};  // Subtree of keys greater than this one.
+        std::string key_{};
+        std::string value_{};
+        bool tombstone_{};
+    };
+
+    static int _count(const char* p);
+    static bool _is_leaf(const char* p);
+    static void _init_page(char* p, bool leaf, page_id first_child);
+    static size_t _cell_offset(const char* p, int i);
+    static K _key(const char* p, int i);
+    static bool _is_tombstone(const char* p, int i);
+    static V _value(const char* p, int i);
+    static page_id _child(const char* p, int i);
+    static int _search(const char* p, const K& k, bool& found);
+    static Cell _cell(const char* p, int i);
+    static size_t _cell_size(const Cell& cell);
+    static bool _make_room(char* p, size_t bytes);
+    static void _compact(char* p);
+    static void _insert_cell(char* p, int i, const Cell& cell);
+    static void _erase_cell(char* p, int i);
+
+    PageHandle _locate(const K& k, int& i, bool& found) const;
+    template<typename F> bool _scan(page_id id, const K& lo, F& f) const;
+    bool _put(const K& k, const V& v);
+    void _insert(std::vector<std::pair<page_id, int>>& path, PageHandle page, int i, Cell cell);
+
+    mutable BufferPool pool_;  // Lookups change what is cached, not what is stored.
+    page_id root_{kNullPage};
+    size_t size_{};
+};
+
+#endif //CS225_SP22_C2_PAGEDBTREE_H_
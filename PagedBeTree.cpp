@@ -0,0 +1,1120 @@
+/*!
+ * @brief This file contains the implementation of class <em>PagedBeTree</em>.
+ *
+ * Page layouts (offsets in bytes):
+ *  - Metadata (page 0): magic [0, 8), page size [8, 12), key size [12, 16), root [16, 20), fanout [20, 24),
+ *    number of keys in the leaves [24, 32), number of buffered messages [32, 40).
+ *  - Every node: leaf tag [0], number of keys [2, 4).
+ *  - Internal node: bytes of buffered messages [4, 6); `Fanout - 1` pivot slots, `Fanout` child page numbers,
+ *    then the message buffer up to the end of the page. Messages (operation [0], key, payload length, payload)
+ *    are appended in arrival order.
+ *  - Leaf node: previous leaf [4, 8), next leaf [8, 12), start of the value heap [12, 14); sorted slots
+ *    (key, value offset, value length) followed by free space and the value heap, as in <em>PagedBPlusTree</em>.
+ */
+#include "PagedBeTree.h"
+#include "utilities.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/*!
+ * @brief This constructor opens the tree stored in the given file, or creates an empty one.
+ * @param path is path to the database file.
+ * @param frames is number of pages cached in memory.
+ * @throw IOError if the file cannot be opened or was written by an incompatible tree.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::PagedBeTree(const std::string& path,
+                                                                                size_t frames)
+    : pool_(path, frames) {
+    if (0 == pool_.pageCount()) {  // A new file.
+        auto meta = pool_.allocate();
+        std::memcpy(meta.data(), kMagic, 8);
+        setPageField<uint32_t>(meta.data(), 8, kPageSize);
+        setPageField<uint32_t>(meta.data(), 12, kKeySize);
+        setPageField<uint32_t>(meta.data(), 16, kNullPage);
+        setPageField<uint32_t>(meta.data(), 20, Fanout);
+        setPageField<uint64_t>(meta.data(), 24, 0);
+        setPageField<uint64_t>(meta.data(), 32, 0);
+        return;
+    }
+    auto meta = pool_.fetch(0);
+    if (0 != std::memcmp(meta.data(), kMagic, 8) || kPageSize != pageField<uint32_t>(meta.data(), 8)
+        || kKeySize != pageField<uint32_t>(meta.data(), 12) || Fanout != pageField<uint32_t>(meta.data(), 20)) {
+        throw IOError();
+    }
+    root_ = pageField<uint32_t>(meta.data(), 16);
+    size_ = pageField<uint64_t>(meta.data(), 24);
+    pending_ = pageField<uint64_t>(meta.data(), 32);
+}
+
+/*!
+ * @brief This destructor checkpoints the tree. Buffered messages stay buffered.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::~PagedBeTree() {
+    try {
+        checkpoint();
+    } catch (const IOError& error) {
+        std::cerr << error.what() << std::endl;
+    }
+}
+
+/*!
+ * @brief This method inserts the given key-value pair, overwriting the value if the key already exists.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @throw std::length_error if the encoded value is too large for a page.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::insert(K k, V v) {
+    Message m{kPut, std::move(k), {}};
+    ValueCodec::encode(v, m.payload_);
+    if (kSlotSize + m.payload_.size() > kMaxEntry) { throw std::length_error("The value is too large for a page!"); }
+    _send(std::move(m));
+}
+
+/*!
+ * @brief This method removes the given key from the tree, if present.
+ * @param k is the key object.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::remove(const K& k) {
+    _send(Message{kErase, k, {}});
+}
+
+/*!
+ * @brief This method applies a patch to the value of the given key, if present, without reading the value.
+ * @param k is the key object.
+ * @param p is the patch.
+ * @throw std::length_error if the encoded patch is too large for a page.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::patch(const K& k, const Patch& p) {
+    Message m{kPatch, k, {}};
+    PatchCodec::encode(p, m.payload_);
+    if (kSlotSize + m.payload_.size() > kMaxEntry) { throw std::length_error("The patch is too large for a page!"); }
+    _send(std::move(m));
+}
+
+/*!
+ * @brief This method checks if the given key exists in the tree.
+ * @param k is the key object.
+ * @return true if exists, false if not exists.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+bool PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::contains(const K& k) const {
+    return _lookup(k).has_value();
+}
+
+/*!
+ * @brief This method looks up a key and decodes its value, with every buffered message applied.
+ * @param k is the key object.
+ * @return copy of the value object, or an empty optional if not found.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+std::optional<V> PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::find(const K& k) const {
+    auto value = _lookup(k);
+    if (!value) { return std::nullopt; }
+    return ValueCodec::decode(value->data(), value->size());
+}
+
+/*!
+ * @brief This method calls `f` on the decoded value of the given key, if present.
+ * @tparam F is type of the callable, invoked as `f(const V&)`.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+template<typename F>
+bool PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::visit(const K& k, F&& f) const {
+    auto v = find(k);
+    if (!v) { return false; }
+    std::forward<F>(f)(std::as_const(*v));
+    return true;
+}
+
+/*!
+ * @brief This method decodes the value of the given key, lets `f` modify it and stores it back. Unlike `patch()`,
+ * it reads the value first; prefer `patch()` when the change can be described without reading.
+ * @tparam F is type of the callable, invoked as `f(V&)`.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ * @throw std::length_error if the modified value is too large for a page.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+template<typename F>
+bool PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::update(const K& k, F&& f) {
+    auto v = find(k);
+    if (!v) { return false; }
+    std::forward<F>(f)(*v);
+    insert(k, std::move(*v));
+    return true;
+}
+
+/*!
+ * @brief This method returns number of keys in the leaves. Keys whose messages are still buffered are not
+ * counted yet; the count is exact after `flush()`.
+ * @return the number of keys.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+size_t PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::size() const {
+    return size_;
+}
+
+/*!
+ * @brief This method returns number of messages buffered in internal pages.
+ * @return the number of messages.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+size_t PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::pending() const {
+    return pending_;
+}
+
+/*!
+ * @brief This method moves every buffered message down to the leaves.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::flush() {
+    if (0 == pending_) { return; }
+    _grow(_drain(root_));
+}
+
+/*!
+ * @brief This method records the root and counters in the metadata page and writes every dirty page back.
+ * When it returns, reopening the file yields the current tree, buffered messages included.
+ * @throw IOError if a page cannot be written.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::checkpoint() {
+    {
+        auto meta = pool_.fetch(0);
+        setPageField<uint32_t>(meta.data(), 16, root_);
+        setPageField<uint64_t>(meta.data(), 24, size_);
+        setPageField<uint64_t>(meta.data(), 32, pending_);
+        meta.markDirty();
+    }
+    pool_.flush();
+}
+
+/*!
+ * @brief This method returns the buffer pool, e.g. to read its counters.
+ * @return reference to the buffer pool.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+const BufferPool& PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::pool() const {
+    return pool_;
+}
+
+/*!
+ * @brief This method flushes the buffers and returns an iterator to the smallest key.
+ * @return the iterator.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::begin() {
+    flush();
+    return ConstIterator{this, _edge_leaf(false), 0};
+}
+
+/*!
+ * @brief This method returns the past-the-end iterator.
+ * @return the iterator.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::end() const {
+    return ConstIterator{this, kNullPage, 0};
+}
+
+/*!
+ * @brief This method flushes the buffers and returns a reverse iterator to the largest key.
+ * @return the reverse iterator.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstReverseIterator
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::rbegin() {
+    flush();
+    return ConstReverseIterator{end()};
+}
+
+/*!
+ * @brief This method flushes the buffers and returns the past-the-end reverse iterator.
+ * @return the reverse iterator.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstReverseIterator
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::rend() {
+    return ConstReverseIterator{begin()};
+}
+
+/*!
+ * @brief This method flushes the buffers and returns an iterator to the first key not less than `k`.
+ * @param k is the key object.
+ * @return the iterator.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::lower_bound(const K& k) {
+    flush();
+    if (kNullPage == root_) { return end(); }
+    auto page = pool_.fetch(root_);
+    while (!_is_leaf(page.data())) {
+        page = pool_.fetch(_child(page.data(), _child_index(page.data(), k)));
+    }
+    int i = _leaf_lower_bound(page.data(), k);
+    page_id id = page.id();
+    page.release();
+    return ConstIterator{this, id, i};
+}
+
+/*!
+ * @brief This method flushes the buffers and returns an iterator to the first key greater than `k`.
+ * @param k is the key object.
+ * @return the iterator.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::upper_bound(const K& k) {
+    auto iter = lower_bound(k);
+    if (end() != iter && !(k < iter.key())) { ++iter; }
+    return iter;
+}
+
+/*!
+ * @brief This method flushes the buffers and returns the keys in `[lo, hi)`.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the exclusive upper bound.
+ * @return the range.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::Range
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::range(const K& lo, const K& hi) {
+    return Range{lower_bound(lo), lower_bound(hi)};
+}
+
+/*!
+ * @brief This method flushes the buffers and returns the keys in `[lo, hi]`, so that the largest key can be
+ * included without a sentinel.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the inclusive upper bound.
+ * @return the range (empty if `hi` is less than `lo`).
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::Range
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::closed_range(const K& lo, const K& hi) {
+    if (hi < lo) { return Range{end(), end()}; }
+    return Range{lower_bound(lo), upper_bound(hi)};
+}
+
+/*!
+ * @brief This method returns number of keys (pivots of an internal node, slots of a leaf) in a node.
+ * @param p is pointer to the page.
+ * @return the number of keys.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+int PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_count(const char* p) {
+    return pageField<uint16_t>(p, 2);
+}
+
+/*!
+ * @brief This method checks if a node is a leaf.
+ * @param p is pointer to the page.
+ * @return true if it is, false otherwise.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+bool PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_is_leaf(const char* p) {
+    return 0 != p[0];
+}
+
+/*!
+ * @brief This method resets the header of a page to an empty node: an unlinked leaf, or an internal node with
+ * an empty buffer.
+ * @param p is pointer to the page.
+ * @param leaf is true for a leaf, false for an internal node.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_init_page(char* p, bool leaf) {
+    std::memset(p, 0, kHeaderSize);
+    p[0] = static_cast<char>(leaf);
+    if (leaf) {
+        setPageField<uint32_t>(p, 4, kNullPage);
+        setPageField<uint32_t>(p, 8, kNullPage);
+        setPageField<uint16_t>(p, 12, static_cast<uint16_t>(kPageSize));
+    }
+}
+
+/*!
+ * @brief This method decodes a key stored at the given offset.
+ * @param p is pointer to the page.
+ * @param offset is offset of the key.
+ * @return the key object.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+K PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_key(const char* p, size_t offset) {
+    return KeyCodec::decode(p + offset, kKeySize);
+}
+
+/*!
+ * @brief This method checks two keys for equivalence using only `operator<`.
+ * @param a is the first key.
+ * @param b is the second key.
+ * @return true if neither is less than the other.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+bool PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_equal(const K& a, const K& b) {
+    return !(a < b) && !(b < a);
+}
+
+/*!
+ * @brief This method returns the offset of the `i`-th pivot of an internal node.
+ * @param i is index of the pivot.
+ * @return the offset.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+size_t PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_internal_key_offset(int i) {
+    return kHeaderSize + static_cast<size_t>(i) * kKeySize;
+}
+
+/*!
+ * @brief This method returns the offset of the `i`-th child of an internal node.
+ * @param i is index of the child.
+ * @return the offset.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+size_t PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_internal_child_offset(int i) {
+    return kHeaderSize + kMaxPivots * kKeySize + static_cast<size_t>(i) * sizeof(page_id);
+}
+
+/*!
+ * @brief This method returns the `i`-th child of an internal node.
+ * @param p is pointer to the page.
+ * @param i is index of the child.
+ * @return the child page number.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+page_id PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_child(const char* p, int i) {
+    return pageField<page_id>(p, _internal_child_offset(i));
+}
+
+/*!
+ * @brief This method finds the child of an internal node that covers `k`: the number of pivots not greater than `k`.
+ * @param p is pointer to the page.
+ * @param k is the key object.
+ * @return index of the child.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+int PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_child_index(const char* p, const K& k) {
+    int lo = 0, hi = _count(p);
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (k < _key(p, _internal_key_offset(mid))) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+/*!
+ * @brief This method finds the child of a decoded internal node that covers `k`.
+ * @param pivots is the pivots of the node.
+ * @param k is the key object.
+ * @return index of the child.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+int PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_child_index(const std::vector<K>& pivots,
+                                                                                     const K& k) {
+    return static_cast<int>(std::upper_bound(pivots.begin(), pivots.end(), k) - pivots.begin());
+}
+
+/*!
+ * @brief This method returns the bytes taken by the message buffer of an internal node.
+ * @param p is pointer to the page.
+ * @return the bytes used.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+size_t PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_buffer_used(const char* p) {
+    return pageField<uint16_t>(p, 4);
+}
+
+/*!
+ * @brief This method appends a message to the buffer of an internal node. The caller guarantees the space.
+ * @param p is pointer to the page.
+ * @param m is the message.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_append(char* p, const Message& m) {
+    std::string bytes{};
+    bytes.reserve(m.size());
+    bytes.push_back(static_cast<char>(m.op_));
+    KeyCodec::encode(m.key_, bytes);
+    codecPut(bytes, static_cast<uint16_t>(m.payload_.size()));
+    bytes.append(m.payload_);
+    size_t used = _buffer_used(p);
+    std::memcpy(p + kBufferOffset + used, bytes.data(), bytes.size());
+    setPageField<uint16_t>(p, 4, static_cast<uint16_t>(used + bytes.size()));
+}
+
+/*!
+ * @brief This method decodes an internal node: its pivots, children and buffered messages.
+ * @param p is pointer to the page.
+ * @return the decoded node.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::Internal
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_read_internal(const char* p) {
+    Internal node{};
+    int n = _count(p);
+    for (int i = 0; i < n; ++i) { node.pivots_.push_back(_key(p, _internal_key_offset(i))); }
+    for (int i = 0; i <= n; ++i) { node.children_.push_back(_child(p, i)); }
+    const char* in = p + kBufferOffset;
+    const char* last = in + _buffer_used(p);
+    while (in < last) {
+        Message m{static_cast<uint8_t>(in[0]), KeyCodec::decode(in + 1, kKeySize), {}};
+        auto length = pageField<uint16_t>(in, 1 + kKeySize);
+        m.payload_.assign(in + kMessageHeaderSize, length);
+        in += m.size();
+        node.bytes_ += m.size();
+        node.buffer_.push_back(std::move(m));
+    }
+    return node;
+}
+
+/*!
+ * @brief This method returns the offset of the `i`-th slot of a leaf.
+ * @param i is index of the slot.
+ * @return the offset.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+size_t PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_slot_offset(int i) {
+    return kHeaderSize + static_cast<size_t>(i) * kSlotSize;
+}
+
+/*!
+ * @brief This method decodes the `i`-th key of a leaf.
+ * @param p is pointer to the page.
+ * @param i is index of the slot.
+ * @return the key object.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+K PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_leaf_key(const char* p, int i) {
+    return _key(p, _slot_offset(i));
+}
+
+/*!
+ * @brief This method decodes the `i`-th value of a leaf.
+ * @param p is pointer to the page.
+ * @param i is index of the slot.
+ * @return the value object.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+V PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_leaf_value(const char* p, int i) {
+    size_t slot = _slot_offset(i);
+    return ValueCodec::decode(p + pageField<uint16_t>(p, slot + kKeySize), pageField<uint16_t>(p, slot + kKeySize + 2));
+}
+
+/*!
+ * @brief This method finds the first slot of a leaf whose key is not less than `k`.
+ * @param p is pointer to the page.
+ * @param k is the key object.
+ * @return index of the slot (number of keys if none).
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+int PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_leaf_lower_bound(const char* p, const K& k) {
+    int lo = 0, hi = _count(p);
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (_leaf_key(p, mid) < k) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/*!
+ * @brief This method returns the contiguous free space between the slots and the value heap of a leaf.
+ * @param p is pointer to the page.
+ * @return the free space in bytes.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+size_t PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_leaf_free(const char* p) {
+    return pageField<uint16_t>(p, 12) - _slot_offset(_count(p));
+}
+
+/*!
+ * @brief This method inserts an entry into the `i`-th slot of a leaf. The caller guarantees
+ * `kSlotSize + value.size()` bytes of free space.
+ * @param p is pointer to the page.
+ * @param i is index of the slot.
+ * @param k is the key object.
+ * @param value is the encoded value.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_leaf_insert(char* p, int i, const K& k,
+                                                                                      const std::string& value) {
+    int n = _count(p);
+    size_t slot = _slot_offset(i);
+    std::string key{};
+    KeyCodec::encode(k, key);
+    std::memmove(p + slot + kSlotSize, p + slot, (n - i) * kSlotSize);
+    auto heap = static_cast<uint16_t>(pageField<uint16_t>(p, 12) - value.size());
+    std::memcpy(p + heap, value.data(), value.size());
+    std::memcpy(p + slot, key.data(), kKeySize);
+    setPageField<uint16_t>(p, slot + kKeySize, heap);
+    setPageField<uint16_t>(p, slot + kKeySize + 2, static_cast<uint16_t>(value.size()));
+    setPageField<uint16_t>(p, 12, heap);
+    setPageField<uint16_t>(p, 2, static_cast<uint16_t>(n + 1));
+}
+
+/*!
+ * @brief This method resolves the encoded value of a key. The buffers on the way down hold messages newer
+ * than anything below them, and each buffer is in arrival order; the newest put or erase settles the base value
+ * and the patches newer than it are applied on top. The descent stops at the first put or erase.
+ * @param k is the key object.
+ * @return the encoded value, or an empty optional if not found.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+std::optional<std::string> PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_lookup(
+    const K& k) const {
+    if (kNullPage == root_) { return std::nullopt; }
+    std::vector<std::string> patches{};  // Newest first.
+    std::optional<std::string> base{};
+    bool settled{};
+    auto page = pool_.fetch(root_);
+    while (!settled && !_is_leaf(page.data())) {
+        const char* p = page.data();
+        std::vector<std::pair<uint8_t, const char*>> matches{};  // Operation and message, oldest first.
+        const char* in = p + kBufferOffset;
+        const char* last = in + _buffer_used(p);
+        while (in < last) {
+            if (_equal(KeyCodec::decode(in + 1, kKeySize), k)) { matches.emplace_back(in[0], in); }
+            in += kMessageHeaderSize + pageField<uint16_t>(in, 1 + kKeySize);
+        }
+        for (auto match = matches.rbegin(); !settled && match != matches.rend(); ++match) {
+            std::string payload{match->second + kMessageHeaderSize,
+                                pageField<uint16_t>(match->second, 1 + kKeySize)};
+            if (kPatch == match->first) {
+                patches.push_back(std::move(payload));
+            } else {
+                if (kPut == match->first) { base = std::move(payload); }
+                settled = true;
+            }
+        }
+        if (!settled) { page = pool_.fetch(_child(p, _child_index(p, k))); }
+    }
+    if (!settled) {
+        const char* p = page.data();
+        int i = _leaf_lower_bound(p, k);
+        if (i < _count(p) && _equal(_leaf_key(p, i), k)) {
+            size_t slot = _slot_offset(i);
+            base.emplace(p + pageField<uint16_t>(p, slot + kKeySize), pageField<uint16_t>(p, slot + kKeySize + 2));
+        }
+    }
+    if (base) {
+        for (auto patch = patches.rbegin(); patch != patches.rend(); ++patch) { _patch(*base, *patch); }
+    }
+    return base;
+}
+
+/*!
+ * @brief This method applies an encoded patch to an encoded value, unless the result would be too large for a
+ * page, in which case the patch is dropped.
+ * @param value is the encoded value.
+ * @param patch is the encoded patch.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_patch(std::string& value,
+                                                                               const std::string& patch) {
+    V v = ValueCodec::decode(value.data(), value.size());
+    PatchCodec::decode(patch.data(), patch.size()).apply(v);
+    std::string patched{};
+    ValueCodec::encode(v, patched);
+    if (kSlotSize + patched.size() <= kMaxEntry) { value = std::move(patched); }
+}
+
+/*!
+ * @brief This method delivers a message to the tree. It is appended to the root buffer when there is room,
+ * which is the common case; otherwise the root flushes part of its buffer first.
+ * @param m is the message.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_send(Message m) {
+    if (kNullPage == root_) {
+        auto page = pool_.allocate();
+        _init_page(page.data(), true);
+        root_ = page.id();
+    }
+    ++pending_;
+    {
+        auto page = pool_.fetch(root_);
+        if (!_is_leaf(page.data()) && _buffer_used(page.data()) + m.size() <= kBufferSize) {
+            _append(page.data(), m);
+            page.markDirty();
+            return;
+        }
+    }
+    std::vector<Message> messages{};
+    messages.push_back(std::move(m));
+    _grow(_push(root_, std::move(messages)));
+}
+
+/*!
+ * @brief This method grows new roots above the current root while it has split.
+ * @param splits is the new right siblings of the root.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_grow(Splits splits) {
+    while (!splits.empty()) {
+        Internal node{};
+        node.children_.push_back(root_);
+        for (auto& [key, child] : splits) {
+            node.pivots_.push_back(std::move(key));
+            node.children_.push_back(child);
+        }
+        auto page = pool_.allocate();
+        root_ = page.id();
+        page.release();
+        splits = _write_internal(root_, node);
+    }
+}
+
+/*!
+ * @brief This method delivers a batch of messages to a subtree. A leaf applies them; an internal node buffers
+ * them and, once its buffer overflows, flushes the messages bound for its fullest children until the buffer is half
+ * empty, so that the cost of decoding and rewriting the node is shared by many messages.
+ * @param id is the root page of the subtree.
+ * @param messages is the messages, oldest first.
+ * @return the new right siblings of `id`, if it had to split.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::Splits
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_push(page_id id, std::vector<Message> messages) {
+    Internal node{};
+    {
+        auto page = pool_.fetch(id);
+        if (_is_leaf(page.data())) {
+            page.release();
+            return _apply(id, messages);
+        }
+        node = _read_internal(page.data());
+    }
+    for (auto& m : messages) {
+        node.bytes_ += m.size();
+        node.buffer_.push_back(std::move(m));
+    }
+    if (node.bytes_ > kBufferSize) {
+        while (node.bytes_ > kBufferSize / 2) { _flush_child(node, _fullest_child(node)); }
+    }
+    return _write_internal(id, node);
+}
+
+/*!
+ * @brief This method empties the buffers of a subtree, top-down.
+ * @param id is the root page of the subtree.
+ * @return the new right siblings of `id`, if it had to split.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::Splits
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_drain(page_id id) {
+    Internal node{};
+    {
+        auto page = pool_.fetch(id);
+        if (_is_leaf(page.data())) { return {}; }
+        node = _read_internal(page.data());
+    }
+    while (!node.buffer_.empty()) { _flush_child(node, _fullest_child(node)); }
+    for (size_t i = 0; i < node.children_.size(); ++i) {
+        auto splits = _drain(node.children_[i]);
+        for (size_t j = 0; j < splits.size(); ++j) {
+            node.pivots_.insert(node.pivots_.begin() + i + j, std::move(splits[j].first));
+            node.children_.insert(node.children_.begin() + i + j + 1, splits[j].second);
+        }
+        i += splits.size();
+    }
+    return _write_internal(id, node);
+}
+
+/*!
+ * @brief This method moves the buffered messages bound for one child of a decoded node down into that child,
+ * in one batch, and adopts the siblings the child splits into.
+ * @param node is the decoded node.
+ * @param i is index of the child.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_flush_child(Internal& node, int i) {
+    std::vector<Message> batch{};
+    std::vector<Message> rest{};
+    for (auto& m : node.buffer_) {
+        if (_child_index(node.pivots_, m.key_) == i) {
+            node.bytes_ -= m.size();
+            batch.push_back(std::move(m));
+        } else {
+            rest.push_back(std::move(m));
+        }
+    }
+    node.buffer_ = std::move(rest);
+    auto splits = _push(node.children_[i], std::move(batch));
+    for (size_t j = 0; j < splits.size(); ++j) {
+        node.pivots_.insert(node.pivots_.begin() + i + j, std::move(splits[j].first));
+        node.children_.insert(node.children_.begin() + i + j + 1, splits[j].second);
+    }
+}
+
+/*!
+ * @brief This method finds the child of a decoded node with the most buffered bytes.
+ * @param node is the decoded node.
+ * @return index of the child.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+int PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_fullest_child(const Internal& node) {
+    std::vector<size_t> bytes(node.children_.size());
+    for (const auto& m : node.buffer_) { bytes[_child_index(node.pivots_, m.key_)] += m.size(); }
+    return static_cast<int>(std::max_element(bytes.begin(), bytes.end()) - bytes.begin());
+}
+
+/*!
+ * @brief This method writes a decoded internal node back to its page. A node with more than `Fanout` children
+ * is divided evenly into several pages, each taking the buffered messages of its key range.
+ * @param id is the page of the node.
+ * @param node is the decoded node; its buffer must fit in one page.
+ * @return the new right siblings of `id`.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::Splits
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_write_internal(page_id id, const Internal& node) {
+    int children = static_cast<int>(node.children_.size());
+    int parts = (children + Fanout - 1) / Fanout;
+    Splits splits{};
+    for (int part = 0; part < parts; ++part) {
+        int first = part * children / parts, last = (part + 1) * children / parts;  // Children [first, last).
+        auto page = 0 == part ? pool_.fetch(id) : pool_.allocate();
+        char* p = page.data();
+        _init_page(p, false);
+        for (int i = first; i < last - 1; ++i) {
+            std::string key{};
+            KeyCodec::encode(node.pivots_[i], key);
+            std::memcpy(p + _internal_key_offset(i - first), key.data(), kKeySize);
+        }
+        for (int i = first; i < last; ++i) {
+            setPageField<page_id>(p, _internal_child_offset(i - first), node.children_[i]);
+        }
+        setPageField<uint16_t>(p, 2, static_cast<uint16_t>(last - first - 1));
+        for (const auto& m : node.buffer_) {
+            int i = _child_index(node.pivots_, m.key_);
+            if (first <= i && i < last) { _append(p, m); }
+        }
+        page.markDirty();
+        if (0 != part) { splits.emplace_back(node.pivots_[first - 1], page.id()); }
+    }
+    return splits;
+}
+
+/*!
+ * @brief This method applies a batch of messages to a leaf. The leaf is rebuilt from its entries merged with the
+ * messages (sorted stably by key, so that messages of one key keep their order); entries that no longer fit go to
+ * new leaves linked after it.
+ * @param id is the leaf page.
+ * @param messages is the messages, oldest first. They are consumed.
+ * @return the new right siblings of `id`.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::Splits
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_apply(page_id id,
+                                                                          std::vector<Message>& messages) {
+    auto page = pool_.fetch(id);
+    char* p = page.data();
+    std::vector<std::pair<K, std::string>> entries{};
+    for (int i = 0; i < _count(p); ++i) {
+        size_t slot = _slot_offset(i);
+        entries.emplace_back(_leaf_key(p, i), std::string{p + pageField<uint16_t>(p, slot + kKeySize),
+                                                          pageField<uint16_t>(p, slot + kKeySize + 2)});
+    }
+    std::stable_sort(messages.begin(), messages.end(),
+                     [](const Message& a, const Message& b) { return a.key_ < b.key_; });
+
+    std::vector<std::pair<K, std::string>> merged{};
+    merged.reserve(entries.size() + messages.size());
+    size_t e{};
+    for (size_t m = 0; m < messages.size();) {
+        const K& k = messages[m].key_;
+        while (e < entries.size() && entries[e].first < k) { merged.push_back(std::move(entries[e++])); }
+        std::optional<std::string> value{};
+        if (e < entries.size() && _equal(entries[e].first, k)) { value = std::move(entries[e++].second); }
+        bool existed = value.has_value();
+        for (; m < messages.size() && _equal(messages[m].key_, k); ++m) {
+            const Message& message = messages[m];
+            if (kPut == message.op_) {
+                value = message.payload_;
+            } else if (kErase == message.op_) {
+                value.reset();
+            } else if (value) {
+                _patch(*value, message.payload_);
+            }
+        }
+        if (value) { merged.emplace_back(k, std::move(*value)); }
+        size_ += value.has_value();
+        size_ -= existed;
+    }
+    while (e < entries.size()) { merged.push_back(std::move(entries[e++])); }
+    pending_ -= messages.size();
+
+    page_id prev = pageField<uint32_t>(p, 4), next = pageField<uint32_t>(p, 8);
+    Splits splits{};
+    _init_page(p, true);
+    setPageField<uint32_t>(p, 4, prev);
+    page.markDirty();
+    for (auto& [k, value] : merged) {
+        if (_leaf_free(p) < kSlotSize + value.size()) {
+            auto sibling = pool_.allocate();
+            _init_page(sibling.data(), true);
+            setPageField<uint32_t>(sibling.data(), 4, page.id());
+            setPageField<uint32_t>(p, 8, sibling.id());
+            splits.emplace_back(k, sibling.id());
+            page = std::move(sibling);
+            p = page.data();
+            page.markDirty();
+        }
+        _leaf_insert(p, _count(p), k, value);
+    }
+    setPageField<uint32_t>(p, 8, next);
+    if (kNullPage != next && !splits.empty()) {
+        page_id last = page.id();
+        page.release();
+        auto sibling = pool_.fetch(next);
+        setPageField<uint32_t>(sibling.data(), 4, last);
+        sibling.markDirty();
+    }
+    return splits;
+}
+
+/*!
+ * @brief This method descends along the leftmost or rightmost edge of the tree. The buffers must be empty.
+ * @param last is true for the rightmost leaf, false for the leftmost leaf.
+ * @return the leaf page number, or kNullPage if the tree is empty.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+page_id PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::_edge_leaf(bool last) const {
+    if (kNullPage == root_) { return kNullPage; }
+    auto page = pool_.fetch(root_);
+    while (!_is_leaf(page.data())) {
+        page = pool_.fetch(_child(page.data(), last ? _count(page.data()) : 0));
+    }
+    return page.id();
+}
+
+/*!
+ * @brief This constructor positions the iterator at the `i`-th slot of a leaf, moving on to the next
+ * non-empty leaf if the slot does not exist.
+ * @param tree is pointer to the tree.
+ * @param leaf is the leaf page number (kNullPage for the end).
+ * @param i is index of the slot.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::ConstIterator(
+    const PagedBeTree* tree, page_id leaf, int i)
+    : tree_(tree), leaf_(leaf), i_(i) {
+    _skip_forward();
+    _load();
+}
+
+/*!
+ * @brief This method moves past the end of the current leaf, and past empty leaves, if needed.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::_skip_forward() {
+    while (kNullPage != leaf_) {
+        auto page = tree_->pool_.fetch(leaf_);
+        if (i_ < _count(page.data())) { return; }
+        leaf_ = pageField<uint32_t>(page.data(), 8);
+        i_ = 0;
+    }
+    i_ = 0;
+}
+
+/*!
+ * @brief This method decodes the current entry.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+void PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::_load() {
+    if (kNullPage == leaf_) { return; }
+    auto page = tree_->pool_.fetch(leaf_);
+    entry_ = {_leaf_key(page.data(), i_), _leaf_value(page.data(), i_)};
+}
+
+/*!
+ * @brief This operator returns the current entry.
+ * @return copy of the key-value pair.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::reference
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::operator*() const {
+    return entry_;
+}
+
+/*!
+ * @brief This method returns the current key.
+ * @return reference to the key decoded into the iterator.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+const K& PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::key() const {
+    return entry_.first;
+}
+
+/*!
+ * @brief This method returns the current value.
+ * @return reference to the value decoded into the iterator.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+const V& PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::value() const {
+    return entry_.second;
+}
+
+/*!
+ * @brief This operator advances to the next key.
+ * @return reference to this iterator.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator&
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::operator++() {
+    ++i_;
+    _skip_forward();
+    _load();
+    return *this;
+}
+
+/*!
+ * @brief This operator advances to the next key.
+ * @return copy of the iterator before advancing.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::operator++(int) {
+    auto copy = *this;
+    ++*this;
+    return copy;
+}
+
+/*!
+ * @brief This operator moves back to the previous key, skipping empty leaves. Decrementing the end iterator
+ * yields the largest key.
+ * @return reference to this iterator.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator&
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::operator--() {
+    if (kNullPage == leaf_) {
+        leaf_ = tree_->_edge_leaf(true);
+        i_ = _count(tree_->pool_.fetch(leaf_).data());
+    }
+    while (0 == i_) {
+        leaf_ = pageField<uint32_t>(tree_->pool_.fetch(leaf_).data(), 4);
+        i_ = _count(tree_->pool_.fetch(leaf_).data());
+    }
+    --i_;
+    _load();
+    return *this;
+}
+
+/*!
+ * @brief This operator moves back to the previous key.
+ * @return copy of the iterator before moving.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+typename PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator
+PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::operator--(int) {
+    auto copy = *this;
+    --*this;
+    return copy;
+}
+
+/*!
+ * @brief This operator checks if two iterators refer to the same slot.
+ * @param rhs is the other iterator.
+ * @return true if equal, false otherwise.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+bool PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::operator==(
+    const ConstIterator& rhs) const {
+    return tree_ == rhs.tree_ && leaf_ == rhs.leaf_ && i_ == rhs.i_;
+}
+
+/*!
+ * @brief This operator checks if two iterators refer to different slots.
+ * @param rhs is the other iterator.
+ * @return true if not equal, false otherwise.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec, typename ValueCodec, typename PatchCodec,
+    int Fanout>
+bool PagedBeTree<K, V, Patch, KeyCodec, ValueCodec, PatchCodec, Fanout>::ConstIterator::operator!=(
+    const ConstIterator& rhs) const {
+    return !(*this == rhs);
+}
@@ -0,0 +1,200 @@
+/*!
+ * @brief This file contains the class definition of <em>PagedBeTree</em>.
+ */
+#ifndef CS225_SP22_C2_PAGEDBETREE_H_
+#define CS225_SP22_C2_PAGEDBETREE_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <iterator>
+#include "bufferPool.h"
+#include "codec.h"
+
+/*!
+ * @brief This class implements a B-epsilon tree stored in fixed-size pages of a file, cached by a <em>BufferPool</em>.
+ * It is the write-optimized sibling of <em>PagedBPlusTree</em>: besides pivot keys and child page numbers, every
+ * internal page holds a buffer of messages (put, erase, patch). Modifications are appended to the buffer of the
+ * root without reading any leaf; when a buffer fills up, the messages bound for the children that have the most
+ * of them move down one level, one batch per child, and a leaf receives all of its pending messages at once. Each
+ * modification therefore costs a fraction of a page write instead of a root-to-leaf read and a leaf write.
+ * Lookups check the buffers on their way down, so they always see the latest state.
+ *
+ * Modifications are blind: `insert()`, `remove()` and `patch()` do not report whether the key existed, and
+ * `size()` counts only keys whose messages have reached the leaves (exact after `flush()`). Iteration flushes
+ * every buffer first and then walks the leaf chain, as in <em>PagedBPlusTree</em>. Leaves are never merged.
+ * Modifications reach the file when pages are evicted and on `checkpoint()`, but reopening the file (even after a
+ * crash) sees the last checkpoint only; the destructor checkpoints.
+ * @tparam K is type of key objects.
+ * @tparam V is type of value objects.
+ * @tparam Patch is type of partial updates, applied to a value by `void apply(V&) const`. A patch of a missing
+ * key does nothing; a patch must not make a value too large for a page, or it is dropped.
+ * @tparam KeyCodec serializes keys into exactly `KeyCodec::fixed_size` bytes.
+ * @tparam ValueCodec serializes values.
+ * @tparam PatchCodec serializes patches.
+ * @tparam Fanout is the maximum number of children of an internal page. A smaller fanout leaves more room for
+ * messages, so that more of them move down per flush, at the cost of a deeper tree.
+ */
+template<typename K, typename V, typename Patch, typename KeyCodec = Codec<K>, typename ValueCodec = Codec<V>,
+    typename PatchCodec = Codec<Patch>, int Fanout = 16>
+class PagedBeTree {
+    static constexpr size_t kKeySize{KeyCodec::fixed_size};
+    static constexpr size_t kHeaderSize{16};
+    static constexpr size_t kSlotSize{kKeySize + 4};  // Key, value offset and value length.
+    static constexpr size_t kMaxEntry{(kPageSize - kHeaderSize) / 4};  // Largest slot and value of a leaf.
+    static constexpr int kMaxPivots{Fanout - 1};
+    static constexpr size_t kBufferOffset{kHeaderSize + kMaxPivots * kKeySize + Fanout * sizeof(page_id)};
+    static constexpr size_t kBufferSize{kPageSize - kBufferOffset};
+    static constexpr size_t kMessageHeaderSize{1 + kKeySize + 2};  // Operation, key and payload length.
+    static_assert(Fanout >= 3, "An internal page needs at least 3 children.");
+    static_assert(kBufferSize >= 2 * (kMessageHeaderSize + kMaxEntry), "The message buffer is too small.");
+    static constexpr char kMagic[9]{"RQRSBE01"};  // First bytes of the metadata page.
+    static constexpr uint8_t kPut{1};
+    static constexpr uint8_t kErase{2};
+    static constexpr uint8_t kPatch{3};
+public:
+    /*!
+     * @brief This class walks the leaf chain in key order, in both directions. The current entry is decoded
+     * into the iterator, so dereferencing yields a copy. It is invalidated by any modification of the tree.
+     */
+    class ConstIterator {
+        friend PagedBeTree;
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type;  // Entries are decoded, not referenced.
+        using pointer = void;
+
+        ConstIterator() = default;
+        reference operator*() const;
+        [[nodiscard]] const K& key() const;
+        [[nodiscard]] const V& value() const;
+        ConstIterator& operator++();
+        ConstIterator operator++(int);
+        ConstIterator& operator--();
+        ConstIterator operator--(int);
+        bool operator==(const ConstIterator& rhs) const;
+        bool operator!=(const ConstIterator& rhs) const;
+
+    private:
+        ConstIterator(const PagedBeTree* tree, page_id leaf, int i);
+        void _skip_forward();
+        void _load();
+
+        const PagedBeTree* tree_{nullptr};
+        page_id leaf_{kNullPage};  // kNullPage for the past-the-end iterator.
+        int i_{};
+        value_type entry_{};
+    };
+    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+    /*!
+     * @brief This class holds a half-open range of the tree, usable in range-based for loops.
+     */
+    class Range {
+    public:
+        Range(ConstIterator first, ConstIterator last) : first_(first), last_(last) {}
+        ConstIterator begin() const { return first_; }
+        ConstIterator end() const { return last_; }
+        ConstReverseIterator rbegin() const { return ConstReverseIterator{last_}; }
+        ConstReverseIterator rend() const { return ConstReverseIterator{first_}; }
+        [[nodiscard]] bool empty() const { return first_ == last_; }
+
+    private:
+        ConstIterator first_;
+        ConstIterator last_;
+    };
+
+    explicit PagedBeTree(const std::string& path, size_t frames = 256);
+    PagedBeTree(const PagedBeTree& tree) = delete;
+    PagedBeTree& operator=(const PagedBeTree& tree) = delete;
+    virtual ~PagedBeTree();
+
+    void insert(K k, V v);
+    void remove(const K& k);
+    void patch(const K& k, const Patch& p);
+    [[nodiscard]] bool contains(const K& k) const;
+    [[nodiscard]] std::optional<V> find(const K& k) const;
+    template<typename F> bool visit(const K& k, F&& f) const;
+    template<typename F> bool update(const K& k, F&& f);
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] size_t pending() const;
+    void flush();
+    void checkpoint();
+    [[nodiscard]] const BufferPool& pool() const;
+    ConstIterator begin();
+    ConstIterator end() const;
+    ConstReverseIterator rbegin();
+    ConstReverseIterator rend();
+    ConstIterator lower_bound(const K& k);
+    ConstIterator upper_bound(const K& k);
+    Range range(const K& lo, const K& hi);
+    Range closed_range(const K& lo, const K& hi);
+
+private:
+    /*!
+     * @brief This struct holds a decoded message.
+     */
+    struct Message {
+        uint8_t op_{};
+        K key_{};
+        std::string payload_{};  // Encoded value (put) or patch (patch).
+        [[nodiscard]] size_t size() const { return kMessageHeaderSize + payload_.size(); }
+    };
+
+    /*!
+     * @brief This struct holds a decoded internal page while messages are flushed out of it. It may temporarily
+     * hold more children than fit in a page; it is then written back as several pages.
+     */
+    struct Internal {
+        std::vector<K> pivots_{};
+        std::vector<page_id> children_{};
+        std::vector<Message> buffer_{};  // Oldest first.
+        size_t bytes_{};  // Encoded size of the buffer.
+    };
+
+    using Splits = std::vector<std::pair<K, page_id>>;  // New right siblings, each with its smallest key.
+
+    static int _count(const char* p);
+    static bool _is_leaf(const char* p);
+    static void _init_page(char* p, bool leaf);
+    static K _key(const char* p, size_t offset);
+    static bool _equal(const K& a, const K& b);
+
+    static size_t _internal_key_offset(int i);
+    static size_t _internal_child_offset(int i);
+    static page_id _child(const char* p, int i);
+    static int _child_index(const char* p, const K& k);
+    static int _child_index(const std::vector<K>& pivots, const K& k);
+    static size_t _buffer_used(const char* p);
+    static void _append(char* p, const Message& m);
+    static Internal _read_internal(const char* p);
+
+    static size_t _slot_offset(int i);
+    static K _leaf_key(const char* p, int i);
+    static V _leaf_value(const char* p, int i);
+    static int _leaf_lower_bound(const char* p, const K& k);
+    static size_t _leaf_free(const char* p);
+    static void _leaf_insert(char* p, int i, const K& k, const std::string& value);
+
+    static void _patch(std::string& value, const std::string& patch);
+    std::optional<std::string> _lookup(const K& k) const;
+    void _send(Message m);
+    void _grow(Splits splits);
+    Splits _push(page_id id, std::vector<Message> messages);
+    Splits _drain(page_id id);
+    void _flush_child(Internal& node, int i);
+    static int _fullest_child(const Internal& node);
+    Splits _write_internal(page_id id, const Internal& node);
+    Splits _apply(page_id id, std::vector<Message>& messages);
+    page_id _edge_leaf(bool last) const;
+
+    mutable BufferPool pool_;  // Lookups change what is cached, not what is stored.
+    page_id root_{kNullPage};
+    size_t size_{};  // Keys in the leaves.
+    size_t pending_{};  // Messages not yet applied to a leaf.
+};
+
+#endif //CS225_SP22_C2_PAGEDBETREE_H_
@@ -0,0 +1,653 @@
+/*!
+ * @brief This file contains the implementation of class <em>AdaptiveRadixTree</em>.
+ */
+#include "adaptiveRadixTree.h"
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/*!
+ * @brief This copy constructor copies every node of the given tree.
+ * @param tree is the tree to copy.
+ */
+template<typename V>
+AdaptiveRadixTree<V>::AdaptiveRadixTree(const AdaptiveRadixTree& tree)
+    : root_(_clone(tree.root_)), size_(tree.size_) {
+}
+
+/*!
+ * @brief This copy assignment operator replaces every node with a copy of the given tree's.
+ * @param tree is the tree to copy.
+ * @return reference to this tree.
+ */
+template<typename V>
+AdaptiveRadixTree<V>& AdaptiveRadixTree<V>::operator=(const AdaptiveRadixTree& tree) {
+    if (this != &tree) {
+        Node* root = _clone(tree.root_);
+        _destroy(root_);
+        root_ = root;
+        size_ = tree.size_;
+    }
+    return *this;
+}
+
+/*!
+ * @brief This destructor frees every node.
+ */
+template<typename V>
+AdaptiveRadixTree<V>::~AdaptiveRadixTree() {
+    _destroy(root_);
+}
+
+/*!
+ * @brief This method overwrites the value of the given key, or inserts the pair if the key is absent.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if a new pair was inserted, false if an existing value was overwritten.
+ */
+template<typename V>
+bool AdaptiveRadixTree<V>::upsert(int k, V v) {
+    bool inserted = _insert(root_, _encode(k), v, 0);
+    size_ += inserted;
+    return inserted;
+}
+
+/*!
+ * @brief This method removes the given key from the tree.
+ * @param k is the key object.
+ * @return true if removed, false if not found.
+ */
+template<typename V>
+bool AdaptiveRadixTree<V>::remove(int k) {
+    bool removed = _remove(root_, _encode(k), 0);
+    size_ -= removed;
+    return removed;
+}
+
+/*!
+ * @brief This method looks up a key without copying the value.
+ * @param k is the key object.
+ * @return pointer to the value object stored in the tree, or nullptr if not found.
+ * The pointer is invalidated by the next insertion or removal.
+ */
+template<typename V>
+const V* AdaptiveRadixTree<V>::find(int k) const {
+    Leaf* leaf = _find_leaf(_encode(k));
+    return nullptr == leaf ? nullptr : &leaf->value_;
+}
+
+/*!
+ * @brief This method modifies the value of the given key in place.
+ * @tparam F is type of the callable, invoked as `f(V&)`.
+ * @param k is the key object.
+ * @param f is the callable.
+ * @return true if the key was found (and `f` was called), false otherwise.
+ */
+template<typename V>
+template<typename F>
+bool AdaptiveRadixTree<V>::update(int k, F&& f) {
+    Leaf* leaf = _find_leaf(_encode(k));
+    if (nullptr == leaf) { return false; }
+    std::forward<F>(f)(leaf->value_);
+    return true;
+}
+
+/*!
+ * @brief This method calls `f` on the keys in `[lo, hi]` and their values in key order, skipping every subtree
+ * whose keys all fall outside the range, until `f` returns false.
+ * @tparam F is type of the callable, invoked as `bool f(int, const V&)`; false stops the scan.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the inclusive upper bound.
+ * @param descending is true to visit the keys in descending order.
+ * @param f is the callable.
+ * @return false if the scan was stopped, true otherwise.
+ */
+template<typename V>
+template<typename F>
+bool AdaptiveRadixTree<V>::scan(int lo, int hi, bool descending, F&& f) const {
+    if (nullptr == root_ || hi < lo) { return true; }
+    return _scan(root_, 0, 0, _encode(lo), _encode(hi), descending, f);
+}
+
+/*!
+ * @brief This method returns number of keys in the tree.
+ * @return the number of keys.
+ */
+template<typename V>
+size_t AdaptiveRadixTree<V>::size() const {
+    return size_;
+}
+
+/*!
+ * @brief This method removes every key from the tree.
+ */
+template<typename V>
+void AdaptiveRadixTree<V>::clear() {
+    _destroy(root_);
+    root_ = nullptr;
+    size_ = 0;
+}
+
+/*!
+ * @brief This method maps a key to an unsigned integer with the same order.
+ * @param k is the key object.
+ * @return the encoded key.
+ */
+template<typename V>
+uint32_t AdaptiveRadixTree<V>::_encode(int k) {
+    return static_cast<uint32_t>(k) ^ 0x80000000u;
+}
+
+/*!
+ * @brief This method maps an encoded key back to the key.
+ * @param key is the encoded key.
+ * @return the key object.
+ */
+template<typename V>
+int AdaptiveRadixTree<V>::_decode(uint32_t key) {
+    return static_cast<int>(key ^ 0x80000000u);
+}
+
+/*!
+ * @brief This method returns the byte of an encoded key at the given depth.
+ * @param key is the encoded key.
+ * @param depth is index of the byte, 0 for the most significant one.
+ * @return the byte.
+ */
+template<typename V>
+uint8_t AdaptiveRadixTree<V>::_byte(uint32_t key, int depth) {
+    return static_cast<uint8_t>(key >> (24 - 8 * depth));
+}
+
+/*!
+ * @brief This method returns the mask of the bytes of an encoded key below the given depth.
+ * @param depth is the number of leading bytes that are fixed.
+ * @return the mask.
+ */
+template<typename V>
+uint32_t AdaptiveRadixTree<V>::_low_mask(int depth) {
+    return depth >= 4 ? 0 : UINT32_MAX >> (8 * depth);
+}
+
+/*!
+ * @brief This method finds the child of an internal node for the given byte. A node of 16 compares every byte
+ * at once with SSE2.
+ * @param n is pointer to the internal node.
+ * @param b is the byte.
+ * @return pointer to the slot of the child, or nullptr if there is none.
+ */
+template<typename V>
+typename AdaptiveRadixTree<V>::Node** AdaptiveRadixTree<V>::_find_child(Node* n, uint8_t b) {
+    switch (n->type_) {
+        case Type::kNode4: {
+            auto x = static_cast<Node4*>(n);
+            for (int i = 0; i < x->count_; ++i) {
+                if (b == x->keys_[i]) { return &x->c_[i]; }
+            }
+            return nullptr;
+        }
+        case Type::kNode16: {
+            auto x = static_cast<Node16*>(n);
+#if defined(__SSE2__)
+            __m128i eq = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(b)),
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(x->keys_.data())));
+            auto mask = static_cast<unsigned>(_mm_movemask_epi8(eq)) & ((1u << x->count_) - 1);
+            return mask ? &x->c_[__builtin_ctz(mask)] : nullptr;
+#else
+            for (int i = 0; i < x->count_; ++i) {
+                if (b == x->keys_[i]) { return &x->c_[i]; }
+            }
+            return nullptr;
+#endif
+        }
+        case Type::kNode48: {
+            auto x = static_cast<Node48*>(n);
+            return x->index_[b] ? &x->c_[x->index_[b] - 1] : nullptr;
+        }
+        case Type::kNode256: {
+            auto x = static_cast<Node256*>(n);
+            return x->c_[b] ? &x->c_[b] : nullptr;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+/*!
+ * @brief This method adds a child for a byte that an internal node does not have yet. A full node is replaced by
+ * a node of the next size.
+ * @param ref is reference to the pointer to the node, updated if the node is replaced.
+ * @param b is the byte.
+ * @param child is pointer to the child.
+ */
+template<typename V>
+void AdaptiveRadixTree<V>::_add_child(Node*& ref, uint8_t b, Node* child) {
+    switch (ref->type_) {
+        case Type::kNode4: {
+            auto x = static_cast<Node4*>(ref);
+            if (x->count_ < 4) {
+                int i = x->count_;
+                for (; i > 0 && x->keys_[i - 1] > b; --i) {
+                    x->keys_[i] = x->keys_[i - 1];
+                    x->c_[i] = x->c_[i - 1];
+                }
+                x->keys_[i] = b;
+                x->c_[i] = child;
+                ++x->count_;
+                return;
+            }
+            auto y = new Node16;
+            static_cast<Node&>(*y) = *x;
+            std::copy(x->keys_.begin(), x->keys_.end(), y->keys_.begin());
+            std::copy(x->c_.begin(), x->c_.end(), y->c_.begin());
+            y->type_ = Type::kNode16;
+            delete x;
+            ref = y;
+            break;
+        }
+        case Type::kNode16: {
+            auto x = static_cast<Node16*>(ref);
+            if (x->count_ < 16) {
+                int i = x->count_;
+                for (; i > 0 && x->keys_[i - 1] > b; --i) {
+                    x->keys_[i] = x->keys_[i - 1];
+                    x->c_[i] = x->c_[i - 1];
+                }
+                x->keys_[i] = b;
+                x->c_[i] = child;
+                ++x->count_;
+                return;
+            }
+            auto y = new Node48;
+            static_cast<Node&>(*y) = *x;
+            for (int i = 0; i < 16; ++i) {
+                y->index_[x->keys_[i]] = static_cast<uint8_t>(i + 1);
+                y->c_[i] = x->c_[i];
+            }
+            y->type_ = Type::kNode48;
+            delete x;
+            ref = y;
+            break;
+        }
+        case Type::kNode48: {
+            auto x = static_cast<Node48*>(ref);
+            if (x->count_ < 48) {
+                int slot = 0;
+                while (nullptr != x->c_[slot]) { ++slot; }
+                x->index_[b] = static_cast<uint8_t>(slot + 1);
+                x->c_[slot] = child;
+                ++x->count_;
+                return;
+            }
+            auto y = new Node256;
+            static_cast<Node&>(*y) = *x;
+            for (int i = 0; i < 256; ++i) {
+                if (x->index_[i]) { y->c_[i] = x->c_[x->index_[i] - 1]; }
+            }
+            y->type_ = Type::kNode256;
+            delete x;
+            ref = y;
+            break;
+        }
+        case Type::kNode256: {
+            auto x = static_cast<Node256*>(ref);
+            x->c_[b] = child;
+            ++x->count_;
+            return;
+        }
+        default:
+            return;
+    }
+    _add_child(ref, b, child);  // Into the larger node.
+}
+
+/*!
+ * @brief This method removes the child of an internal node for the given byte. A node left with too few children
+ * is replaced by a node of the previous size, and a node of 4 left with one child is merged into that child.
+ * @param ref is reference to the pointer to the node, updated if the node is replaced.
+ * @param b is the byte, which must have a child.
+ */
+template<typename V>
+void AdaptiveRadixTree<V>::_remove_child(Node*& ref, uint8_t b) {
+    switch (ref->type_) {
+        case Type::kNode4: {
+            auto x = static_cast<Node4*>(ref);
+            int i = static_cast<int>(_find_child(x, b) - x->c_.data());
+            for (--x->count_; i < x->count_; ++i) {
+                x->keys_[i] = x->keys_[i + 1];
+                x->c_[i] = x->c_[i + 1];
+            }
+            if (1 == x->count_) {  // Path compression: the only child takes over the prefix and the byte.
+                Node* child = x->c_[0];
+                if (Type::kLeaf != child->type_) {
+                    std::array<uint8_t, 3> prefix{};
+                    int length = x->prefix_length_;
+                    std::copy(x->prefix_.begin(), x->prefix_.begin() + length, prefix.begin());
+                    prefix[length++] = x->keys_[0];
+                    std::copy(child->prefix_.begin(), child->prefix_.begin() + child->prefix_length_,
+                              prefix.begin() + length);
+                    child->prefix_length_ = static_cast<uint8_t>(length + child->prefix_length_);
+                    child->prefix_ = prefix;
+                }
+                delete x;
+                ref = child;
+            }
+            return;
+        }
+        case Type::kNode16: {
+            auto x = static_cast<Node16*>(ref);
+            int i = static_cast<int>(_find_child(x, b) - x->c_.data());
+            for (--x->count_; i < x->count_; ++i) {
+                x->keys_[i] = x->keys_[i + 1];
+                x->c_[i] = x->c_[i + 1];
+            }
+            if (3 == x->count_) {
+                auto y = new Node4;
+                static_cast<Node&>(*y) = *x;
+                std::copy(x->keys_.begin(), x->keys_.begin() + 3, y->keys_.begin());
+                std::copy(x->c_.begin(), x->c_.begin() + 3, y->c_.begin());
+                y->type_ = Type::kNode4;
+                delete x;
+                ref = y;
+            }
+            return;
+        }
+        case Type::kNode48: {
+            auto x = static_cast<Node48*>(ref);
+            x->c_[x->index_[b] - 1] = nullptr;
+            x->index_[b] = 0;
+            if (12 == --x->count_) {
+                auto y = new Node16;
+                static_cast<Node&>(*y) = *x;
+                int j = 0;
+                for (int i = 0; i < 256; ++i) {
+                    if (x->index_[i]) {
+                        y->keys_[j] = static_cast<uint8_t>(i);
+                        y->c_[j++] = x->c_[x->index_[i] - 1];
+                    }
+                }
+                y->type_ = Type::kNode16;
+                delete x;
+                ref = y;
+            }
+            return;
+        }
+        case Type::kNode256: {
+            auto x = static_cast<Node256*>(ref);
+            x->c_[b] = nullptr;
+            if (37 == --x->count_) {
+                auto y = new Node48;
+                static_cast<Node&>(*y) = *x;
+                int slot = 0;
+                for (int i = 0; i < 256; ++i) {
+                    if (x->c_[i]) {
+                        y->index_[i] = static_cast<uint8_t>(slot + 1);
+                        y->c_[slot++] = x->c_[i];
+                    }
+                }
+                y->type_ = Type::kNode48;
+                delete x;
+                ref = y;
+            }
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+/*!
+ * @brief This method calls `g` on the children of an internal node in byte order until it returns false.
+ * @tparam G is type of the callable, invoked as `bool g(uint8_t, const Node*)`.
+ * @param n is pointer to the internal node.
+ * @param descending is true to visit the children in descending byte order.
+ * @param g is the callable.
+ * @return false if `g` returned false, true otherwise.
+ */
+template<typename V>
+template<typename G>
+bool AdaptiveRadixTree<V>::_for_each_child(const Node* n, bool descending, G&& g) {
+    auto sorted = [&](const uint8_t* keys, Node* const* c) {
+        for (int j = 0; j < n->count_; ++j) {
+            int i = descending ? n->count_ - 1 - j : j;
+            if (!g(keys[i], c[i])) { return false; }
+        }
+        return true;
+    };
+    switch (n->type_) {
+        case Type::kNode4: {
+            auto x = static_cast<const Node4*>(n);
+            return sorted(x->keys_.data(), x->c_.data());
+        }
+        case Type::kNode16: {
+            auto x = static_cast<const Node16*>(n);
+            return sorted(x->keys_.data(), x->c_.data());
+        }
+        case Type::kNode48: {
+            auto x = static_cast<const Node48*>(n);
+            for (int j = 0; j < 256; ++j) {
+                int i = descending ? 255 - j : j;
+                if (x->index_[i] && !g(static_cast<uint8_t>(i), x->c_[x->index_[i] - 1])) { return false; }
+            }
+            return true;
+        }
+        case Type::kNode256: {
+            auto x = static_cast<const Node256*>(n);
+            for (int j = 0; j < 256; ++j) {
+                int i = descending ? 255 - j : j;
+                if (x->c_[i] && !g(static_cast<uint8_t>(i), x->c_[i])) { return false; }
+            }
+            return true;
+        }
+        default:
+            return true;
+    }
+}
+
+/*!
+ * @brief This method frees a single node (not its children).
+ * @param n is pointer to the node.
+ */
+template<typename V>
+void AdaptiveRadixTree<V>::_free(Node* n) {
+    switch (n->type_) {
+        case Type::kLeaf:
+            delete static_cast<Leaf*>(n);
+            return;
+        case Type::kNode4:
+            delete static_cast<Node4*>(n);
+            return;
+        case Type::kNode16:
+            delete static_cast<Node16*>(n);
+            return;
+        case Type::kNode48:
+            delete static_cast<Node48*>(n);
+            return;
+        case Type::kNode256:
+            delete static_cast<Node256*>(n);
+            return;
+    }
+}
+
+/*!
+ * @brief This method frees a subtree.
+ * @param n is pointer to the root of the subtree (may be nullptr).
+ */
+template<typename V>
+void AdaptiveRadixTree<V>::_destroy(Node* n) {
+    if (nullptr == n) { return; }
+    _for_each_child(n, false, [](uint8_t, Node* child) {
+        _destroy(child);
+        return true;
+    });
+    _free(n);
+}
+
+/*!
+ * @brief This method copies a subtree.
+ * @param n is pointer to the root of the subtree (may be nullptr).
+ * @return pointer to the copy.
+ */
+template<typename V>
+typename AdaptiveRadixTree<V>::Node* AdaptiveRadixTree<V>::_clone(const Node* n) {
+    if (nullptr == n) { return nullptr; }
+    switch (n->type_) {
+        case Type::kLeaf:
+            return new Leaf(*static_cast<const Leaf*>(n));
+        case Type::kNode4: {
+            auto x = new Node4(*static_cast<const Node4*>(n));
+            for (int i = 0; i < x->count_; ++i) { x->c_[i] = _clone(x->c_[i]); }
+            return x;
+        }
+        case Type::kNode16: {
+            auto x = new Node16(*static_cast<const Node16*>(n));
+            for (int i = 0; i < x->count_; ++i) { x->c_[i] = _clone(x->c_[i]); }
+            return x;
+        }
+        case Type::kNode48: {
+            auto x = new Node48(*static_cast<const Node48*>(n));
+            for (auto& c : x->c_) { c = _clone(c); }
+            return x;
+        }
+        case Type::kNode256: {
+            auto x = new Node256(*static_cast<const Node256*>(n));
+            for (auto& c : x->c_) { c = _clone(c); }
+            return x;
+        }
+    }
+    return nullptr;
+}
+
+/*!
+ * @brief This method finds the leaf of an encoded key.
+ * @param key is the encoded key.
+ * @return pointer to the leaf, or nullptr if not found.
+ */
+template<typename V>
+typename AdaptiveRadixTree<V>::Leaf* AdaptiveRadixTree<V>::_find_leaf(uint32_t key) const {
+    Node* n = root_;
+    int depth = 0;
+    while (nullptr != n && Type::kLeaf != n->type_) {
+        for (int i = 0; i < n->prefix_length_; ++i) {
+            if (n->prefix_[i] != _byte(key, depth + i)) { return nullptr; }
+        }
+        depth += n->prefix_length_;
+        Node** child = _find_child(n, _byte(key, depth++));
+        n = nullptr == child ? nullptr : *child;
+    }
+    if (nullptr == n || key != static_cast<Leaf*>(n)->key_) { return nullptr; }
+    return static_cast<Leaf*>(n);
+}
+
+/*!
+ * @brief This method recursively inserts a key-value pair into a subtree, or overwrites the value of the key.
+ * @param ref is reference to the pointer to the root of the subtree, updated if the root is replaced.
+ * @param key is the encoded key.
+ * @param v is the value object, moved from.
+ * @param depth is the number of key bytes consumed above the subtree.
+ * @return true if a new pair was inserted, false if an existing value was overwritten.
+ */
+template<typename V>
+bool AdaptiveRadixTree<V>::_insert(Node*& ref, uint32_t key, V& v, int depth) {
+    if (nullptr == ref) {
+        ref = new Leaf(key, std::move(v));
+        return true;
+    }
+    if (Type::kLeaf == ref->type_) {
+        auto leaf = static_cast<Leaf*>(ref);
+        if (key == leaf->key_) {
+            leaf->value_ = std::move(v);
+            return false;
+        }
+        Node* n = new Node4;  // Branches where the two keys first differ.
+        while (_byte(key, depth) == _byte(leaf->key_, depth)) {
+            n->prefix_[n->prefix_length_++] = _byte(key, depth++);
+        }
+        _add_child(n, _byte(leaf->key_, depth), leaf);
+        _add_child(n, _byte(key, depth), new Leaf(key, std::move(v)));
+        ref = n;
+        return true;
+    }
+    for (int i = 0; i < ref->prefix_length_; ++i) {
+        if (ref->prefix_[i] == _byte(key, depth + i)) { continue; }
+        Node* n = new Node4;  // Splits the prefix where the key leaves it.
+        n->prefix_length_ = static_cast<uint8_t>(i);
+        std::copy(ref->prefix_.begin(), ref->prefix_.begin() + i, n->prefix_.begin());
+        uint8_t b = ref->prefix_[i];
+        ref->prefix_length_ = static_cast<uint8_t>(ref->prefix_length_ - i - 1);
+        std::copy(ref->prefix_.begin() + i + 1, ref->prefix_.begin() + i + 1 + ref->prefix_length_,
+                  ref->prefix_.begin());
+        _add_child(n, b, ref);
+        _add_child(n, _byte(key, depth + i), new Leaf(key, std::move(v)));
+        ref = n;
+        return true;
+    }
+    depth += ref->prefix_length_;
+    Node** child = _find_child(ref, _byte(key, depth));
+    if (nullptr != child) { return _insert(*child, key, v, depth + 1); }
+    _add_child(ref, _byte(key, depth), new Leaf(key, std::move(v)));
+    return true;
+}
+
+/*!
+ * @brief This method recursively removes a key from a subtree.
+ * @param ref is reference to the pointer to the root of the subtree, updated if the root is replaced.
+ * @param key is the encoded key.
+ * @param depth is the number of key bytes consumed above the subtree.
+ * @return true if removed, false if not found.
+ */
+template<typename V>
+bool AdaptiveRadixTree<V>::_remove(Node*& ref, uint32_t key, int depth) {
+    if (nullptr == ref) { return false; }
+    if (Type::kLeaf == ref->type_) {  // Only the root is checked here; other leaves are removed by their parent.
+        if (key != static_cast<Leaf*>(ref)->key_) { return false; }
+        _free(ref);
+        ref = nullptr;
+        return true;
+    }
+    for (int i = 0; i < ref->prefix_length_; ++i) {
+        if (ref->prefix_[i] != _byte(key, depth + i)) { return false; }
+    }
+    depth += ref->prefix_length_;
+    uint8_t b = _byte(key, depth);
+    Node** child = _find_child(ref, b);
+    if (nullptr == child) { return false; }
+    if (Type::kLeaf != (*child)->type_) { return _remove(*child, key, depth + 1); }
+    if (key != static_cast<Leaf*>(*child)->key_) { return false; }
+    _free(*child);
+    _remove_child(ref, b);
+    return true;
+}
+
+/*!
+ * @brief This method visits the keys of a subtree in `[lo, hi]`.
+ * @tparam F is type of the callable, invoked as `bool f(int, const V&)`; false stops the scan.
+ * @param n is pointer to the root of the subtree.
+ * @param base holds the key bytes consumed above the subtree (the others are 0).
+ * @param depth is the number of key bytes consumed above the subtree.
+ * @param lo is the inclusive lower bound, encoded.
+ * @param hi is the inclusive upper bound, encoded.
+ * @param descending is true to visit the keys in descending order.
+ * @param f is the callable.
+ * @return false if the scan was stopped, true otherwise.
+ */
+template<typename V>
+template<typename F>
+bool AdaptiveRadixTree<V>::_scan(const Node* n, uint32_t base, int depth, uint32_t lo, uint32_t hi,
+                                 bool descending, F& f) {
+    if (Type::kLeaf == n->type_) {
+        auto leaf = static_cast<const Leaf*>(n);
+        return leaf->key_ < lo || leaf->key_ > hi || f(_decode(leaf->key_), std::as_const(leaf->value_));
+    }
+    for (int i = 0; i < n->prefix_length_; ++i) {
+        base |= static_cast<uint32_t>(n->prefix_[i]) << (24 - 8 * depth++);
+    }
+    if ((base | _low_mask(depth)) < lo || base > hi) { return true; }  // Every key is out of range.
+    return _for_each_child(n, descending, [&](uint8_t b, const Node* child) {
+        uint32_t child_base = base | static_cast<uint32_t>(b) << (24 - 8 * depth);
+        if ((child_base | _low_mask(depth + 1)) < lo || child_base > hi) { return true; }
+        return _scan(child, child_base, depth + 1, lo, hi, descending, f);
+    });
+}
@@ -0,0 +1,93 @@
+/*!
+ * @brief This file contains the class definition of <em>AdaptiveRadixTree</em>.
+ */
+#ifndef CS225_SP22_C2_ADAPTIVERADIXTREE_H_
+#define CS225_SP22_C2_ADAPTIVERADIXTREE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/*!
+ * @brief This class implements an adaptive radix tree (ART) over `int` keys. A key is split into 4 bytes, most
+ * significant first (with the sign bit flipped, so that byte order is key order), and each internal node branches
+ * on one byte. Internal nodes come in 4 sizes (4, 16, 48 and 256 children) and are replaced by the next size when
+ * they fill up or by the previous one when they empty out, so sparse and dense key ranges both stay compact.
+ * Bytes shared by every key below a node are stored once in the node (path compression), and a subtree holding a
+ * single key is a leaf (lazy expansion). A lookup takes at most 4 steps, whatever the number of keys.
+ * @tparam V is type of value objects.
+ */
+template<typename V>
+class AdaptiveRadixTree {
+public:
+    AdaptiveRadixTree() = default;
+    AdaptiveRadixTree(const AdaptiveRadixTree& tree);
+    AdaptiveRadixTree& operator=(const AdaptiveRadixTree& tree);
+    virtual ~AdaptiveRadixTree();
+
+    bool upsert(int k, V v);
+    bool remove(int k);
+    [[nodiscard]] const V* find(int k) const;
+    template<typename F> bool update(int k, F&& f);
+    template<typename F> bool scan(int lo, int hi, bool descending, F&& f) const;
+    [[nodiscard]] size_t size() const;
+    void clear();
+
+private:
+    enum class Type : uint8_t { kLeaf, kNode4, kNode16, kNode48, kNode256 };
+
+    struct Node {
+        explicit Node(Type type) : type_(type) {}
+        Type type_;
+        uint8_t prefix_length_{};
+        uint16_t count_{};  // Number of children.
+        std::array<uint8_t, 3> prefix_{};  // Bytes shared by every key below, after the byte that led here.
+    };
+    struct Leaf : Node {
+        Leaf(uint32_t key, V value) : Node(Type::kLeaf), key_(key), value_(std::move(value)) {}
+        uint32_t key_;
+        V value_;
+    };
+    struct Node4 : Node {
+        Node4() : Node(Type::kNode4) {}
+        std::array<uint8_t, 4> keys_{};  // Sorted.
+        std::array<Node*, 4> c_{};
+    };
+    struct Node16 : Node {
+        Node16() : Node(Type::kNode16) {}
+        std::array<uint8_t, 16> keys_{};  // Sorted.
+        std::array<Node*, 16> c_{};
+    };
+    struct Node48 : Node {
+        Node48() : Node(Type::kNode48) {}
+        std::array<uint8_t, 256> index_{};  // 1 + slot of the child for each byte, 0 if none.
+        std::array<Node*, 48> c_{};
+    };
+    struct Node256 : Node {
+        Node256() : Node(Type::kNode256) {}
+        std::array<Node*, 256> c_{};
+    };
+
+    static uint32_t _encode(int k);
+    static int _decode(uint32_t key);
+    static uint8_t _byte(uint32_t key, int depth);
+    static uint32_t _low_mask(int depth);
+    static Node** _find_child(Node* n, uint8_t b);
+    static void _add_child(Node*& ref, uint8_t b, Node* child);
+    static void _remove_child(Node*& ref, uint8_t b);
+    template<typename G> static bool _for_each_child(const Node* n, bool descending, G&& g);
+    static void _free(Node* n);
+    static void _destroy(Node* n);
+    static Node* _clone(const Node* n);
+    Leaf* _find_leaf(uint32_t key) const;
+    bool _insert(Node*& ref, uint32_t key, V& v, int depth);
+    bool _remove(Node*& ref, uint32_t key, int depth);
+    template<typename F> static bool _scan(const Node* n, uint32_t base, int depth, uint32_t lo, uint32_t hi,
+                                           bool descending, F& f);
+
+    Node* root_{nullptr};
+    size_t size_{};
+};
+
+#endif //CS225_SP22_C2_ADAPTIVERADIXTREE_H_
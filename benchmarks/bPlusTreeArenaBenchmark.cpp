@@ -0,0 +1,72 @@
+/*!
+ * @brief This file benchmarks the arena-allocated B+-tree against the shared_ptr-based <em>BPlusTree</em>
+ * on random insertions and lookups of integer keys.
+ * Usage: bench_bplustree_arena [num_keys]
+ */
+#include "../config.h"  // Must come first: BPlusTree.h relies on DEBUG for member access.
+#include "../BPlusTree.h"
+#include "../BPlusTree.cpp"
+#include "../ArenaBPlusTree.h"
+#include "../ArenaBPlusTree.cpp"
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <string>
+
+/*!
+ * @brief This function times a callable.
+ * @param f is the callable.
+ * @return elapsed seconds.
+ */
+template<typename F>
+double timeIt(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*!
+ * @brief This function inserts all keys and then looks all of them up in shuffled order.
+ * @param tree is the tree under test.
+ * @param name is the label printed in the report.
+ * @param inserts is the insertion order.
+ * @param lookups is the lookup order.
+ */
+template<typename Tree>
+void run(Tree& tree, const std::string& name, const std::vector<int>& inserts, const std::vector<int>& lookups) {
+    double insert_s = timeIt([&]() {
+        for (int k : inserts) { tree.insert(k, k); }
+    });
+    long found{};
+    double lookup_s = timeIt([&]() {
+        for (int k : lookups) { found += tree.contains(k); }
+    });
+    double n = static_cast<double>(inserts.size());
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << n / insert_s / 1e6 << std::setw(12) << n / lookup_s / 1e6
+              << std::setw(12) << found << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::stoi(argv[1]) : 10000000;
+    std::vector<int> inserts(n);
+    std::iota(inserts.begin(), inserts.end(), 0);
+    std::vector<int> lookups{inserts};
+    std::mt19937 generator{225};
+    std::shuffle(inserts.begin(), inserts.end(), generator);
+    std::shuffle(lookups.begin(), lookups.end(), generator);
+
+    std::cout << n << " random int keys (million operations per second)" << std::endl;
+    std::cout << std::left << std::setw(16) << "tree" << std::right << std::setw(12) << "insert"
+              << std::setw(12) << "lookup" << std::setw(12) << "found" << std::endl;
+    {
+        BPlusTree<int, int> tree;
+        run(tree, "shared_ptr", inserts, lookups);
+    }
+    {
+        ArenaBPlusTree<int, int> tree;
+        run(tree, "arena", inserts, lookups);
+    }
+    return 0;
+}
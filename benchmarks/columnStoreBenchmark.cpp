@@ -0,0 +1,98 @@
+/*!
+ * @brief This file benchmarks the aggregates of <em>ColumnStore</em> (total waiting time, counts per stage, per
+ * registry and per profession category) against the same aggregates computed row by row over an array of structs,
+ * as the monthly report used to over the records. Build with -DRQRS_NATIVE_ARCH=ON to measure the AVX2 path
+ * instead of SSE2.
+ * Usage: bench_column_store [rows] [repeats]
+ */
+#include "../columnStore.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/*!
+ * @brief This function returns the seconds elapsed since `start`.
+ * @param start is the starting time.
+ * @return the elapsed time in seconds.
+ */
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*!
+ * @brief This function times `repeats` calls of an aggregate and prints its throughput.
+ * @param name is the label printed in the report.
+ * @param rows is number of rows aggregated per call.
+ * @param repeats is number of calls.
+ * @param aggregate is the aggregate, returning a checksum of its result.
+ */
+template<typename F>
+void run(const std::string& name, size_t rows, int repeats, F&& aggregate) {
+    long long checksum{};
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) { checksum += aggregate(); }
+    double seconds = secondsSince(start);
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << static_cast<double>(rows) * repeats / seconds / 1e6 << " M rows/s   (checksum "
+              << checksum << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t rows = argc > 1 ? std::stoul(argv[1]) : 10000000;
+    int repeats = argc > 2 ? std::stoi(argv[2]) : 20;
+    std::minstd_rand generator{42};
+    const time_t now{1700000000};
+    ColumnStore store;
+    std::vector<ColumnStore::Row> records(rows);  // The same rows, one struct each.
+    for (size_t i = 0; i < rows; ++i) {
+        auto& row = records[i];
+        row.id = static_cast<int>(i);
+        row.registry = 1 + static_cast<int>(generator() % 5);
+        row.profession = 1 + static_cast<int>(generator() % 8);
+        row.age = 1 + static_cast<int>(generator() % 7);
+        row.risk = static_cast<int>(generator() % 4);
+        row.stage = static_cast<ColumnStore::Stage>(generator() % ColumnStore::kStages);
+        row.arrival = now - static_cast<time_t>(generator() % (86400 * 100));
+        row.treated = ColumnStore::Stage::kTreated == row.stage ? now - static_cast<time_t>(generator() % 86400) : -1;
+        store.upsert(row);
+    }
+    std::cout << rows << " rows, " << repeats << " repeats" << std::endl;
+
+    run("waiting days, rows", rows, repeats, [&] {
+        long long total{};
+        for (const auto& row : records) {
+            if (ColumnStore::Stage::kWithdrawn == row.stage) { continue; }
+            time_t end = row.treated < 0 ? now : row.treated;
+            total += static_cast<long long>(std::ceil(std::difftime(end, row.arrival) / 86400));
+        }
+        return total;
+    });
+    run("waiting days, columns", rows, repeats, [&] { return store.waitingDays(now); });
+
+    run("count by stage, rows", rows, repeats, [&] {
+        std::array<size_t, ColumnStore::kStages> counts{};
+        for (const auto& row : records) { ++counts[static_cast<size_t>(row.stage)]; }
+        return static_cast<long long>(counts[0]);
+    });
+    run("count by stage, columns", rows, repeats, [&] { return static_cast<long long>(store.countByStage()[0]); });
+
+    for (auto [name, column] : {std::pair{"registry", ColumnStore::Column::kRegistry},
+                                std::pair{"profession", ColumnStore::Column::kProfession}}) {
+        run(std::string{"count by "} + name + ", rows", rows, repeats, [&, column = column] {
+            std::array<size_t, ColumnStore::kMaxValues> counts{};
+            for (const auto& row : records) {
+                if (ColumnStore::Stage::kWithdrawn == row.stage) { continue; }
+                ++counts[ColumnStore::Column::kRegistry == column ? row.registry : row.profession];
+            }
+            return static_cast<long long>(counts[1]);
+        });
+        run(std::string{"count by "} + name + ", columns", rows, repeats,
+            [&, column = column] { return static_cast<long long>(store.countBy(column)[1]); });
+    }
+    return 0;
+}
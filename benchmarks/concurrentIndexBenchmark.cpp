@@ -0,0 +1,134 @@
+/*!
+ * @brief This file benchmarks the concurrent indexes <em>ConcurrentBPlusTree</em> and <em>ConcurrentBTree</em>
+ * against <em>BPlusTree</em> and <em>BTree</em> behind one reader-writer lock (the way the database indexes would
+ * have to be shared otherwise). Workers run a mix of lookups and upserts over a prefilled index; the report gives
+ * throughput as the number of threads grows. `int` keys exercise optimistic lock coupling, `std::string` keys
+ * the shared-latch mode.
+ * Usage: bench_concurrent_index [max_threads] [ops_per_thread] [write_percent]
+ */
+#include "../config.h"  // Must come first: BPlusTree.h relies on DEBUG for member access.
+#include "../BPlusTree.h"
+#include "../BPlusTree.cpp"
+#include "../BTree.h"
+#include "../BTree.cpp"
+#include "../ConcurrentBPlusTree.h"
+#include "../ConcurrentBPlusTree.cpp"
+#include "../ConcurrentBTree.h"
+#include "../ConcurrentBTree.cpp"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*!
+ * @brief This class wraps a single-threaded tree with one reader-writer lock. It is the baseline.
+ * @tparam Tree is type of the tree.
+ */
+template<typename Tree>
+class LockedTree {
+public:
+    template<typename K>
+    bool contains(const K& k) const {
+        std::shared_lock<std::shared_mutex> lock{mutex_};
+        return tree_.contains(k);
+    }
+    template<typename K>
+    bool upsert(const K& k, int v) {
+        std::unique_lock<std::shared_mutex> lock{mutex_};
+        return tree_.upsert(k, v);
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    Tree tree_;
+};
+
+/*!
+ * @brief This function runs a lookup/upsert mix on `threads` workers over an index prefilled with every other key.
+ * @param keys is the key space.
+ * @param threads is the number of workers.
+ * @param ops is the number of operations per worker.
+ * @param write_percent is the share of upserts, in percent.
+ * @return throughput in million operations per second.
+ */
+template<typename Index, typename K>
+double measureThroughput(const std::vector<K>& keys, unsigned threads, long ops, unsigned write_percent) {
+    Index index;
+    for (size_t i = 0; i < keys.size(); i += 2) { index.upsert(keys[i], static_cast<int>(i)); }
+    std::atomic<bool> go{false};
+    std::atomic<long> found{0};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&index, &keys, &go, &found, ops, write_percent, t]() {
+            std::minstd_rand generator{t + 1};
+            long hits{};
+            while (!go.load()) {}
+            for (long i = 0; i < ops; ++i) {
+                const K& k = keys[generator() % keys.size()];
+                if (generator() % 100 < write_percent) {
+                    index.upsert(k, static_cast<int>(i));
+                } else {
+                    hits += index.contains(k);
+                }
+            }
+            found += hits;
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& worker : workers) { worker.join(); }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(ops) * threads / elapsed.count() / 1e6;
+}
+
+/*!
+ * @brief This function prints one row of the report.
+ * @param name is the label of the index.
+ * @param keys is the key space.
+ * @param max_threads is the largest number of workers.
+ * @param ops is the number of operations per worker.
+ * @param write_percent is the share of upserts, in percent.
+ */
+template<typename Index, typename K>
+void report(const std::string& name, const std::vector<K>& keys, unsigned max_threads, long ops,
+            unsigned write_percent) {
+    std::cout << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(2);
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        std::cout << std::setw(9) << measureThroughput<Index>(keys, threads, ops, write_percent);
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned max_threads = argc > 1 ? std::stoul(argv[1]) : 32;
+    long ops = argc > 2 ? std::stol(argv[2]) : 200000;
+    unsigned write_percent = argc > 3 ? std::stoul(argv[3]) : 10;
+    constexpr int kKeySpace{1 << 18};
+    std::vector<int> int_keys(kKeySpace);
+    std::vector<std::string> string_keys(kKeySpace);
+    for (int i = 0; i < kKeySpace; ++i) {
+        int_keys[i] = static_cast<int>((i * 2654435761u) & 0x7FFFFFFF);
+        string_keys[i] = "patient-" + std::to_string(int_keys[i]);
+    }
+
+    std::cout << write_percent << "% upserts, " << ops << " ops per thread, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << std::left << std::setw(34) << "M ops/s by threads" << std::right;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) { std::cout << std::setw(9) << threads; }
+    std::cout << std::endl;
+    report<LockedTree<BPlusTree<int, int>>>("locked BPlusTree<int>", int_keys, max_threads, ops, write_percent);
+    report<ConcurrentBPlusTree<int, int>>("ConcurrentBPlusTree<int>", int_keys, max_threads, ops, write_percent);
+    report<LockedTree<BTree<int, int>>>("locked BTree<int>", int_keys, max_threads, ops, write_percent);
+    report<ConcurrentBTree<int, int>>("ConcurrentBTree<int>", int_keys, max_threads, ops, write_percent);
+    report<LockedTree<BTree<std::string, int>>>("locked BTree<string>", string_keys, max_threads, ops,
+                                                write_percent);
+    report<ConcurrentBTree<std::string, int>>("ConcurrentBTree<string>", string_keys, max_threads, ops,
+                                              write_percent);
+    return 0;
+}
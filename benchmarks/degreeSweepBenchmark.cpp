@@ -0,0 +1,90 @@
+/*!
+ * @brief This file sweeps the node degree of <em>BPlusTree</em> and <em>BTree</em> and reports insertion and
+ * lookup throughput for `int` and `std::string` keys, so that a fanout can be picked per deployment.
+ * Usage: bench_degree_sweep [num_keys]
+ */
+#include "../config.h"  // Must come first: BPlusTree.h relies on DEBUG for member access.
+#include "../BPlusTree.h"
+#include "../BPlusTree.cpp"
+#include "../BTree.h"
+#include "../BTree.cpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+
+/*!
+ * @brief This function times a callable.
+ * @param f is the callable.
+ * @return elapsed seconds.
+ */
+template<typename F>
+double timeIt(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*!
+ * @brief This function inserts all keys into a fresh tree and then looks all of them up in another order.
+ * @param tree_name is the label of the tree printed in the report.
+ * @param degree is the degree printed in the report.
+ * @param inserts is the insertion order.
+ * @param lookups is the lookup order.
+ */
+template<typename Tree, typename K>
+void run(const std::string& tree_name, int degree, const std::vector<K>& inserts, const std::vector<K>& lookups) {
+    Tree tree;
+    double insert_s = timeIt([&]() {
+        for (const auto& k : inserts) { tree.insert(k, 0); }
+    });
+    long found{};
+    double lookup_s = timeIt([&]() {
+        for (const auto& k : lookups) { found += tree.contains(k); }
+    });
+    double n = static_cast<double>(inserts.size());
+    std::cout << std::left << std::setw(12) << tree_name << std::right << std::setw(8) << degree << std::fixed
+              << std::setprecision(2) << std::setw(12) << n / insert_s / 1e6 << std::setw(12)
+              << n / lookup_s / 1e6 << std::setw(12) << found << std::endl;
+}
+
+/*!
+ * @brief This function runs both trees for every degree in the sequence.
+ * @tparam K is type of key objects.
+ * @tparam Degrees are the degrees to sweep.
+ * @param label is the key type printed in the report.
+ * @param inserts is the insertion order.
+ * @param lookups is the lookup order.
+ */
+template<typename K, int... Degrees>
+void sweep(const std::string& label, const std::vector<K>& inserts, const std::vector<K>& lookups,
+           std::integer_sequence<int, Degrees...>) {
+    std::cout << std::endl << label << " keys (million operations per second)" << std::endl;
+    std::cout << std::left << std::setw(12) << "tree" << std::right << std::setw(8) << "degree" << std::setw(12)
+              << "insert" << std::setw(12) << "lookup" << std::setw(12) << "found" << std::endl;
+    (run<BPlusTree<K, int, Degrees>>("BPlusTree", Degrees, inserts, lookups), ...);
+    (run<BTree<K, int, Degrees>>("BTree", Degrees, inserts, lookups), ...);
+}
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    std::vector<int> inserts(n);
+    std::iota(inserts.begin(), inserts.end(), 0);
+    std::vector<int> lookups{inserts};
+    std::mt19937 generator{225};
+    std::shuffle(inserts.begin(), inserts.end(), generator);
+    std::shuffle(lookups.begin(), lookups.end(), generator);
+    std::vector<std::string> string_inserts, string_lookups;
+    for (int k : inserts) { string_inserts.push_back("user" + std::to_string(k)); }
+    for (int k : lookups) { string_lookups.push_back("user" + std::to_string(k)); }
+
+    std::cout << n << " random keys per run" << std::endl;
+    using Degrees = std::integer_sequence<int, 4, 8, 16, 32, 64, 128>;
+    sweep("int", inserts, lookups, Degrees{});
+    sweep("std::string", string_inserts, string_lookups, Degrees{});
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*!
+ * @brief This file benchmarks the in-node key search of a full B+-tree node (63 `int` keys) and of a full
+ * overflow block (16 unsorted keys): `std::lower_bound` and a plain loop vs. the routines in keySearch.h.
+ * Build with -DRQRS_NATIVE_ARCH=ON to measure the AVX2 path instead of SSE2.
+ * Usage: bench_key_search [queries]
+ */
+#include "../keySearch.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr int kNodeKeys{63};
+constexpr int kOverflowKeys{16};
+constexpr int kNodes{1 << 14};  // Enough nodes to defeat the branch predictor, few enough to stay in cache.
+
+/*!
+ * @brief This function times `queries` calls of a search routine over random nodes and keys.
+ * @param name is the label printed in the report.
+ * @param keys holds `kNodes` nodes of `width` keys each.
+ * @param width is number of keys per node.
+ * @param queries is the query keys.
+ * @param search is the search routine, called as `search(node, k)`.
+ */
+template<typename F>
+void run(const std::string& name, const std::vector<int>& keys, int width, const std::vector<int>& queries,
+         F&& search) {
+    long checksum{};
+    auto start = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < queries.size(); ++q) {
+        checksum += search(keys.data() + (q % kNodes) * width, queries[q]);
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << s / static_cast<double>(queries.size()) * 1e9 << " ns"
+              << std::setw(16) << checksum << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    long n = argc > 1 ? std::stol(argv[1]) : 50000000;
+    std::mt19937 generator{225};
+    std::uniform_int_distribution<int> dist{0, 1 << 20};
+    std::vector<int> sorted(static_cast<size_t>(kNodes) * kNodeKeys);
+    std::vector<int> unsorted(static_cast<size_t>(kNodes) * kOverflowKeys);
+    for (int j = 0; j < kNodes; ++j) {  // Sorted nodes with evenly spread keys.
+        for (int i = 0; i < kNodeKeys; ++i) { sorted[j * kNodeKeys + i] = i * (1 << 14) + j; }
+    }
+    for (auto& k : unsorted) { k = dist(generator) & 63; }
+    std::vector<int> queries(n);
+    for (auto& k : queries) { k = dist(generator); }
+
+#if defined(__AVX2__)
+    std::cout << "Vector path: AVX2" << std::endl;
+#elif defined(__SSE2__)
+    std::cout << "Vector path: SSE2" << std::endl;
+#else
+    std::cout << "Vector path: none" << std::endl;
+#endif
+    std::cout << n << " queries per routine (time per query, checksum)" << std::endl;
+    run("std::lower_bound (63 keys)", sorted, kNodeKeys, queries, [](const int* keys, int k) {
+        return static_cast<int>(std::lower_bound(keys, keys + kNodeKeys, k) - keys);
+    });
+    run("keyLowerBound (63 keys)", sorted, kNodeKeys, queries, [](const int* keys, int k) {
+        return keyLowerBound(keys, kNodeKeys, k);
+    });
+    run("loop find (16 keys)", unsorted, kOverflowKeys, queries, [](const int* keys, int k) {
+        for (int j = 0; j < kOverflowKeys; ++j) {
+            if (keys[j] == (k & 63)) { return j; }
+        }
+        return -1;
+    });
+    run("keyFind (16 keys)", unsorted, kOverflowKeys, queries, [](const int* keys, int k) {
+        return keyFind(keys, kOverflowKeys, k & 63);
+    });
+    return 0;
+}
@@ -0,0 +1,188 @@
+/*!
+ * @brief This file benchmarks the MultiQueue against a single lock-protected Fibonacci heap
+ * (the way the centralized queue would have to be shared). It reports throughput and rank error
+ * as the number of threads grows, then drains a <em>ConcurrentCentralizedQueue</em> while re-prioritizing
+ * some of its keys by id, and checks that every key is popped exactly once.
+ * Usage: bench_multiqueue [max_threads] [ops_per_thread]
+ */
+#include "../multiQueue.h"
+#include "../multiQueue.cpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+#include <string>
+
+/*!
+ * @brief This class wraps a Fibonacci heap with one global lock. It is the baseline.
+ */
+class LockedHeap {
+public:
+    void push(long k) {
+        std::lock_guard<std::mutex> lock{mutex_};
+        heap_.push(k);
+    }
+    bool try_pop(long& k) {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (heap_.empty()) { return false; }
+        k = heap_.top();
+        heap_.pop();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    FibonacciHeap<long> heap_;
+};
+
+/*!
+ * @brief This function runs a 50/50 push/pop mix on `threads` workers over a prefilled queue.
+ * @param queue is the queue under test.
+ * @param threads is the number of workers.
+ * @param ops is the number of operations per worker.
+ * @return throughput in million operations per second.
+ */
+template<typename Queue>
+double measureThroughput(Queue& queue, unsigned threads, long ops) {
+    for (long i = 0; i < 1 << 16; ++i) {
+        queue.push((i * 2654435761L) % (1L << 30));
+    }
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&queue, &go, ops, t]() {
+            std::minstd_rand generator{t + 1};
+            long k;
+            while (!go.load()) {}
+            for (long i = 0; i < ops; ++i) {
+                if (i & 1) {
+                    queue.try_pop(k);
+                } else {
+                    queue.push(static_cast<long>(generator() % (1L << 30)));
+                }
+            }
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& worker : workers) { worker.join(); }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(ops) * threads / elapsed.count() / 1e6;
+}
+
+/*!
+ * @brief This function drains a queue holding the keys 0..n-1 with `threads` workers and computes
+ * the rank error of every pop: how many smaller keys were still queued at that moment.
+ * @param queue is the queue under test (prefilled by this function).
+ * @param threads is the number of workers.
+ * @param n is the number of keys.
+ * @return a pair of (mean rank error, max rank error).
+ */
+template<typename Queue>
+std::pair<double, long> measureRankError(Queue& queue, unsigned threads, long n) {
+    std::vector<long> keys(n);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::minstd_rand{42});
+    for (auto k : keys) { queue.push(k); }
+    std::atomic<long> sequence{0};
+    std::vector<long> popped(n, -1);  // popped[s] is the key of the s-th pop.
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            long k;
+            while (queue.try_pop(k)) {
+                popped[sequence.fetch_add(1)] = k;
+            }
+        });
+    }
+    for (auto& worker : workers) { worker.join(); }
+    std::vector<long> fenwick(n + 1, 0);  // Counts of keys still queued.
+    auto add = [&](long i, long v) { for (++i; i <= n; i += i & -i) { fenwick[i] += v; }};
+    auto prefix = [&](long i) { long s{}; for (; i > 0; i -= i & -i) { s += fenwick[i]; } return s; };
+    for (long i = 0; i < n; ++i) { add(i, 1); }
+    double total{};
+    long worst{};
+    for (long s = 0; s < sequence; ++s) {
+        long rank = prefix(popped[s]);  // Smaller keys still present.
+        total += static_cast<double>(rank);
+        worst = std::max(worst, rank);
+        add(popped[s], -1);
+    }
+    return {total / static_cast<double>(n), worst};
+}
+
+/*!
+ * @brief This struct is a queued key with an id, like the records of the centralized queue.
+ */
+struct Item {
+    int id{};
+    long priority{};
+    [[nodiscard]] int GetId() const { return id; }
+};
+
+/*!
+ * @brief This functor orders items by priority (smaller first).
+ */
+struct ItemLess {
+    bool operator()(const Item& lhs, const Item& rhs) const { return lhs.priority < rhs.priority; }
+};
+
+std::ostream& operator<<(std::ostream& os, const Item& item) {
+    return os << item.id;
+}
+
+/*!
+ * @brief This function drains a ConcurrentCentralizedQueue of `n` items with `threads` workers. Before popping,
+ * each worker moves a share of the ids (one in eight) to the front of the queue with `updateKey`.
+ * @param threads is the number of workers.
+ * @param n is the number of items.
+ * @return true if every item was popped exactly once.
+ */
+bool checkCentralizedBackend(unsigned threads, int n) {
+    ConcurrentCentralizedQueue<Item, ItemLess> queue{threads};
+    for (int i = 0; i < n; ++i) { queue.push(Item{i, (i * 2654435761L) % (1L << 30)}); }
+    std::atomic<int> updated{0};
+    std::vector<std::atomic<int>> pops(n);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = static_cast<int>(t) * 8; i < n; i += static_cast<int>(threads) * 8) {
+                if (queue.updateKey(i, Item{i, -1L - i})) { updated++; }
+            }
+            Item item;
+            while (queue.try_pop(item)) { pops[item.id]++; }
+        });
+    }
+    for (auto& worker : workers) { worker.join(); }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    bool once = std::all_of(pops.begin(), pops.end(), [](const std::atomic<int>& p) { return 1 == p.load(); });
+    std::cout << std::setw(8) << threads << std::setw(16) << std::fixed << std::setprecision(2)
+              << static_cast<double>(n + updated) / elapsed.count() / 1e6 << std::setw(16) << updated
+              << std::setw(16) << (once ? "yes" : "NO") << std::endl;
+    return once;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned max_threads = argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency());
+    long ops = argc > 2 ? std::stol(argv[2]) : 1000000;
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "locked Mops/s" << std::setw(16) << "multiq Mops/s"
+              << std::setw(16) << "mean rank err" << std::setw(16) << "max rank err" << std::endl;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        LockedHeap locked;
+        double locked_tp = measureThroughput(locked, threads, ops);
+        MultiQueue<long> multi_queue{threads};
+        double multi_tp = measureThroughput(multi_queue, threads, ops);
+        MultiQueue<long> rank_queue{threads};
+        auto [mean_err, max_err] = measureRankError(rank_queue, threads, 1 << 18);
+        std::cout << std::setw(8) << threads << std::setw(16) << std::fixed << std::setprecision(2) << locked_tp
+                  << std::setw(16) << multi_tp << std::setw(16) << mean_err << std::setw(16) << max_err << std::endl;
+    }
+    std::cout << std::endl << std::setw(8) << "threads" << std::setw(16) << "backend Mops/s" << std::setw(16)
+              << "updated by id" << std::setw(16) << "popped once" << std::endl;
+    bool ok{true};
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        ok = checkCentralizedBackend(threads, 1 << 18) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+/*!
+ * @brief This file benchmarks the disk-backed <em>PagedBPlusTree</em>: building an index of `int` keys and
+ * record-sized values, checkpointing it, reopening it, and looking keys up with a buffer pool smaller than the file.
+ * Usage: bench_paged_bplustree [num_keys] [frames] [path]
+ */
+#include "../PagedBPlusTree.h"
+#include "../PagedBPlusTree.cpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+
+/*!
+ * @brief This function times a callable.
+ * @param f is the callable.
+ * @return elapsed seconds.
+ */
+template<typename F>
+double timeIt(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*!
+ * @brief This function prints one line of the report.
+ * @param name is the label of the phase.
+ * @param s is elapsed seconds.
+ * @param ops is number of operations (0 to omit the throughput).
+ */
+void report(const std::string& name, double s, size_t ops) {
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << s * 1e3 << " ms";
+    if (ops) { std::cout << std::setw(12) << static_cast<double>(ops) / s / 1e6 << " M ops/s"; }
+    std::cout << std::endl;
+}
+
+/*!
+ * @brief This function prints the buffer pool counters.
+ * @param pool is the buffer pool.
+ */
+void reportPool(const BufferPool& pool) {
+    const auto& stats = pool.stats();
+    std::cout << "    hits " << stats.hits << ", misses " << stats.misses << ", evictions " << stats.evictions
+              << ", writes " << stats.writes << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    size_t frames = argc > 2 ? std::stoul(argv[2]) : 1024;
+    std::string path = argc > 3 ? argv[3] : "bench_paged_bplustree.db";
+    std::vector<int> keys(n);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::mt19937 generator{225};
+    std::shuffle(keys.begin(), keys.end(), generator);
+    std::string value(150, 'x');  // About the size of an encoded database record.
+
+    ::unlink(path.c_str());
+    std::cout << n << " keys, " << frames << " frames of " << kPageSize << " bytes" << std::endl;
+    {
+        PagedBPlusTree<int, std::string> tree{path, frames};
+        report("insert", timeIt([&]() {
+            for (int k : keys) { tree.insert(k, value); }
+        }), n);
+        reportPool(tree.pool());
+        report("checkpoint", timeIt([&]() { tree.checkpoint(); }), 0);
+        std::cout << "    " << tree.pool().pageCount() << " pages" << std::endl;
+    }
+    std::shuffle(keys.begin(), keys.end(), generator);
+    double reopen_s{};
+    long found{};
+    {
+        std::unique_ptr<PagedBPlusTree<int, std::string>> tree{};
+        reopen_s = timeIt([&]() { tree = std::make_unique<PagedBPlusTree<int, std::string>>(path, frames); });
+        report("reopen", reopen_s, 0);
+        report("random lookup", timeIt([&]() {
+            for (int k : keys) { found += tree->contains(k); }
+        }), n);
+        reportPool(tree->pool());
+        report("full scan", timeIt([&]() {
+            for (auto iter = tree->begin(); iter != tree->end(); ++iter) { found += iter.key() >= 0; }
+        }), n);
+    }
+    std::cout << "found " << found << " (expected " << 2L * n << ")" << std::endl;
+    ::unlink(path.c_str());
+    return 0;
+}
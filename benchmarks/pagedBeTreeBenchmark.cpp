@@ -0,0 +1,135 @@
+/*!
+ * @brief This file benchmarks the update churn of the disk-backed indexes: record-sized values of `int` keys are
+ * updated at random, in place through <em>PagedBPlusTree</em> (read, modify, write back) and as buffered patches
+ * through <em>PagedBeTree</em>, with a buffer pool smaller than the file. The page misses and writes show the I/O
+ * each update costs.
+ * Usage: bench_paged_betree [num_keys] [num_updates] [frames]
+ */
+#include "../PagedBPlusTree.h"
+#include "../PagedBPlusTree.cpp"
+#include "../PagedBeTree.h"
+#include "../PagedBeTree.cpp"
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+
+/*!
+ * @brief This struct overwrites the status field (the first 4 bytes) of a value, like a medical status update.
+ */
+struct StatusPatch {
+    int status;
+
+    /*!
+     * @brief This method applies the patch.
+     * @param v is the value.
+     */
+    void apply(std::string& v) const { std::memcpy(v.data(), &status, sizeof(status)); }
+};
+
+/*!
+ * @brief This function times a callable.
+ * @param f is the callable.
+ * @return elapsed seconds.
+ */
+template<typename F>
+double timeIt(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*!
+ * @brief This function prints one line of the report, with the buffer pool counters per operation.
+ * @param name is the label of the phase.
+ * @param s is elapsed seconds.
+ * @param ops is number of operations.
+ * @param before is the buffer pool counters before the phase.
+ * @param after is the buffer pool counters after the phase.
+ */
+void report(const std::string& name, double s, size_t ops, const BufferPool::Stats& before,
+            const BufferPool::Stats& after) {
+    auto per_op = [&](size_t a, size_t b) { return static_cast<double>(a - b) / static_cast<double>(ops); };
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << s * 1e3 << " ms" << std::setw(10) << static_cast<double>(ops) / s / 1e6
+              << " M ops/s" << std::setprecision(3) << std::setw(10) << per_op(after.misses, before.misses)
+              << " misses/op" << std::setw(10) << per_op(after.writes, before.writes) << " writes/op" << std::endl;
+}
+
+/*!
+ * @brief This function loads a tree, churns it with updates and looks every key up.
+ * @tparam Tree is type of the tree.
+ * @tparam U is type of the callable that updates a key, invoked as `u(tree, key, status)`.
+ * @param name is the label of the tree.
+ * @param tree is the tree.
+ * @param n is number of keys.
+ * @param updates is the keys to update, in order.
+ * @param u is the callable.
+ * @return number of keys whose status matches the last update.
+ */
+template<typename Tree, typename U>
+long run(const std::string& name, Tree& tree, int n, const std::vector<int>& updates, U&& u) {
+    std::string value(150, 'x');  // About the size of an encoded database record.
+    std::memset(value.data(), 0, sizeof(int));
+    for (int k = 0; k < n; ++k) { tree.insert(k, value); }
+    tree.checkpoint();
+    auto before = tree.pool().stats();
+    double s = timeIt([&]() {
+        for (size_t i = 0; i < updates.size(); ++i) { u(tree, updates[i], static_cast<int>(i)); }
+        tree.checkpoint();
+    });
+    report(name + " update", s, updates.size(), before, tree.pool().stats());
+    std::vector<int> last(n, 0);
+    for (size_t i = 0; i < updates.size(); ++i) { last[updates[i]] = static_cast<int>(i); }
+    long matched{};
+    before = tree.pool().stats();
+    s = timeIt([&]() {
+        for (int k = 0; k < n; ++k) {
+            auto v = tree.find(k);
+            int status{};
+            std::memcpy(&status, v->data(), sizeof(status));
+            matched += status == last[k];
+        }
+    });
+    report(name + " lookup", s, n, before, tree.pool().stats());
+    return matched;
+}
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::stoi(argv[1]) : 200000;
+    size_t m = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    size_t frames = argc > 3 ? std::stoul(argv[3]) : 256;
+    std::mt19937 generator{225};
+    std::uniform_int_distribution<int> key{0, n - 1};
+    std::vector<int> updates(m);
+    for (auto& k : updates) { k = key(generator); }
+
+    std::cout << n << " keys, " << m << " updates, " << frames << " frames of " << kPageSize << " bytes"
+              << std::endl;
+    long matched{};
+    {
+        ::unlink("bench_paged_betree_bplus.db");
+        PagedBPlusTree<int, std::string> tree{"bench_paged_betree_bplus.db", frames};
+        matched += run("PagedBPlusTree", tree, n, updates, [](auto& t, int k, int status) {
+            t.update(k, [&](std::string& v) { StatusPatch{status}.apply(v); });
+        });
+    }
+    {
+        ::unlink("bench_paged_betree_be.db");
+        PagedBeTree<int, std::string, StatusPatch> tree{"bench_paged_betree_be.db", frames};
+        matched += run("PagedBeTree", tree, n, updates, [](auto& t, int k, int status) {
+            t.patch(k, StatusPatch{status});
+        });
+        std::cout << "    " << tree.pending() << " messages still buffered" << std::endl;
+    }
+    std::cout << "matched " << matched << " (expected " << 2L * n << ")" << std::endl;
+    ::unlink("bench_paged_betree_bplus.db");
+    ::unlink("bench_paged_betree_be.db");
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*!
+ * @brief This file benchmarks the storage engines that can back the primary index (see `makeStorageEngine`) on a
+ * record-sized payload: bulk loading sorted IDs, point lookups, 100-key ordered scans, then a mix of the three with
+ * upserts (half of them to new IDs), all through the <em>StorageEngine</em> interface, as the application would
+ * call it. The hash engine reads its whole table per scan, so scans are timed on 1 in 1000 operations and are left
+ * out of the default mix.
+ * Usage: bench_storage_engine [keys] [ops] [lookup_percent] [scan_percent]
+ */
+#include "../config.h"  // Must come first: BPlusTree.h relies on DEBUG for member access.
+#include "../storageEngine.h"
+#include "../BPlusTree.cpp"
+#include "../BTree.cpp"
+#include "../flatHashMap.cpp"
+#include "../adaptiveRadixTree.cpp"
+#include "../storageEngine.cpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/*!
+ * @brief This struct stands in for a database record: about the same size, and cheap to copy.
+ */
+struct Payload {
+    int id_{};
+    std::array<char, 124> bytes_{};
+};
+
+/*!
+ * @brief This function returns the seconds elapsed since `start`.
+ * @param start is the starting time.
+ * @return the elapsed time in seconds.
+ */
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*!
+ * @brief This function prints one row of the report: bulk load, lookup, scan and mixed throughput of an engine.
+ * @param name is the name of the engine.
+ * @param keys is the number of IDs to load (0 to `2 * keys - 2`, every other ID).
+ * @param ops is the number of operations of each phase.
+ * @param lookup_percent is the share of lookups in the mix, in percent.
+ * @param scan_percent is the share of scans in the mix, in percent.
+ */
+void report(const char* name, int keys, long ops, unsigned lookup_percent, unsigned scan_percent) {
+    auto engine = makeStorageEngine<Payload>(name);
+    std::vector<std::pair<int, Payload>> entries(keys);
+    for (int i = 0; i < keys; ++i) { entries[i] = {2 * i, Payload{2 * i, {}}}; }
+    auto start = std::chrono::steady_clock::now();
+    engine->bulk_load(std::move(entries));
+    double load = keys / secondsSince(start) / 1e6;
+
+    std::minstd_rand generator{42};
+    long hits{};
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ops; ++i) {
+        const Payload* payload = engine->find(static_cast<int>(generator() % (2u * keys)));
+        hits += nullptr != payload;
+    }
+    double lookup = ops / secondsSince(start) / 1e6;
+
+    auto visit = [](const int&, const Payload& payload) { return payload.id_ >= 0; };
+    long visited{};
+    long scans = std::max(ops / 1000, 1L);
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < scans; ++i) {
+        int id = static_cast<int>(generator() % (2u * keys));
+        visited += engine->scan(id, id + 199, false, visit);
+    }
+    double scan = scans / secondsSince(start) / 1e3;
+
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ops; ++i) {
+        unsigned op = generator() % 100;
+        int id = static_cast<int>(generator() % (2u * keys));
+        if (op < lookup_percent) {
+            hits += nullptr != engine->find(id);
+        } else if (op < lookup_percent + scan_percent) {
+            visited += engine->scan(id, id + 199, false, visit);
+        } else {
+            engine->upsert(id, Payload{id, {}});
+        }
+    }
+    double mixed = ops / secondsSince(start) / 1e6;
+
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << load << std::setw(12) << lookup << std::setw(12) << scan << std::setw(12) << mixed
+              << std::setw(12) << engine->size() << "   (" << hits << " hits, " << visited << " scanned)"
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int keys = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    long ops = argc > 2 ? std::stol(argv[2]) : 2000000;
+    unsigned lookup_percent = argc > 3 ? std::stoul(argv[3]) : 90;
+    unsigned scan_percent = argc > 4 ? std::stoul(argv[4]) : 0;
+    std::cout << keys << " keys, " << ops << " ops, mix: " << lookup_percent << "% lookups, " << scan_percent
+              << "% scans, " << 100 - lookup_percent - scan_percent << "% upserts" << std::endl;
+    std::cout << std::left << std::setw(12) << "engine" << std::right << std::setw(12) << "load M/s"
+              << std::setw(12) << "lookup M/s" << std::setw(12) << "scan K/s" << std::setw(12) << "mixed M/s"
+              << std::setw(12) << "final size" << std::endl;
+    for (const char* name : kStorageEngineNames) { report(name, keys, ops, lookup_percent, scan_percent); }
+    return 0;
+}
@@ -0,0 +1,428 @@
+/*!
+ * @brief This file contains the implementation of classes <em>PageHandle</em> and <em>BufferPool</em>.
+ */
+#include "bufferPool.h"
+#include "utilities.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*!
+ * @brief This constructor pins nothing; it is used by the buffer pool after pinning a frame.
+ * @param pool is pointer to the owning pool.
+ * @param frame is index of the pinned frame.
+ */
+PageHandle::PageHandle(BufferPool* pool, size_t frame) : pool_(pool), frame_(frame) {}
+
+/*!
+ * @brief This move constructor takes over the pin of another handle.
+ * @param handle is the handle to move from.
+ */
+PageHandle::PageHandle(PageHandle&& handle) noexcept: pool_(handle.pool_), frame_(handle.frame_) {
+    handle.pool_ = nullptr;
+}
+
+/*!
+ * @brief This move assignment operator releases the current pin and takes over the pin of another handle.
+ * @param handle is the handle to move from.
+ * @return reference to this handle.
+ */
+PageHandle& PageHandle::operator=(PageHandle&& handle) noexcept {
+    if (this != &handle) {
+        release();
+        pool_ = handle.pool_;
+        frame_ = handle.frame_;
+        handle.pool_ = nullptr;
+    }
+    return *this;
+}
+
+/*!
+ * @brief This destructor releases the pin.
+ */
+PageHandle::~PageHandle() {
+    release();
+}
+
+/*!
+ * @brief This method returns the page number of the pinned page.
+ * @return the page number.
+ */
+page_id PageHandle::id() const {
+    return pool_->frames_[frame_].id_;
+}
+
+/*!
+ * @brief This method returns the cached bytes of the pinned page. They stay valid until the pin is released.
+ * @return pointer to `kPageSize` bytes.
+ */
+char* PageHandle::data() const {
+    return pool_->_data(frame_);
+}
+
+/*!
+ * @brief This method marks the pinned page as modified, so that it is written back before being evicted.
+ */
+void PageHandle::markDirty() {
+    pool_->frames_[frame_].dirty_ = true;
+}
+
+/*!
+ * @brief This method releases the pin early. The handle becomes empty.
+ */
+void PageHandle::release() {
+    if (nullptr != pool_) {
+        pool_->_unpin(frame_);
+        pool_ = nullptr;
+    }
+}
+
+/*!
+ * @brief This operator checks if the handle pins a page.
+ * @return true if it does, false otherwise.
+ */
+PageHandle::operator bool() const {
+    return nullptr != pool_;
+}
+
+/*!
+ * @brief This constructor opens (or creates) the database file at its last checkpoint.
+ * @param path is path to the file.
+ * @param frames is number of cached pages (at least `kMinFrames`).
+ * @throw IOError if the file cannot be opened or has no valid header.
+ */
+BufferPool::BufferPool(const std::string& path, size_t frames)
+    : frames_(std::max(frames, kMinFrames)), buffer_(new char[std::max(frames, kMinFrames) * kPageSize]) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) { throw IOError(); }
+    struct stat st{};
+    try {
+        if (0 != ::fstat(fd_, &st)) { throw IOError(); }
+        _open(static_cast<size_t>(st.st_size));
+        if (0 == st.st_size) { syncParentDirectory(path); }  // The new file must survive a crash too.
+    } catch (const IOError&) {
+        ::close(fd_);
+        throw;
+    }
+}
+
+/*!
+ * @brief This destructor writes back all dirty pages and closes the file. Errors cannot be reported here,
+ * so owners should call `flush()` themselves first.
+ */
+BufferPool::~BufferPool() {
+    try {
+        flush();
+    } catch (const IOError& error) {
+        std::cerr << error.what() << std::endl;
+    }
+    ::close(fd_);
+}
+
+/*!
+ * @brief This method pins a page, reading it from the file if it is not cached.
+ * @param id is the page number.
+ * @return handle to the pinned page.
+ * @throw IOError if the page cannot be read.
+ * @throw std::runtime_error if every frame is pinned.
+ */
+PageHandle BufferPool::fetch(page_id id) {
+    auto iter = table_.find(id);
+    if (table_.end() != iter) {
+        ++stats_.hits;
+        auto& frame = frames_[iter->second];
+        ++frame.pins_;
+        frame.referenced_ = true;
+        return PageHandle{this, iter->second};
+    }
+    ++stats_.misses;
+    size_t i = _victim();
+    if (id < locations_.size() && kNullPage != locations_[id]) {
+        _read_page(locations_[id], _data(i));
+    } else {
+        std::memset(_data(i), 0, kPageSize);  // Allocated but never written back.
+    }
+    frames_[i] = Frame{id, 1, false, true};
+    table_[id] = i;
+    return PageHandle{this, i};
+}
+
+/*!
+ * @brief This method appends a zeroed page to the file and pins it. The page is written back like any other.
+ * @return handle to the pinned page.
+ */
+PageHandle BufferPool::allocate() {
+    size_t i = _victim();
+    std::memset(_data(i), 0, kPageSize);
+    auto id = static_cast<page_id>(locations_.size());
+    locations_.push_back(kNullPage);
+    frames_[i] = Frame{id, 1, true, true};
+    table_[id] = i;
+    modified_ = true;
+    return PageHandle{this, i};
+}
+
+/*!
+ * @brief This method makes a checkpoint: it writes every dirty page and the page map to pages of the file that the
+ * previous checkpoint does not use, forces them to stable storage, then commits them by writing and forcing the
+ * next header page. Pages used only by the previous checkpoint are free afterwards.
+ * @throw IOError if a page cannot be written.
+ * @throw std::runtime_error if the page map does not fit in a header page.
+ */
+void BufferPool::flush() {
+    for (size_t i = 0; i < frames_.size(); ++i) {
+        if (frames_[i].dirty_) { _write(i); }
+    }
+    if (!modified_) { return; }
+    size_t count = (locations_.size() + kEntriesPerMapPage - 1) / kEntriesPerMapPage;
+    if (count > kMaxMapPages) { throw std::runtime_error("The buffer pool file has too many pages!"); }
+    std::unique_ptr<char[]> page{new char[kPageSize]};
+    std::vector<page_id> map_pages;
+    for (size_t m = 0; m < count; ++m) {
+        size_t first = m * kEntriesPerMapPage;
+        size_t n = std::min(kEntriesPerMapPage, locations_.size() - first);
+        std::memset(page.get(), 0, kPageSize);
+        std::memcpy(page.get(), locations_.data() + first, n * sizeof(page_id));
+        map_pages.push_back(_free_slot());
+        _write_page(map_pages.back(), page.get());
+    }
+    if (0 != ::fsync(fd_)) { throw IOError(); }
+    std::memset(page.get(), 0, kPageSize);
+    setPageField<uint64_t>(page.get(), 0, kMagic);
+    setPageField<uint64_t>(page.get(), 8, sequence_ + 1);
+    setPageField<uint32_t>(page.get(), 16, static_cast<uint32_t>(locations_.size()));
+    setPageField<uint32_t>(page.get(), 20, static_cast<uint32_t>(count));
+    std::memcpy(page.get() + kHeaderSize, map_pages.data(), count * sizeof(page_id));
+    setPageField<uint32_t>(page.get(), 24, _checksum(page.get(), kPageSize));
+    _write_page(static_cast<page_id>((sequence_ + 1) % 2), page.get());
+    if (0 != ::fsync(fd_)) { throw IOError(); }
+    ++sequence_;
+    map_pages_ = std::move(map_pages);
+    modified_ = false;
+    _collect();
+}
+
+/*!
+ * @brief This method returns number of pages, including pages not yet written back.
+ * @return the number of pages.
+ */
+page_id BufferPool::pageCount() const {
+    return static_cast<page_id>(locations_.size());
+}
+
+/*!
+ * @brief This method returns number of frames.
+ * @return the number of frames.
+ */
+size_t BufferPool::frames() const {
+    return frames_.size();
+}
+
+/*!
+ * @brief This method returns the event counters.
+ * @return reference to the counters.
+ */
+const BufferPool::Stats& BufferPool::stats() const {
+    return stats_;
+}
+
+/*!
+ * @brief This method frees a frame with the clock algorithm: the hand skips pinned frames and gives referenced
+ * frames a second chance. A dirty victim is written back first.
+ * @return index of the free frame.
+ * @throw std::runtime_error if every frame is pinned.
+ */
+size_t BufferPool::_victim() {
+    for (size_t step = 0; step < 2 * frames_.size() + 1; ++step) {
+        size_t i = hand_;
+        hand_ = (hand_ + 1) % frames_.size();
+        auto& frame = frames_[i];
+        if (kNullPage == frame.id_) { return i; }
+        if (frame.pins_ > 0) { continue; }
+        if (frame.referenced_) {
+            frame.referenced_ = false;
+            continue;
+        }
+        if (frame.dirty_) { _write(i); }
+        table_.erase(frame.id_);
+        frame.id_ = kNullPage;
+        ++stats_.evictions;
+        return i;
+    }
+    throw std::runtime_error("Every buffer pool frame is pinned!");
+}
+
+/*!
+ * @brief This method writes a cached page back to the file. A page used by the checkpoint is not overwritten; the
+ * new version goes to a free page of the file instead.
+ * @param frame is index of the frame.
+ * @throw IOError if the page cannot be written.
+ */
+void BufferPool::_write(size_t frame) {
+    auto& slot = locations_[frames_[frame].id_];
+    if (kNullPage == slot || (slot < checkpointed_.size() && checkpointed_[slot])) { slot = _free_slot(); }
+    _write_page(slot, _data(frame));
+    frames_[frame].dirty_ = false;
+    modified_ = true;
+    ++stats_.writes;
+}
+
+/*!
+ * @brief This method releases one pin of a frame.
+ * @param frame is index of the frame.
+ */
+void BufferPool::_unpin(size_t frame) {
+    --frames_[frame].pins_;
+}
+
+/*!
+ * @brief This method returns the bytes of a frame.
+ * @param frame is index of the frame.
+ * @return pointer to `kPageSize` bytes.
+ */
+char* BufferPool::_data(size_t frame) const {
+    return buffer_.get() + frame * kPageSize;
+}
+
+/*!
+ * @brief This method loads the page map of the last checkpoint, or writes the first header of a new file.
+ * @param bytes is size of the file.
+ * @throw IOError if the file cannot be read or written, or has no valid header.
+ */
+void BufferPool::_open(size_t bytes) {
+    std::unique_ptr<char[]> page{new char[kPageSize]};
+    file_pages_ = std::max<page_id>(2, static_cast<page_id>(bytes / kPageSize));  // A torn last page is ignored.
+    if (bytes < kPageSize) {  // A new file: an empty checkpoint.
+        std::memset(page.get(), 0, kPageSize);
+        setPageField<uint64_t>(page.get(), 0, kMagic);
+        setPageField<uint32_t>(page.get(), 24, _checksum(page.get(), kPageSize));
+        _write_page(0, page.get());
+        if (0 != ::fsync(fd_)) { throw IOError(); }
+        _collect();
+        return;
+    }
+    bool found{false};
+    for (page_id slot = 0; slot < 2; ++slot) {
+        if (!_read_header(slot, page.get())) { continue; }
+        auto sequence = pageField<uint64_t>(page.get(), 8);
+        if (found && sequence <= sequence_) { continue; }
+        found = true;
+        sequence_ = sequence;
+        locations_.assign(pageField<uint32_t>(page.get(), 16), kNullPage);
+        map_pages_.resize(pageField<uint32_t>(page.get(), 20));
+        std::memcpy(map_pages_.data(), page.get() + kHeaderSize, map_pages_.size() * sizeof(page_id));
+    }
+    if (!found) { throw IOError(); }  // Not written by this class, or both headers damaged.
+    if (map_pages_.size() != (locations_.size() + kEntriesPerMapPage - 1) / kEntriesPerMapPage) { throw IOError(); }
+    for (size_t m = 0; m < map_pages_.size(); ++m) {
+        if (map_pages_[m] >= file_pages_) { throw IOError(); }
+        _read_page(map_pages_[m], page.get());
+        size_t first = m * kEntriesPerMapPage;
+        size_t n = std::min(kEntriesPerMapPage, locations_.size() - first);
+        std::memcpy(locations_.data() + first, page.get(), n * sizeof(page_id));
+    }
+    for (auto slot : locations_) {
+        if (kNullPage != slot && slot >= file_pages_) { throw IOError(); }  // Past the end of the file.
+    }
+    _collect();
+}
+
+/*!
+ * @brief This method reads a header page and checks it.
+ * @param slot is the page of the file (0 or 1).
+ * @param page is pointer to `kPageSize` bytes receiving the header.
+ * @return true if the header is complete and undamaged.
+ * @throw IOError if the file cannot be read.
+ */
+bool BufferPool::_read_header(page_id slot, char* page) const {
+    auto n = ::pread(fd_, page, kPageSize, static_cast<off_t>(slot) * static_cast<off_t>(kPageSize));
+    if (n < 0) { throw IOError(); }
+    if (static_cast<size_t>(n) != kPageSize || kMagic != pageField<uint64_t>(page, 0)) { return false; }
+    auto checksum = pageField<uint32_t>(page, 24);
+    setPageField<uint32_t>(page, 24, 0);
+    return checksum == _checksum(page, kPageSize) && pageField<uint32_t>(page, 20) <= kMaxMapPages;
+}
+
+/*!
+ * @brief This method reads a page of the file. Bytes past the end of the file read as zeros.
+ * @param slot is the page of the file.
+ * @param page is pointer to `kPageSize` bytes.
+ * @throw IOError if the page cannot be read.
+ */
+void BufferPool::_read_page(page_id slot, char* page) const {
+    auto n = ::pread(fd_, page, kPageSize, static_cast<off_t>(slot) * static_cast<off_t>(kPageSize));
+    if (n < 0) { throw IOError(); }
+    std::memset(page + n, 0, kPageSize - static_cast<size_t>(n));
+}
+
+/*!
+ * @brief This method writes a page of the file.
+ * @param slot is the page of the file.
+ * @param page is pointer to `kPageSize` bytes.
+ * @throw IOError if the page cannot be written.
+ */
+void BufferPool::_write_page(page_id slot, const char* page) const {
+    auto offset = static_cast<off_t>(slot) * static_cast<off_t>(kPageSize);
+    if (::pwrite(fd_, page, kPageSize, offset) != static_cast<ssize_t>(kPageSize)) { throw IOError(); }
+}
+
+/*!
+ * @brief This method takes a page of the file that the checkpoint does not use, growing the file if there is none.
+ * @return the page of the file.
+ */
+page_id BufferPool::_free_slot() {
+    if (free_.empty()) { return file_pages_++; }
+    auto slot = free_.back();
+    free_.pop_back();
+    return slot;
+}
+
+/*!
+ * @brief This method marks the pages of the file used by the checkpoint (headers, page map and the pages it maps)
+ * and frees the others, lowest first.
+ */
+void BufferPool::_collect() {
+    checkpointed_.assign(file_pages_, false);
+    checkpointed_[0] = checkpointed_[1] = true;
+    for (auto slot : locations_) {
+        if (kNullPage != slot) { checkpointed_[slot] = true; }
+    }
+    for (auto slot : map_pages_) { checkpointed_[slot] = true; }
+    free_.clear();
+    for (page_id slot = file_pages_; slot-- > 2;) {
+        if (!checkpointed_[slot]) { free_.push_back(slot); }
+    }
+}
+
+/*!
+ * @brief This function computes the 32-bit FNV-1a hash of a header page, which is enough to detect a torn write.
+ * @param data is the page.
+ * @param n is size of the page.
+ * @return the checksum.
+ */
+uint32_t BufferPool::_checksum(const char* data, size_t n) {
+    uint32_t hash{2166136261u};
+    for (size_t i = 0; i < n; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+/*!
+ * @brief This function forces the directory entries of the directory containing a file to stable storage, so that
+ * a file just created or renamed there is still found after a crash.
+ * @param path is path to the file.
+ * @throw IOError if the directory cannot be synchronized.
+ */
+void syncParentDirectory(const std::string& path) {
+    auto slash = path.find_last_of('/');
+    std::string directory{std::string::npos == slash ? "." : 0 == slash ? "/" : path.substr(0, slash)};
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) { throw IOError(); }
+    bool synced = 0 == ::fsync(fd);
+    ::close(fd);
+    if (!synced) { throw IOError(); }
+}
@@ -0,0 +1,154 @@
+/*!
+ * @brief This file contains the class definitions of <em>PageHandle</em> and <em>BufferPool</em>, which cache the
+ * fixed-size pages of a database file in memory.
+ */
+#ifndef CS225_SP22_C2_BUFFERPOOL_H_
+#define CS225_SP22_C2_BUFFERPOOL_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+using page_id = uint32_t;
+constexpr inline size_t kPageSize{4096};  // Bytes per page, on disk and in memory.
+constexpr inline page_id kNullPage{UINT32_MAX};
+
+class BufferPool;
+
+/*!
+ * @brief This function reads a field of a page. Pages carry no alignment guarantee, so the bytes are copied.
+ * @tparam T is type of the field.
+ * @param p is pointer to the page.
+ * @param offset is offset of the field.
+ * @return value of the field.
+ */
+template<typename T>
+T pageField(const char* p, size_t offset) {
+    T t;
+    std::memcpy(&t, p + offset, sizeof(T));
+    return t;
+}
+
+/*!
+ * @brief This function writes a field of a page.
+ * @tparam T is type of the field.
+ * @param p is pointer to the page.
+ * @param offset is offset of the field.
+ * @param t is the new value.
+ */
+template<typename T>
+void setPageField(char* p, size_t offset, T t) {
+    std::memcpy(p + offset, &t, sizeof(T));
+}
+
+/*!
+ * @brief This class pins one cached page for as long as it lives, so the page cannot be evicted while in use.
+ * It is move-only; the pin is released by the destructor or by `release()`.
+ */
+class PageHandle {
+    friend BufferPool;
+public:
+    PageHandle() = default;
+    PageHandle(const PageHandle& handle) = delete;
+    PageHandle& operator=(const PageHandle& handle) = delete;
+    PageHandle(PageHandle&& handle) noexcept;
+    PageHandle& operator=(PageHandle&& handle) noexcept;
+    virtual ~PageHandle();
+
+    [[nodiscard]] page_id id() const;
+    [[nodiscard]] char* data() const;
+    void markDirty();
+    void release();
+    explicit operator bool() const;
+
+private:
+    PageHandle(BufferPool* pool, size_t frame);
+
+    BufferPool* pool_{nullptr};
+    size_t frame_{};
+};
+
+/*!
+ * @brief This class caches pages of a file in a fixed number of frames. Pages are replaced with the clock
+ * algorithm and written back when evicted or on `flush()`; pinned pages are never evicted.
+ *
+ * The file is shadow-paged, so that it always holds the state of the last `flush()` (the checkpoint), whatever is
+ * evicted in between. Page numbers seen by the owner are mapped to pages of the file by a page map. A page that the
+ * checkpoint uses is never overwritten: its next version goes to a free page of the file. `flush()` writes the dirty
+ * pages and the page map to free pages, then commits them by writing a header page, which alternates between the
+ * first two pages of the file and carries a sequence number and a checksum. Opening the file takes the valid header
+ * with the larger sequence number, so a crash during a checkpoint leaves the previous one in place.
+ */
+class BufferPool {
+    friend PageHandle;
+public:
+    /*!
+     * @brief This struct counts buffer pool events since the pool was opened.
+     */
+    struct Stats {
+        size_t hits{};
+        size_t misses{};
+        size_t evictions{};
+        size_t writes{};
+    };
+
+    BufferPool(const std::string& path, size_t frames);
+    BufferPool(const BufferPool& pool) = delete;
+    BufferPool& operator=(const BufferPool& pool) = delete;
+    virtual ~BufferPool();
+
+    PageHandle fetch(page_id id);
+    PageHandle allocate();
+    void flush();
+    [[nodiscard]] page_id pageCount() const;
+    [[nodiscard]] size_t frames() const;
+    [[nodiscard]] const Stats& stats() const;
+
+private:
+    static constexpr size_t kMinFrames{8};  // Enough for the pages pinned at once by a split.
+    static constexpr uint64_t kMagic{0x4c4f4f5053525152};  // "RQRSPOOL", at the start of a header page.
+    static constexpr size_t kHeaderSize{28};  // Magic, sequence, page count, map page count and checksum.
+    static constexpr size_t kEntriesPerMapPage{kPageSize / sizeof(page_id)};
+    static constexpr size_t kMaxMapPages{(kPageSize - kHeaderSize) / sizeof(page_id)};  // About 4 GiB of pages.
+
+    struct Frame {
+        page_id id_{kNullPage};
+        int pins_{};
+        bool dirty_{};
+        bool referenced_{};
+    };
+
+    size_t _victim();
+    void _write(size_t frame);
+    void _unpin(size_t frame);
+    [[nodiscard]] char* _data(size_t frame) const;
+    void _open(size_t bytes);
+    bool _read_header(page_id slot, char* page) const;
+    void _read_page(page_id slot, char* page) const;
+    void _write_page(page_id slot, const char* page) const;
+    page_id _free_slot();
+    void _collect();
+    static uint32_t _checksum(const char* data, size_t n);
+
+    int fd_{-1};
+    std::vector<page_id> locations_{};  // Page -> page of the file holding its latest version (the page map).
+    std::vector<page_id> map_pages_{};  // Pages of the file holding the page map of the checkpoint.
+    std::vector<bool> checkpointed_{};  // Pages of the file used by the checkpoint, which must not be overwritten.
+    std::vector<page_id> free_{};  // Pages of the file not used by the checkpoint nor written since.
+    page_id file_pages_{};  // Number of pages of the file, headers included.
+    uint64_t sequence_{};  // Sequence number of the checkpoint.
+    bool modified_{};  // Pages written or allocated since the checkpoint.
+    std::vector<Frame> frames_;
+    std::unique_ptr<char[]> buffer_;  // frames_.size() pages, back to back.
+    std::unordered_map<page_id, size_t> table_{};  // Cached page -> frame.
+    size_t hand_{};  // Clock hand.
+    Stats stats_{};
+};
+
+void syncParentDirectory(const std::string& path);
+
+#endif //CS225_SP22_C2_BUFFERPOOL_H_
@@ -9,74 +9,93 @@
  * @tparam Comp is type of comparator.
  * @param comp_ is the customized comparator.
  */
-template<typename T, typename Comp, typename KeyHasher>
-CentralizedQueue<T, Comp, KeyHasher>::CentralizedQueue(Comp comp_)
+template<typename T, typename Comp, typename IdOf>
+CentralizedQueue<T, Comp, IdOf>::CentralizedQueue(Comp comp_)
     : Heap(comp_) {}
 
 /*!
- * @brief This method decreases a key and update the multimap and the heap.
+ * @brief This method decreases a key and update the index and the heap.
  * @param x is pointer to the node to be decreased.
  * @param k is the new key (pass by value).
  */
-template<typename T, typename Comp, typename KeyHasher>
-void CentralizedQueue<T, Comp, KeyHasher>::decreaseKey(Node* x, T k) {
-    multimap_.erase(x->key); // Remove the record with the key.
-    multimap_.insert({k, x});  // Insert the new pair into the map.
+template<typename T, typename Comp, typename IdOf>
+void CentralizedQueue<T, Comp, IdOf>::decreaseKey(Node* x, T k) {
+    reindex(x, k);
     Heap::FibHeapDecreaseKey(x, std::move(k));  // Perform heap operation.
 }
 
 /*!
- * @brief This method pushes a new object onto the priority queue.
+ * @brief This method replaces the key of a node with an arbitrary new key and update the index and the heap.
+ * It performs a decrease-key if the priority does not drop, and a cut-and-reinsert otherwise.
+ * @param x is pointer to the node to be updated (stays valid).
  * @param k is the new key (pass by value).
  */
-template<typename T, typename Comp, typename KeyHasher>
-typename CentralizedQueue<T, Comp, KeyHasher>::Node* CentralizedQueue<T, Comp, KeyHasher>::push(T k) {
-    auto x = Heap::push(k);
-    multimap_.insert({std::move(k), x});  // Bug fixed here. Always remember not to use something already moved.
-    return x;
+template<typename T, typename Comp, typename IdOf>
+void CentralizedQueue<T, Comp, IdOf>::updateKey(Node* x, T k) {
+    reindex(x, k);
+    if (Heap::comp_(x->key, k)) {  // Priority lowered.
+        Heap::FibHeapIncreaseKey(x, std::move(k));
+    } else {
+        Heap::FibHeapDecreaseKey(x, std::move(k));
+    }
+}
+
+/*!
+ * @brief This method applies a batch of key updates (e.g. a whole profession category being promoted).
+ * Each update costs one index lookup plus one key update.
+ * @tparam Range is any iterable range of (id, new key) pairs.
+ * @param updates is the range of updates. Ids not in the queue are skipped.
+ * @return number of updates applied.
+ */
+template<typename T, typename Comp, typename IdOf>
+template<typename Range>
+size_t CentralizedQueue<T, Comp, IdOf>::reprioritize(const Range& updates) {
+    size_t count{};
+    for (const auto& [id, k] : updates) {
+        Node* x = find_by_id(id);
+        if (!x) { continue; }
+        updateKey(x, k);
+        count++;
+    }
+    return count;
 }
 
 /*!
- * @brief This method finds the object with the given key on the multimap.
- * @param k is the key to look for.
- * @return an iterator to the desired key-node pair.
+ * @brief This method pushes a new object onto the priority queue.
+ * @param k is the new key (pass by value).
  */
-template<typename T, typename Comp, typename KeyHasher>
-typename CentralizedQueue<T, Comp, KeyHasher>::Iterator
-CentralizedQueue<T, Comp, KeyHasher>::find(const T& k) {
-    return multimap_.find(k);
+template<typename T, typename Comp, typename IdOf>
+typename CentralizedQueue<T, Comp, IdOf>::Node* CentralizedQueue<T, Comp, IdOf>::push(T k) {
+    auto x = Heap::push(std::move(k));
+    index_.insert_or_assign(id_of_(x->key), x);
+    return x;
 }
 
 /*!
- * @brief This function finds an node with the specified key in the multimap.
- * @param found is flag indicates success or failure of the search operation.
- * @param k is reference to the desired key object.
- * @return an iterator to the desired key-node pair.
+ * @brief This method finds the node holding the object with the given id.
+ * @param id is the id to look for.
+ * @return pointer to the node, or nullptr if not found.
  */
-template<typename T, typename Comp, typename KeyHasher>
-typename CentralizedQueue<T, Comp, KeyHasher>::Iterator
-CentralizedQueue<T, Comp, KeyHasher>::find(bool& found, const T& k) {
-    auto iter = multimap_.find(k);
-    found = iter != multimap_.end();
-    return iter;
+template<typename T, typename Comp, typename IdOf>
+typename CentralizedQueue<T, Comp, IdOf>::Node* CentralizedQueue<T, Comp, IdOf>::find_by_id(const Id& id) const {
+    auto ptr = index_.find(id);
+    return ptr ? *ptr : nullptr;
 }
 
 /*!
  * @brief This method removes the object with the highest priority from the priority queue.
  */
-template<typename T, typename Comp, typename KeyHasher>
-void CentralizedQueue<T, Comp, KeyHasher>::pop() {
+template<typename T, typename Comp, typename IdOf>
+void CentralizedQueue<T, Comp, IdOf>::pop() {
     if (Heap::empty()) { return; }
     auto x = Heap::FibHeapExtractMin();  // Remove the node from the heap.
-    auto range = multimap_.equal_range(x->key);  // Locate the range with the same key.
-    auto iter = std::find_if(range.first, range.second, [x](const std::pair<T, Node*>& ele) -> bool {
-        return ele.second == x;
-    });  // Find the first element with the given key.
-    if (iter != range.second) {  // Key found!
-        multimap_.erase(iter);  // Remove from the multimap.
+    auto id = id_of_(x->key);
+    if (find_by_id(id) == x) {  // Key found!
+        index_.erase(id);  // Remove from the index.
     } else {
-        std::cerr << "Key " << x->key << " not found in multimap." << std::endl;
+        std::cerr << "Key " << x->key << " not found in index." << std::endl;
     }
+    delete x;
 }
 
 /*!
@@ -84,36 +103,35 @@ void CentralizedQueue<T, Comp, KeyHasher>::pop() {
  * @param k is the key to find.
  * @return pointer to the node.
  */
-template<typename T, typename Comp, typename KeyHasher>
-typename CentralizedQueue<T, Comp, KeyHasher>::Node* CentralizedQueue<T, Comp, KeyHasher>::findNode(const T& k) {
-    Iterator iter = find(k);
-    return iter->second;
+template<typename T, typename Comp, typename IdOf>
+typename CentralizedQueue<T, Comp, IdOf>::Node* CentralizedQueue<T, Comp, IdOf>::findNode(const T& k) const {
+    return find_by_id(id_of_(k));
 }
 
 /*!
- * @brief This functions searches the entire multimap_ for a key-node pair whose key satisfies the input predicate.
- * @param found is flag indicating success or failure of searching operation.
- * @param pred is a predicate which compares keys (e.g. a lambda expression).
- * @return an iterator to the desired key-node pair.
+ * @brief This function gets pointers to all objects in the queue.
+ * @return a vector of pointers to the keys.
  */
-template<typename T, typename Comp, typename KeyHasher>
-typename CentralizedQueue<T, Comp, KeyHasher>::Iterator
-CentralizedQueue<T, Comp, KeyHasher>::find_if(bool& found,
-                                              const std::function<bool(const std::pair<T, Node*>&)>& pred) {
-    auto iter = std::find_if(multimap_.begin(), multimap_.end(), pred);
-    found = iter != multimap_.end();
-    return iter;
+template<typename T, typename Comp, typename IdOf>
+std::vector<const T*> CentralizedQueue<T, Comp, IdOf>::get_ptrs() const {
+    std::vector<const T*> vec;
+    vec.reserve(index_.size());
+    for (const auto& pair : index_) {
+        vec.template emplace_back(&pair.second->key);
+    }  // Get a vector of pointers to all keys in the index.
+    return vec;
 }
 
 /*!
- * @brief This function gets pointers to all objects in the multimap.
- * @return a vector of pointers to the keys.
+ * @brief This method moves the index entry of a node if its new key carries a different id.
+ * @param x is pointer to the node.
+ * @param k is reference to the new key.
  */
-template<typename T, typename Comp, typename KeyHasher>
-std::vector<const T*> CentralizedQueue<T, Comp, KeyHasher>::get_ptrs() const {
-    std::vector<const T*> vec;
-    for (auto iter = multimap_.begin(); iter != multimap_.end(); ++iter) {
-        vec.template emplace_back(&iter->second->key);
-    }  // Get a vector of pointers to all keys in the multimap.
-    return vec;
+template<typename T, typename Comp, typename IdOf>
+void CentralizedQueue<T, Comp, IdOf>::reindex(Node* x, const T& k) {
+    auto old_id = id_of_(x->key);
+    auto new_id = id_of_(k);
+    if (old_id == new_id) { return; }
+    if (find_by_id(old_id) == x) { index_.erase(old_id); }
+    index_.insert_or_assign(new_id, x);
 }
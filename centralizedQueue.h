@@ -6,26 +6,40 @@
 
 #include "fibonacciHeap.h"
 #include "fibonacciHeap.cpp"
-#include <unordered_map>
+#include "flatHashMap.h"
+#include "flatHashMap.cpp"
+#include <type_traits>
+
+/*!
+ * @brief This functor extracts the identifier of a queued object. Replace it for keys
+ * without a `GetId()` method.
+ * @tparam T is type of keys.
+ */
+template<typename T>
+struct KeyId {
+    auto operator()(const T& k) const { return k.GetId(); }
+};
 
 /*!
  * @brief This class implements a priority queue with a <em>Fibonacci heap</em>.
- * search operations accelerated to <em>constant time</em> complexity with std::unordered_map.
+ * search operations by id accelerated to <em>constant time</em> complexity with a flat hash map.
+ * Ids of queued objects are expected to be unique.
  * @tparam T is type of keys.
  * @tparam Comp is type of comparators (functor with overloaded () operator).
- * @tparam Hasher is the hashing function of the keys.
+ * @tparam IdOf is the functor which extracts the identifier of a key.
  */
-template<typename T, typename Comp = std::less<T>, typename Hasher = std::hash<T>>
+template<typename T, typename Comp = std::less<T>, typename IdOf = KeyId<T>>
 class CentralizedQueue : public FibonacciHeap<T, Comp> {
 public:
     // Setting alias.
     using Heap = FibonacciHeap<T, Comp>;
     using Node = typename Heap::FibonacciNode;
-    using Iterator = typename std::unordered_map<T, Node*, Hasher>::iterator;
+    using Id = std::decay_t<std::invoke_result_t<IdOf, const T&>>;
 
 private:
     // Fields.
-    std::unordered_multimap<T, Node*, Hasher> multimap_;  // Protected!
+    FlatHashMap<Id, Node*> index_;  // Maps ids to heap nodes. Protected!
+    IdOf id_of_{};
 
 public:
     // Constructors and destructor.
@@ -41,11 +55,16 @@ public:
     Node* push(T k) override;
     void pop() override;
     void decreaseKey(Node* x, T k);
-    [[nodiscard]] Iterator find(const T& k);
-    [[nodiscard]] Iterator find(bool& found, const T& k);  // Overloaded find with boolean flag.
-    [[nodiscard]] Iterator find_if(bool& found, const std::function<bool(const std::pair<T, Node*>&)>& pred);
-    [[nodiscard]] Node* findNode(const T& k);  // Debugging purposes only.
+    void updateKey(Node* x, T k);
+    template<typename Range>
+    size_t reprioritize(const Range& updates);  // Range of (id, key) pairs.
+    [[nodiscard]] Node* find_by_id(const Id& id) const;
+    [[nodiscard]] Node* findNode(const T& k) const;  // Debugging purposes only.
     [[nodiscard]] std::vector<const T*> get_ptrs() const;
+
+private:
+    // Private helper functions.
+    void reindex(Node* x, const T& k);
 };
 
 #endif //CS225_SP22_C1_CENTRALIZEDQUEUE_H_
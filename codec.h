@@ -0,0 +1,89 @@
+/*!
+ * @brief This file contains the serialization helpers and the default <em>Codec</em> used by the disk-backed indexes.
+ * Values are stored in host byte order, so a database file is only portable between machines of the same endianness.
+ */
+#ifndef CS225_SP22_C2_CODEC_H_
+#define CS225_SP22_C2_CODEC_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+/*!
+ * @brief This function appends the bytes of a trivially copyable object to a buffer.
+ * @tparam T is type of the object.
+ * @param out is the buffer.
+ * @param t is the object.
+ */
+template<typename T>
+void codecPut(std::string& out, const T& t) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable objects can be copied bytewise.");
+    out.append(reinterpret_cast<const char*>(&t), sizeof(T));
+}
+
+/*!
+ * @brief This function appends a length-prefixed string to a buffer.
+ * @param out is the buffer.
+ * @param s is the string.
+ */
+inline void codecPutString(std::string& out, const std::string& s) {
+    codecPut(out, static_cast<uint32_t>(s.size()));
+    out.append(s);
+}
+
+/*!
+ * @brief This function reads a trivially copyable object and advances the cursor past it.
+ * @tparam T is type of the object.
+ * @param in is the cursor.
+ * @return the object.
+ */
+template<typename T>
+T codecGet(const char*& in) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable objects can be copied bytewise.");
+    T t;
+    std::memcpy(&t, in, sizeof(T));
+    in += sizeof(T);
+    return t;
+}
+
+/*!
+ * @brief This function reads a length-prefixed string and advances the cursor past it.
+ * @param in is the cursor.
+ * @return the string.
+ */
+inline std::string codecGetString(const char*& in) {
+    auto n = codecGet<uint32_t>(in);
+    std::string s{in, n};
+    in += n;
+    return s;
+}
+
+/*!
+ * @brief This class (de)serializes objects for the disk-backed indexes. The primary template copies trivially
+ * copyable types bytewise; other types need a specialization providing `encode` and `decode`. Key codecs must
+ * also provide `fixed_size`, the length of every encoding.
+ * @tparam T is type of the objects.
+ */
+template<typename T>
+struct Codec {
+    static_assert(std::is_trivially_copyable_v<T>, "Specialize Codec for types that are not trivially copyable.");
+    static constexpr size_t fixed_size{sizeof(T)};
+
+    static void encode(const T& t, std::string& out) { codecPut(out, t); }
+
+    static T decode(const char* in, size_t) { return codecGet<T>(in); }
+};
+
+/*!
+ * @brief This specialization stores the characters of a string without a length prefix (the page records it).
+ */
+template<>
+struct Codec<std::string> {
+    static void encode(const std::string& s, std::string& out) { out.append(s); }
+
+    static std::string decode(const char* in, size_t n) { return std::string{in, n}; }
+};
+
+#endif //CS225_SP22_C2_CODEC_H_
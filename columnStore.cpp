@@ -0,0 +1,264 @@
+/*!
+ * @brief This file contains the implementation of <em>ColumnStore</em>.
+ */
+#include "columnStore.h"
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/*!
+ * @brief This function splits a time into whole days since the epoch and seconds of the day.
+ * @param t is the time.
+ * @param day receives the day.
+ * @param second receives the second of the day, from 0 to 86399.
+ */
+static void splitTime(time_t t, int32_t& day, int32_t& second) {
+    constexpr time_t kDay{86400};
+    time_t d = t / kDay;
+    time_t s = t % kDay;
+    if (s < 0) {  // Round towards negative infinity.
+        s += kDay;
+        --d;
+    }
+    day = static_cast<int32_t>(d);
+    second = static_cast<int32_t>(s);
+}
+
+/*!
+ * @brief This function counts the rows of each value in an `int16_t` column, skipping the rows of one stage.
+ * Each block of rows is compared with every value, and the matches are added up in 16-bit lanes, which are
+ * widened before they can overflow.
+ * @tparam N is number of values counted, from 0 to N - 1; other values are not counted.
+ * @param values is the column.
+ * @param stage is the stage column.
+ * @param n is number of rows.
+ * @param skipped is the stage whose rows are skipped.
+ * @param counts receives the counts, added to the first N entries.
+ */
+template<int N>
+static void countValues(const int16_t* values, const int16_t* stage, size_t n, int16_t skipped, size_t* counts) {
+    constexpr size_t kBlocks{32767};  // Blocks added up before a 16-bit lane could overflow.
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i skip16 = _mm256_set1_epi16(skipped);
+    while (n - i >= 16) {
+        __m256i acc[N];
+        for (auto& lanes : acc) { lanes = _mm256_setzero_si256(); }
+        size_t end = i + std::min((n - i) / 16, kBlocks) * 16;
+        for (; i < end; i += 16) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i drop = _mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(stage + i)), skip16);
+            for (int b = 0; b < N; ++b) {  // A match is -1, so subtracting it counts it.
+                __m256i match = _mm256_cmpeq_epi16(v, _mm256_set1_epi16(static_cast<int16_t>(b)));
+                acc[b] = _mm256_sub_epi16(acc[b], _mm256_andnot_si256(drop, match));
+            }
+        }
+        for (int b = 0; b < N; ++b) {
+            alignas(32) uint16_t lanes[16];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc[b]);
+            for (uint16_t lane : lanes) { counts[b] += lane; }
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i skip8 = _mm_set1_epi16(skipped);
+    while (n - i >= 8) {
+        __m128i acc[N];
+        for (auto& lanes : acc) { lanes = _mm_setzero_si128(); }
+        size_t end = i + std::min((n - i) / 8, kBlocks) * 8;
+        for (; i < end; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            __m128i drop = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(stage + i)), skip8);
+            for (int b = 0; b < N; ++b) {
+                __m128i match = _mm_cmpeq_epi16(v, _mm_set1_epi16(static_cast<int16_t>(b)));
+                acc[b] = _mm_sub_epi16(acc[b], _mm_andnot_si128(drop, match));
+            }
+        }
+        for (int b = 0; b < N; ++b) {
+            alignas(16) uint16_t lanes[8];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc[b]);
+            for (uint16_t lane : lanes) { counts[b] += lane; }
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (stage[i] != skipped && values[i] >= 0 && values[i] < N) { ++counts[values[i]]; }
+    }
+}
+
+/*!
+ * @brief This method adds a record to the store, or overwrites its row if the ID is already there.
+ * @param row is the record.
+ */
+void ColumnStore::upsert(const Row& row) {
+    auto [iter, inserted] = rows_.try_emplace(row.id, stage_.size());
+    if (inserted) {
+        for (auto* column : {&registry_, &profession_, &age_, &risk_, &stage_}) { column->emplace_back(); }
+        for (auto* column : {&arrival_day_, &arrival_second_, &treated_day_, &treated_second_}) {
+            column->emplace_back();
+        }
+    }
+    size_t i = iter->second;
+    registry_[i] = static_cast<int16_t>(row.registry);
+    profession_[i] = static_cast<int16_t>(row.profession);
+    age_[i] = static_cast<int16_t>(row.age);
+    risk_[i] = static_cast<int16_t>(row.risk);
+    for (auto column : {Column::kRegistry, Column::kProfession, Column::kAge, Column::kRisk}) {
+        auto& largest = largest_[static_cast<size_t>(column)];
+        largest = std::max(largest, _column(column)[i]);
+    }
+    stage_[i] = static_cast<int16_t>(row.stage);
+    splitTime(row.arrival, arrival_day_[i], arrival_second_[i]);
+    if (row.treated < 0) {
+        treated_day_[i] = -1;
+        treated_second_[i] = 0;
+    } else {
+        splitTime(row.treated, treated_day_[i], treated_second_[i]);
+    }
+}
+
+/*!
+ * @brief This method returns number of rows, withdrawn records included.
+ * @return the number of rows.
+ */
+size_t ColumnStore::size() const {
+    return stage_.size();
+}
+
+/*!
+ * @brief This method counts the records in each stage.
+ * @return the counts, indexed by stage.
+ */
+std::array<size_t, ColumnStore::kStages> ColumnStore::countByStage() const {
+    std::array<size_t, 8> counts{};
+    countValues<8>(stage_.data(), stage_.data(), stage_.size(), -1, counts.data());
+    std::array<size_t, kStages> result{};
+    std::copy_n(counts.begin(), kStages, result.begin());
+    return result;
+}
+
+/*!
+ * @brief This method counts the records of each value of a column, withdrawn records excluded.
+ * @param column is the column.
+ * @return the counts, indexed by value.
+ */
+std::array<size_t, ColumnStore::kMaxValues> ColumnStore::countBy(Column column) const {
+    const auto& values = _column(column);
+    std::array<size_t, kMaxValues> counts{};
+    auto skipped = static_cast<int16_t>(Stage::kWithdrawn);
+    int16_t largest = largest_[static_cast<size_t>(column)];
+    if (largest < 4) {  // Fewer values to compare each block with.
+        countValues<4>(values.data(), stage_.data(), values.size(), skipped, counts.data());
+    } else if (largest < 8) {
+        countValues<8>(values.data(), stage_.data(), values.size(), skipped, counts.data());
+    } else {
+        countValues<kMaxValues>(values.data(), stage_.data(), values.size(), skipped, counts.data());
+    }
+    return counts;
+}
+
+/*!
+ * @brief This method adds up the waiting time of the records, withdrawn records excluded, in whole days rounded up
+ * as `RegistrationRecord::GetWaitingTime()` does: until the treatment, or until `now` if not treated yet.
+ * With both times split into days and seconds of the day, that is the difference of the days plus one if the end
+ * is later in its day than the arrival, so no division is needed.
+ * @param now is the current time.
+ * @return the total waiting time in days.
+ */
+long long ColumnStore::waitingDays(time_t now) const {
+    int32_t now_day, now_second;
+    splitTime(now, now_day, now_second);
+    const int32_t* arrival_day = arrival_day_.data();
+    const int32_t* arrival_second = arrival_second_.data();
+    const int32_t* treated_day = treated_day_.data();
+    const int32_t* treated_second = treated_second_.data();
+    const int16_t* stage = stage_.data();
+    const size_t n = stage_.size();
+    constexpr size_t kBlocks{16384};  // Blocks added up before a 32-bit lane could overflow.
+    long long total{};
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i now_day8 = _mm256_set1_epi32(now_day);
+    const __m256i now_second8 = _mm256_set1_epi32(now_second);
+    const __m256i none8 = _mm256_set1_epi32(-1);
+    const __m256i withdrawn8 = _mm256_set1_epi32(static_cast<int32_t>(Stage::kWithdrawn));
+    while (n - i >= 8) {
+        __m256i acc = _mm256_setzero_si256();
+        size_t end = i + std::min((n - i) / 8, kBlocks) * 8;
+        for (; i < end; i += 8) {
+            __m256i td = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(treated_day + i));
+            __m256i ts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(treated_second + i));
+            __m256i open = _mm256_cmpeq_epi32(td, none8);
+            __m256i day = _mm256_blendv_epi8(td, now_day8, open);
+            __m256i second = _mm256_blendv_epi8(ts, now_second8, open);
+            __m256i ad = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arrival_day + i));
+            __m256i as = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arrival_second + i));
+            __m256i days = _mm256_sub_epi32(day, ad);
+            __m256i later = _mm256_cmpgt_epi32(second, as);
+            days = _mm256_sub_epi32(days, later);
+            __m256i st = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(stage + i)));
+            acc = _mm256_add_epi32(acc, _mm256_andnot_si256(_mm256_cmpeq_epi32(st, withdrawn8), days));
+        }
+        alignas(32) int32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        for (int32_t lane : lanes) { total += lane; }
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i now_day4 = _mm_set1_epi32(now_day);
+    const __m128i now_second4 = _mm_set1_epi32(now_second);
+    const __m128i none4 = _mm_set1_epi32(-1);
+    const __m128i withdrawn4 = _mm_set1_epi32(static_cast<int32_t>(Stage::kWithdrawn));
+    while (n - i >= 4) {
+        __m128i acc = _mm_setzero_si128();
+        size_t end = i + std::min((n - i) / 4, kBlocks) * 4;
+        for (; i < end; i += 4) {
+            __m128i td = _mm_loadu_si128(reinterpret_cast<const __m128i*>(treated_day + i));
+            __m128i ts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(treated_second + i));
+            __m128i open = _mm_cmpeq_epi32(td, none4);  // SSE2 has no blend: select with and/andnot/or.
+            __m128i day = _mm_or_si128(_mm_and_si128(open, now_day4), _mm_andnot_si128(open, td));
+            __m128i second = _mm_or_si128(_mm_and_si128(open, now_second4), _mm_andnot_si128(open, ts));
+            __m128i ad = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrival_day + i));
+            __m128i as = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrival_second + i));
+            __m128i days = _mm_sub_epi32(day, ad);
+            __m128i later = _mm_cmpgt_epi32(second, as);  // -1 where the end is later in its day.
+            days = _mm_sub_epi32(days, later);
+            __m128i st = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(stage + i));
+            st = _mm_srai_epi32(_mm_unpacklo_epi16(st, st), 16);  // Sign-extend 4 stages to 32 bits.
+            acc = _mm_add_epi32(acc, _mm_andnot_si128(_mm_cmpeq_epi32(st, withdrawn4), days));
+        }
+        alignas(16) int32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        for (int32_t lane : lanes) { total += lane; }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (static_cast<int16_t>(Stage::kWithdrawn) == stage[i]) { continue; }
+        bool open = treated_day[i] < 0;
+        int32_t day = open ? now_day : treated_day[i];
+        int32_t second = open ? now_second : treated_second[i];
+        total += day - arrival_day[i] + (second > arrival_second[i]);
+    }
+    return total;
+}
+
+/*!
+ * @brief This method returns a column grouped by `countBy`.
+ * @param column is the column.
+ * @return the values of the column.
+ */
+const std::vector<int16_t>& ColumnStore::_column(Column column) const {
+    switch (column) {
+        case Column::kRegistry:
+            return registry_;
+        case Column::kProfession:
+            return profession_;
+        case Column::kAge:
+            return age_;
+        case Column::kRisk:
+        default:
+            return risk_;
+    }
+}
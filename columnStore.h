@@ -0,0 +1,76 @@
+/*!
+ * @brief This file contains the class definition of <em>ColumnStore</em>.
+ */
+#ifndef CS225_SP22_C2_COLUMNSTORE_H_
+#define CS225_SP22_C2_COLUMNSTORE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ * @brief This class keeps the attributes that reports aggregate over, one row per registration record, as a
+ * struct of arrays: `int16_t` columns for the registry, profession category, age category, risk status and stage,
+ * and `int32_t` columns for the arrival and treatment times, split into days and seconds of the day. An aggregate
+ * reads only the columns it needs, 4 (SSE2) or 8 (AVX2, when compiled with `-mavx2`) rows of `int32_t` or 8 or 16
+ * rows of `int16_t` per instruction, without data-dependent branches. Rows are never removed: a withdrawn record
+ * keeps its row in the withdrawn stage, which the aggregates skip.
+ */
+class ColumnStore {
+public:
+    /*!
+     * @brief This enumeration lists where a record is: the waiting list, a local queue, the centralized queue, the
+     * appointment list, the treated list or the pending (withdrawn) list.
+     */
+    enum class Stage : int16_t { kWaitingList, kLocalQueue, kCentralizedQueue, kAppointment, kTreated, kWithdrawn };
+
+    /*!
+     * @brief This enumeration lists the columns that `countBy` groups by.
+     */
+    enum class Column { kRegistry, kProfession, kAge, kRisk };
+
+    static constexpr int kStages{6};
+    static constexpr int kMaxValues{16};  // Grouped columns hold values from 0 to 15; others are not counted.
+
+    /*!
+     * @brief This struct holds the attributes of one record, as given to `upsert`.
+     */
+    struct Row {
+        int id{};
+        int registry{};
+        int profession{};
+        int age{};
+        int risk{};
+        Stage stage{};
+        time_t arrival{};
+        time_t treated{-1};  // Time of the treatment, or -1 if not treated yet.
+    };
+
+    void upsert(const Row& row);
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] std::array<size_t, kStages> countByStage() const;
+    [[nodiscard]] std::array<size_t, kMaxValues> countBy(Column column) const;
+    [[nodiscard]] long long waitingDays(time_t now) const;
+
+private:
+    static constexpr int32_t kSecondsPerDay{86400};
+
+    [[nodiscard]] const std::vector<int16_t>& _column(Column column) const;
+
+    std::unordered_map<int, size_t> rows_{};  // Row of each ID.
+    std::vector<int16_t> registry_{};
+    std::vector<int16_t> profession_{};
+    std::vector<int16_t> age_{};
+    std::vector<int16_t> risk_{};
+    std::vector<int16_t> stage_{};
+    std::vector<int32_t> arrival_day_{};
+    std::vector<int32_t> arrival_second_{};
+    std::vector<int32_t> treated_day_{};  // -1 if not treated yet.
+    std::vector<int32_t> treated_second_{};
+    std::array<int16_t, 4> largest_{};  // Largest value of each grouped column, to compare blocks with fewer values.
+};
+
+#endif //CS225_SP22_C2_COLUMNSTORE_H_
@@ -4,8 +4,20 @@
 #ifndef CS225_SP22_C1_CONFIG_H_
 #define CS225_SP22_C1_CONFIG_H_
 
+#include <ctime>
+
 #define DEBUG 0
 
+// Set to 1 (or configure with -DRQRS_FIB_HEAP_STATS=ON) to collect Fibonacci heap statistics.
+#ifndef FIB_HEAP_STATS
+#define FIB_HEAP_STATS 0
+#endif
+
+// Set to 1 (or configure with -DRQRS_PERSISTENT_DB=ON) to keep the database indexes in data/*.db.
+#ifndef PERSISTENT_DB
+#define PERSISTENT_DB 0
+#endif
+
 // Terminal color codes. Only tested in Linux and macOS.
 #define RESET   "\033[0m"
 #define BLACK   "\033[30m"      /* Black */
@@ -3,6 +3,8 @@
  */
 
 #include "databaseSchema.h"
+#include <algorithm>
+#include <utility>
 
 int DBRecord::GetMedicalStatus() const {
     return medical_status_;
@@ -32,10 +34,187 @@ DBRecord::DBRecord(RegistrationRecord& record, int registration)
     : record_(record), registration_{registration} {
 }
 
-RegistrationRecord DBRecord::GetRecord() const {
+const RegistrationRecord& DBRecord::GetRecord() const {
     return record_;
 }
 
 void DBRecord::SetRecord(const RegistrationRecord& record) {
     record_ = record;
-}
\ No newline at end of file
+}
+
+DBRecordUpdate::DBRecordUpdate(const RegistrationRecord& record, int medical_status, std::optional<int> treatment)
+    : record_(record), medical_status_{medical_status}, treatment_{treatment} {
+}
+
+const RegistrationRecord& DBRecordUpdate::GetRecord() const {
+    return record_;
+}
+
+int DBRecordUpdate::GetMedicalStatus() const {
+    return medical_status_;
+}
+
+std::optional<int> DBRecordUpdate::GetTreatment() const {
+    return treatment_;
+}
+
+void DBRecordUpdate::apply(DBRecord& db_record) const {
+    db_record.SetMedicalStatus(medical_status_);
+    db_record.SetRecord(record_);
+    if (treatment_) { db_record.SetTreatment(*treatment_); }
+}
+
+IdPostings::IdPostings(std::string bytes) : bytes_(std::move(bytes)) {
+}
+
+/*!
+ * @brief This method adds an ID to the list. Only the gap it falls into is re-encoded.
+ * @param id is the ID.
+ * @return true if the ID was added, false if it was already in the list.
+ */
+bool IdPostings::insert(int id) {
+    auto target = static_cast<uint32_t>(id);
+    uint32_t prev{};
+    const char* in = bytes_.data();
+    while (in != bytes_.data() + bytes_.size()) {
+        size_t start = in - bytes_.data();
+        uint32_t cur = prev + _get_gap(in);
+        if (cur == target) { return false; }
+        if (static_cast<int>(cur) > id) {  // Split the gap from `prev` to `cur` in two.
+            std::string gaps;
+            _put_gap(gaps, target - prev);
+            _put_gap(gaps, cur - target);
+            bytes_.replace(start, in - bytes_.data() - start, gaps);
+            return true;
+        }
+        prev = cur;
+    }
+    _put_gap(bytes_, target - prev);
+    return true;
+}
+
+/*!
+ * @brief This method removes an ID from the list. Only the gaps around it are re-encoded.
+ * @param id is the ID.
+ * @return true if the ID was removed, false if it was not in the list.
+ */
+bool IdPostings::erase(int id) {
+    auto target = static_cast<uint32_t>(id);
+    uint32_t prev{};
+    const char* in = bytes_.data();
+    const char* end = bytes_.data() + bytes_.size();
+    while (in != end) {
+        size_t start = in - bytes_.data();
+        uint32_t cur = prev + _get_gap(in);
+        if (static_cast<int>(cur) > id) { return false; }
+        if (cur == target) {
+            if (in == end) {
+                bytes_.erase(start);
+            } else {  // Merge the gaps before and after the ID.
+                uint32_t next = cur + _get_gap(in);
+                std::string gap;
+                _put_gap(gap, next - prev);
+                bytes_.replace(start, in - bytes_.data() - start, gap);
+            }
+            return true;
+        }
+        prev = cur;
+    }
+    return false;
+}
+
+bool IdPostings::contains(int id) const {
+    bool found{false};
+    forEach([&](int cur) { found = found || cur == id; });
+    return found;
+}
+
+bool IdPostings::empty() const {
+    return bytes_.empty();
+}
+
+size_t IdPostings::size() const {
+    return std::count_if(bytes_.begin(), bytes_.end(), [](char byte) { return 0 == (byte & 0x80); });
+}
+
+std::vector<int> IdPostings::ids() const {
+    std::vector<int> ids;
+    forEach([&](int id) { ids.push_back(id); });
+    return ids;
+}
+
+const std::string& IdPostings::bytes() const {
+    return bytes_;
+}
+
+void IdPostings::_put_gap(std::string& out, uint32_t gap) {
+    while (gap >= 0x80) {
+        out.push_back(static_cast<char>((gap & 0x7F) | 0x80));
+        gap >>= 7;
+    }
+    out.push_back(static_cast<char>(gap));
+}
+
+uint32_t IdPostings::_get_gap(const char*& in) {
+    uint32_t gap{};
+    for (int shift = 0;; shift += 7) {
+        auto byte = static_cast<uint8_t>(*in++);
+        gap |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (0 == (byte & 0x80)) { return gap; }
+    }
+}
+/*!
+ * @brief This method adds a new record to the batch.
+ * @param db_record is the record.
+ */
+void DBBatch::insert(const DBRecord& db_record) {
+    changes_.push_back(Change{Kind::kInsert, db_record.GetRecord().GetId(), db_record});
+}
+
+/*!
+ * @brief This method adds a status update to the batch.
+ * @param change is the update.
+ */
+void DBBatch::update(const DBRecordUpdate& change) {
+    changes_.push_back(Change{Kind::kUpdate, change.GetRecord().GetId(), change});
+}
+
+/*!
+ * @brief This method adds the removal of a record to the batch.
+ * @param id is the ID of the record.
+ */
+void DBBatch::remove(int id) {
+    changes_.push_back(Change{Kind::kRemove, id, std::monostate{}});
+}
+
+/*!
+ * @brief This method sorts the changes by ID. Changes of the same ID keep the order in which they were added.
+ */
+void DBBatch::sort() {
+    std::stable_sort(changes_.begin(), changes_.end(),
+                     [](const Change& a, const Change& b) { return a.id_ < b.id_; });
+}
+
+/*!
+ * @brief This method returns the changes, in the order they were added or, after `sort()`, by ID.
+ * @return the changes.
+ */
+const std::vector<DBBatch::Change>& DBBatch::changes() const {
+    return changes_;
+}
+
+/*!
+ * @brief This method checks whether the batch holds no change.
+ * @return true if it does not, false otherwise.
+ */
+bool DBBatch::empty() const {
+    return changes_.empty();
+}
+
+/*!
+ * @brief This method returns number of changes in the batch.
+ * @return the number of changes.
+ */
+size_t DBBatch::size() const {
+    return changes_.size();
+}
@@ -4,6 +4,11 @@
 #ifndef CS225_SP22_C2_DATABASESCHEMA_H_
 #define CS225_SP22_C2_DATABASESCHEMA_H_
 #include "registrationRecord.h"
+#include "codec.h"
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
 
 class DBRecord {
 private:
@@ -15,7 +20,7 @@ public:
     DBRecord() = default;
     explicit DBRecord(RegistrationRecord& record, int registration);
     virtual ~DBRecord() = default;
-    [[nodiscard]] RegistrationRecord GetRecord() const;
+    [[nodiscard]] const RegistrationRecord& GetRecord() const;
     [[nodiscard]] int GetMedicalStatus() const;
     [[nodiscard]] int GetRegistration() const;
     [[nodiscard]] int GetTreatment() const;
@@ -25,4 +30,186 @@ public:
     void SetTreatment(int treatment);
 };
 
+/*!
+ * @brief This specialization lets the disk-backed indexes store database records.
+ */
+template<>
+struct Codec<DBRecord> {
+    static void encode(const DBRecord& db_record, std::string& out) {
+        db_record.GetRecord().serialize(out);
+        codecPut(out, db_record.GetMedicalStatus());
+        codecPut(out, db_record.GetRegistration());
+        codecPut(out, db_record.GetTreatment());
+    }
+
+    static DBRecord decode(const char* in, size_t) {
+        auto record = RegistrationRecord::deserialize(in);
+        int medical_status = codecGet<int>(in);
+        DBRecord db_record{record, codecGet<int>(in)};
+        db_record.SetMedicalStatus(medical_status);
+        db_record.SetTreatment(codecGet<int>(in));
+        return db_record;
+    }
+};
+
+/*!
+ * @brief This class describes a status update of a database record: the new registration record, the new medical
+ * status and, optionally, the new treatment. The paged primary index buffers it as a patch instead of rewriting
+ * the record.
+ */
+class DBRecordUpdate {
+private:
+    RegistrationRecord record_{};
+    int medical_status_{0};
+    std::optional<int> treatment_{};  // Empty to keep the current treatment.
+public:
+    DBRecordUpdate() = default;
+    DBRecordUpdate(const RegistrationRecord& record, int medical_status, std::optional<int> treatment = std::nullopt);
+    [[nodiscard]] const RegistrationRecord& GetRecord() const;
+    [[nodiscard]] int GetMedicalStatus() const;
+    [[nodiscard]] std::optional<int> GetTreatment() const;
+    void apply(DBRecord& db_record) const;
+};
+
+/*!
+ * @brief This specialization lets the buffered primary index store status updates.
+ */
+template<>
+struct Codec<DBRecordUpdate> {
+    static void encode(const DBRecordUpdate& update, std::string& out) {
+        update.GetRecord().serialize(out);
+        codecPut(out, update.GetMedicalStatus());
+        codecPut(out, update.GetTreatment().has_value());
+        codecPut(out, update.GetTreatment().value_or(-1));
+    }
+
+    static DBRecordUpdate decode(const char* in, size_t) {
+        auto record = RegistrationRecord::deserialize(in);
+        int medical_status = codecGet<int>(in);
+        bool has_treatment = codecGet<bool>(in);
+        int treatment = codecGet<int>(in);
+        return DBRecordUpdate{record, medical_status, has_treatment ? std::optional<int>{treatment} : std::nullopt};
+    }
+};
+
+/*!
+ * @brief This class holds the IDs of the database records that share a name, i.e. a posting list of the secondary
+ * index. The IDs are kept in ascending order as the gaps between consecutive IDs (the first one from 0), each in
+ * LEB128 (7 bits per byte), so that most IDs of a list take one or two bytes. IDs are ordered as `int`, like the
+ * keys of the primary index, and gaps are taken modulo 2^32, so a negative first ID simply takes five bytes. Every
+ * operation decodes the list from the front, which is fine for the few records that share a name.
+ */
+class IdPostings {
+private:
+    std::string bytes_{};
+public:
+    IdPostings() = default;
+    explicit IdPostings(std::string bytes);
+    bool insert(int id);
+    bool erase(int id);
+    [[nodiscard]] bool contains(int id) const;
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] std::vector<int> ids() const;
+    [[nodiscard]] const std::string& bytes() const;
+    template<typename F> void forEach(F&& f) const;
+private:
+    static void _put_gap(std::string& out, uint32_t gap);
+    static uint32_t _get_gap(const char*& in);
+};
+
+/*!
+ * @brief This method calls `f` on every ID in ascending order.
+ * @tparam F is type of the callable, invoked as `f(int)`.
+ * @param f is the callable.
+ */
+template<typename F>
+void IdPostings::forEach(F&& f) const {
+    const char* in = bytes_.data();
+    uint32_t id{};
+    while (in != bytes_.data() + bytes_.size()) {
+        id += _get_gap(in);
+        f(static_cast<int>(id));
+    }
+}
+
+/*!
+ * @brief This specialization lets the disk-backed secondary index store posting lists as they are encoded.
+ */
+template<>
+struct Codec<IdPostings> {
+    static void encode(const IdPostings& postings, std::string& out) { out.append(postings.bytes()); }
+
+    static IdPostings decode(const char* in, size_t n) { return IdPostings{std::string{in, n}}; }
+};
+
+/*!
+ * @brief This class collects the Database changes of a tick so that they are applied together: sorted by ID
+ * (changes of the same ID keep their order), each index is modified in one merged pass instead of one descent per
+ * change. The batch is logged as a single record, so recovery replays all of it or none.
+ */
+class DBBatch {
+public:
+    enum class Kind : uint8_t { kInsert, kUpdate, kRemove };
+
+    /*!
+     * @brief This struct holds one change: a new record, a status update or the removal of an ID.
+     */
+    struct Change {
+        Kind kind_{};
+        int id_{};
+        std::variant<std::monostate, DBRecord, DBRecordUpdate> value_{};
+    };
+
+    void insert(const DBRecord& db_record);
+    void update(const DBRecordUpdate& change);
+    void remove(int id);
+    void sort();
+    [[nodiscard]] const std::vector<Change>& changes() const;
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
+private:
+    std::vector<Change> changes_{};
+};
+
+/*!
+ * @brief This specialization lets the database log store a batch as one record. Each change is its kind, its ID
+ * and its length-prefixed record or update.
+ */
+template<>
+struct Codec<DBBatch> {
+    static void encode(const DBBatch& batch, std::string& out) {
+        codecPut(out, static_cast<uint32_t>(batch.size()));
+        for (const auto& change : batch.changes()) {
+            codecPut(out, change.kind_);
+            codecPut(out, change.id_);
+            std::string value;
+            if (auto db_record = std::get_if<DBRecord>(&change.value_)) {
+                Codec<DBRecord>::encode(*db_record, value);
+            } else if (auto update = std::get_if<DBRecordUpdate>(&change.value_)) {
+                Codec<DBRecordUpdate>::encode(*update, value);
+            }
+            codecPutString(out, value);
+        }
+    }
+
+    static DBBatch decode(const char* in, size_t) {
+        DBBatch batch;
+        auto n = codecGet<uint32_t>(in);
+        for (uint32_t i = 0; i < n; ++i) {
+            auto kind = codecGet<DBBatch::Kind>(in);
+            int id = codecGet<int>(in);
+            std::string value = codecGetString(in);
+            if (DBBatch::Kind::kInsert == kind) {
+                batch.insert(Codec<DBRecord>::decode(value.data(), value.size()));
+            } else if (DBBatch::Kind::kUpdate == kind) {
+                batch.update(Codec<DBRecordUpdate>::decode(value.data(), value.size()));
+            } else {
+                batch.remove(id);
+            }
+        }
+        return batch;
+    }
+};
+
 #endif //CS225_SP22_C2_DATABASESCHEMA_H_
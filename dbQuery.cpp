@@ -0,0 +1,430 @@
+/*!
+ * @brief This file contains the implementation of <em>DBQuery</em>.
+ */
+#include "dbQuery.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <limits>
+
+static constexpr std::pair<const char*, DBQuery::Field> kFields[]{
+        {"id",         DBQuery::Field::kId},
+        {"name",       DBQuery::Field::kName},
+        {"status",     DBQuery::Field::kStatus},
+        {"profession", DBQuery::Field::kProfession},
+        {"age",        DBQuery::Field::kAge},
+        {"risk",       DBQuery::Field::kRisk},
+        {"registry",   DBQuery::Field::kRegistry},
+        {"treatment",  DBQuery::Field::kTreatment},
+};
+static constexpr std::pair<const char*, DBQuery::Op> kOps[]{
+        {"=",  DBQuery::Op::kEq},
+        {"==", DBQuery::Op::kEq},
+        {"!=", DBQuery::Op::kNe},
+        {"<",  DBQuery::Op::kLt},
+        {"<=", DBQuery::Op::kLe},
+        {">",  DBQuery::Op::kGt},
+        {">=", DBQuery::Op::kGe},
+};
+static constexpr const char* kStatusNames[]{"registered", "queueing", "appointment", "withdrawn", "treated"};
+static constexpr unsigned kAllStatuses{(1U << DBQuery::kStatuses) - 1};
+
+/*!
+ * @brief This function compares two strings, ignoring the case of ASCII letters.
+ * @param a is the first string.
+ * @param b is the second string.
+ * @return true if they are equal.
+ */
+static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+/*!
+ * @brief This function reads the characters of `text` from `i` on that satisfy `pred`.
+ * @param text is the text.
+ * @param i is the position, moved past the characters read.
+ * @param pred is the predicate on characters.
+ * @return the characters read.
+ */
+template<typename P>
+static std::string_view readWhile(std::string_view text, size_t& i, P&& pred) {
+    size_t start = i;
+    while (i < text.size() && pred(static_cast<unsigned char>(text[i]))) { ++i; }
+    return text.substr(start, i - start);
+}
+
+/*!
+ * @brief This function skips white space.
+ * @param text is the text.
+ * @param i is the position, moved to the next other character.
+ */
+static void skipSpaces(std::string_view text, size_t& i) {
+    readWhile(text, i, [](unsigned char c) { return std::isspace(c); });
+}
+
+/*!
+ * @brief This function reads a word of letters and underscores.
+ * @param text is the text.
+ * @param i is the position, moved past the word.
+ * @return the word, empty if there is none at `i`.
+ */
+static std::string_view readWord(std::string_view text, size_t& i) {
+    return readWhile(text, i, [](unsigned char c) { return std::isalpha(c) || '_' == c; });
+}
+
+/*!
+ * @brief This function returns the name of a field, as written in queries.
+ * @param field is the field.
+ * @return the name.
+ */
+static const char* fieldName(DBQuery::Field field) {
+    for (const auto& [name, f] : kFields) {
+        if (f == field) { return name; }
+    }
+    return "?";
+}
+
+/*!
+ * @brief This function returns the text of an operator.
+ * @param op is the operator.
+ * @return the text.
+ */
+static const char* opName(DBQuery::Op op) {
+    for (const auto& [name, o] : kOps) {
+        if (o == op) { return name; }
+    }
+    return "?";
+}
+
+/*!
+ * @brief This function lists the names of the statuses in a set.
+ * @param statuses is the set of statuses, bit `s` for status `s`.
+ * @return the names, separated by commas.
+ */
+static std::string statusList(unsigned statuses) {
+    std::string out;
+    for (int s = 0; s < DBQuery::kStatuses; ++s) {
+        if (!(statuses >> s & 1U)) { continue; }
+        if (!out.empty()) { out += ", "; }
+        out += kStatusNames[s];
+    }
+    return out;
+}
+
+/*!
+ * @brief This method parses a query. Predicates are separated by `AND`, which may be written in any case, and
+ * white space is optional around operators. An empty query matches every record.
+ * @param text is the query.
+ * @param error is set to the reason if the query cannot be parsed.
+ * @return the query, or nothing if it cannot be parsed.
+ */
+std::optional<DBQuery> DBQuery::parse(std::string_view text, std::string& error) {
+    DBQuery query;
+    size_t i{};
+    skipSpaces(text, i);
+    size_t first = i;
+    if (equalsIgnoreCase(readWord(text, i), "explain")) {
+        query.explain_ = true;
+    } else {
+        i = first;
+    }
+    for (skipSpaces(text, i); i < text.size();) {
+        std::string_view word = readWord(text, i);
+        auto field = std::find_if(std::begin(kFields), std::end(kFields),
+                                  [&](const auto& f) { return equalsIgnoreCase(word, f.first); });
+        if (word.empty() || std::end(kFields) == field) {
+            error = "Expected a field (id, name, status, profession, age, risk, registry or treatment) at \"" +
+                    std::string{text.substr(i - word.size())} + "\"";
+            return std::nullopt;
+        }
+        Term term{field->second};
+        skipSpaces(text, i);
+        std::string_view op = readWhile(text, i, [](unsigned char c) { return '<' == c || '>' == c || '=' == c ||
+                                                                              '!' == c; });
+        auto o = std::find_if(std::begin(kOps), std::end(kOps), [&](const auto& p) { return op == p.first; });
+        if (std::end(kOps) == o) {
+            error = "Expected an operator (=, !=, <, <=, > or >=) after \"" + std::string{word} + "\"";
+            return std::nullopt;
+        }
+        term.op = o->second;
+        skipSpaces(text, i);
+        std::string_view value;
+        if (i < text.size() && '"' == text[i]) {
+            size_t close = text.find('"', i + 1);
+            if (std::string_view::npos == close) {
+                error = "Unterminated quote after \"" + std::string{word} + "\"";
+                return std::nullopt;
+            }
+            value = text.substr(i + 1, close - i - 1);
+            i = close + 1;
+        } else {
+            value = readWhile(text, i, [](unsigned char c) { return !std::isspace(c); });
+        }
+        if (Field::kName == term.field) {
+            if (Op::kEq != term.op && Op::kNe != term.op) {
+                error = "Names can only be compared with = and !=";
+                return std::nullopt;
+            }
+            term.text = value;
+        } else {
+            auto status = std::find_if(std::begin(kStatusNames), std::end(kStatusNames),
+                                       [&](const char* s) { return equalsIgnoreCase(value, s); });
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), term.value);
+            if (Field::kStatus == term.field && std::end(kStatusNames) != status) {
+                term.value = static_cast<int>(status - std::begin(kStatusNames));
+            } else if (value.empty() || std::errc{} != ec || value.data() + value.size() != end) {
+                error = "Expected an integer" + std::string{Field::kStatus == term.field ? " or a status name" : ""} +
+                        " after \"" + std::string{word} + std::string{op} + "\"";
+                return std::nullopt;
+            }
+        }
+        query.terms_.push_back(std::move(term));
+        skipSpaces(text, i);
+        if (i == text.size()) { break; }
+        size_t rest = i;
+        if (!equalsIgnoreCase(readWord(text, i), "and")) {
+            error = "Expected AND at \"" + std::string{text.substr(rest)} + "\"";
+            return std::nullopt;
+        }
+        skipSpaces(text, i);
+    }
+    return query;
+}
+
+/*!
+ * @brief This method tells whether the query asks for its plans instead of the records.
+ * @return true if the query starts with `EXPLAIN`.
+ */
+bool DBQuery::explain() const {
+    return explain_;
+}
+
+/*!
+ * @brief This method reads an integer field of a record.
+ * @param db_record is the record.
+ * @param field is the field, not `kName`.
+ * @return the value.
+ */
+int DBQuery::_value(const DBRecord& db_record, Field field) {
+    const auto& record = db_record.GetRecord();
+    switch (field) {
+        case Field::kId:
+            return record.GetId();
+        case Field::kStatus:
+            return db_record.GetMedicalStatus();
+        case Field::kProfession:
+            return record.GetProfessionId();
+        case Field::kAge:
+            return record.GetAgeId();
+        case Field::kRisk:
+            return record.GetRiskStatus();
+        case Field::kRegistry:
+            return record.GetLocalQueueId();
+        case Field::kTreatment:
+            return db_record.GetTreatment();
+        case Field::kName:
+        default:
+            return 0;
+    }
+}
+
+/*!
+ * @brief This method tells whether a record satisfies every predicate of the query.
+ * @param db_record is the record.
+ * @return true if it does.
+ */
+bool DBQuery::matches(const DBRecord& db_record) const {
+    return std::all_of(terms_.begin(), terms_.end(), [&](const Term& term) {
+        if (Field::kName == term.field) {
+            return (db_record.GetRecord().GetName() == term.text) == (Op::kEq == term.op);
+        }
+        int value = _value(db_record, term.field);
+        switch (term.op) {
+            case Op::kEq:
+                return value == term.value;
+            case Op::kNe:
+                return value != term.value;
+            case Op::kLt:
+                return value < term.value;
+            case Op::kLe:
+                return value <= term.value;
+            case Op::kGt:
+                return value > term.value;
+            case Op::kGe:
+            default:
+                return value >= term.value;
+        }
+    });
+}
+
+/*!
+ * @brief This method returns the values of an integer field allowed by the comparisons of the query (`!=` is not
+ * taken into account).
+ * @param field is the field, not `kName`.
+ * @return the smallest and largest allowed values; the smallest is larger if no value is allowed.
+ */
+std::pair<long long, long long> DBQuery::bounds(Field field) const {
+    long long lo{std::numeric_limits<int>::min()}, hi{std::numeric_limits<int>::max()};
+    for (const auto& term : terms_) {
+        if (term.field != field) { continue; }
+        long long value{term.value};
+        switch (term.op) {
+            case Op::kEq:
+                lo = std::max(lo, value);
+                hi = std::min(hi, value);
+                break;
+            case Op::kLt:
+                hi = std::min(hi, value - 1);
+                break;
+            case Op::kLe:
+                hi = std::min(hi, value);
+                break;
+            case Op::kGt:
+                lo = std::max(lo, value + 1);
+                break;
+            case Op::kGe:
+                lo = std::max(lo, value);
+                break;
+            case Op::kNe:
+            default:
+                break;
+        }
+    }
+    return {lo, hi};
+}
+
+/*!
+ * @brief This method returns the name that the query requires, if any.
+ * @return pointer to the name, or nullptr if the query has no `name=` predicate.
+ */
+const std::string* DBQuery::name() const {
+    for (const auto& term : terms_) {
+        if (Field::kName == term.field && Op::kEq == term.op) { return &term.text; }
+    }
+    return nullptr;
+}
+
+/*!
+ * @brief This method returns the medical statuses allowed by the query.
+ * @return the set of statuses, bit `s` for status `s`.
+ */
+unsigned DBQuery::statuses() const {
+    auto [lo, hi] = bounds(Field::kStatus);
+    unsigned statuses{};
+    for (int s = 0; s < kStatuses; ++s) {
+        if (lo <= s && s <= hi) { statuses |= 1U << s; }
+    }
+    for (const auto& term : terms_) {
+        if (Field::kStatus == term.field && Op::kNe == term.op && 0 <= term.value && term.value < kStatuses) {
+            statuses &= ~(1U << term.value);
+        }
+    }
+    return statuses;
+}
+
+/*!
+ * @brief This method lists the plans that can answer the query, cheapest first. An ID range is clipped to the IDs in
+ * the primary index, over which IDs are assumed to be spread evenly, and scanned in order at one unit per record;
+ * candidates found by name or status are fetched by ID at `kLookupCost` each; a full scan reads every record. A plan
+ * whose index the query does not constrain is not listed, except the full scan, and a query that no record can
+ * satisfy (or an empty index) gets the single plan `kNone`.
+ * @param statistics describes the indexes.
+ * @return the plans, the chosen one first.
+ */
+std::vector<DBQueryPlan> DBQuery::plans(const Statistics& statistics) const {
+    using Access = DBQueryPlan::Access;
+    std::vector<DBQueryPlan> plans;
+    auto [lo, hi] = bounds(Field::kId);
+    bool id_bounded = lo > std::numeric_limits<int>::min() || hi < std::numeric_limits<int>::max();
+    lo = std::max<long long>(lo, statistics.min_id);
+    hi = std::min<long long>(hi, statistics.max_id);
+    unsigned statuses = this->statuses();
+    bool contradictory = 0 == statistics.records || lo > hi || 0 == statuses ||
+                         (name() && 0 == statistics.name_matches);
+    for (auto field : {Field::kProfession, Field::kAge, Field::kRisk, Field::kRegistry, Field::kTreatment}) {
+        auto [field_lo, field_hi] = bounds(field);
+        contradictory = contradictory || field_lo > field_hi;
+    }
+    if (contradictory) {
+        plans.push_back(DBQueryPlan{Access::kNone});
+        return plans;
+    }
+    if (id_bounded) {
+        DBQueryPlan plan{Access::kIdRange};
+        plan.lo = static_cast<int>(lo);
+        plan.hi = static_cast<int>(hi);
+        auto span = static_cast<unsigned long long>(static_cast<long long>(statistics.max_id) - statistics.min_id + 1);
+        auto ids = static_cast<unsigned long long>(hi - lo + 1);
+        plan.estimate = static_cast<size_t>((statistics.records * ids + span - 1) / span);  // IDs spread evenly.
+        plan.cost = plan.estimate;
+        plans.push_back(plan);
+    }
+    if (name()) {
+        DBQueryPlan plan{Access::kNameLookup};
+        plan.estimate = statistics.name_matches;
+        plan.cost = (1 + plan.estimate) * kLookupCost;
+        plans.push_back(plan);
+    }
+    if (kAllStatuses != statuses) {
+        DBQueryPlan plan{Access::kStatusBitmap};
+        plan.statuses = statuses;
+        for (int s = 0; s < kStatuses; ++s) {
+            if (statuses >> s & 1U) { plan.estimate += statistics.status_counts[s]; }
+        }
+        plan.cost = plan.estimate * kLookupCost;
+        plans.push_back(plan);
+    }
+    DBQueryPlan scan{Access::kFullScan};
+    scan.estimate = scan.cost = statistics.records;
+    plans.push_back(scan);
+    std::stable_sort(plans.begin(), plans.end(), [](const auto& a, const auto& b) { return a.cost < b.cost; });
+    return plans;
+}
+
+/*!
+ * @brief This method writes the query back as text, with one space around each operator and `AND`.
+ * @return the text; `(all records)` if the query has no predicate.
+ */
+std::string DBQuery::toString() const {
+    std::string out;
+    for (const auto& term : terms_) {
+        if (!out.empty()) { out += " AND "; }
+        out += std::string{fieldName(term.field)} + " " + opName(term.op) + " ";
+        if (Field::kName == term.field) {
+            out += "\"" + term.text + "\"";
+        } else if (Field::kStatus == term.field && 0 <= term.value && term.value < kStatuses) {
+            out += kStatusNames[term.value];
+        } else {
+            out += std::to_string(term.value);
+        }
+    }
+    return out.empty() ? "(all records)" : out;
+}
+
+/*!
+ * @brief This method describes the plan in one line, as printed by `EXPLAIN`.
+ * @return the description.
+ */
+std::string DBQueryPlan::describe() const {
+    std::string out;
+    switch (access) {
+        case Access::kNone:
+            return "no access: no record can satisfy the query (0 records)";
+        case Access::kIdRange:
+            out = "ID range scan of the primary index, IDs " + std::to_string(lo) + " to " + std::to_string(hi);
+            break;
+        case Access::kNameLookup:
+            out = "name lookup in the secondary index, then primary index lookups by ID";
+            break;
+        case Access::kStatusBitmap:
+            out = "status bitmap scan (" + statusList(statuses) + "), then primary index lookups by ID";
+            break;
+        case Access::kFullScan:
+        default:
+            out = "full scan of the primary index";
+            break;
+    }
+    return out + " (estimated " + std::to_string(estimate) + " candidate(s), cost " + std::to_string(cost) + ")";
+}
@@ -0,0 +1,91 @@
+/*!
+ * @brief This file contains the class definition of <em>DBQuery</em>.
+ */
+#ifndef CS225_SP22_C2_DBQUERY_H_
+#define CS225_SP22_C2_DBQUERY_H_
+
+#include "databaseSchema.h"
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*!
+ * @brief This struct describes one way of finding the candidates of a query: the index it reads, the part of that
+ * index, and the estimated number of candidates and cost. Every candidate is then checked against the whole query.
+ */
+struct DBQueryPlan {
+    /*!
+     * @brief This enumeration lists the access paths: nothing (no record can satisfy the query), an ordered scan of
+     * an ID range of the primary index, a name lookup in the secondary index, a scan of the status bitmaps, or an
+     * ordered scan of the whole primary index.
+     */
+    enum class Access { kNone, kIdRange, kNameLookup, kStatusBitmap, kFullScan };
+
+    Access access{Access::kFullScan};
+    int lo{};  // IDs in [lo, hi], for kIdRange.
+    int hi{};
+    unsigned statuses{};  // Bit `s` for medical status `s`, for kStatusBitmap.
+    size_t estimate{};  // Estimated number of candidates.
+    size_t cost{};  // Estimated cost, in records read by an ordered scan.
+
+    [[nodiscard]] std::string describe() const;
+};
+
+/*!
+ * @brief This class holds a conjunction of predicates over the Database records, parsed from text such as
+ * `profession<=2 AND risk=1 AND status=queueing AND registry=3`. Fields are `id`, `name`, `status` (0 to 4 or its
+ * name), `profession`, `age`, `risk`, `registry` (the local queue) and `treatment`; operators are `=`, `!=`, `<`,
+ * `<=`, `>` and `>=` (`=` and `!=` only for names, which may be quoted). A leading `EXPLAIN` asks for the plans
+ * instead of the records. The query lists its possible plans, cheapest first, from a few index statistics.
+ */
+class DBQuery {
+public:
+    enum class Field { kId, kName, kStatus, kProfession, kAge, kRisk, kRegistry, kTreatment };
+    enum class Op { kEq, kNe, kLt, kLe, kGt, kGe };
+
+    static constexpr int kStatuses{5};  // Medical statuses, as in StatusIndex.
+
+    /*!
+     * @brief This struct holds one predicate: a field, an operator and a value (`text` for names).
+     */
+    struct Term {
+        Field field{};
+        Op op{};
+        int value{};
+        std::string text{};
+    };
+
+    /*!
+     * @brief This struct holds what the planner knows about the indexes.
+     */
+    struct Statistics {
+        size_t records{};  // Number of records in the primary index.
+        int min_id{};  // Smallest and largest ID in the primary index, if it is not empty.
+        int max_id{};
+        std::array<size_t, kStatuses> status_counts{};  // Number of records in each medical status.
+        size_t name_matches{};  // Number of records with the name of the query, if it has one.
+    };
+
+    static constexpr size_t kLookupCost{4};  // A record fetched by ID costs about as much as 4 scanned records.
+
+    static std::optional<DBQuery> parse(std::string_view text, std::string& error);
+    [[nodiscard]] bool explain() const;
+    [[nodiscard]] bool matches(const DBRecord& db_record) const;
+    [[nodiscard]] std::pair<long long, long long> bounds(Field field) const;
+    [[nodiscard]] const std::string* name() const;
+    [[nodiscard]] unsigned statuses() const;
+    [[nodiscard]] std::vector<DBQueryPlan> plans(const Statistics& statistics) const;
+    [[nodiscard]] std::string toString() const;
+
+private:
+    static int _value(const DBRecord& db_record, Field field);
+
+    std::vector<Term> terms_{};
+    bool explain_{false};
+};
+
+#endif //CS225_SP22_C2_DBQUERY_H_
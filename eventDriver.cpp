@@ -11,6 +11,7 @@
 void move12Hours(Container& container) {
     halfDaysPassed++;
     eventTrigger(container);
+    commitDB(container);  // One fsync for every Database change of this tick.
 }
 
 /*!
@@ -30,12 +31,17 @@ void moveNDays(int numberOfDays, Container& container) {
  * @param container is the crucial data structure.
  */
 void eventTrigger(Container& container) {
+    container.batch.emplace();  // The Database changes of the processors below are applied together.
     waitingListProcessor(container);
     forwardRegistrationRecords(container);
     appointmentProcessor(container);
     if (0 == halfDaysPassed % 2) {
         treatmentProcessor(container);
+#if FIB_HEAP_STATS
+        std::cout << CYAN << "[Fibonacci heap] " << container.centralizedQueue.stats() << RESET << std::endl;
+#endif
     }
+    applyDBBatch(container);
     if (0 == halfDaysPassed % 14) {
         std::cout << BOLDYELLOW << std::string(40, '-') << std::endl;
         std::cout << BOLDYELLOW << "New weekly report available!" << std::endl;
@@ -73,11 +79,15 @@ void loadRecords(Container& container) {
         for (const auto& row : CSVRange{file}) {
             int risk{std::stoi(std::string(row[8]))};
             RegistrationRecord record{row};
-            addDBRecord(container, record, 0);
+            if (!container.primaryDB.find(record.GetId())) {  // Records restored by recoverDB() are kept.
+                addDBRecord(container, record, 0);
+            }
             if (0 == risk || 1 == risk) {
                 temp.push(record);
+                trackRecord(container, record, ColumnStore::Stage::kLocalQueue);
             } else {
                 container.waitingList.push_back(record);  // Add median/high risk patients to the waiting list.
+                trackRecord(container, record, ColumnStore::Stage::kWaitingList);
             }
         }
         container.localQueues.emplace_back(temp);
@@ -135,9 +145,11 @@ void forwardRegistrationRecords(Container& container) {
         int regID{generateRandomRangedInt(0, numReg - 1)};  // Randomly pick a local registry to place the record.
         if (!container.localQueues[regID].empty()) {  // If local queue is not empty, forward its first record.
             container.centralizedQueue.push(container.localQueues[regID].front());
+            trackRecord(container, container.localQueues[regID].front(), ColumnStore::Stage::kCentralizedQueue);
             container.localQueues[regID].pop();  // Remove this record from the queue.
         } else if (!container.waitingList.empty()) {  // Forward the first element in the waiting list if local queue is empty.
             container.centralizedQueue.push(container.waitingList.front());
+            trackRecord(container, container.waitingList.front(), ColumnStore::Stage::kCentralizedQueue);
             std::cout << BOLDYELLOW << "Record (ID " << container.waitingList.front().GetId()
                       << ") has been forward to the centralized queue!" << std::endl;
             container.waitingList.erase(container.waitingList.begin());  // Remove the element from the waiting list.
@@ -189,7 +201,8 @@ void withdrawRecord(int id, Container& container) {
         if (found) {  // Found in local queue!
             auto& record{*queue_iter};  // Get a reference of the object.
             container.pendingList.push_back(std::move(record));  // It calls the move constructor.
-            updateDBRecord(container, record, 3);
+            trackRecord(container, container.pendingList.back(), ColumnStore::Stage::kWithdrawn);
+            updateDBRecord(container, container.pendingList.back(), 3);  // `record` has been moved from.
             queue.erase(queue_iter);  // Remove the record from the local queue.
             std::cout << BOLDGREEN << "Registration record (ID " << id
                       << ") found in a local queue has been successfully withdrawn!" << RESET
@@ -208,8 +221,9 @@ void withdrawRecord(int id, Container& container) {
         if (waiting_iter != container.waitingList.end()) {  // Found in waiting list!
             auto& record{*waiting_iter};  // Get the reference of the object.
             container.pendingList.push_back(std::move(record));  // It calls the move constructor.
+            trackRecord(container, container.pendingList.back(), ColumnStore::Stage::kWithdrawn);
+            updateDBRecord(container, container.pendingList.back(), 3);  // `record` has been moved from.
             container.waitingList.erase(waiting_iter);  // Remove the record from the waiting list.
-            updateDBRecord(container, record, 3);
             std::cout << BOLDGREEN << "Registration record (ID " << id
                       << ") found in the waiting list has been successfully withdrawn!" << RESET
                       << std::endl;
@@ -227,7 +241,8 @@ void withdrawRecord(int id, Container& container) {
         if (app_iter != container.appointmentList.end()) {  // Found in waiting list!
             auto& record{*app_iter};  // Get the reference of the object.
             container.pendingList.push_back(std::move(record));  // It calls the move constructor.
-            updateDBRecord(container, record, 3);
+            trackRecord(container, container.pendingList.back(), ColumnStore::Stage::kWithdrawn);
+            updateDBRecord(container, container.pendingList.back(), 3);  // `record` has been moved from.
             container.appointmentList.erase(app_iter);  // Remove the record from the waiting list.
             std::cout << BOLDGREEN << "Registration record (ID " << id
                       << ") found in the appointment list has been successfully withdrawn!" << RESET
@@ -237,17 +252,15 @@ void withdrawRecord(int id, Container& container) {
     }
     // Finally, look at the centralized queue.
     if (!container.centralizedQueue.empty()) {
-        auto centralized_iter =
-            container.centralizedQueue.find_if(found, [&id](const auto& pair) {
-                return pair.first.GetId() == id;  // `&` means "capture by reference."
-            });
-        if (found) {  // Found in the centralized queue!
-            auto& record{centralized_iter->first};  // Get a reference of the object.
+        auto centralized_node = container.centralizedQueue.find_by_id(id);  // Constant-time lookup by id.
+        if (centralized_node) {  // Found in the centralized queue!
+            auto& record{centralized_node->key};  // Get a reference of the object.
             auto temp{record};  // Make a copy.
             container.pendingList.push_back(record);  // It calls the copy constructor.
+            trackRecord(container, record, ColumnStore::Stage::kWithdrawn);
             updateDBRecord(container, temp, 3);
             temp.SetProfessionId(-1);  // This dummy object can always be the root.
-            container.centralizedQueue.decreaseKey(centralized_iter->second,
+            container.centralizedQueue.decreaseKey(centralized_node,
                                                    std::move(temp));  // Make the modified record the root.
             container.centralizedQueue.pop();  // Remove the record from the centralized queue.
             std::cout << BOLDGREEN << "Registration record (ID " << id
@@ -279,7 +292,8 @@ void recoverRecord(int id, Container& container) {
         record.applyPenalty();  // Add additional two weeks waiting time for risk status 0/1.
     }
     container.waitingList.push_back(std::move(record));  // Move constructor called here.
-    updateDBRecord(container, record, 0);
+    trackRecord(container, container.waitingList.back(), ColumnStore::Stage::kWaitingList);
+    updateDBRecord(container, container.waitingList.back(), 0);  // `record` has been moved from.
     container.pendingList.erase(pending_iter);  // Remove record from pending list.
     std::cout << BOLDGREEN << "Registration record (ID " << id
               << ") has been recovered!" << RESET
@@ -289,8 +303,8 @@ void recoverRecord(int id, Container& container) {
 }
 
 /*!
- * @brief This function updates the profession id for a specified record and updates its container @em if
- * the information update increases the priority of this record.
+ * @brief This function updates the profession id for a specified record and updates its container.
+ * Both promotions and demotions are applied; the centralized queue re-prioritizes the record in place.
  * @param id is record to be updated.
  * @param targetID is the profession id desired.
  * @param container is the crucial data structure.
@@ -305,12 +319,14 @@ void updateProfessionId(int id, int targetID, Container& container) {
             });
         if (found) {  // Found in local queue!
             auto& record{*queue_iter};  // Get the reference of the object.
-            if (record.GetProfessionId() <= targetID) {
-                std::cout << BOLDYELLOW << "Attributes not updated since the request does not increase the priority."
+            if (record.GetProfessionId() == targetID) {
+                std::cout << BOLDYELLOW << "Attributes not updated since the request has no effects."
                           << std::endl;
                 return;  // No update applied.
             }
             record.SetProfessionId(targetID);
+            trackRecord(container, record, ColumnStore::Stage::kLocalQueue);
+            updateDBRecord(container, record);
             std::cout << BOLDGREEN << "Registration record (ID " << id
                       << ") found in a local queue has been successfully updated with a new profession category!"
                       << RESET << std::endl;
@@ -318,21 +334,19 @@ void updateProfessionId(int id, int targetID, Container& container) {
         }
     }
     // Then look at the centralized queue.
-    auto centralized_iter =
-        container.centralizedQueue.find_if(found, [&id](const auto& keyPair) {
-            return keyPair.first.GetId() == id;  // `&` means "capture by reference."
-        });
-    if (found) {  // Found in the centralized queue!
-        auto record{centralized_iter->first};  // Get the reference of the object.
-        if (record.GetProfessionId() <= targetID) {
-            std::cout << BOLDYELLOW << "Attribute not updated since the request does not increase the priority."
+    auto centralized_node = container.centralizedQueue.find_by_id(id);  // Constant-time lookup by id.
+    if (centralized_node) {  // Found in the centralized queue!
+        auto temp{centralized_node->key};  // Make a copy to update the property.
+        if (temp.GetProfessionId() == targetID) {
+            std::cout << BOLDYELLOW << "Attribute not updated since the request has no effects."
                       << std::endl;
             return;  // No update applied.
         }
-        auto temp{record};  // Make a copy to update the property.
         temp.SetProfessionId(targetID);   // Update the attribute.
-        container.centralizedQueue.decreaseKey(centralized_iter->second,
-                                               std::move(temp));  // Maintain the heap property.
+        trackRecord(container, temp, ColumnStore::Stage::kCentralizedQueue);
+        updateDBRecord(container, temp);
+        container.centralizedQueue.updateKey(centralized_node,
+                                             std::move(temp));  // Maintain the heap property.
         std::cout << BOLDGREEN << "Registration record (ID " << id
                   << ") found in the centralized queue has been successfully updated with a new profession category!"
                   << RESET << std::endl;
@@ -346,13 +360,15 @@ void updateProfessionId(int id, int targetID, Container& container) {
                          return record.GetId() == id;  // `&` means "capture by reference."
                      });
     if (waiting_iter != container.waitingList.end()) {  // Found in waiting list!
-        auto record{*waiting_iter};  // Get the reference of the object.
-        if (record.GetProfessionId() <= targetID) {
-            std::cout << BOLDYELLOW << "Attributes not updated since the request does not increase the priority."
+        auto& record{*waiting_iter};  // Get the reference of the object.
+        if (record.GetProfessionId() == targetID) {
+            std::cout << BOLDYELLOW << "Attributes not updated since the request has no effects."
                       << std::endl;
             return;  // No update applied.
         }
         record.SetProfessionId(targetID);
+        trackRecord(container, record, ColumnStore::Stage::kWaitingList);
+        updateDBRecord(container, record);
         std::cout << BOLDGREEN << "Registration record (ID " << id
                   << ") found in the waiting list has been successfully updated with a new profession category!"
                   << RESET << std::endl;
@@ -363,8 +379,10 @@ void updateProfessionId(int id, int targetID, Container& container) {
 }
 
 /*!
- * @brief This function updates the risk status for a specified record and updates its container @em if
- * the information update increases the priority of this record.
+ * @brief This function updates the risk status for a specified record and updates its container, whether the update
+ * raises or lowers the priority of this record. A record in the waiting list gets the waiting time of a new
+ * registration with the target risk status, so it moves to a random local queue for risk status 0/1; a record in the
+ * centralized queue is re-prioritized in place.
  * @param id is record to be updated.
  * @param targetID is the profession id desired.
  * @param container is the crucial data structure.
@@ -379,18 +397,21 @@ void updateRiskStatus(int id, int targetID, Container& container) {
                      });
     if (waiting_iter != container.waitingList.end()) {  // Found in waiting list!
         auto& record{*waiting_iter};  // Get the reference of the object.
-        if (record.GetRiskStatus() <= targetID) {
-            std::cout << BOLDYELLOW << "Attributes not updated since the request does not increase the priority."
+        if (record.GetRiskStatus() == targetID) {
+            std::cout << BOLDYELLOW << "Attributes not updated since the request has no effects." << RESET
                       << std::endl;
             return;  // No update applied.
         }
         record.SetRiskStatus(targetID);
-        if (targetID == 3) {
-            record.SetExtension(60);
+        if (2 <= targetID) {  // Median and high risk patients wait as if they had just registered.
+            record.SetExtension(2 == targetID ? 60 : std::numeric_limits<int>::max());
+            trackRecord(container, record, ColumnStore::Stage::kWaitingList);
+            updateDBRecord(container, record);
         } else {
+            trackRecord(container, record, ColumnStore::Stage::kLocalQueue);
             record.SetExtension(0);
+            updateDBRecord(container, record, 0);  // Before `record` is moved from.
             container.localQueues[generateRandomRangedInt(0, numReg - 1)].emplace(std::move(record));
-            updateDBRecord(container, record, 0);
             container.waitingList.erase(waiting_iter);  // Remove the current record from the waiting list.
         }
         std::cout << BOLDGREEN << "Registration record (ID " << id
@@ -398,11 +419,48 @@ void updateRiskStatus(int id, int targetID, Container& container) {
                   << RESET << std::endl;
         return;  // Done update.
     }
+    // Then look at the centralized queue.
+    auto centralized_node = container.centralizedQueue.find_by_id(id);  // Constant-time lookup by id.
+    if (centralized_node && centralized_node->key.GetRiskStatus() != targetID) {  // Found in the centralized queue!
+        auto temp{centralized_node->key};  // Make a copy to update the property.
+        temp.SetRiskStatus(targetID);
+        trackRecord(container, temp, ColumnStore::Stage::kCentralizedQueue);
+        updateDBRecord(container, temp);
+        container.centralizedQueue.updateKey(centralized_node, std::move(temp));
+        std::cout << BOLDGREEN << "Registration record (ID " << id
+                  << ") found in the centralized queue has been successfully updated with a new risk status!"
+                  << RESET << std::endl;
+        return;  // Done update.
+    }
     std::cout << BOLDYELLOW << "Registration record (ID " << id
               << ") does not exist in RQRS or operation has no effects!"
               << RESET << std::endl;
 }
 
+/*!
+ * @brief This function lists the next `n` records to be assigned an appointment, i.e. the top of the
+ * centralized queue in priority order. The queue is not modified.
+ * @param n is number of records to show.
+ * @param container is the crucial data structure.
+ * @sideeffects It prints the records to the console.
+ */
+void previewAppointments(int n, Container& container) {
+    if (container.centralizedQueue.empty()) {
+        std::cout << BOLDYELLOW << "No records waiting in the centralized queue!" << RESET << std::endl;
+        return;
+    }
+    auto next = container.centralizedQueue.top_k(static_cast<size_t>(n));
+    std::cout << std::endl;
+    std::cout << BOLDBLUE << std::string(55, '-') << "  *** Next " << next.size() << " Appointments ***  "
+              << std::string(55, '-') << RESET << std::endl;
+    for (size_t i = 0; i < next.size(); ++i) {
+        std::cout << BOLDCYAN << "#" << std::setw(4) << std::left << i + 1 << RESET
+                  << BOLDMAGENTA << *next[i] << RESET << std::endl;
+    }
+    std::cout << BOLDBLUE << std::string(120, '-') << RESET << std::endl;
+    std::cout << std::endl;
+}
+
 /*!
  * @brief This function produces the weekly reports, including people treated, people with appointments,
  * and people waiting for appointments.
@@ -468,43 +526,25 @@ void generateWeeklyReports(int order, Container& container) {
 
 /*!
  * @brief This function produces the monthly reports, including people treated, people with appointments,
- * and people waiting for appointments.
+ * people waiting for appointments and the number of Database records in each medical status. Totals, the average
+ * waiting time and the breakdowns by registry and profession category are aggregated over the column store.
  * @param container is the crucial data structure.
  * @sideeffects It prints the report to the console.
  */
 void generateMonthlyReports(Container& container) {
     std::ofstream file{"data/report.txt", std::ios_base::app};
-    size_t num_wait{};
-    long waiting_time{};
-    std::vector<const RegistrationRecord*> queue_ptr{};
+    using Stage = ColumnStore::Stage;
+    auto stages = container.columns.countByStage();
+    auto count = [&stages](Stage stage) { return stages[static_cast<size_t>(stage)]; };
     std::vector<size_t> queue_count{};
     for (const auto& queue : container.localQueues) {
-        auto queue_temp = queue.get_ptrs();
-        queue_ptr.insert(queue_ptr.end(), queue_temp.begin(), queue_temp.end());
-        num_wait += queue.size();
         queue_count.push_back(queue.size());
     }
-    for (const auto* const record_ptr : queue_ptr) {
-        waiting_time += record_ptr->GetWaitingTime();
-    }
-    num_wait += container.centralizedQueue.size();
-    num_wait += container.waitingList.size();
-    num_wait += container.appointmentList.size();
-    unsigned long num_appoint{container.appointmentList.size() + container.treatedList.size()};
-    unsigned long num_reg{num_wait + container.treatedList.size()};
-    auto cent_temp = container.centralizedQueue.get_ptrs();
-    for (const auto* const record_ptr : cent_temp) {
-        waiting_time += record_ptr->GetWaitingTime();
-    }
-    for (const auto& record : container.waitingList) {
-        waiting_time += record.GetWaitingTime();
-    }
-    for (const auto& record : container.appointmentList) {
-        waiting_time += record.GetWaitingTime();
-    }
-    for (const auto& record : container.treatedList) {
-        waiting_time += record.GetWaitingTime();
-    }
+    size_t num_wait{count(Stage::kLocalQueue) + count(Stage::kCentralizedQueue) + count(Stage::kWaitingList)
+                    + count(Stage::kAppointment)};
+    unsigned long num_appoint{count(Stage::kAppointment) + count(Stage::kTreated)};
+    unsigned long num_reg{num_wait + count(Stage::kTreated)};
+    long long waiting_time{container.columns.waitingDays(getRQRSCurrTime())};  // One scan of the time columns.
     double average_waiting_time = (double) waiting_time / (double) num_reg;
 
     std::cout << std::endl;
@@ -531,6 +571,23 @@ void generateMonthlyReports(Container& container) {
               << BOLDBLUE << std::setw(50) << std::left << "Number of withdrawals: " << CYAN << std::left
               << container.pendingList.size() << "\n"
               << RESET << std::endl;
+    const char* med_status[]{"Registered", "Queueing", "Appointment Assigned", "Withdrawn", "Treated"};
+    for (int i = 0; i < StatusIndex::kStatuses; ++i) {  // O(1) each, from the status index.
+        std::cout << BOLDBLUE << std::setw(50) << std::left << "Database records " + std::string{med_status[i]} + ": "
+                  << CYAN << std::left << container.statusIndex.count(i) << RESET << std::endl;
+    }
+    auto registries = container.columns.countBy(ColumnStore::Column::kRegistry);
+    auto professions = container.columns.countBy(ColumnStore::Column::kProfession);
+    for (int i = 1; i <= numReg; ++i) {
+        std::cout << BOLDBLUE << "Number of people registered at Registry #" << i << std::setw(8) << std::left << ": "
+                  << CYAN << std::left << registries[i] << RESET << std::endl;
+    }
+    for (size_t i = 1; i < professions.size(); ++i) {
+        if (0 == professions[i]) { continue; }
+        std::cout << BOLDBLUE << "Number of people in Profession Category #" << i << std::setw(8) << std::left << ": "
+                  << CYAN << std::left << professions[i] << RESET << std::endl;
+    }
+    std::cout << std::endl;
     file << "\n" << std::setw(50) << std::left << "Number of people registered: " << std::left
          << num_reg << "\n";
     for (size_t i = 0; i < queue_count.size(); ++i) {
@@ -552,4 +609,17 @@ void generateMonthlyReports(Container& container) {
          << average_waiting_time << " days\n"
          << std::setw(50) << std::left << "Number of withdrawals: " << std::left
          << container.pendingList.size() << "\n";
+    for (int i = 0; i < StatusIndex::kStatuses; ++i) {
+        file << std::setw(50) << std::left << "Database records " + std::string{med_status[i]} + ": " << std::left
+             << container.statusIndex.count(i) << "\n";
+    }
+    for (int i = 1; i <= numReg; ++i) {
+        file << "Number of people registered at Registry #" << i << std::setw(8) << std::left << ": " << std::left
+             << registries[i] << "\n";
+    }
+    for (size_t i = 1; i < professions.size(); ++i) {
+        if (0 == professions[i]) { continue; }
+        file << "Number of people in Profession Category #" << i << std::setw(8) << std::left << ": " << std::left
+             << professions[i] << "\n";
+    }
 }
@@ -20,5 +20,6 @@ void updateProfessionId(int id, int targetID, Container& container);
 void updateRiskStatus(int id, int targetID, Container& container);
 void generateWeeklyReports(int order, Container& container);
 void generateMonthlyReports(Container& container);
+void previewAppointments(int n, Container& container);
 
 #endif //CS225_SP22_C1_EVENTDRIVER_H_
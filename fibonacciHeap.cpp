@@ -147,29 +147,31 @@ void FibonacciHeap<T, Comp>::FibHeapInsert(FibonacciHeap::FibonacciNode* x) {
  */
 template<typename T, typename Comp>
 void FibonacciHeap<T, Comp>::Consolidate() {
-    auto x{min};  // `x` is always in the root list.
     const int MAX_DEGREE =
         static_cast<int>(log(static_cast<double>(n)) / log((1 + sqrt(static_cast<double>(5))) / 2));
-    std::vector<FibonacciNode*> A(MAX_DEGREE + 1, nullptr);  // Define vector A filled with null pointers.
-    while (true) { // Iterate through the root list until
+    std::vector<FibonacciNode*> A(MAX_DEGREE + 2, nullptr);  // Define vector A filled with null pointers.
+    std::vector<FibonacciNode*> roots;  // Snapshot of the root list, which is modified by linking.
+    auto w{min};
+    do {
+        roots.push_back(w);
+        w = w->right;
+    } while (w != min);
+    for (auto x : roots) {  // For each node `x` in the root list.
         int d = x->degree;
         while (A[d]) {  // Root with degree `d` already exists in the root list.
             auto y = A[d];
-            if (x == y) { goto EXIT; }
             if (comp_(y->key, x->key)) { std::swap(x, y); }
             FibHeapLink(y, x);
+            FIB_HEAP_STAT(links);
             A[d] = nullptr;  // Trees linked and eliminated.
             d++;  // Continue to check the next possible degree.
+            if (d + 1 >= static_cast<int>(A.size())) { A.resize(d + 2, nullptr); }
         }
         A[d] = x;
-        x = x->right;
     }
-    EXIT:
-    min = x;
+    min = nullptr;
     for (auto root : A) {  // For each unique root in list A.
-        if (root) {  // If root with current degree exists...
-            if (comp_(root->key, min->key)) { min = root; }  // Update min if necessary.
-        }
+        if (root && (!min || comp_(root->key, min->key))) { min = root; }  // Update min if necessary.
     }
 }
 
@@ -195,6 +197,7 @@ typename FibonacciHeap<T, Comp>::FibonacciNode* FibonacciHeap<T, Comp>::FibHeapE
             Consolidate();
         }
         n--;  // Update number of nodes in the heap.
+        FIB_HEAP_STAT(extract_mins);
     }
     return z;
 }
@@ -249,18 +252,20 @@ void FibonacciHeap<T, Comp>::Cut(FibonacciHeap::FibonacciNode* x, FibonacciHeap:
 /*!
  * @brief This function recursively check a node that has just lost a child and perform cutting if necessary.
  * @param y is the node which just lost a child.
+ * @return number of cuts performed.
  */
 template<typename T, typename Comp>
-void FibonacciHeap<T, Comp>::CascadingCut(FibonacciHeap::FibonacciNode* y) {
+unsigned FibonacciHeap<T, Comp>::CascadingCut(FibonacciHeap::FibonacciNode* y) {
     FibonacciNode* z{y->p};
     if (z) {  // If `y` is not the root.
         if (!y->mark) {  // Mark `y` if previously unmarked.
             y->mark = true;
         } else {
             Cut(y, z);  // Cut `y` if already marked.
-            CascadingCut(z);  // Call recursively on `y`'s parent.
+            return 1 + CascadingCut(z);  // Call recursively on `y`'s parent.
         }
     }
+    return 0;
 }
 
 /*!
@@ -275,13 +280,15 @@ void FibonacciHeap<T, Comp>::FibHeapDecreaseKey(FibonacciHeap::FibonacciNode* x,
         std::cerr << "Error: New key is greater than the current key!" << std::endl;
         return;
     }
+    FIB_HEAP_STAT(decrease_keys);
     // Update current key.
     x->key = std::move(k);
     FibonacciNode* y{x->p};
     // If x is not a root?
     if (y && comp_(x->key, y->key)) {
         Cut(x, y);  // Cut `x` from subtree `y`.
-        CascadingCut(y);  // Recursively check and cut `y`.
+        FIB_HEAP_STAT(cuts);
+        FIB_HEAP_STAT_ADD(cascading_cuts, CascadingCut(y));  // Recursively check and cut `y`.
     }
     // Update `min` pointer if necessary.
     if (comp_(x->key, min->key)) {
@@ -289,6 +296,48 @@ void FibonacciHeap<T, Comp>::FibHeapDecreaseKey(FibonacciHeap::FibonacciNode* x,
     }
 }
 
+/*!
+ * @brief This function increases the key value of a given node. Nodes without children (other than `min`)
+ * cannot violate the heap property and are updated in place; otherwise the node is cut out of the heap
+ * and reinserted with the new key.
+ * @param x is the pointer to the node.
+ * @param k is the new key value (must be no smaller than the current key).
+ */
+template<typename T, typename Comp>
+void FibonacciHeap<T, Comp>::FibHeapIncreaseKey(FibonacciHeap::FibonacciNode* x, T k) {
+    // Check if new key is valid.
+    if (comp_(k, x->key)) {
+        std::cerr << "Error: New key is smaller than the current key!" << std::endl;
+        return;
+    }
+    FIB_HEAP_STAT(increase_keys);
+    if (!x->child && x != min) {  // No children to compare against and `min` is unaffected.
+        x->key = std::move(k);
+        return;
+    }
+    FibHeapDelete(x);  // Detach `x` (its children are moved to the root list).
+    x->key = std::move(k);
+    FibHeapInsert(x);  // Reinsert the same node so that handles stay valid.
+}
+
+/*!
+ * @brief This function removes an arbitrary node from the heap without deallocating it.
+ * It works like a decrease-key to negative infinity followed by an extract-min.
+ * @param x is the pointer to the node.
+ * @return pointer to the detached node.
+ */
+template<typename T, typename Comp>
+typename FibonacciHeap<T, Comp>::FibonacciNode* FibonacciHeap<T, Comp>::FibHeapDelete(FibonacciNode* x) {
+    FIB_HEAP_STAT(deletes);
+    FibonacciNode* y{x->p};
+    if (y) {  // If x is not a root?
+        Cut(x, y);  // Cut `x` from subtree `y`.
+        FIB_HEAP_STAT_ADD(delete_cuts, 1 + CascadingCut(y));  // Recursively check and cut `y`.
+    }
+    min = x;  // `x` now plays the role of the minimum.
+    return FibHeapExtractMin();
+}
+
 // Private helper functions.
 /*!
  * @brief This function concatenates two circular, doubly linked lists.
@@ -355,3 +404,165 @@ template<typename T, typename Comp>
 typename FibonacciHeap<T, Comp>::FibonacciNode* FibonacciHeap<T, Comp>::topNode() const {
     return min;
 }
+
+/*!
+ * @brief This method returns an iterator which visits all keys in priority order.
+ * @return an iterator to the top key.
+ */
+template<typename T, typename Comp>
+typename FibonacciHeap<T, Comp>::OrderedIterator FibonacciHeap<T, Comp>::ordered_begin() const {
+    return OrderedIterator{min, comp_};
+}
+
+/*!
+ * @brief This method returns the end iterator of the priority-order traversal.
+ * @return an empty iterator.
+ */
+template<typename T, typename Comp>
+typename FibonacciHeap<T, Comp>::OrderedIterator FibonacciHeap<T, Comp>::ordered_end() const {
+    return OrderedIterator{};
+}
+
+/*!
+ * @brief This method peeks at the `k` keys with the highest priority without popping them.
+ * @param k is the number of keys wanted.
+ * @return a vector of pointers to the keys in priority order (shorter if the heap has fewer keys).
+ */
+template<typename T, typename Comp>
+std::vector<const T*> FibonacciHeap<T, Comp>::top_k(size_t k) const {
+    std::vector<const T*> vec;
+    vec.reserve(std::min<size_t>(k, n));
+    for (auto iter = ordered_begin(); vec.size() < k && iter != ordered_end(); ++iter) {
+        vec.push_back(&*iter);
+    }
+    return vec;
+}
+
+#if FIB_HEAP_STATS
+/*!
+ * @brief This method takes a snapshot of the heap statistics. The structural part is computed by walking
+ * every node, so it costs O(n) and is meant for periodic reporting only.
+ * @return the statistics.
+ */
+template<typename T, typename Comp>
+FibHeapStats FibonacciHeap<T, Comp>::stats() const {
+    FibHeapStats s{stats_};
+    s.nodes = n;
+    if (!min) { return s; }
+    unsigned long degree_sum{};
+    std::vector<const FibonacciNode*> stack;
+    auto iter{min};
+    do {  // Count the roots and seed the traversal.
+        s.roots++;
+        stack.push_back(iter);
+        iter = iter->right;
+    } while (iter != min);
+    while (!stack.empty()) {
+        auto x = stack.back();
+        stack.pop_back();
+        int degree{};
+        if (x->child) {
+            auto c{x->child};
+            do {
+                degree++;
+                stack.push_back(c);
+                c = c->right;
+            } while (c != x->child);
+        }
+        degree_sum += degree;
+        s.max_degree = std::max(s.max_degree, degree);
+        if (x->mark) { s.marked++; }
+    }
+    s.mean_degree = static_cast<double>(degree_sum) / n;
+    return s;
+}
+#endif
+
+/*!
+ * @brief This constructor seeds the frontier with the whole root list.
+ * @param roots is pointer to any node in the root list (may be null).
+ * @param comp is the comparator of the heap.
+ */
+template<typename T, typename Comp>
+FibonacciHeap<T, Comp>::OrderedIterator::OrderedIterator(const FibonacciNode* roots, Comp comp) : comp_(comp) {
+    if (!roots) { return; }
+    auto iter{roots};
+    do {
+        frontier_.push_back(iter);
+        iter = iter->right;
+    } while (iter != roots);
+    std::make_heap(frontier_.begin(), frontier_.end(), [this](const auto lhs, const auto rhs) {
+        return comp_(rhs->key, lhs->key);
+    });  // Linear-time heapify, best node at the front.
+}
+
+/*!
+ * @brief This overloaded dereference operator returns the current key.
+ * @return constant reference to the key.
+ */
+template<typename T, typename Comp>
+const T& FibonacciHeap<T, Comp>::OrderedIterator::operator*() const {
+    return frontier_.front()->key;
+}
+
+/*!
+ * @brief This overloaded member access operator returns the address of the current key.
+ * @return pointer to the key.
+ */
+template<typename T, typename Comp>
+const T* FibonacciHeap<T, Comp>::OrderedIterator::operator->() const {
+    return &frontier_.front()->key;
+}
+
+/*!
+ * @brief This overloaded pre-increment operator replaces the current node with its children.
+ * @return reference to the incremented iterator.
+ */
+template<typename T, typename Comp>
+typename FibonacciHeap<T, Comp>::OrderedIterator& FibonacciHeap<T, Comp>::OrderedIterator::operator++() {
+    auto greater = [this](const auto lhs, const auto rhs) { return comp_(rhs->key, lhs->key); };
+    std::pop_heap(frontier_.begin(), frontier_.end(), greater);
+    auto x = frontier_.back();
+    frontier_.pop_back();
+    if (x->child) {  // Children are the only candidates that become eligible.
+        auto iter{x->child};
+        do {
+            pushNode(iter);
+            iter = iter->right;
+        } while (iter != x->child);
+    }
+    return *this;
+}
+
+/*!
+ * @brief This method pushes a node onto the frontier.
+ * @param x is pointer to the node.
+ */
+template<typename T, typename Comp>
+void FibonacciHeap<T, Comp>::OrderedIterator::pushNode(const FibonacciNode* x) {
+    frontier_.push_back(x);
+    std::push_heap(frontier_.begin(), frontier_.end(), [this](const auto lhs, const auto rhs) {
+        return comp_(rhs->key, lhs->key);
+    });
+}
+
+/*!
+ * @brief This overloaded equality operator checks whether two iterators are both exhausted or at the same node.
+ * @param rhs is reference to another iterator.
+ * @return true if equal, false otherwise.
+ */
+template<typename T, typename Comp>
+bool FibonacciHeap<T, Comp>::OrderedIterator::operator==(const OrderedIterator& rhs) const {
+    if (frontier_.empty() || rhs.frontier_.empty()) { return frontier_.empty() == rhs.frontier_.empty(); }
+    return frontier_.front() == rhs.frontier_.front();
+}
+
+/*!
+ * @brief This overloaded inequality operator checks whether two iterators differ.
+ * @param rhs is reference to another iterator.
+ * @return true if not equal, false otherwise.
+ */
+template<typename T, typename Comp>
+bool FibonacciHeap<T, Comp>::OrderedIterator::operator!=(const OrderedIterator& rhs) const {
+    return !(*this == rhs);
+}
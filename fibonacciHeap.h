@@ -10,6 +10,58 @@
 #include <cmath>
 #include <algorithm>
 #include <vector>
+#include <iterator>
+#include "config.h"
+
+#if FIB_HEAP_STATS
+/*!
+ * @brief This struct holds the structural statistics of a Fibonacci heap. The first group is computed on demand
+ * by walking the heap; the second group consists of counters accumulated since construction.
+ */
+struct FibHeapStats {
+    // Structure of the heap at the time of the snapshot.
+    unsigned nodes{};
+    unsigned roots{};  // Length of the root list.
+    int max_degree{};
+    double mean_degree{};  // Average degree over all nodes.
+    unsigned marked{};  // Number of marked nodes.
+    // Operation counters.
+    unsigned long decrease_keys{};
+    unsigned long cuts{};  // Cuts performed directly by decrease-key.
+    unsigned long cascading_cuts{};  // Cascading cuts that follow them.
+    unsigned long increase_keys{};
+    unsigned long deletes{};  // Including the cut-and-reinserts of increase-key.
+    unsigned long delete_cuts{};  // Cuts and cascading cuts performed by delete.
+    unsigned long extract_mins{};  // Including the extract-min that ends each delete.
+    unsigned long links{};  // Links performed by consolidation.
+
+    [[nodiscard]] double cutsPerDecreaseKey() const {
+        return decrease_keys ? static_cast<double>(cuts + cascading_cuts) / decrease_keys : 0.0;
+    }
+    [[nodiscard]] double linksPerExtractMin() const {
+        return extract_mins ? static_cast<double>(links) / extract_mins : 0.0;
+    }
+};
+
+/*!
+ * @brief This overloaded operator prints the statistics on a single line.
+ */
+inline std::ostream& operator<<(std::ostream& os, const FibHeapStats& s) {
+    return os << "nodes=" << s.nodes << " roots=" << s.roots << " max_degree=" << s.max_degree
+              << " mean_degree=" << s.mean_degree << " marked=" << s.marked
+              << " decrease_keys=" << s.decrease_keys << " cuts=" << s.cuts
+              << " cascading_cuts=" << s.cascading_cuts << " cuts/decrease_key=" << s.cutsPerDecreaseKey()
+              << " increase_keys=" << s.increase_keys << " deletes=" << s.deletes << " delete_cuts=" << s.delete_cuts
+              << " extract_mins=" << s.extract_mins << " links=" << s.links
+              << " links/extract_min=" << s.linksPerExtractMin();
+}
+
+#define FIB_HEAP_STAT(counter) (++stats_.counter)
+#define FIB_HEAP_STAT_ADD(counter, n) (stats_.counter += (n))
+#else
+#define FIB_HEAP_STAT(counter) ((void) 0)
+#define FIB_HEAP_STAT_ADD(counter, n) ((void) (n))
+#endif
 
 /*!
  * @brief This class declaration declares a CLRS-style Fibonacci heap data structure.
@@ -40,8 +92,39 @@ protected:
     int n{0};
     FibonacciNode* min{nullptr};
     Comp comp_;  // Function object for comparison.
+#if FIB_HEAP_STATS
+    FibHeapStats stats_{};  // Only the operation counters are maintained here.
+#endif
 
 public:
+    /*!
+     * @brief This class lazily visits the keys in priority order without modifying the heap.
+     * It keeps a binary heap (the frontier) seeded with the roots; each step pops the best node
+     * and pushes its children, so the first k keys cost O(k log k) plus the initial heapify of the roots.
+     * The iterator is invalidated by any modification of the heap.
+     */
+    class OrderedIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        OrderedIterator() = default;  // The end iterator.
+        OrderedIterator(const FibonacciNode* roots, Comp comp);
+        reference operator*() const;
+        pointer operator->() const;
+        OrderedIterator& operator++();
+        bool operator==(const OrderedIterator& rhs) const;
+        bool operator!=(const OrderedIterator& rhs) const;
+
+    private:
+        void pushNode(const FibonacciNode* x);
+        std::vector<const FibonacciNode*> frontier_{};
+        Comp comp_{};
+    };
+
     // Constructors and destructors.
     FibonacciHeap();
     explicit FibonacciHeap(Comp comp);
@@ -58,6 +141,12 @@ public:
     [[nodiscard]] virtual unsigned size() const;
     [[nodiscard]] virtual T& top() const;
     virtual FibonacciNode* topNode() const;
+    [[nodiscard]] OrderedIterator ordered_begin() const;
+    [[nodiscard]] OrderedIterator ordered_end() const;
+    [[nodiscard]] std::vector<const T*> top_k(size_t k) const;
+#if FIB_HEAP_STATS
+    [[nodiscard]] FibHeapStats stats() const;
+#endif
 
     // Static functions.
     static FibonacciHeap* FibHeapUnion(FibonacciHeap* H1, FibonacciHeap* H2);
@@ -74,9 +163,11 @@ protected:
     FibonacciNode* FibHeapExtractMin();
     void FibHeapLink(FibonacciNode* y, FibonacciNode* x);
     void FibHeapDecreaseKey(FibonacciNode* x, T k);
+    void FibHeapIncreaseKey(FibonacciNode* x, T k);
+    FibonacciNode* FibHeapDelete(FibonacciNode* x);
     void Consolidate();
     void Cut(FibonacciNode* x, FibonacciNode* y);
-    void CascadingCut(FibonacciNode* y);
+    unsigned CascadingCut(FibonacciNode* y);
     void DeallocateTree(FibonacciNode* x);
 };
 
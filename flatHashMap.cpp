@@ -0,0 +1,258 @@
+/*!
+ * @brief This file contains the implementation of class <em>FlatHashMap</em>.
+ */
+#include "flatHashMap.h"
+
+/*!
+ * @brief This constructor creates an empty map able to hold `capacity` entries without rehashing.
+ * @param capacity is the expected number of entries.
+ */
+template<typename K, typename V, typename Hasher>
+FlatHashMap<K, V, Hasher>::FlatHashMap(size_t capacity) {
+    reserve(capacity);
+}
+
+/*!
+ * @brief This constructor creates an iterator and moves it to the first occupied slot at or after `i`.
+ * @param map is pointer to the map.
+ * @param i is the starting slot index.
+ */
+template<typename K, typename V, typename Hasher>
+template<bool Const>
+FlatHashMap<K, V, Hasher>::BasicIterator<Const>::BasicIterator(map_pointer map, size_t i) : map_(map), i_(i) {
+    while (i_ < map_->used_.size() && !map_->used_[i_]) { ++i_; }
+}
+
+/*!
+ * @brief This overloaded pre-increment operator moves the iterator to the next occupied slot.
+ * @return reference to the incremented iterator.
+ */
+template<typename K, typename V, typename Hasher>
+template<bool Const>
+typename FlatHashMap<K, V, Hasher>::template BasicIterator<Const>&
+FlatHashMap<K, V, Hasher>::BasicIterator<Const>::operator++() {
+    do { ++i_; } while (i_ < map_->used_.size() && !map_->used_[i_]);
+    return *this;
+}
+
+/*!
+ * @brief This overloaded post-increment operator moves the iterator to the next occupied slot.
+ * @return the original iterator.
+ */
+template<typename K, typename V, typename Hasher>
+template<bool Const>
+typename FlatHashMap<K, V, Hasher>::template BasicIterator<Const>
+FlatHashMap<K, V, Hasher>::BasicIterator<Const>::operator++(int) {
+    BasicIterator temp{*this};
+    operator++();
+    return temp;
+}
+
+/*!
+ * @brief This method computes the preferred slot of a key. The hash is mixed with a Fibonacci multiplier
+ * so that identity hashes (e.g. `std::hash<int>`) still spread over the table.
+ * @param k is the key object.
+ * @return index of the home slot.
+ */
+template<typename K, typename V, typename Hasher>
+size_t FlatHashMap<K, V, Hasher>::_home(const K& k) const {
+    uint64_t h = static_cast<uint64_t>(Hasher{}(k)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(h ^ (h >> 32)) & mask_;
+}
+
+/*!
+ * @brief This method probes for the slot holding `k`, or the empty slot where `k` would be inserted.
+ * @param k is the key object.
+ * @return index of the slot.
+ */
+template<typename K, typename V, typename Hasher>
+size_t FlatHashMap<K, V, Hasher>::_probe(const K& k) const {
+    size_t i = _home(k);
+    while (used_[i] && !(slots_[i].first == k)) {
+        i = (i + 1) & mask_;
+    }
+    return i;
+}
+
+/*!
+ * @brief This method moves all entries into a new table.
+ * @param capacity is the new capacity (a power of two).
+ */
+template<typename K, typename V, typename Hasher>
+void FlatHashMap<K, V, Hasher>::_rehash(size_t capacity) {
+    std::vector<value_type> old_slots(capacity);
+    std::vector<uint8_t> old_used(capacity, 0);
+    old_slots.swap(slots_);
+    old_used.swap(used_);
+    mask_ = capacity - 1;
+    for (size_t j = 0; j < old_used.size(); ++j) {
+        if (!old_used[j]) { continue; }
+        size_t i = _probe(old_slots[j].first);
+        slots_[i] = std::move(old_slots[j]);
+        used_[i] = 1;
+    }
+}
+
+/*!
+ * @brief This method makes room for at least `n` entries while keeping the load factor under 3/4.
+ * @param n is the expected number of entries.
+ */
+template<typename K, typename V, typename Hasher>
+void FlatHashMap<K, V, Hasher>::reserve(size_t n) {
+    size_t capacity = 8;
+    while (capacity * 3 < n * 4) { capacity <<= 1; }
+    if (capacity > slots_.size()) { _rehash(capacity); }
+}
+
+/*!
+ * @brief This method inserts a key-value pair, or overwrites the value if the key already exists.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if a new entry was inserted, false if an existing one was overwritten.
+ */
+template<typename K, typename V, typename Hasher>
+bool FlatHashMap<K, V, Hasher>::insert_or_assign(K k, V v) {
+    if ((size_ + 1) * 4 > slots_.size() * 3) {
+        _rehash(slots_.empty() ? 8 : slots_.size() * 2);
+    }
+    size_t i = _probe(k);
+    if (used_[i]) {
+        slots_[i].second = std::move(v);
+        return false;
+    }
+    slots_[i] = std::make_pair(std::move(k), std::move(v));
+    used_[i] = 1;
+    size_++;
+    return true;
+}
+
+/*!
+ * @brief This method removes a key. Later entries of the same probe run are shifted backwards
+ * so that no tombstone is needed.
+ * @param k is the key object.
+ * @return true if removed, false if not found.
+ */
+template<typename K, typename V, typename Hasher>
+bool FlatHashMap<K, V, Hasher>::erase(const K& k) {
+    if (0 == size_) { return false; }
+    size_t i = _probe(k);
+    if (!used_[i]) { return false; }
+    for (size_t j = (i + 1) & mask_; used_[j]; j = (j + 1) & mask_) {
+        size_t home = _home(slots_[j].first);
+        if (((j - home) & mask_) >= ((j - i) & mask_)) {  // Entry `j` may legally move back to `i`.
+            slots_[i] = std::move(slots_[j]);
+            i = j;
+        }
+    }
+    slots_[i] = value_type{};
+    used_[i] = 0;
+    size_--;
+    return true;
+}
+
+/*!
+ * @brief This method looks up a key.
+ * @param k is the key object.
+ * @return pointer to the mapped value, or nullptr if not found.
+ */
+template<typename K, typename V, typename Hasher>
+V* FlatHashMap<K, V, Hasher>::find(const K& k) {
+    if (0 == size_) { return nullptr; }
+    size_t i = _probe(k);
+    return used_[i] ? &slots_[i].second : nullptr;
+}
+
+/*!
+ * @brief This method looks up a key.
+ * @param k is the key object.
+ * @return pointer to the mapped value, or nullptr if not found.
+ */
+template<typename K, typename V, typename Hasher>
+const V* FlatHashMap<K, V, Hasher>::find(const K& k) const {
+    if (0 == size_) { return nullptr; }
+    size_t i = _probe(k);
+    return used_[i] ? &slots_[i].second : nullptr;
+}
+
+/*!
+ * @brief This method checks if the given key exists in the map.
+ * @param k is the key object.
+ * @return true if exists, false otherwise.
+ */
+template<typename K, typename V, typename Hasher>
+bool FlatHashMap<K, V, Hasher>::contains(const K& k) const {
+    return nullptr != find(k);
+}
+
+/*!
+ * @brief This method checks if the map is empty.
+ * @return true if empty, false otherwise.
+ */
+template<typename K, typename V, typename Hasher>
+bool FlatHashMap<K, V, Hasher>::empty() const {
+    return 0 == size_;
+}
+
+/*!
+ * @brief This method returns number of entries in the map.
+ * @return number of entries.
+ */
+template<typename K, typename V, typename Hasher>
+size_t FlatHashMap<K, V, Hasher>::size() const {
+    return size_;
+}
+
+/*!
+ * @brief This method returns number of slots in the table.
+ * @return number of slots.
+ */
+template<typename K, typename V, typename Hasher>
+size_t FlatHashMap<K, V, Hasher>::capacity() const {
+    return slots_.size();
+}
+
+/*!
+ * @brief This method removes all entries (the table keeps its capacity).
+ */
+template<typename K, typename V, typename Hasher>
+void FlatHashMap<K, V, Hasher>::clear() {
+    std::fill(slots_.begin(), slots_.end(), value_type{});
+    std::fill(used_.begin(), used_.end(), 0);
+    size_ = 0;
+}
+
+/*!
+ * @brief This method returns an iterator to the first entry.
+ * @return an iterator.
+ */
+template<typename K, typename V, typename Hasher>
+typename FlatHashMap<K, V, Hasher>::Iterator FlatHashMap<K, V, Hasher>::begin() {
+    return Iterator{this, 0};
+}
+
+/*!
+ * @brief This method returns the past-the-end iterator.
+ * @return an iterator.
+ */
+template<typename K, typename V, typename Hasher>
+typename FlatHashMap<K, V, Hasher>::Iterator FlatHashMap<K, V, Hasher>::end() {
+    return Iterator{this, used_.size()};
+}
+
+/*!
+ * @brief This method returns a constant iterator to the first entry.
+ * @return a constant iterator.
+ */
+template<typename K, typename V, typename Hasher>
+typename FlatHashMap<K, V, Hasher>::ConstIterator FlatHashMap<K, V, Hasher>::begin() const {
+    return ConstIterator{this, 0};
+}
+
+/*!
+ * @brief This method returns the past-the-end constant iterator.
+ * @return a constant iterator.
+ */
+template<typename K, typename V, typename Hasher>
+typename FlatHashMap<K, V, Hasher>::ConstIterator FlatHashMap<K, V, Hasher>::end() const {
+    return ConstIterator{this, used_.size()};
+}
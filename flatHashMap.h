@@ -0,0 +1,95 @@
+/*!
+ * @brief This file contains the class definition of <em>FlatHashMap</em>.
+ */
+#ifndef CS225_SP22_C1_FLATHASHMAP_H_
+#define CS225_SP22_C1_FLATHASHMAP_H_
+
+#include <vector>
+#include <utility>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+
+/*!
+ * @brief This class implements an open-addressing hash map with linear probing and backward-shift deletion.
+ * All entries live in one contiguous array, so there is no per-entry allocation and no tombstone.
+ * @tparam K is type of keys.
+ * @tparam V is type of mapped values (must be default-constructible).
+ * @tparam Hasher is the hashing function of the keys. Its output is further mixed by the map.
+ */
+template<typename K, typename V, typename Hasher = std::hash<K>>
+class FlatHashMap {
+public:
+    using value_type = std::pair<K, V>;
+
+    /*!
+     * @brief This class defines a forward iterator over occupied slots.
+     */
+    template<bool Const>
+    class BasicIterator {
+        friend FlatHashMap;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using map_pointer = std::conditional_t<Const, const FlatHashMap*, FlatHashMap*>;
+
+        BasicIterator() = default;
+        reference operator*() const { return map_->slots_[i_]; }
+        pointer operator->() const { return &map_->slots_[i_]; }
+        BasicIterator& operator++();
+        BasicIterator operator++(int);
+        bool operator==(const BasicIterator& rhs) const { return map_ == rhs.map_ && i_ == rhs.i_; }
+        bool operator!=(const BasicIterator& rhs) const { return !(*this == rhs); }
+
+    private:
+        BasicIterator(map_pointer map, size_t i);
+        map_pointer map_{nullptr};
+        size_t i_{};
+    };
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    // Constructors and destructor.
+    FlatHashMap() = default;
+    explicit FlatHashMap(size_t capacity);
+    FlatHashMap(const FlatHashMap& flat_hash_map) = default;
+    FlatHashMap& operator=(const FlatHashMap& flat_hash_map) = default;
+    FlatHashMap(FlatHashMap&& flat_hash_map) noexcept = default;
+    FlatHashMap& operator=(FlatHashMap&& flat_hash_map) noexcept = default;
+    virtual ~FlatHashMap() = default;
+
+    // APIs.
+    bool insert_or_assign(K k, V v);
+    bool erase(const K& k);
+    [[nodiscard]] V* find(const K& k);
+    [[nodiscard]] const V* find(const K& k) const;
+    [[nodiscard]] bool contains(const K& k) const;
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] size_t capacity() const;
+    void reserve(size_t n);
+    void clear();
+    Iterator begin();
+    Iterator end();
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+private:
+    // Fields.
+    std::vector<value_type> slots_{};
+    std::vector<uint8_t> used_{};  // 1 if the slot at the same index is occupied.
+    size_t size_{};
+    size_t mask_{};  // Capacity minus one (capacity is always a power of two).
+
+    // Private helper functions.
+    [[nodiscard]] size_t _home(const K& k) const;
+    [[nodiscard]] size_t _probe(const K& k) const;
+    void _rehash(size_t capacity);
+};
+
+#endif //CS225_SP22_C1_FLATHASHMAP_H_
@@ -0,0 +1,189 @@
+/*!
+ * @brief This file contains the in-node key search routines shared by the B-tree family.
+ * The generic versions work for any ordered key type; the `int` overloads compare several keys
+ * per instruction with SSE2 (always available on x86-64) or AVX2 (when compiled with `-mavx2`), and the
+ * `std::string` overload compares cached 8-byte key prefixes before the keys themselves.
+ */
+#ifndef CS225_SP22_C2_KEYSEARCH_H_
+#define CS225_SP22_C2_KEYSEARCH_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/*!
+ * @brief This function finds the first key not less than `k` in a sorted array.
+ * @tparam K is type of key objects.
+ * @param keys is pointer to the sorted keys.
+ * @param n is number of keys.
+ * @param k is the key object.
+ * @return index of the first key not less than `k` (n if none).
+ */
+template<typename K>
+int keyLowerBound(const K* keys, int n, const K& k) {
+    return static_cast<int>(std::lower_bound(keys, keys + n, k) - keys);
+}
+
+/*!
+ * @brief This function finds the first key greater than `k` in a sorted array.
+ * @tparam K is type of key objects.
+ * @param keys is pointer to the sorted keys.
+ * @param n is number of keys.
+ * @param k is the key object.
+ * @return index of the first key greater than `k` (n if none).
+ */
+template<typename K>
+int keyUpperBound(const K* keys, int n, const K& k) {
+    return static_cast<int>(std::upper_bound(keys, keys + n, k) - keys);
+}
+
+/*!
+ * @brief This function finds a key in an unsorted array without data-dependent branches:
+ * every slot is compared and the last match found (scanning backwards) is kept.
+ * @tparam K is type of key objects.
+ * @param keys is pointer to the keys.
+ * @param n is number of keys.
+ * @param k is the key object.
+ * @return index of the first slot equal to `k`, or -1 if not found.
+ */
+template<typename K>
+int keyFind(const K* keys, int n, const K& k) {
+    int r = -1;
+    for (int j = n - 1; j >= 0; --j) {
+        r = keys[j] == k ? j : r;  // Compiled to a conditional move.
+    }
+    return r;
+}
+
+/*!
+ * @brief This function counts the sorted `int` keys less than `k`, 8 (AVX2) or 4 (SSE2) at a time.
+ * The comparison mask of a sorted block is a run of ones, so its popcount is the offset of the answer.
+ * @param keys is pointer to the sorted keys.
+ * @param n is number of keys.
+ * @param k is the key object.
+ * @return index of the first key not less than `k` (n if none).
+ */
+inline int keyLowerBound(const int* keys, int n, const int& k) {
+    int i = 0;
+#if defined(__AVX2__)
+    const __m256i k8 = _mm256_set1_epi32(k);
+    for (; i + 8 <= n; i += 8) {
+        __m256i lt = _mm256_cmpgt_epi32(k8, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)));
+        auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(lt)));
+        if (0xFFu != mask) { return i + __builtin_popcount(mask); }
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i k4 = _mm_set1_epi32(k);
+    for (; i + 4 <= n; i += 4) {
+        __m128i lt = _mm_cmpgt_epi32(k4, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)));
+        auto mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(lt)));
+        if (0xFu != mask) { return i + __builtin_popcount(mask); }
+    }
+#endif
+    while (i < n && keys[i] < k) { ++i; }
+    return i;
+}
+
+/*!
+ * @brief This function counts the sorted `int` keys not greater than `k`, several at a time.
+ * @param keys is pointer to the sorted keys.
+ * @param n is number of keys.
+ * @param k is the key object.
+ * @return index of the first key greater than `k` (n if none).
+ */
+inline int keyUpperBound(const int* keys, int n, const int& k) {
+    int i = 0;
+#if defined(__AVX2__)
+    const __m256i k8 = _mm256_set1_epi32(k);
+    for (; i + 8 <= n; i += 8) {
+        __m256i gt = _mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), k8);
+        auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(gt)));
+        if (mask) { return i + 8 - __builtin_popcount(mask); }
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i k4 = _mm_set1_epi32(k);
+    for (; i + 4 <= n; i += 4) {
+        __m128i gt = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), k4);
+        auto mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(gt)));
+        if (mask) { return i + 4 - __builtin_popcount(mask); }
+    }
+#endif
+    while (i < n && !(k < keys[i])) { ++i; }
+    return i;
+}
+
+/*!
+ * @brief This function finds an `int` key in an unsorted array. Each block of 64 slots is compared in full
+ * and the matches are collected in a bit mask; the first set bit is the answer.
+ * @param keys is pointer to the keys.
+ * @param n is number of keys.
+ * @param k is the key object.
+ * @return index of the first slot equal to `k`, or -1 if not found.
+ */
+inline int keyFind(const int* keys, int n, const int& k) {
+    for (int base = 0; base < n; base += 64) {
+        int m = std::min(n - base, 64);
+        uint64_t mask{};
+        int i = 0;
+#if defined(__SSE2__)
+        const __m128i k4 = _mm_set1_epi32(k);
+        for (; i + 4 <= m; i += 4) {
+            __m128i eq = _mm_cmpeq_epi32(k4, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + base + i)));
+            mask |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(eq))) << i;
+        }
+#endif
+        for (; i < m; ++i) {
+            mask |= static_cast<uint64_t>(keys[base + i] == k) << i;
+        }
+        if (mask) { return base + __builtin_ctzll(mask); }
+    }
+    return -1;
+}
+
+/*!
+ * @brief This function packs the first 8 bytes of a string key into an integer, most significant byte first and
+ * zero-padded. Prefixes compare like the keys they come from, except that different keys may share a prefix.
+ * @param k is the key.
+ * @return the prefix.
+ */
+inline uint64_t keyPrefix(std::string_view k) {
+    unsigned char bytes[8]{};
+    std::memcpy(bytes, k.data(), std::min<size_t>(k.size(), 8));
+    uint64_t prefix{};
+    for (unsigned char byte : bytes) { prefix = (prefix << 8) | byte; }  // Compiled to a load and a byte swap.
+    return prefix;
+}
+
+/*!
+ * @brief This function finds the first string key not less than `k` in a sorted array, comparing the cached
+ * prefixes of the keys (see `keyPrefix`) as integers and reading a key only when its prefix ties with `k`'s.
+ * @param keys is pointer to the sorted keys.
+ * @param prefixes is pointer to the prefixes of the keys.
+ * @param n is number of keys.
+ * @param k is the key.
+ * @return index of the first key not less than `k` (n if none).
+ */
+inline int keyLowerBound(const std::string* keys, const uint64_t* prefixes, int n, std::string_view k) {
+    const uint64_t prefix = keyPrefix(k);
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        bool less = prefixes[mid] != prefix ? prefixes[mid] < prefix : std::string_view{keys[mid]} < k;
+        if (less) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+#endif //CS225_SP22_C2_KEYSEARCH_H_
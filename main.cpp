@@ -4,13 +4,18 @@
 #include "registrationRecord.h"
 #include "config.h"
 #include "eventDriver.h"
+#include <cstdlib>
 
 int main() {
     printWelcomeMessage();  // Welcome!
     startingTime = std::time(nullptr);
 
     // Instantiate our crucial data structures.
-    Container container{numReg, numLoc};
+    const char* engine = std::getenv("RQRS_ENGINE");  // Storage engine of the primary index.
+    Container container{numReg, numLoc, engine ? engine : "bplustree"};
+#if !PERSISTENT_DB
+    std::cout << YELLOW << "Primary index storage engine: " << container.primaryDB.name() << RESET << std::endl;
+#endif
 
     int choice;
     std::cout << std::endl;
@@ -24,12 +29,19 @@ int main() {
         printBigText();
         return 0;
     }
+    std::cout << YELLOW << "Recovering the database..." << RESET << std::endl;
+    try {
+        recoverDB(container);
+    } catch (const IOError& error) {
+        std::cerr << error.what() << std::endl;
+    }
     std::cout << YELLOW << "Loading local registries..." << RESET << std::endl;
     try {
         loadRecords(container);
     } catch (const IOError& error) {
         std::cerr << error.what() << std::endl;
     }
+    commitDB(container);
     std::cout << YELLOW << "Loading appointment preferences..." << RESET << std::endl;
     try {
         loadPreferences(container);
@@ -38,9 +50,9 @@ int main() {
     }
 
     showPrompt();
-    std::cout << GREEN << "Please enter your choice (0-13): " << RESET;
+    std::cout << GREEN << "Please enter your choice (0-18): " << RESET;
     while (true) {
-        scanIntRange(choice, 0, 13);
+        scanIntRange(choice, 0, 18);
         switch (choice) {
             case 1: {
                 move12Hours(container);
@@ -155,14 +167,76 @@ int main() {
                 removeDBRecord(container, name);
                 break;
             }
+            case 14: {
+                int n;
+                std::cout << BLUE << "Please enter the number of upcoming appointments to preview (max=100): "
+                          << RESET << std::endl;
+                scanIntRange(n, 1, 100);
+                previewAppointments(n, container);
+                break;
+            }
+            case 15: {
+                int lo, hi, order;
+                std::cout << BLUE << "Please enter the smallest ID to export: " << RESET << std::endl;
+                scanIntRange(lo, 1, std::numeric_limits<int>::max());
+                std::cout << BLUE << "Please enter the largest ID to export: " << RESET << std::endl;
+                scanIntRange(hi, lo, std::numeric_limits<int>::max());
+                std::cout << BLUE << "What order do you want? (1: ascending ID, 2: descending ID)" << RESET
+                          << std::endl;
+                scanIntRange(order, 1, 2);
+                exportDBRecords(container, lo, hi, 2 == order);
+                break;
+            }
+            case 16: {
+                std::string prefix;
+                int limit;
+                std::cout << BLUE << "Please enter the beginning of the usernames to search for: " << RESET
+                          << std::endl;
+                std::cin.clear();
+                std::cin.ignore(256, '\n');
+                getline(std::cin, prefix);
+                std::cout << BLUE << "Please enter the maximum number of records to list (max=100): " << RESET
+                          << std::endl;
+                scanIntRange(limit, 1, 100);
+                searchDBRecords(container, prefix, limit);
+                break;
+            }
+            case 17: {
+                int status, limit;
+                std::cout << BLUE << "Which medical status do you want to list? (0: Registered, 1: Queueing, "
+                                     "2: Appointment Assigned, 3: Withdrawn, 4: Treated)" << RESET << std::endl;
+                scanIntRange(status, 0, StatusIndex::kStatuses - 1);
+                std::cout << BLUE << "Please enter the maximum number of records to list (max=100): " << RESET
+                          << std::endl;
+                scanIntRange(limit, 1, 100);
+                listDBRecordsByStatus(container, status, limit);
+                break;
+            }
+            case 18: {
+                std::string text;
+                int limit;
+                std::cout << BLUE << "Please enter the query, e.g. \"profession<=2 AND risk=1 AND status=queueing\" "
+                                     "(fields: id, name, status, profession, age, risk, registry, treatment; start "
+                                     "with EXPLAIN to show the plan only): " << RESET << std::endl;
+                std::cin.clear();
+                std::cin.ignore(256, '\n');
+                getline(std::cin, text);
+                std::cout << BLUE << "Please enter the maximum number of records to list (max=100): " << RESET
+                          << std::endl;
+                scanIntRange(limit, 1, 100);
+                queryDBRecords(container, text, limit);
+                break;
+            }
             case 9:
             default:
                 showPrompt();
         }
-        std::cout << GREEN << "Please enter your choice (0-13, enter 9 to re-display the prompt): " << RESET;
+        commitDB(container);
+        std::cout << GREEN << "Please enter your choice (0-18, enter 9 to re-display the prompt): " << RESET;
     }
 
     EXIT:
+    checkpointDB(container);
     printBigText();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,179 @@
+/*!
+ * @brief This file contains the implementation of class <em>MultiQueue</em>.
+ */
+#include "multiQueue.h"
+
+/*!
+ * @brief This constructor creates `c * num_threads` empty shards.
+ * @param num_threads is the expected number of concurrent workers.
+ * @param c is the number of shards per worker (2 is the usual choice).
+ * @param comp is the comparator.
+ */
+template<typename T, typename Comp, typename Heap>
+MultiQueue<T, Comp, Heap>::MultiQueue(unsigned num_threads, unsigned c, Comp comp) : comp_(comp) {
+    unsigned m = std::max(2u, std::max(1u, c) * std::max(1u, num_threads));
+    shards_.reserve(m);
+    for (unsigned i = 0; i < m; ++i) {
+        shards_.push_back(std::make_unique<Shard>(comp_));
+    }
+}
+
+/*!
+ * @brief This method picks a shard uniformly at random with a per-thread generator.
+ * @return index of the shard.
+ */
+template<typename T, typename Comp, typename Heap>
+size_t MultiQueue<T, Comp, Heap>::_random_shard() {
+    thread_local std::minstd_rand generator{
+        static_cast<std::minstd_rand::result_type>(std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+    return generator() % shards_.size();
+}
+
+/*!
+ * @brief This method pushes a new object onto a random shard.
+ * @param k is the new key (pass by value).
+ */
+template<typename T, typename Comp, typename Heap>
+void MultiQueue<T, Comp, Heap>::push(T k) {
+    while (true) {
+        auto& shard = *shards_[_random_shard()];
+        std::unique_lock<std::mutex> lock{shard.mutex_, std::try_to_lock};
+        if (!lock) { continue; }  // Contended: just try another shard.
+        shard.heap_.push(std::move(k));
+        size_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+}
+
+/*!
+ * @brief This method pops a high-priority object: the better top of two random shards. A pair that cannot be locked
+ * right away is replaced by a fresh random pair; after `kTryLocks` such pairs in a row the next pair is waited for,
+ * so that a shard held by a preempted worker (more workers than cores) does not fall behind the others. Only when
+ * fewer objects than shards are left, so that random pairs keep missing them, does it fall back to the best top of all
+ * shards.
+ * @param k is reference to the object receiving the popped key.
+ * @return true if an object was popped, false if the queue is empty.
+ */
+template<typename T, typename Comp, typename Heap>
+bool MultiQueue<T, Comp, Heap>::try_pop(T& k) {
+    unsigned failures{};  // Pairs in a row that could not be locked right away.
+    while (size_.load(std::memory_order_relaxed) > 0) {
+        size_t i = _random_shard();
+        size_t j = _random_shard();
+        if (i == j) { j = (j + 1) % shards_.size(); }
+        if (i > j) { std::swap(i, j); }  // Lock in index order.
+        std::unique_lock<std::mutex> lock_i{shards_[i]->mutex_, std::defer_lock};
+        std::unique_lock<std::mutex> lock_j{shards_[j]->mutex_, std::defer_lock};
+        if (failures < kTryLocks) {
+            if (!lock_i.try_lock() || !lock_j.try_lock()) {
+                failures++;
+                continue;  // Contended: try a fresh pair.
+            }
+        } else {
+            lock_i.lock();
+            lock_j.lock();
+        }
+        failures = 0;
+        auto& a = shards_[i]->heap_;
+        auto& b = shards_[j]->heap_;
+        if (a.empty() && b.empty()) {
+            if (size_.load(std::memory_order_relaxed) >= static_cast<long>(shards_.size())) { continue; }
+            lock_j.unlock();
+            lock_i.unlock();
+            return _pop_best(k);  // Few objects left.
+        }
+        auto& best = b.empty() || (!a.empty() && !comp_(b.top(), a.top())) ? a : b;
+        k = std::move(best.top());
+        best.pop();
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+/*!
+ * @brief This method locks every shard (in index order) and pops the best top among them.
+ * @param k is reference to the object receiving the popped key.
+ * @return true if an object was popped, false if every shard is empty.
+ */
+template<typename T, typename Comp, typename Heap>
+bool MultiQueue<T, Comp, Heap>::_pop_best(T& k) {
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(shards_.size());
+    Heap* best{nullptr};
+    for (auto& shard : shards_) {
+        locks.emplace_back(shard->mutex_);
+        auto& heap = shard->heap_;
+        if (!heap.empty() && (!best || comp_(heap.top(), best->top()))) { best = &heap; }
+    }
+    if (!best) { return false; }
+    k = std::move(best->top());
+    best->pop();
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+/*!
+ * @brief This method checks if the queue is (momentarily) empty.
+ * @return true if empty, false otherwise.
+ */
+template<typename T, typename Comp, typename Heap>
+bool MultiQueue<T, Comp, Heap>::empty() const {
+    return size_.load(std::memory_order_relaxed) <= 0;
+}
+
+/*!
+ * @brief This method returns the (momentary) number of objects in the queue.
+ * @return number of objects.
+ */
+template<typename T, typename Comp, typename Heap>
+unsigned MultiQueue<T, Comp, Heap>::size() const {
+    long n = size_.load(std::memory_order_relaxed);
+    return n > 0 ? static_cast<unsigned>(n) : 0;
+}
+
+/*!
+ * @brief This method returns the number of shards.
+ * @return number of shards.
+ */
+template<typename T, typename Comp, typename Heap>
+unsigned MultiQueue<T, Comp, Heap>::num_shards() const {
+    return static_cast<unsigned>(shards_.size());
+}
+
+/*!
+ * @brief This method replaces the key of the object with the given id, in whichever shard holds it.
+ * @param id is the id to look for.
+ * @param k is the new key (pass by value).
+ * @return true if the object was found and updated.
+ */
+template<typename T, typename Comp, typename Heap>
+template<typename Id>
+bool MultiQueue<T, Comp, Heap>::updateKey(const Id& id, T k) {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard->mutex_};
+        auto x = shard->heap_.find_by_id(id);
+        if (!x) { continue; }
+        shard->heap_.updateKey(x, std::move(k));
+        return true;
+    }
+    return false;
+}
+
+/*!
+ * @brief This method moves every object out of a sequential priority queue (e.g. the centralized queue),
+ * so that a batch of records can be handed to concurrent workers. It must not race with other calls.
+ * @tparam Queue is any type with `empty()`, `top()` and `pop()`.
+ * @param queue is reference to the source queue (empty afterwards).
+ * @return number of objects moved.
+ */
+template<typename T, typename Comp, typename Heap>
+template<typename Queue>
+unsigned MultiQueue<T, Comp, Heap>::absorb(Queue& queue) {
+    unsigned count{};
+    for (; !queue.empty(); ++count) {
+        push(queue.top());
+        queue.pop();
+    }
+    return count;
+}
@@ -0,0 +1,79 @@
+/*!
+ * @brief This file contains the class definition of <em>MultiQueue</em>, a concurrent relaxed priority queue.
+ */
+#ifndef CS225_SP22_C1_MULTIQUEUE_H_
+#define CS225_SP22_C1_MULTIQUEUE_H_
+
+#include "centralizedQueue.h"  // Includes the Fibonacci heap.
+#include "centralizedQueue.cpp"
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+
+/*!
+ * @brief This class implements a MultiQueue: `c * p` Fibonacci heaps, each guarded by its own lock.
+ * A push goes to a random shard; a pop looks at the tops of two random shards and takes the better one.
+ * Pops are therefore relaxed: the result is close to, but not always, the global top. In exchange any
+ * number of appointment workers can push and pop at the same time.
+ * @tparam T is type of keys.
+ * @tparam Comp is type of comparators (functor with overloaded () operator).
+ * @tparam Heap is type of the shards: a Fibonacci heap, or a CentralizedQueue to find and update keys by id.
+ */
+template<typename T, typename Comp = std::less<T>, typename Heap = FibonacciHeap<T, Comp>>
+class MultiQueue {
+private:
+    /*!
+     * @brief One shard: a heap and its lock, padded to its own cache lines.
+     */
+    struct alignas(64) Shard {
+        explicit Shard(Comp comp) : heap_(comp) {}
+        std::mutex mutex_;
+        Heap heap_;
+    };
+
+    static constexpr unsigned kTryLocks{1};  // Contended pairs skipped by a pop before it waits for one.
+
+    // Fields.
+    std::vector<std::unique_ptr<Shard>> shards_;
+    alignas(64) std::atomic<long> size_{0};
+    Comp comp_;
+
+public:
+    // Constructors and destructor.
+    MultiQueue() = delete;  // No-args constructor explicitly removed.
+    explicit MultiQueue(unsigned num_threads, unsigned c = 2, Comp comp = Comp());
+    MultiQueue(const MultiQueue& multi_queue) = delete;  // Locks cannot be copied or moved.
+    MultiQueue& operator=(const MultiQueue& multi_queue) = delete;
+    MultiQueue(MultiQueue&& multi_queue) = delete;
+    MultiQueue& operator=(MultiQueue&& multi_queue) = delete;
+    virtual ~MultiQueue() = default;
+
+    // APIs (thread-safe).
+    void push(T k);
+    bool try_pop(T& k);
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] unsigned size() const;
+    [[nodiscard]] unsigned num_shards() const;
+    template<typename Id>
+    bool updateKey(const Id& id, T k);  // CentralizedQueue shards only.
+
+    // APIs (not thread-safe).
+    template<typename Queue>
+    unsigned absorb(Queue& queue);
+
+private:
+    // Private helper functions.
+    size_t _random_shard();
+    bool _pop_best(T& k);
+};
+
+/*!
+ * @brief This alias is the concurrent backend of the centralized queue: its shards keep an id index, so that records
+ * can still be re-prioritized by id while workers pop.
+ */
+template<typename T, typename Comp = std::less<T>, typename IdOf = KeyId<T>>
+using ConcurrentCentralizedQueue = MultiQueue<T, Comp, CentralizedQueue<T, Comp, IdOf>>;
+
+#endif //CS225_SP22_C1_MULTIQUEUE_H_
@@ -0,0 +1,96 @@
+/*!
+ * @brief This file contains the class definition of <em>OptimisticLatch</em>, the per-node latch of the
+ * concurrent B-tree family.
+ */
+#ifndef CS225_SP22_C2_OPTIMISTICLATCH_H_
+#define CS225_SP22_C2_OPTIMISTICLATCH_H_
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+
+/*!
+ * @brief This class implements a latch for optimistic lock coupling. It pairs a version counter with a
+ * reader-writer mutex and supports three modes:
+ * - optimistic: a reader notes the version, reads without latching and validates the version afterwards;
+ *   anything it read from a node that changed meanwhile must be discarded;
+ * - shared: a reader holds the mutex in shared mode, for node contents that cannot be read while being
+ *   written (e.g. `std::string` keys);
+ * - exclusive: a writer holds the mutex exclusively; the version is odd while it does.
+ * Every exclusive section bumps the version by two, so a validated version proves that no writer came in between.
+ */
+class OptimisticLatch {
+public:
+    OptimisticLatch() = default;
+    OptimisticLatch(const OptimisticLatch& latch) = delete;
+    OptimisticLatch& operator=(const OptimisticLatch& latch) = delete;
+    virtual ~OptimisticLatch() = default;
+
+    /*!
+     * @brief This method starts an optimistic read.
+     * @param version is set to the current version.
+     * @return false if a writer holds the latch (the reader must restart).
+     */
+    bool readLock(uint64_t& version) const {
+        version = version_.load(std::memory_order_acquire);
+        return !(version & 1);
+    }
+
+    /*!
+     * @brief This method checks that the node did not change since `readLock()`.
+     * @param version is the version returned by `readLock()`.
+     * @return true if everything read since is consistent.
+     */
+    [[nodiscard]] bool validate(uint64_t version) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version_.load(std::memory_order_relaxed) == version;
+    }
+
+    /*!
+     * @brief This method turns an optimistic read into exclusive ownership, unless the node changed.
+     * Never blocks.
+     * @param version is the version returned by `readLock()`.
+     * @return true if the latch is now held exclusively.
+     */
+    bool tryUpgrade(uint64_t version) {
+        if (!mutex_.try_lock()) { return false; }
+        if (version_.load(std::memory_order_relaxed) != version) {
+            mutex_.unlock();
+            return false;
+        }
+        version_.store(version + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*!
+     * @brief This method acquires the latch exclusively.
+     */
+    void lock() {
+        mutex_.lock();
+        version_.fetch_add(1, std::memory_order_release);
+    }
+
+    /*!
+     * @brief This method releases exclusive ownership and publishes a new version.
+     */
+    void unlock() {
+        version_.fetch_add(1, std::memory_order_release);
+        mutex_.unlock();
+    }
+
+    /*!
+     * @brief This method acquires the latch in shared mode. The version cannot change while it is held.
+     */
+    void lockShared() const { mutex_.lock_shared(); }
+
+    /*!
+     * @brief This method releases the latch from shared mode.
+     */
+    void unlockShared() const { mutex_.unlock_shared(); }
+
+private:
+    std::atomic<uint64_t> version_{0};  // Odd while held exclusively.
+    mutable std::shared_mutex mutex_{};
+};
+
+#endif //CS225_SP22_C2_OPTIMISTICLATCH_H_
@@ -3,20 +3,68 @@
  * which process registration records.
  */
 #include "recordProcessor.h"
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+
+#if !PERSISTENT_DB
+/*!
+ * @brief This function creates the storage engine of the primary index, falling back to the B+-tree if the name
+ * is unknown.
+ * @param name is the name of the engine.
+ * @return the engine.
+ */
+static std::unique_ptr<StorageEngine<int, DBRecord>> makePrimaryEngine(std::string_view name) {
+    auto engine = makeStorageEngine<DBRecord>(name);
+    if (nullptr == engine) {
+        std::cout << BOLDRED << "Unknown storage engine \"" << name << "\", using bplustree." << RESET << std::endl;
+        engine = makeStorageEngine<DBRecord>("bplustree");
+    }
+    return engine;
+}
+#endif
 
 /*!
  * @brief This function creates two vectors with size specified by global variables and append them to the new
  * container object.
  * @param num_reg is number of registries.
  * @param num_loc is number of appointment locations.
+ * @param engine is the storage engine of the primary index: "bplustree", "btree", "hash" or "art". It is ignored
+ * when the indexes are persistent.
  */
-Container::Container(int num_reg, int num_loc) {
+Container::Container(int num_reg, int num_loc, [[maybe_unused]] std::string_view engine)
+#if !PERSISTENT_DB
+    : primaryEngine(makePrimaryEngine(engine))
+#endif
+{
     preferences = std::vector<std::vector<int>>
         (num_reg, std::vector<int>(num_loc, 0));  // Appointment location preferences for each local queue.
     availabilities = std::vector<std::vector<bool>>
         (num_loc, std::vector<bool>(numSlot, true));  // Availability of each time slot.
 }
 
+/*!
+ * @brief This function copies the attributes of a record to the column store, with the list or queue it is now in.
+ * It is called whenever a record moves or one of the aggregated attributes changes.
+ * @param container is the crucial data structure.
+ * @param record is the record.
+ * @param stage is where the record is.
+ */
+void trackRecord(Container& container, const RegistrationRecord& record, ColumnStore::Stage stage) {
+    ColumnStore::Row row;
+    row.id = record.GetId();
+    row.registry = record.GetLocalQueueId();
+    row.profession = record.GetProfessionId();
+    row.age = record.GetAgeId();
+    row.risk = record.GetRiskStatus();
+    row.stage = stage;
+    row.arrival = record.GetTimestamp();
+    row.treated = record.GetTreated() ? record.GetFinalWaitingTime() : -1;
+    container.columns.upsert(row);
+}
+
 /*!
  * @brief This function processes records in the waiting list. It decrements their `extension_` fields and
  * push them to a random local queue once their extension ends.
@@ -30,9 +78,10 @@ void waitingListProcessor(Container& container) {
         if (0 == record.GetExtension()) {  // Extension ended, the record is put into a random local queue.
             int queueID{generateRandomRangedInt(0, numReg - 1)};
             container.localQueues[queueID].emplace(record);
+            trackRecord(container, record, ColumnStore::Stage::kLocalQueue);
+            updateDBRecord(container, record, 0);  // Before the erase below shifts `record`.
             container.waitingList.erase(std::remove(
                 container.waitingList.begin(), container.waitingList.end(), record), container.waitingList.end());
-            updateDBRecord(container, record, 0);
         } else { ++iter; }  // Don't use range-based for loop when you erase something.
     }
 
@@ -97,8 +146,10 @@ void newRegistration(Container& container) {
     addDBRecord(container, record, regID);
     if (0 == risk || 1 == risk) {
         container.localQueues[regID - 1].push(record);  // Passed to the overloaded constructor.
+        trackRecord(container, record, ColumnStore::Stage::kLocalQueue);
     } else {
         container.waitingList.emplace_back(recordInfo);  // Also passed to the overloaded constructor.
+        trackRecord(container, container.waitingList.back(), ColumnStore::Stage::kWaitingList);
     }
     std::cout << BOLDGREEN << "New registration record successfully created!" << std::endl;
     std::string path{"data/reg_" + std::to_string(regID) + ".csv"};
@@ -161,12 +212,9 @@ void addDeadline(int id, time_t deadline, Container& container) {
     }
     // Finally, look at the centralized queue.
     if (!container.centralizedQueue.empty()) {
-        auto centralized_iter =
-            container.centralizedQueue.find_if(found, [&id](const auto& pair) {
-                return pair.first.GetId() == id;  // `&` means "capture by reference."
-            });
-        if (found) {  // Found in centralized queue!
-            auto& record{centralized_iter->second->key};  // Get a (non-const) reference of the object.
+        auto centralized_node = container.centralizedQueue.find_by_id(id);  // Constant-time lookup by id.
+        if (centralized_node) {  // Found in centralized queue!
+            auto& record{centralized_node->key};  // Get a (non-const) reference of the object.
             container.deadlineTracker.emplace_back(std::make_pair(&record,
                                                                   deadline));  // Save the pointer to the record.
             std::cout << BOLDGREEN << "Registration record (ID " << id
@@ -254,6 +302,7 @@ void appointmentProcessor(Container& container) {
               << ") with the highest priority in the centralized queue has been assigned an appointment!"
               << RESET << std::endl;
     container.appointmentList.emplace_back(top_record);
+    trackRecord(container, top_record, ColumnStore::Stage::kAppointment);
     container.centralizedQueue.pop();
     // Update database.
     updateDBRecord(container, top_record, 2);
@@ -275,6 +324,7 @@ void appointmentProcessor(Container& container) {
                 if (!success) { return; }  // No space for other appointments.
                 int id{record_ref.GetId()};
                 container.appointmentList.emplace_back(record_ref);
+                trackRecord(container, record_ref, ColumnStore::Stage::kAppointment);
                 updateDBRecord(container, record_ref, 2);
                 queue.erase(queue_iter);
                 container.deadlineTracker.erase(std::remove(container.deadlineTracker.begin(),
@@ -289,7 +339,8 @@ void appointmentProcessor(Container& container) {
         }
         if (found) { continue; }  // Current record done. No iterator increment.
         // Then search the centralized queue.
-        auto cent_iter = container.centralizedQueue.find(found, record_ref);  // Search for the node.
+        auto cent_node = container.centralizedQueue.find_by_id(record_ref.GetId());  // Search for the node.
+        found = nullptr != cent_node;
         if (found) {
             int id{record_ref.GetId()};
             assignAppointment(success,
@@ -297,16 +348,17 @@ void appointmentProcessor(Container& container) {
                               container);  // Assign appointment to the record.
             if (!success) { return; }  // No need to check other records.
             container.appointmentList.emplace_back(record_ref);
+            trackRecord(container, record_ref, ColumnStore::Stage::kAppointment);
+            updateDBRecord(container, container.appointmentList.back(), 2);  // `record_ref` dies with its node.
             auto temp{record_ref};  // Make a copy.
             temp.SetProfessionId(-1);  // Make `temp` the root.
-            container.centralizedQueue.decreaseKey(cent_iter->second,
+            container.centralizedQueue.decreaseKey(cent_node,
                                                    std::move(temp));  // Make the modified record the root.
             container.centralizedQueue.pop();  // Remove the record from the centralized queue.
             container.deadlineTracker.erase(std::remove(container.deadlineTracker.begin(),
                                                         container.deadlineTracker.end(),
                                                         record_pair),
                                             container.deadlineTracker.end());  // Erase-remove idiom.
-            updateDBRecord(container, record_ref, 2);
             std::cout << BOLDGREEN << "Registration record (ID " << id
                       << ") found in the centralized queue has reached its deadline and been assigned an appointment!"
                       << RESET << std::endl;
@@ -319,12 +371,13 @@ void appointmentProcessor(Container& container) {
             if (!success) { return; }  // No need to check for other records.
             int id{record_ref.GetId()};
             container.appointmentList.emplace_back(record_ref);
+            trackRecord(container, record_ref, ColumnStore::Stage::kAppointment);
+            updateDBRecord(container, container.appointmentList.back(), 2);  // The erase below shifts record_ref.
             container.waitingList.erase(waiting_iter);
             container.deadlineTracker.erase(std::remove(container.deadlineTracker.begin(),
                                                         container.deadlineTracker.end(),
                                                         record_pair),
                                             container.deadlineTracker.end());  // Erase-remove idiom.
-            updateDBRecord(container, record_ref, 2);
             std::cout << BOLDGREEN << "Registration record (ID " << id
                       << ") found in the waiting list has reached its deadline and been assigned an appointment!"
                       << RESET << std::endl;
@@ -352,78 +405,315 @@ void treatmentProcessor(Container& container) {
         container.availabilities[record_ref.GetTreatLocId() - 1][record_ref.GetTreatSlotId() - 1]
             = true;  // Free the slot.
         container.treatedList.emplace_back(record_ref);
+        trackRecord(container, record_ref, ColumnStore::Stage::kTreated);
+        // Generate a random treatment! Priority? It's a waste of time to create a new set of rule! :)
+        updateDBRecord(container, container.treatedList.back(), 4, generateRandomRangedInt(0, 2));
         container.appointmentList.erase(std::remove(container.appointmentList.begin(),
                                                     container.appointmentList.end(),
                                                     record_ref),
                                         container.appointmentList.end());  // Erase-remove idiom.
-        // Generate a random treatment! Priority? It's a waste of time to create a new set of rule! :)
-        updateDBRecord(container, record_ref, 4, generateRandomRangedInt(0, 2));
         std::cout << BOLDGREEN << "Record (ID " << id << ") has been treated!" << std::endl;
         // The current record has been removed. No need to increment the iterator.
     }
 }
 
+constexpr inline char kDBLogPath[]{"data/db.wal"};
+constexpr inline size_t kCheckpointLogBytes{4 << 20};  // Log size that triggers a checkpoint.
+#if !PERSISTENT_DB
+constexpr inline char kCheckpointPath[]{"data/primary.ckpt"};
+constexpr inline char kCheckpointMagic[9]{"RQRSCK01"};  // First bytes of the checkpoint.
+#endif
+
+/*!
+ * @brief This enumeration lists the types of the records of the database log.
+ */
+enum class DBLogType : uint8_t {
+    kInsert = 1,  // Payload: the encoded DBRecord.
+    kUpdate = 2,  // Payload: the encoded DBRecordUpdate.
+    kRemove = 3,  // Payload: the ID.
+    kBatch = 4    // Payload: the encoded DBBatch.
+};
+
+/*!
+ * @brief This function adds the ID of a Database record to the posting list of its name.
+ * @param container is the crucial data structure.
+ * @param name is the username of the record.
+ * @param id is the ID of the record.
+ */
+static void addNamePosting(Container& container, const std::string& name, int id) {
+    if (!container.secondaryDB.update(name, [id](IdPostings& postings) { postings.insert(id); })) {
+        IdPostings postings;
+        postings.insert(id);
+        container.secondaryDB.insert(name, postings);
+    }
+}
+
+/*!
+ * @brief This function adds a Database record to both indexes, without logging it.
+ * @param container is the crucial data structure.
+ * @param db_record is the record.
+ */
+static void insertIntoIndexes(Container& container, const DBRecord& db_record) {
+    int id = db_record.GetRecord().GetId();
+#if PERSISTENT_DB
+    container.primaryDB.insert(id, db_record);
+#else
+    container.primaryDB.upsert(id, db_record);
+#endif
+    addNamePosting(container, db_record.GetRecord().GetName(), id);
+    container.statusIndex.set(id, db_record.GetMedicalStatus());
+}
+
+/*!
+ * @brief This function applies a status update to the primary index, without logging it. Whether the record exists
+ * is read from the status index, which holds every record. If the update renames the record, its ID is moved to
+ * the posting list of the new name.
+ * @param container is the crucial data structure.
+ * @param change is the update.
+ * @return true if the record exists, false otherwise.
+ */
+static bool updateInIndexes(Container& container, const DBRecordUpdate& change) {
+    int id = change.GetRecord().GetId();
+    const std::string& name = change.GetRecord().GetName();
+    if (container.statusIndex.status(id) < 0) { return false; }
+#if PERSISTENT_DB
+    // The primary index buffers the change as a patch without reading the record; the record is only read when
+    // the posting list of the new name does not hold its ID, i.e. when it is renamed.
+    bool listed{false};
+    container.secondaryDB.visit(name, [&](const IdPostings& postings) { listed = postings.contains(id); });
+    if (auto db_record = listed ? std::nullopt : container.primaryDB.find(id)) {
+        removeNamePosting(container, db_record->GetRecord().GetName(), id);
+        addNamePosting(container, name, id);
+    }
+    container.primaryDB.patch(id, change);
+#else
+    // The record is stored once, in the primary index; the secondary index only holds its ID.
+    std::optional<std::string> old_name;
+    container.primaryDB.update(id, [&](DBRecord& db_record) {
+        if (db_record.GetRecord().GetName() != name) { old_name = db_record.GetRecord().GetName(); }
+        change.apply(db_record);
+    });
+    if (old_name) {
+        removeNamePosting(container, *old_name, id);
+        addNamePosting(container, name, id);
+    }
+#endif
+    container.statusIndex.set(id, change.GetMedicalStatus());
+    return true;
+}
+
+/*!
+ * @brief This function removes a Database record from both indexes, without logging it.
+ * @param container is the crucial data structure.
+ * @param id is the ID of the record.
+ * @param name receives the username of the record.
+ * @return true if the record existed, false otherwise.
+ */
+static bool removeFromIndexes(Container& container, int id, std::string& name) {
+    auto db_record = container.primaryDB.find(id);
+    if (!db_record) { return false; }
+    name = db_record->GetRecord().GetName();
+    container.primaryDB.remove(id);
+    removeNamePosting(container, name, id);
+    container.statusIndex.erase(id);
+    return true;
+}
+
+/*!
+ * @brief This function applies a sorted batch to both indexes, without logging it. Runs of status updates go to
+ * the primary index in one merged pass (`update_sorted`; the paged index buffers them as patches in ID order), and
+ * the posting lists touched by new or removed records are changed once per name, in name order.
+ * @param container is the crucial data structure.
+ * @param batch is the batch, sorted by ID.
+ */
+static void applyBatchToIndexes(Container& container, const DBBatch& batch) {
+    using Kind = DBBatch::Kind;
+    const auto& changes = batch.changes();
+    std::vector<std::tuple<std::string, int, bool>> postings;  // Name, ID and whether the ID is added.
+#if PERSISTENT_DB
+    std::unordered_map<int, std::string> added;  // Names of the records added by this batch, not yet in the index.
+#endif
+    for (size_t i = 0; i < changes.size();) {
+        const auto& change = changes[i];
+        if (Kind::kUpdate == change.kind_) {
+            size_t j = i;
+            while (j < changes.size() && Kind::kUpdate == changes[j].kind_) { ++j; }
+#if PERSISTENT_DB
+            for (; i < j; ++i) {
+                const auto& update = std::get<DBRecordUpdate>(changes[i].value_);
+                auto iter = added.find(changes[i].id_);
+                if (added.end() == iter) {
+                    updateInIndexes(container, update);
+                    continue;
+                }
+                if (iter->second != update.GetRecord().GetName()) {  // Renamed since it was added.
+                    postings.emplace_back(iter->second, changes[i].id_, false);
+                    postings.emplace_back(update.GetRecord().GetName(), changes[i].id_, true);
+                    iter->second = update.GetRecord().GetName();
+                }
+                container.primaryDB.patch(changes[i].id_, update);
+                container.statusIndex.set(changes[i].id_, update.GetMedicalStatus());
+            }
+#else
+            std::vector<int> ids;
+            for (size_t k = i; k < j; ++k) { ids.push_back(changes[k].id_); }
+            container.primaryDB.update_sorted(ids, [&](size_t k, DBRecord& db_record) {
+                const auto& update = std::get<DBRecordUpdate>(changes[i + k].value_);
+                if (db_record.GetRecord().GetName() != update.GetRecord().GetName()) {  // Renamed.
+                    postings.emplace_back(db_record.GetRecord().GetName(), changes[i + k].id_, false);
+                    postings.emplace_back(update.GetRecord().GetName(), changes[i + k].id_, true);
+                }
+                update.apply(db_record);
+                container.statusIndex.set(changes[i + k].id_, update.GetMedicalStatus());
+            });
+            i = j;
+#endif
+            continue;
+        }
+        if (Kind::kInsert == change.kind_) {
+            const auto& db_record = std::get<DBRecord>(change.value_);
+#if PERSISTENT_DB
+            container.primaryDB.insert(change.id_, db_record);
+            added[change.id_] = db_record.GetRecord().GetName();
+#else
+            container.primaryDB.upsert(change.id_, db_record);
+#endif
+            container.statusIndex.set(change.id_, db_record.GetMedicalStatus());
+            postings.emplace_back(db_record.GetRecord().GetName(), change.id_, true);
+        } else if (auto db_record = container.primaryDB.find(change.id_)) {
+            postings.emplace_back(db_record->GetRecord().GetName(), change.id_, false);
+            container.primaryDB.remove(change.id_);
+            container.statusIndex.erase(change.id_);
+#if PERSISTENT_DB
+            added.erase(change.id_);
+#endif
+        }
+        ++i;
+    }
+    std::stable_sort(postings.begin(), postings.end(),
+                     [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
+    for (size_t i = 0; i < postings.size();) {
+        const std::string& name = std::get<0>(postings[i]);
+        size_t j = i;
+        while (j < postings.size() && std::get<0>(postings[j]) == name) { ++j; }
+        auto apply = [&postings, i, j](IdPostings& ids) {
+            for (size_t k = i; k < j; ++k) {
+                if (std::get<2>(postings[k])) {
+                    ids.insert(std::get<1>(postings[k]));
+                } else {
+                    ids.erase(std::get<1>(postings[k]));
+                }
+            }
+        };
+        bool empty{false};
+        if (!container.secondaryDB.update(name, [&](IdPostings& ids) {
+            apply(ids);
+            empty = ids.empty();
+        })) {
+            IdPostings ids;
+            apply(ids);
+            if (!ids.empty()) { container.secondaryDB.insert(name, ids); }
+        } else if (empty) {
+            container.secondaryDB.remove(name);
+        }
+        i = j;
+    }
+}
+
 void addDBRecord(Container& container, RegistrationRecord& record, int regID) {
-    int id = record.GetId();
-    std::string name = record.GetName();
     DBRecord db_record{record, regID};
-    container.primaryDB.insert(id, db_record);
-    container.secondaryDB.insert(name, db_record);
+    if (container.batch) {
+        container.batch->insert(db_record);
+        return;
+    }
+    insertIntoIndexes(container, db_record);
+    std::string payload;
+    Codec<DBRecord>::encode(db_record, payload);
+    container.wal.append(static_cast<uint8_t>(DBLogType::kInsert), payload);
+}
+
+/*!
+ * @brief This function removes the ID of a Database record from the posting list of its name, and the name from
+ * the secondary index once no record has it.
+ * @param container is the crucial data structure.
+ * @param name is the username of the record.
+ * @param id is the ID of the record.
+ */
+void removeNamePosting(Container& container, const std::string& name, int id) {
+    bool empty{false};
+    container.secondaryDB.update(name, [&](IdPostings& postings) {
+        postings.erase(id);
+        empty = postings.empty();
+    });
+    if (empty) { container.secondaryDB.remove(name); }
+}
+
+/*!
+ * @brief This function writes the attributes of a record that changed outside a tick, such as its profession
+ * category or risk status, to the Database, keeping its medical status.
+ * @param container is the crucial data structure.
+ * @param record is the record, as now kept in RQRS.
+ */
+void updateDBRecord(Container& container, RegistrationRecord& record) {
+    int medical_status = container.statusIndex.status(record.GetId());
+    if (medical_status < 0) { return; }  // Not in the Database, e.g. removed by ID.
+    updateDBRecord(container, record, medical_status);
 }
 
 void updateDBRecord(Container& container, RegistrationRecord& record, int medical_status) {
-    int id = record.GetId();
-    if (!container.primaryDB.contains(id)) { return; }
-    const std::string& name = record.GetName();
-    auto temp = *container.primaryDB.search(id);
-    temp.SetMedicalStatus(medical_status);
-    temp.SetRecord(record);
-    container.primaryDB.remove(id);
-    container.primaryDB.insert(id, temp);
-    container.secondaryDB.remove(name);
-    container.secondaryDB.insert(name, temp);
+    updateDBRecord(container, DBRecordUpdate{record, medical_status});
 }
 
 void updateDBRecord(Container& container, RegistrationRecord& record, int medical_status, int treatment) {
-    int id = record.GetId();
-    const std::string& name = record.GetName();
-    if (!container.primaryDB.contains(id)) { return; }
-    auto temp = *container.primaryDB.search(id);
-    temp.SetMedicalStatus(medical_status);
-    temp.SetRecord(record);
-    temp.SetTreatment(treatment);
-    container.primaryDB.remove(id);
-    container.primaryDB.insert(id, temp);
-    container.secondaryDB.remove(name);
-    container.secondaryDB.insert(name, temp);
+    updateDBRecord(container, DBRecordUpdate{record, medical_status, treatment});
+}
+
+void updateDBRecord(Container& container, const DBRecordUpdate& change) {
+    if (container.batch) {
+        container.batch->update(change);
+        return;
+    }
+    if (!updateInIndexes(container, change)) { return; }
+    std::string payload;
+    Codec<DBRecordUpdate>::encode(change, payload);
+    container.wal.append(static_cast<uint8_t>(DBLogType::kUpdate), payload);
 }
 
 void removeDBRecord(Container& container, int id) {
-    if (!container.primaryDB.contains(id)) {
+    if (container.batch) {  // The outcome is reported right away, so the changes before it are applied first.
+        applyDBBatch(container);
+        container.batch.emplace();
+    }
+    std::string name;
+    if (!removeFromIndexes(container, id, name)) {
         std::cout << BOLDRED << "Database record (ID: " << id << ") does not exist!" << std::endl;
         std::cout << std::endl;
         return;
     }
-    std::string name = container.primaryDB.search(id)->GetRecord().GetName();
-    container.primaryDB.remove(id);
-    container.secondaryDB.remove(name);
+    std::string payload;
+    codecPut(payload, id);
+    container.wal.append(static_cast<uint8_t>(DBLogType::kRemove), payload);
     std::cout << BOLDGREEN << "Database record (ID: " << id << ", Name: " << name << ") has been successfully removed!"
               << std::endl;
     std::cout << std::endl;
 }
 
 void removeDBRecord(Container& container, const std::string& name) {
-    if (!container.secondaryDB.contains(name)) {
+    std::vector<int> ids;
+    container.secondaryDB.visit(name, [&](const IdPostings& postings) { ids = postings.ids(); });
+    if (ids.empty()) {
         std::cout << BOLDRED << "Database record (Name: " << name << ") does not exist!" << std::endl;
         std::cout << std::endl;
         return;
     }
-    int id = container.secondaryDB.search(name)->GetRecord().GetId();
-    container.primaryDB.remove(id);
-    container.secondaryDB.remove(name);
-    std::cout << BOLDGREEN << "Database record (ID: " << id << ", Name: " << name << ") has been successfully removed!"
-              << std::endl;
-    std::cout << std::endl;
+    if (ids.size() > 1) {  // Removing by name would be ambiguous.
+        std::cout << BOLDRED << ids.size() << " Database records are named " << name << " (IDs:";
+        for (int id : ids) { std::cout << " " << id; }
+        std::cout << "). Please remove one of them by ID." << RESET << std::endl;
+        std::cout << std::endl;
+        return;
+    }
+    removeDBRecord(container, ids.front());
 }
 
 void printDBRecord(Container& container, int id) {
@@ -450,59 +740,370 @@ void printDBRecord(Container& container, int id) {
         {3, "Surgery"}
     };
 
-    if (!container.primaryDB.contains(id)) {
+    auto db_record = container.primaryDB.find(id);  // No copy of the record is made.
+    if (!db_record) {
         std::cout << BOLDRED << "Database record (ID " << id << ") does not exist!" << std::endl;
         return;
     }
-    auto db_record = *container.primaryDB.search(id);
-    auto record = db_record.GetRecord();
+    const auto& record = db_record->GetRecord();
     std::cout << std::endl;
     std::cout << BOLDYELLOW << "***  START of Database Query  ***" << RESET << std::endl;
     std::cout << BOLDCYAN << "PERSON: " << RESET;
     std::cout << BOLDMAGENTA << record << RESET << std::endl;
-    std::cout << BOLDCYAN << "MEDICAL STATUS: " << med_map[db_record.GetMedicalStatus()] << RESET << std::endl;
-    std::cout << BOLDCYAN << "REGISTRATION AT: " << reg_map[db_record.GetRegistration()] << RESET << std::endl;
-    std::cout << BOLDCYAN << "TREATMENT: " << treat_map[db_record.GetTreatment()] << RESET << std::endl;
+    std::cout << BOLDCYAN << "MEDICAL STATUS: " << med_map[db_record->GetMedicalStatus()] << RESET << std::endl;
+    std::cout << BOLDCYAN << "REGISTRATION AT: " << reg_map[db_record->GetRegistration()] << RESET << std::endl;
+    std::cout << BOLDCYAN << "TREATMENT: " << treat_map[db_record->GetTreatment()] << RESET << std::endl;
     std::cout << BOLDYELLOW << "***   END of Database Query   ***" << RESET << std::endl;
     std::cout << std::endl;
 }
 
 void printDBRecord(Container& container, const std::string& name) {
-    std::unordered_map<int, std::string> med_map{
-        {0, "Registered"},
-        {1, "Queueing"},
-        {2, "Appointment Assigned"},
-        {3, "Withdrawn"},
-        {4, "Treated"}
-    };
+    std::vector<int> ids;
+    container.secondaryDB.visit(name, [&](const IdPostings& postings) { ids = postings.ids(); });
+    if (ids.empty()) {
+        std::cout << BOLDRED << "Database record (Name:  " << name << ") does not exist!" << RESET << std::endl;
+        return;
+    }
+    for (int id : ids) { printDBRecord(container, id); }  // Every record with that name.
+}
 
-    std::unordered_map<int, std::string> reg_map{
-        {0, "Carle Foundation Hospital"},
-        {1, "OSF Heart of Mary Medical Center"},
-        {2, "Springfield Memorial Hospital"},
-        {3, "McKinley Health Center"},
-        {4, "Hangzhou No.7 People's Hospital"}
+/*!
+ * @brief This function exports all Database records with IDs in `[lo, hi]` with one ordered scan of the primary
+ * index, instead of looking up every ID.
+ * @param container is the crucial data structure.
+ * @param lo is the smallest ID to export.
+ * @param hi is the largest ID to export.
+ * @param descending is true to export in descending ID order.
+ * @sideeffects It prints the records to the console and appends them to `data/export.txt`.
+ */
+void exportDBRecords(Container& container, int lo, int hi, bool descending) {
+    const char* med_status[]{"Registered", "Queueing", "Appointment Assigned", "Withdrawn", "Treated"};
+    std::ofstream file{"data/export.txt", std::ios_base::app};
+    int count{};
+    auto output = [&](const DBRecord& db_record) {
+        std::cout << BOLDMAGENTA << db_record.GetRecord() << RESET << CYAN << "\tMedical Status: "
+                  << med_status[db_record.GetMedicalStatus()] << RESET << std::endl;
+        file << db_record.GetRecord() << "\tMedical Status: " << med_status[db_record.GetMedicalStatus()]
+             << std::endl;
+        ++count;
     };
+    std::cout << std::endl;
+    std::cout << BOLDBLUE << std::string(50, '-') << "  *** Database Records (ID " << lo << " to " << hi
+              << ") ***  " << std::string(50, '-') << RESET << std::endl;
+    file << "\n" << std::string(50, '-') << "  *** Database Records (ID " << lo << " to " << hi << ") ***  "
+         << std::string(50, '-') << std::endl;
+#if PERSISTENT_DB
+    auto range = container.primaryDB.closed_range(lo, hi);
+    if (descending) {
+        for (auto iter = range.rbegin(); iter != range.rend(); ++iter) { output((*iter).second); }
+    } else {
+        for (auto iter = range.begin(); iter != range.end(); ++iter) { output(iter.value()); }
+    }
+#else
+    auto view = container.primaryDB.snapshot();  // Later ticks do not change what is being exported.
+    view->scan(lo, hi, descending, [&](const int&, const DBRecord& db_record) {
+        output(db_record);
+        return true;
+    });
+#endif
+    std::cout << BOLDGREEN << count << " record(s) exported to data/export.txt." << RESET << std::endl;
+    std::cout << std::endl;
+}
 
-    std::unordered_map<int, std::string> treat_map{
-        {-1, "Untreated"},
-        {1, "Targeted Therapies"},
-        {2, "Chemotherapy"},
-        {3, "Surgery"}
-    };
-    if (!container.secondaryDB.contains(name)) {
-        std::cout << BOLDRED << "Database record (Name:  " << name << ") does not exist!" << RESET << std::endl;
-        return;
+/*!
+ * @brief This function lists the Database records whose usernames start with `prefix`, in username order, by
+ * scanning the secondary index from the first match instead of every record. Records sharing a username are
+ * listed by ID.
+ * @param container is the crucial data structure.
+ * @param prefix is the beginning of the usernames.
+ * @param limit is the maximum number of records to list.
+ * @sideeffects It prints the records to the console.
+ */
+void searchDBRecords(Container& container, const std::string& prefix, size_t limit) {
+    const char* med_status[]{"Registered", "Queueing", "Appointment Assigned", "Withdrawn", "Treated"};
+    std::cout << std::endl;
+    size_t count{};
+    container.secondaryDB.prefix_scan(prefix, limit, [&](const std::string&, const IdPostings& postings) {
+        postings.forEach([&](int id) {
+            auto db_record = container.primaryDB.find(id);
+            if (!db_record || count == limit) { return; }
+            std::cout << BOLDMAGENTA << db_record->GetRecord() << RESET << CYAN << "\tMedical Status: "
+                      << med_status[db_record->GetMedicalStatus()] << RESET << std::endl;
+            ++count;
+        });
+    });
+    if (0 == count) {
+        std::cout << BOLDRED << "No Database record has a username starting with \"" << prefix << "\"!" << RESET
+                  << std::endl;
+    } else {
+        std::cout << BOLDGREEN << count << " record(s) listed." << RESET << std::endl;
     }
-    auto db_record = *container.secondaryDB.search(name);
-    auto record = db_record.GetRecord();
     std::cout << std::endl;
-    std::cout << BOLDYELLOW << "***  START of Database Query  ***" << RESET << std::endl;
-    std::cout << BOLDCYAN << "PERSON: " << RESET << std::endl;
-    std::cout << BOLDMAGENTA << record << RESET << std::endl;
-    std::cout << BOLDCYAN << "MEDICAL STATUS: " << med_map[db_record.GetMedicalStatus()] << RESET << std::endl;
-    std::cout << BOLDCYAN << "REGISTRATION AT: " << reg_map[db_record.GetRegistration()] << RESET << std::endl;
-    std::cout << BOLDCYAN << "TREATMENT: " << treat_map[db_record.GetTreatment()] << RESET << std::endl;
-    std::cout << BOLDYELLOW << "***   END of Database Query   ***" << RESET << std::endl;
+}
+
+/*!
+ * @brief This function prints the number of Database records in each medical status, read from the status index
+ * in O(1) time each, then lists the records of one status in ID order without visiting the others.
+ * @param container is the crucial data structure.
+ * @param status is the medical status to list.
+ * @param limit is the maximum number of records to list.
+ * @sideeffects It prints the counts and the records to the console.
+ */
+void listDBRecordsByStatus(Container& container, int status, size_t limit) {
+    const char* med_status[]{"Registered", "Queueing", "Appointment Assigned", "Withdrawn", "Treated"};
+    std::cout << std::endl;
+    for (int i = 0; i < StatusIndex::kStatuses; ++i) {
+        std::cout << BOLDBLUE << std::setw(30) << std::left << med_status[i] << CYAN << container.statusIndex.count(i)
+                  << RESET << std::endl;
+    }
+    size_t count{};
+    for (int id : container.statusIndex.ids(status, limit)) {
+        auto db_record = container.primaryDB.find(id);
+        if (!db_record) { continue; }
+        std::cout << BOLDMAGENTA << db_record->GetRecord() << RESET << CYAN << "\tMedical Status: "
+                  << med_status[status] << RESET << std::endl;
+        ++count;
+    }
+    std::cout << BOLDGREEN << count << " of " << container.statusIndex.count(status) << " " << med_status[status]
+              << " record(s) listed." << RESET << std::endl;
+    std::cout << std::endl;
+}
+
+/*!
+ * @brief This function lists the Database records that satisfy a query, in ID order. The planner estimates the
+ * candidates of each access path from the record count, the status counts and the name postings, and the cheapest
+ * path streams its candidates through the whole predicate until `limit` records match. A query starting with
+ * `EXPLAIN` prints the plans instead.
+ * @param container is the crucial data structure.
+ * @param text is the query, e.g. `profession<=2 AND risk=1 AND status=queueing AND registry=3`.
+ * @param limit is the maximum number of records to list.
+ * @sideeffects It prints the plans or the records to the console.
+ */
+void queryDBRecords(Container& container, const std::string& text, size_t limit) {
+    const char* med_status[]{"Registered", "Queueing", "Appointment Assigned", "Withdrawn", "Treated"};
     std::cout << std::endl;
+    std::string error;
+    auto query = DBQuery::parse(text, error);
+    if (!query) {
+        std::cout << BOLDRED << error << "!" << RESET << std::endl << std::endl;
+        return;
+    }
+    DBQuery::Statistics statistics;
+    statistics.records = container.statusIndex.size();
+    if (0 != statistics.records) {
+#if PERSISTENT_DB
+        auto all = container.primaryDB.closed_range(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+        if (!all.empty()) {
+            statistics.min_id = all.begin().value().GetRecord().GetId();
+            statistics.max_id = (*all.rbegin()).second.GetRecord().GetId();
+        }
+#else
+        for (bool descending : {false, true}) {
+            container.primaryDB.scan(std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), descending,
+                                     [&](const int& id, const DBRecord&) {
+                                         (descending ? statistics.max_id : statistics.min_id) = id;
+                                         return false;
+                                     });
+        }
+#endif
+    }
+    for (int i = 0; i < DBQuery::kStatuses; ++i) { statistics.status_counts[i] = container.statusIndex.count(i); }
+    auto postings = container.secondaryDB.find(query->name() ? *query->name() : std::string{});
+    statistics.name_matches = query->name() && postings ? postings->size() : 0;
+    auto plans = query->plans(statistics);
+    const auto& plan = plans.front();
+    if (query->explain()) {
+        std::cout << BOLDBLUE << "Query: " << RESET << CYAN << query->toString() << RESET << std::endl;
+        std::cout << BOLDBLUE << "Plan:  " << RESET << CYAN << plan.describe() << RESET << std::endl;
+        for (size_t i = 1; i < plans.size(); ++i) {
+            std::cout << BLUE << "  rejected: " << plans[i].describe() << RESET << std::endl;
+        }
+        if (DBQueryPlan::Access::kNone != plan.access) {
+            std::cout << BLUE << "  every candidate is checked against the whole query; at most " << limit
+                      << " record(s) are listed" << RESET << std::endl;
+        }
+        std::cout << std::endl;
+        return;
+    }
+    size_t count{}, examined{};
+    auto consider = [&](const DBRecord& db_record) {
+        ++examined;
+        if (!query->matches(db_record)) { return true; }
+        std::cout << BOLDMAGENTA << db_record.GetRecord() << RESET << CYAN << "\tMedical Status: "
+                  << med_status[db_record.GetMedicalStatus()] << RESET << std::endl;
+        return ++count < limit;
+    };
+    auto fetch = [&](int id) {
+        auto db_record = container.primaryDB.find(id);
+        return !db_record || consider(*db_record);
+    };
+    using Access = DBQueryPlan::Access;
+    if (Access::kIdRange == plan.access || Access::kFullScan == plan.access) {
+        int lo = Access::kIdRange == plan.access ? plan.lo : std::numeric_limits<int>::min();
+        int hi = Access::kIdRange == plan.access ? plan.hi : std::numeric_limits<int>::max();
+#if PERSISTENT_DB
+        auto range = container.primaryDB.closed_range(lo, hi);
+        for (auto iter = range.begin(); iter != range.end() && consider(iter.value()); ++iter) {}
+#else
+        container.primaryDB.scan(lo, hi, false, [&](const int&, const DBRecord& db_record) {
+            return consider(db_record);
+        });
+#endif
+    } else if (Access::kNameLookup == plan.access) {
+        postings->forEach([&](int id) {
+            if (count < limit) { fetch(id); }
+        });
+    } else if (Access::kStatusBitmap == plan.access) {
+        container.statusIndex.scan(plan.statuses, fetch);
+    }
+    if (0 == count) {
+        std::cout << BOLDRED << "No Database record satisfies the query!" << RESET << std::endl;
+    } else {
+        std::cout << BOLDGREEN << count << " record(s) listed." << RESET << std::endl;
+    }
+    std::cout << BLUE << examined << " record(s) examined by " << plan.describe() << RESET << std::endl;
+    std::cout << std::endl;
+}
+
+/*!
+ * @brief This function closes the open batch and applies its changes to the Database in one merged pass per index.
+ * Nothing reads the indexes while the batch is applied, and snapshots taken before keep the previous version, so
+ * readers see either none or all of the batch; it is logged as a single record, so recovery replays it whole too.
+ * @param container is the crucial data structure.
+ */
+void applyDBBatch(Container& container) {
+    if (!container.batch) { return; }
+    DBBatch batch = std::move(*container.batch);
+    container.batch.reset();
+    if (batch.empty()) { return; }
+    batch.sort();
+    applyBatchToIndexes(container, batch);
+    std::string payload;
+    Codec<DBBatch>::encode(batch, payload);
+    container.wal.append(static_cast<uint8_t>(DBLogType::kBatch), payload);
+}
+
+/*!
+ * @brief This function restores the Database after a restart: it loads the last checkpoint (the paged indexes
+ * reopen their own, which the shadow-paged buffer pool keeps intact through a crash) and replays the changes logged
+ * since, then opens the log for new changes. The status index is rebuilt along the way. Replaying is idempotent
+ * (records are upserted, updates set absolute values, removals of missing records are skipped), so a crash between
+ * the checkpoints of the two paged indexes, which leaves one of them ahead of the log, is harmless. Restart time
+ * therefore depends on the size of the log, which checkpoints keep bounded, rather than on the whole history.
+ * @param container is the crucial data structure.
+ * @throw IOError if the checkpoint or the log cannot be read.
+ */
+void recoverDB(Container& container) {
+    size_t restored{};
+#if !PERSISTENT_DB
+    std::string bytes;
+    if (readFile(kCheckpointPath, bytes)) {
+        constexpr size_t kMagicSize{sizeof(kCheckpointMagic) - 1};
+        if (bytes.size() < kMagicSize + sizeof(uint64_t) || 0 != bytes.compare(0, kMagicSize, kCheckpointMagic)) {
+            throw IOError();
+        }
+        const char* in = bytes.data() + kMagicSize;
+        const char* end = bytes.data() + bytes.size();
+        auto count = codecGet<uint64_t>(in);
+        std::vector<std::pair<int, DBRecord>> entries;
+        entries.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) {  // In ID order, as written by checkpointDB().
+            if (static_cast<size_t>(end - in) < sizeof(uint32_t)) { throw IOError(); }
+            auto n = codecGet<uint32_t>(in);
+            if (static_cast<size_t>(end - in) < n) { throw IOError(); }
+            auto db_record = Codec<DBRecord>::decode(in, n);
+            in += n;
+            addNamePosting(container, db_record.GetRecord().GetName(), db_record.GetRecord().GetId());
+            container.statusIndex.set(db_record.GetRecord().GetId(), db_record.GetMedicalStatus());
+            entries.emplace_back(db_record.GetRecord().GetId(), std::move(db_record));
+        }
+        restored = entries.size();
+        container.primaryDB.bulk_load(std::move(entries));
+    }
+#else
+    for (auto iter = container.primaryDB.begin(); iter != container.primaryDB.end(); ++iter) {
+        container.statusIndex.set(iter.value().GetRecord().GetId(), iter.value().GetMedicalStatus());
+    }  // The paged indexes are reopened as they were; the status index is rebuilt from the records.
+#endif
+    size_t replayed = container.wal.open(kDBLogPath, [&container](uint8_t type, const std::string& payload) {
+        switch (static_cast<DBLogType>(type)) {
+            case DBLogType::kInsert:
+                insertIntoIndexes(container, Codec<DBRecord>::decode(payload.data(), payload.size()));
+                break;
+            case DBLogType::kUpdate:
+                updateInIndexes(container, Codec<DBRecordUpdate>::decode(payload.data(), payload.size()));
+                break;
+            case DBLogType::kRemove: {
+                const char* in = payload.data();
+                std::string name;
+                removeFromIndexes(container, codecGet<int>(in), name);
+                break;
+            }
+            case DBLogType::kBatch:
+                applyBatchToIndexes(container, Codec<DBBatch>::decode(payload.data(), payload.size()));
+                break;
+        }
+    });
+    if (0 != restored || 0 != replayed) {
+        std::cout << BOLDGREEN << "Database recovered: ";
+#if !PERSISTENT_DB
+        std::cout << restored << " record(s) from the checkpoint, ";
+#endif
+        std::cout << replayed << " logged change(s) replayed." << RESET << std::endl;
+    }
+}
+
+/*!
+ * @brief This function makes the Database changes since the last call durable, with one write and one fsync for
+ * the whole batch (group commit). It is called once per tick and once per command, and checkpoints the Database
+ * once the log grows past `kCheckpointLogBytes`.
+ * @param container is the crucial data structure.
+ * @sideeffects It prints an error if the log cannot be written; the changes then stay in memory only.
+ */
+void commitDB(Container& container) {
+    try {
+        container.wal.commit();
+    } catch (const IOError& error) {
+        std::cerr << error.what() << std::endl;
+        return;
+    }
+    if (container.wal.bytes() >= kCheckpointLogBytes) { checkpointDB(container); }
+}
+
+/*!
+ * @brief This function writes a checkpoint of the Database and empties the log. In memory, the primary index is
+ * written to `data/primary.ckpt` in ID order (the secondary index is rebuilt from it); the paged indexes write
+ * back their dirty pages instead. The log is emptied only once the checkpoint, directory entry included, is on
+ * stable storage. Nothing happens if the log was never opened, so that a failed recovery does not overwrite the
+ * last checkpoint.
+ * @param container is the crucial data structure.
+ * @sideeffects It prints an error if the checkpoint cannot be written; the log is then kept.
+ */
+void checkpointDB(Container& container) {
+    if (!container.wal.isOpen()) { return; }
+    try {
+#if PERSISTENT_DB
+        container.primaryDB.checkpoint();
+        container.secondaryDB.checkpoint();
+#else
+        std::string bytes{kCheckpointMagic, sizeof(kCheckpointMagic) - 1};
+        codecPut(bytes, static_cast<uint64_t>(container.primaryDB.size()));
+        auto append = [&bytes](const DBRecord& db_record) {
+            size_t start = bytes.size();
+            codecPut(bytes, uint32_t{});  // Length, filled in below.
+            Codec<DBRecord>::encode(db_record, bytes);
+            auto n = static_cast<uint32_t>(bytes.size() - start - sizeof(uint32_t));
+            std::memcpy(bytes.data() + start, &n, sizeof(n));
+        };
+        container.primaryDB.scan(std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), false,
+                                 [&append](const int&, const DBRecord& db_record) {
+                                     append(db_record);
+                                     return true;
+                                 });
+        writeFileDurably(kCheckpointPath, bytes);
+#endif
+        container.wal.reset();
+    } catch (const IOError& error) {
+        std::cerr << error.what() << std::endl;
+    }
 }
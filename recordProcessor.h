@@ -12,7 +12,19 @@
 #include "BTree.cpp"
 #include "BPlusTree.h"
 #include "BPlusTree.cpp"
+#include "PagedBeTree.h"
+#include "PagedBeTree.cpp"
+#include "PagedBTree.h"
+#include "PagedBTree.cpp"
+#include "adaptiveRadixTree.h"
+#include "adaptiveRadixTree.cpp"
+#include "storageEngine.h"
+#include "storageEngine.cpp"
 #include "databaseSchema.h"
+#include "writeAheadLog.h"
+#include "statusIndex.h"
+#include "dbQuery.h"
+#include "columnStore.h"
 #include "utilities.h"
 #include "config.h"
 
@@ -31,8 +43,18 @@ public:
         deadlineTracker{};  // Pairs of pointers-to-record and deadlines.
     std::vector<std::vector<int>> preferences;  // Appointment location preferences for each local queue.
     std::vector<std::vector<bool>> availabilities;  // Availability of each time slot.
-    BPlusTree<int, DBRecord> primaryDB;
-    BTree<std::string, DBRecord> secondaryDB;
+#if PERSISTENT_DB
+    PagedBeTree<int, DBRecord, DBRecordUpdate> primaryDB{"data/primary_be.db"};  // Reopened, not rebuilt, on restart.
+    PagedBTree<std::string, IdPostings> secondaryDB{"data/secondary_ids.db"};  // At most 256 pages in memory.
+#else
+    std::unique_ptr<StorageEngine<int, DBRecord>> primaryEngine;  // Chosen at startup (see makeStorageEngine).
+    StorageEngine<int, DBRecord>& primaryDB{*primaryEngine};
+    BTree<std::string, IdPostings> secondaryDB;  // Name to the IDs of the records, resolved through primaryDB.
+#endif
+    ColumnStore columns{};  // Attributes and stage of the records in the lists above, for reports.
+    StatusIndex statusIndex{};  // IDs of the Database records by medical status, maintained with the indexes.
+    WriteAheadLog wal{};  // Database modifications since the last checkpoint; opened by recoverDB().
+    std::optional<DBBatch> batch{};  // While open, Database changes are collected and applied by applyDBBatch().
 
     // Constructor and destructor.
     Container() = delete;  // No-args constructor explicitly deleted.
@@ -40,10 +62,11 @@ public:
     Container& operator=(const Container& container) = delete;
     Container(Container&& container) = delete;
     Container& operator=(Container&& container) = delete;
-    explicit Container(int num_reg, int num_loc);
+    explicit Container(int num_reg, int num_loc, std::string_view engine = "bplustree");
     virtual ~Container() = default;
 };
 
+void trackRecord(Container& container, const RegistrationRecord& record, ColumnStore::Stage stage);
 void waitingListProcessor(Container& container);
 void newRegistration(Container& container);
 void addDeadline(int id, time_t deadline, Container& container);
@@ -52,11 +75,22 @@ void recoverRecord(int id, Container& container);
 void appointmentProcessor(Container& container);
 void treatmentProcessor(Container& container);
 void addDBRecord(Container& container, RegistrationRecord& record, int regID);
+void updateDBRecord(Container& container, RegistrationRecord& record);
 void updateDBRecord(Container& container, RegistrationRecord& record, int medical_status);
 void updateDBRecord(Container& container, RegistrationRecord& record, int medical_status, int treatment);
+void updateDBRecord(Container& container, const DBRecordUpdate& change);
+void removeNamePosting(Container& container, const std::string& name, int id);
 void removeDBRecord(Container& container, int id);
 void removeDBRecord(Container& container, const std::string& name);
 void printDBRecord(Container& container, int id);
 void printDBRecord(Container& container, const std::string& name);
+void exportDBRecords(Container& container, int lo, int hi, bool descending);
+void searchDBRecords(Container& container, const std::string& prefix, size_t limit);
+void listDBRecordsByStatus(Container& container, int status, size_t limit);
+void queryDBRecords(Container& container, const std::string& text, size_t limit);
+void applyDBBatch(Container& container);
+void recoverDB(Container& container);
+void commitDB(Container& container);
+void checkpointDB(Container& container);
 
 #endif //CS225_SP22_C1_RECORDPROCESSOR_H_
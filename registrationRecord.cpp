@@ -220,6 +220,22 @@ int RegistrationRecord::GetTreatSlotId() const {
     return treat_slot_id_;
 }
 
+/*!
+ * @brief This method gets the `treated_` field of the record.
+ * @return true if the record has been treated, false otherwise.
+ */
+bool RegistrationRecord::GetTreated() const {
+    return treated_;
+}
+
+/*!
+ * @brief This method gets the `final_time_` field of the record.
+ * @return the time when the record got treated.
+ */
+time_t RegistrationRecord::GetFinalWaitingTime() const {
+    return final_time_;
+}
+
 /*!
  * @brief This overloaded equality operator compares two records basing on their `id_` fields
  * and `name_` fields.
@@ -301,3 +317,56 @@ void RegistrationRecord::SetTreatSlotId(int treat_slot_id) {
     treat_slot_id_ = treat_slot_id;
 }
 
+
+/*!
+ * @brief This method appends every field of the record to a buffer.
+ * @param out is the buffer.
+ */
+void RegistrationRecord::serialize(std::string& out) const {
+    codecPut(out, id_);
+    codecPutString(out, name_);
+    codecPutString(out, address_);
+    codecPutString(out, phone_);
+    codecPutString(out, wechat_);
+    codecPutString(out, email_);
+    codecPut(out, profession_id_);
+    codecPut(out, birthday_);
+    codecPut(out, risk_status_);
+    codecPut(out, local_queue_id_);
+    codecPut(out, extension_);
+    codecPut(out, timestamp_);
+    codecPut(out, age_id_);
+    codecPut(out, treated_);
+    codecPut(out, treat_time_);
+    codecPut(out, treat_loc_id_);
+    codecPut(out, treat_slot_id_);
+    codecPut(out, final_time_);
+}
+
+/*!
+ * @brief This function reads a record written by `serialize()` and advances the cursor past it.
+ * @param in is the cursor.
+ * @return the record.
+ */
+RegistrationRecord RegistrationRecord::deserialize(const char*& in) {
+    RegistrationRecord record{};
+    record.id_ = codecGet<int>(in);
+    record.name_ = codecGetString(in);
+    record.address_ = codecGetString(in);
+    record.phone_ = codecGetString(in);
+    record.wechat_ = codecGetString(in);
+    record.email_ = codecGetString(in);
+    record.profession_id_ = codecGet<int>(in);
+    record.birthday_ = codecGet<time_t>(in);
+    record.risk_status_ = codecGet<int>(in);
+    record.local_queue_id_ = codecGet<int>(in);
+    record.extension_ = codecGet<int>(in);
+    record.timestamp_ = codecGet<time_t>(in);
+    record.age_id_ = codecGet<int>(in);
+    record.treated_ = codecGet<bool>(in);
+    record.treat_time_ = codecGet<time_t>(in);
+    record.treat_loc_id_ = codecGet<int>(in);
+    record.treat_slot_id_ = codecGet<int>(in);
+    record.final_time_ = codecGet<time_t>(in);
+    return record;
+}
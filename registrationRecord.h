@@ -13,6 +13,7 @@
 #include "queue.h"
 #include "queue.cpp"
 #include "config.h"
+#include "codec.h"
 
 /*!
  * @brief This class defines objects which holds our records containing patient information.
@@ -69,6 +70,8 @@ public:
     [[nodiscard]] time_t GetTreatTime() const;
     [[nodiscard]] int GetTreatLocId() const;
     [[nodiscard]] int GetTreatSlotId() const;
+    [[nodiscard]] bool GetTreated() const;
+    [[nodiscard]] time_t GetFinalWaitingTime() const;
     void SetProfessionId(int profession_id);
     void SetExtension(int extension);
     void SetRiskStatus(int risk_status);
@@ -80,6 +83,10 @@ public:
     void updateExtension();
     void applyPenalty();
 
+    // Serialization (used by the disk-backed indexes).
+    void serialize(std::string& out) const;
+    static RegistrationRecord deserialize(const char*& in);
+
 private:
     // Private helper functions.
     void setAgeCategory();
@@ -0,0 +1,109 @@
+/*!
+ * @brief This file contains the implementation of <em>StatusIndex</em>.
+ */
+#include "statusIndex.h"
+#include <algorithm>
+
+/*!
+ * @brief This method sets or clears the bit of an ID in the bitmap of a status, allocating and freeing its chunk.
+ * @param id is the ID.
+ * @param status is the medical status; the bit is set if it was clear and cleared otherwise.
+ */
+void StatusIndex::_flip(int id, int status) {
+    int key = id >> kChunkBits;  // Arithmetic shift: negative IDs get chunks of their own, in order.
+    auto offset = static_cast<size_t>(id - key * (1 << kChunkBits));
+    auto& chunk = chunks_[key];
+    uint64_t& word = chunk.bits[status][offset / 64];
+    uint64_t bit = uint64_t{1} << (offset % 64);
+    word ^= bit;
+    if (word & bit) {
+        ++chunk.size;
+    } else if (0 == --chunk.size) {
+        chunks_.erase(key);
+    }
+}
+
+/*!
+ * @brief This method records the status of an ID, moving it out of its previous status if it had one.
+ * @param id is the ID.
+ * @param status is the medical status, from 0 to `kStatuses - 1`.
+ */
+void StatusIndex::set(int id, int status) {
+    auto [iter, inserted] = status_.try_emplace(id, static_cast<int8_t>(status));
+    if (!inserted) {
+        if (iter->second == status) { return; }
+        _flip(id, iter->second);
+        --counts_[iter->second];
+        iter->second = static_cast<int8_t>(status);
+    }
+    _flip(id, status);
+    ++counts_[status];
+}
+
+/*!
+ * @brief This method removes an ID from the index.
+ * @param id is the ID.
+ * @return true if removed, false if not found.
+ */
+bool StatusIndex::erase(int id) {
+    auto iter = status_.find(id);
+    if (status_.end() == iter) { return false; }
+    _flip(id, iter->second);
+    --counts_[iter->second];
+    status_.erase(iter);
+    return true;
+}
+
+/*!
+ * @brief This method removes every ID from the index.
+ */
+void StatusIndex::clear() {
+    chunks_.clear();
+    status_.clear();
+    counts_.fill(0);
+}
+
+/*!
+ * @brief This method returns the status of an ID.
+ * @param id is the ID.
+ * @return the medical status, or -1 if the ID is not indexed.
+ */
+int StatusIndex::status(int id) const {
+    auto iter = status_.find(id);
+    return status_.end() == iter ? kAbsent : iter->second;
+}
+
+/*!
+ * @brief This method returns number of IDs in a status, in O(1) time.
+ * @param status is the medical status.
+ * @return the number of IDs.
+ */
+size_t StatusIndex::count(int status) const {
+    return counts_[status];
+}
+
+/*!
+ * @brief This method returns number of IDs in the index.
+ * @return the number of IDs.
+ */
+size_t StatusIndex::size() const {
+    return status_.size();
+}
+
+/*!
+ * @brief This method lists the IDs in a status, in ascending order. Words without any ID are skipped whole, and
+ * the IDs of a word are found by counting trailing zeros.
+ * @param status is the medical status.
+ * @param limit is the largest number of IDs to list.
+ * @return the IDs.
+ */
+std::vector<int> StatusIndex::ids(int status, size_t limit) const {
+    std::vector<int> ids;
+    if (0 == limit) { return ids; }
+    ids.reserve(std::min(limit, counts_[status]));
+    scan(1U << status, [&](int id) {
+        ids.push_back(id);
+        return ids.size() < limit;
+    });
+    return ids;
+}
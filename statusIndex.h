@@ -0,0 +1,85 @@
+/*!
+ * @brief This file contains the class definition of <em>StatusIndex</em>.
+ */
+#ifndef CS225_SP22_C2_STATUSINDEX_H_
+#define CS225_SP22_C2_STATUSINDEX_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ * @brief This class indexes the Database records by medical status: one bitmap of IDs per status, with a counter
+ * each, so that the number of records in a status is read in O(1) and its IDs are listed in ascending order by
+ * skipping empty 64-bit words. Like a roaring bitmap, the bitmaps are split into chunks of 65536 IDs keyed by
+ * `id >> 16`, and only chunks holding an ID are allocated, so memory follows the number of IDs rather than the
+ * largest one. The status of every ID is kept in a hash map as well, so moving a record to another status does not
+ * need the record itself.
+ */
+class StatusIndex {
+public:
+    static constexpr int kStatuses{5};  // Registered, queueing, appointment assigned, withdrawn and treated.
+
+    void set(int id, int status);
+    bool erase(int id);
+    void clear();
+    [[nodiscard]] int status(int id) const;
+    [[nodiscard]] size_t count(int status) const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] std::vector<int> ids(int status, size_t limit = std::numeric_limits<size_t>::max()) const;
+    template<typename F> size_t scan(unsigned statuses, F&& f) const;
+
+private:
+    static constexpr int kAbsent{-1};
+    static constexpr int kChunkBits{16};
+    static constexpr size_t kChunkWords{(size_t{1} << kChunkBits) / 64};
+
+    /*!
+     * @brief This struct holds the bitmaps of 65536 consecutive IDs: bit `i % 64` of word `i / 64` of a status is
+     * set for the `i`-th ID of the chunk.
+     */
+    struct Chunk {
+        std::array<std::array<uint64_t, kChunkWords>, kStatuses> bits{};
+        size_t size{};  // Number of IDs in the chunk; an empty chunk is freed.
+    };
+
+    void _flip(int id, int status);
+
+    std::map<int, Chunk> chunks_{};  // Chunk of the IDs `key << 16` to `(key << 16) + 65535`, in key order.
+    std::unordered_map<int, int8_t> status_{};  // Status of each ID.
+    std::array<size_t, kStatuses> counts_{};
+};
+
+/*!
+ * @brief This method calls `f` on the IDs in any of several statuses, in ascending order, until `f` returns false.
+ * The bitmaps of the statuses are OR-ed one 64-bit word at a time, so the IDs need no merging.
+ * @tparam F is type of the callable, invoked as `f(int)` and returning bool.
+ * @param statuses is the set of statuses, bit `s` for status `s`.
+ * @param f is the callable.
+ * @return the number of IDs visited.
+ */
+template<typename F>
+size_t StatusIndex::scan(unsigned statuses, F&& f) const {
+    size_t visited{};
+    for (const auto& [key, chunk] : chunks_) {
+        auto base = static_cast<int64_t>(key) * (int64_t{1} << kChunkBits);
+        for (size_t w = 0; w < kChunkWords; ++w) {
+            uint64_t word{};
+            for (int s = 0; s < kStatuses; ++s) {
+                if (statuses >> s & 1U) { word |= chunk.bits[s][w]; }
+            }
+            for (; 0 != word; word &= word - 1) {
+                ++visited;
+                auto id = base + static_cast<int64_t>(w * 64 + static_cast<size_t>(__builtin_ctzll(word)));
+                if (!f(static_cast<int>(id))) { return visited; }
+            }
+        }
+    }
+    return visited;
+}
+
+#endif //CS225_SP22_C2_STATUSINDEX_H_
@@ -0,0 +1,406 @@
+/*!
+ * @brief This file contains the implementations of the storage engines.
+ */
+#include "storageEngine.h"
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+/*!
+ * @brief This method returns the name of the engine.
+ * @return the name.
+ */
+template<typename Tree, typename K, typename V>
+const char* TreeEngine<Tree, K, V>::name() const {
+    return name_;
+}
+
+/*!
+ * @brief This method looks up a key without copying the value.
+ * @param k is the key object.
+ * @return pointer to the value object, or nullptr if not found.
+ */
+template<typename Tree, typename K, typename V>
+const V* TreeEngine<Tree, K, V>::find(const K& k) const {
+    return tree_.find(k);
+}
+
+/*!
+ * @brief This method overwrites the value of the given key, or inserts the pair if the key is absent.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if a new pair was inserted.
+ */
+template<typename Tree, typename K, typename V>
+bool TreeEngine<Tree, K, V>::upsert(K k, V v) {
+    bool inserted = tree_.upsert(std::move(k), std::move(v));
+    size_ += inserted;
+    return inserted;
+}
+
+/*!
+ * @brief This method modifies the value of the given key in place.
+ * @param k is the key object.
+ * @param f is the modification.
+ * @return true if the key was found.
+ */
+template<typename Tree, typename K, typename V>
+bool TreeEngine<Tree, K, V>::update(const K& k, const std::function<void(V&)>& f) {
+    return tree_.update(k, f);
+}
+
+/*!
+ * @brief This method modifies the values of many keys in place, in one pass down the tree.
+ * @param keys are the keys, in ascending order.
+ * @param f is the modification.
+ * @return the number of keys found.
+ */
+template<typename Tree, typename K, typename V>
+size_t TreeEngine<Tree, K, V>::update_sorted(const std::vector<K>& keys, const std::function<void(size_t, V&)>& f) {
+    return tree_.update_sorted(keys.data(), keys.size(), f);
+}
+
+/*!
+ * @brief This method removes the given key.
+ * @param k is the key object.
+ * @return true if removed.
+ */
+template<typename Tree, typename K, typename V>
+bool TreeEngine<Tree, K, V>::remove(const K& k) {
+    bool removed = tree_.remove(k);
+    size_ -= removed;
+    return removed;
+}
+
+/*!
+ * @brief This method visits the keys in `[lo, hi]` in the given order, until `f` returns false.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the inclusive upper bound.
+ * @param descending is true to visit the keys in descending order.
+ * @param f is the visitor.
+ * @return the number of keys visited.
+ */
+template<typename Tree, typename K, typename V>
+size_t TreeEngine<Tree, K, V>::scan(const K& lo, const K& hi, bool descending,
+                                    const typename StorageEngine<K, V>::Visitor& f) const {
+    if (hi < lo) { return 0; }
+    auto first = tree_.lower_bound(lo);
+    auto last = tree_.lower_bound(hi);
+    if (tree_.end() != last && !(hi < last.key())) { ++last; }  // Past `hi` itself.
+    size_t visited{};
+    if (!descending) {
+        for (auto it = first; it != last; ++it) {
+            ++visited;
+            if (!f(it.key(), it.value())) { break; }
+        }
+        return visited;
+    }
+    using category = typename std::iterator_traits<typename Tree::ConstIterator>::iterator_category;
+    if constexpr (std::is_base_of_v<std::bidirectional_iterator_tag, category>) {
+        for (auto it = last; it != first;) {
+            --it;
+            ++visited;
+            if (!f(it.key(), it.value())) { break; }
+        }
+    } else {  // Buffer the range (as pointers into the tree) and walk it backwards.
+        std::vector<std::pair<const K*, const V*>> entries;
+        for (auto it = first; it != last; ++it) {
+            entries.emplace_back(&it.key(), &it.value());
+        }
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+            ++visited;
+            if (!f(*it->first, *it->second)) { break; }
+        }
+    }
+    return visited;
+}
+
+/*!
+ * @brief This method replaces the contents of the engine with the given pairs, building the tree bottom-up in O(n)
+ * time instead of inserting them one by one.
+ * @param entries are the pairs, sorted by key and with distinct keys.
+ */
+template<typename Tree, typename K, typename V>
+void TreeEngine<Tree, K, V>::bulk_load(std::vector<std::pair<K, V>> entries) {
+    size_ = entries.size();
+    tree_.bulk_load(std::move(entries));
+}
+
+/*!
+ * @brief This method returns number of keys in the engine.
+ * @return the number of keys.
+ */
+template<typename Tree, typename K, typename V>
+size_t TreeEngine<Tree, K, V>::size() const {
+    return size_;
+}
+
+/*!
+ * @brief This method returns a copy-on-write copy of the engine, in O(1) time.
+ * @return the copy.
+ */
+template<typename Tree, typename K, typename V>
+std::unique_ptr<StorageEngine<K, V>> TreeEngine<Tree, K, V>::snapshot() const {
+    return std::make_unique<TreeEngine>(*this);
+}
+
+/*!
+ * @brief This method returns the name of the engine.
+ * @return the name.
+ */
+template<typename K, typename V>
+const char* HashEngine<K, V>::name() const {
+    return "hash";
+}
+
+/*!
+ * @brief This method looks up a key without copying the value.
+ * @param k is the key object.
+ * @return pointer to the value object, or nullptr if not found.
+ */
+template<typename K, typename V>
+const V* HashEngine<K, V>::find(const K& k) const {
+    return map_.find(k);
+}
+
+/*!
+ * @brief This method overwrites the value of the given key, or inserts the pair if the key is absent.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if a new pair was inserted.
+ */
+template<typename K, typename V>
+bool HashEngine<K, V>::upsert(K k, V v) {
+    return map_.insert_or_assign(std::move(k), std::move(v));
+}
+
+/*!
+ * @brief This method modifies the value of the given key in place.
+ * @param k is the key object.
+ * @param f is the modification.
+ * @return true if the key was found.
+ */
+template<typename K, typename V>
+bool HashEngine<K, V>::update(const K& k, const std::function<void(V&)>& f) {
+    V* v = map_.find(k);
+    if (nullptr == v) { return false; }
+    f(*v);
+    return true;
+}
+
+/*!
+ * @brief This method modifies the values of many keys in place, one probe each (the table has no order to share).
+ * @param keys are the keys.
+ * @param f is the modification.
+ * @return the number of keys found.
+ */
+template<typename K, typename V>
+size_t HashEngine<K, V>::update_sorted(const std::vector<K>& keys, const std::function<void(size_t, V&)>& f) {
+    size_t found{};
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (V* v = map_.find(keys[i])) {
+            f(i, *v);
+            ++found;
+        }
+    }
+    return found;
+}
+
+/*!
+ * @brief This method removes the given key.
+ * @param k is the key object.
+ * @return true if removed.
+ */
+template<typename K, typename V>
+bool HashEngine<K, V>::remove(const K& k) {
+    return map_.erase(k);
+}
+
+/*!
+ * @brief This method visits the keys in `[lo, hi]` in the given order, until `f` returns false. The table is
+ * unordered, so every entry is read and those in range are sorted first.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the inclusive upper bound.
+ * @param descending is true to visit the keys in descending order.
+ * @param f is the visitor.
+ * @return the number of keys visited.
+ */
+template<typename K, typename V>
+size_t HashEngine<K, V>::scan(const K& lo, const K& hi, bool descending,
+                              const typename StorageEngine<K, V>::Visitor& f) const {
+    std::vector<const std::pair<K, V>*> entries;
+    for (const auto& entry : map_) {
+        if (!(entry.first < lo) && !(hi < entry.first)) { entries.push_back(&entry); }
+    }
+    std::sort(entries.begin(), entries.end(), [descending](const auto* a, const auto* b) {
+        return descending ? b->first < a->first : a->first < b->first;
+    });
+    size_t visited{};
+    for (const auto* entry : entries) {
+        ++visited;
+        if (!f(entry->first, entry->second)) { break; }
+    }
+    return visited;
+}
+
+/*!
+ * @brief This method replaces the contents of the engine with the given pairs, sizing the table once.
+ * @param entries are the pairs, sorted by key and with distinct keys.
+ */
+template<typename K, typename V>
+void HashEngine<K, V>::bulk_load(std::vector<std::pair<K, V>> entries) {
+    map_.clear();
+    map_.reserve(entries.size());
+    for (auto& [k, v] : entries) {
+        map_.insert_or_assign(std::move(k), std::move(v));
+    }
+}
+
+/*!
+ * @brief This method returns number of keys in the engine.
+ * @return the number of keys.
+ */
+template<typename K, typename V>
+size_t HashEngine<K, V>::size() const {
+    return map_.size();
+}
+
+/*!
+ * @brief This method returns a copy of the engine; it copies the whole table.
+ * @return the copy.
+ */
+template<typename K, typename V>
+std::unique_ptr<StorageEngine<K, V>> HashEngine<K, V>::snapshot() const {
+    return std::make_unique<HashEngine>(*this);
+}
+
+/*!
+ * @brief This method returns the name of the engine.
+ * @return the name.
+ */
+template<typename V>
+const char* ArtEngine<V>::name() const {
+    return "art";
+}
+
+/*!
+ * @brief This method looks up a key without copying the value.
+ * @param k is the key object.
+ * @return pointer to the value object, or nullptr if not found.
+ */
+template<typename V>
+const V* ArtEngine<V>::find(const int& k) const {
+    return tree_.find(k);
+}
+
+/*!
+ * @brief This method overwrites the value of the given key, or inserts the pair if the key is absent.
+ * @param k is the key object.
+ * @param v is the value object.
+ * @return true if a new pair was inserted.
+ */
+template<typename V>
+bool ArtEngine<V>::upsert(int k, V v) {
+    return tree_.upsert(k, std::move(v));
+}
+
+/*!
+ * @brief This method modifies the value of the given key in place.
+ * @param k is the key object.
+ * @param f is the modification.
+ * @return true if the key was found.
+ */
+template<typename V>
+bool ArtEngine<V>::update(const int& k, const std::function<void(V&)>& f) {
+    return tree_.update(k, f);
+}
+
+/*!
+ * @brief This method modifies the values of many keys in place, one descent each: a descent takes at most 4 steps,
+ * and sorted keys find the nodes of the previous one in cache.
+ * @param keys are the keys, in ascending order.
+ * @param f is the modification.
+ * @return the number of keys found.
+ */
+template<typename V>
+size_t ArtEngine<V>::update_sorted(const std::vector<int>& keys, const std::function<void(size_t, V&)>& f) {
+    size_t found{};
+    for (size_t i = 0; i < keys.size(); ++i) {
+        found += tree_.update(keys[i], [&f, i](V& v) { f(i, v); });
+    }
+    return found;
+}
+
+/*!
+ * @brief This method removes the given key.
+ * @param k is the key object.
+ * @return true if removed.
+ */
+template<typename V>
+bool ArtEngine<V>::remove(const int& k) {
+    return tree_.remove(k);
+}
+
+/*!
+ * @brief This method visits the keys in `[lo, hi]` in the given order, until `f` returns false.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the inclusive upper bound.
+ * @param descending is true to visit the keys in descending order.
+ * @param f is the visitor.
+ * @return the number of keys visited.
+ */
+template<typename V>
+size_t ArtEngine<V>::scan(const int& lo, const int& hi, bool descending,
+                          const typename StorageEngine<int, V>::Visitor& f) const {
+    size_t visited{};
+    tree_.scan(lo, hi, descending, [&visited, &f](int k, const V& v) {
+        ++visited;
+        return f(k, v);
+    });
+    return visited;
+}
+
+/*!
+ * @brief This method replaces the contents of the engine with the given pairs.
+ * @param entries are the pairs, sorted by key and with distinct keys.
+ */
+template<typename V>
+void ArtEngine<V>::bulk_load(std::vector<std::pair<int, V>> entries) {
+    tree_.clear();
+    for (auto& [k, v] : entries) {
+        tree_.upsert(k, std::move(v));
+    }
+}
+
+/*!
+ * @brief This method returns number of keys in the engine.
+ * @return the number of keys.
+ */
+template<typename V>
+size_t ArtEngine<V>::size() const {
+    return tree_.size();
+}
+
+/*!
+ * @brief This method returns a copy of the engine; it copies the whole tree.
+ * @return the copy.
+ */
+template<typename V>
+std::unique_ptr<StorageEngine<int, V>> ArtEngine<V>::snapshot() const {
+    return std::make_unique<ArtEngine>(*this);
+}
+
+/*!
+ * @brief This function creates an empty storage engine for `int` keys.
+ * @tparam V is type of value objects.
+ * @param name is one of `kStorageEngineNames`: "bplustree", "btree", "hash" or "art".
+ * @return the engine, or nullptr if the name is unknown.
+ */
+template<typename V>
+std::unique_ptr<StorageEngine<int, V>> makeStorageEngine(std::string_view name) {
+    if ("bplustree" == name) { return std::make_unique<TreeEngine<BPlusTree<int, V>, int, V>>("bplustree"); }
+    if ("btree" == name) { return std::make_unique<TreeEngine<BTree<int, V>, int, V>>("btree"); }
+    if ("hash" == name) { return std::make_unique<HashEngine<int, V>>(); }
+    if ("art" == name) { return std::make_unique<ArtEngine<V>>(); }
+    return nullptr;
+}
@@ -0,0 +1,191 @@
+/*!
+ * @brief This file contains the definition of the <em>StorageEngine</em> interface and of the engines behind it.
+ */
+#ifndef CS225_SP22_C2_STORAGEENGINE_H_
+#define CS225_SP22_C2_STORAGEENGINE_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "BPlusTree.h"
+#include "BTree.h"
+#include "adaptiveRadixTree.h"
+#include "flatHashMap.h"
+
+/*!
+ * @brief This class is the interface of an in-memory index: point lookups and modifications, ordered range scans
+ * and bulk loading. Engines differ in what they make cheap, so the index of an application can be chosen for its
+ * access mix (see `makeStorageEngine`).
+ * @tparam K is type of key objects.
+ * @tparam V is type of value objects.
+ */
+template<typename K, typename V>
+class StorageEngine {
+public:
+    using Visitor = std::function<bool(const K&, const V&)>;  // Returns false to stop a scan.
+
+    virtual ~StorageEngine() = default;
+
+    /*!
+     * @brief This method returns the name of the engine, as accepted by `makeStorageEngine`.
+     * @return the name.
+     */
+    [[nodiscard]] virtual const char* name() const = 0;
+
+    /*!
+     * @brief This method looks up a key without copying the value.
+     * @param k is the key object.
+     * @return pointer to the value object, or nullptr if not found. It is invalidated by the next modification.
+     */
+    [[nodiscard]] virtual const V* find(const K& k) const = 0;
+
+    /*!
+     * @brief This method overwrites the value of the given key, or inserts the pair if the key is absent.
+     * @param k is the key object.
+     * @param v is the value object.
+     * @return true if a new pair was inserted, false if an existing value was overwritten.
+     */
+    virtual bool upsert(K k, V v) = 0;
+
+    /*!
+     * @brief This method modifies the value of the given key in place.
+     * @param k is the key object.
+     * @param f is the modification.
+     * @return true if the key was found (and `f` was called), false otherwise.
+     */
+    virtual bool update(const K& k, const std::function<void(V&)>& f) = 0;
+
+    /*!
+     * @brief This method modifies the values of many keys in place, in one pass where the engine is ordered.
+     * @param keys are the keys, in ascending order. Duplicates are allowed and visited in order.
+     * @param f is the modification, called as `f(i, v)` with the index of the key in `keys`.
+     * @return the number of keys found (and `f` calls).
+     */
+    virtual size_t update_sorted(const std::vector<K>& keys, const std::function<void(size_t, V&)>& f) = 0;
+
+    /*!
+     * @brief This method removes the given key.
+     * @param k is the key object.
+     * @return true if removed, false if not found.
+     */
+    virtual bool remove(const K& k) = 0;
+
+    /*!
+     * @brief This method calls `f` on the keys in `[lo, hi]` and their values in key order, until `f` returns false.
+     * Both bounds are inclusive, so every key down to the largest one can be scanned without a sentinel.
+     * @param lo is the inclusive lower bound.
+     * @param hi is the inclusive upper bound.
+     * @param descending is true to visit the keys in descending order.
+     * @param f is the visitor.
+     * @return the number of keys visited.
+     */
+    virtual size_t scan(const K& lo, const K& hi, bool descending, const Visitor& f) const = 0;
+
+    /*!
+     * @brief This method replaces the contents of the engine with the given pairs.
+     * @param entries are the pairs, sorted by key and with distinct keys.
+     */
+    virtual void bulk_load(std::vector<std::pair<K, V>> entries) = 0;
+
+    /*!
+     * @brief This method returns number of keys in the engine.
+     * @return the number of keys.
+     */
+    [[nodiscard]] virtual size_t size() const = 0;
+
+    /*!
+     * @brief This method returns a frozen copy of the engine, to be read while the engine keeps changing.
+     * @return the copy.
+     */
+    [[nodiscard]] virtual std::unique_ptr<StorageEngine> snapshot() const = 0;
+};
+
+/*!
+ * @brief This class exposes <em>BPlusTree</em> or <em>BTree</em> as a storage engine. Snapshots are copy-on-write
+ * and take O(1) time, and bulk loads build the tree bottom-up. The B-tree iterates forward only, so its descending
+ * scans buffer the range first.
+ * @tparam Tree is type of the tree.
+ * @tparam K is type of key objects.
+ * @tparam V is type of value objects.
+ */
+template<typename Tree, typename K, typename V>
+class TreeEngine : public StorageEngine<K, V> {
+public:
+    explicit TreeEngine(const char* name) : name_(name) {}
+    [[nodiscard]] const char* name() const override;
+    [[nodiscard]] const V* find(const K& k) const override;
+    bool upsert(K k, V v) override;
+    bool update(const K& k, const std::function<void(V&)>& f) override;
+    size_t update_sorted(const std::vector<K>& keys, const std::function<void(size_t, V&)>& f) override;
+    bool remove(const K& k) override;
+    size_t scan(const K& lo, const K& hi, bool descending, const typename StorageEngine<K, V>::Visitor& f) const
+    override;
+    void bulk_load(std::vector<std::pair<K, V>> entries) override;
+    [[nodiscard]] size_t size() const override;
+    [[nodiscard]] std::unique_ptr<StorageEngine<K, V>> snapshot() const override;
+
+private:
+    const char* name_;
+    Tree tree_{};
+    size_t size_{};  // The trees do not count their keys.
+};
+
+/*!
+ * @brief This class exposes <em>FlatHashMap</em> as a storage engine: the fastest point operations, but a scan
+ * reads every entry and sorts those in range, and a snapshot copies the table. It is unsuitable for range queries
+ * (ID exports, ID-range queries): pick it only for lookup-heavy use.
+ * @tparam K is type of key objects.
+ * @tparam V is type of value objects.
+ */
+template<typename K, typename V>
+class HashEngine : public StorageEngine<K, V> {
+public:
+    [[nodiscard]] const char* name() const override;
+    [[nodiscard]] const V* find(const K& k) const override;
+    bool upsert(K k, V v) override;
+    bool update(const K& k, const std::function<void(V&)>& f) override;
+    size_t update_sorted(const std::vector<K>& keys, const std::function<void(size_t, V&)>& f) override;
+    bool remove(const K& k) override;
+    size_t scan(const K& lo, const K& hi, bool descending, const typename StorageEngine<K, V>::Visitor& f) const
+    override;
+    void bulk_load(std::vector<std::pair<K, V>> entries) override;
+    [[nodiscard]] size_t size() const override;
+    [[nodiscard]] std::unique_ptr<StorageEngine<K, V>> snapshot() const override;
+
+private:
+    FlatHashMap<K, V> map_{};
+};
+
+/*!
+ * @brief This class exposes <em>AdaptiveRadixTree</em> as a storage engine for `int` keys: lookups in at most 4
+ * steps and ordered scans, but a snapshot copies the tree.
+ * @tparam V is type of value objects.
+ */
+template<typename V>
+class ArtEngine : public StorageEngine<int, V> {
+public:
+    [[nodiscard]] const char* name() const override;
+    [[nodiscard]] const V* find(const int& k) const override;
+    bool upsert(int k, V v) override;
+    bool update(const int& k, const std::function<void(V&)>& f) override;
+    size_t update_sorted(const std::vector<int>& keys, const std::function<void(size_t, V&)>& f) override;
+    bool remove(const int& k) override;
+    size_t scan(const int& lo, const int& hi, bool descending, const typename StorageEngine<int, V>::Visitor& f) const
+    override;
+    void bulk_load(std::vector<std::pair<int, V>> entries) override;
+    [[nodiscard]] size_t size() const override;
+    [[nodiscard]] std::unique_ptr<StorageEngine<int, V>> snapshot() const override;
+
+private:
+    AdaptiveRadixTree<V> tree_{};
+};
+
+inline constexpr const char* kStorageEngineNames[]{"bplustree", "btree", "hash", "art"};
+
+template<typename V>
+std::unique_ptr<StorageEngine<int, V>> makeStorageEngine(std::string_view name);
+
+#endif //CS225_SP22_C2_STORAGEENGINE_H_
@@ -0,0 +1,138 @@
+/*!
+ * @brief This file tests <em>BPlusTree</em> against std::map: random insertions and heavy removals must leave the
+ * same pairs in both, in the same order, iterators must step across leaves in both directions, and snapshots must
+ * not see later modifications. Trees built by `bulk_load` must behave the same.
+ */
+#include "../config.h"  // Must come first: BPlusTree.h relies on DEBUG for member access.
+#include "../BPlusTree.h"
+#include "../BPlusTree.cpp"
+#include "check.h"
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+/*!
+ * @brief This function checks that a tree holds exactly the pairs of a map, walking it in both directions.
+ * @param tree is the tree.
+ * @param reference is the map.
+ * @return true if they agree, false otherwise.
+ */
+template<typename Tree>
+bool sameContents(const Tree& tree, const std::map<int, int>& reference) {
+    auto iter = reference.begin();
+    for (const auto& [k, v] : tree) {
+        if (reference.end() == iter || iter->first != k || iter->second != v) { return false; }
+        ++iter;
+    }
+    if (reference.end() != iter) { return false; }
+    auto riter = reference.rbegin();
+    for (auto titer = tree.rbegin(); titer != tree.rend(); ++titer) {
+        if (reference.rend() == riter || riter->first != (*titer).first) { return false; }
+        ++riter;
+    }
+    return reference.rend() == riter;
+}
+
+/*!
+ * @brief This function runs rounds of random operations on a tree and on a map: each round grows the tree, then
+ * removes most of it, so that leaves are merged and borrowed from while their overflow blocks are still filled.
+ * @tparam Degree is the minimum degree of the tree.
+ * @tparam OverflowSize is capacity of the overflow block of each leaf.
+ * @param seed seeds the random operations.
+ * @param keys is the number of distinct keys.
+ * @param rounds is the number of grow-and-shrink rounds.
+ */
+template<int Degree, int OverflowSize>
+void testAgainstMap(unsigned seed, int keys, int rounds) {
+    BPlusTree<int, int, Degree, OverflowSize> tree;
+    std::map<int, int> reference;
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> key{-keys / 2, keys - keys / 2 - 1};  // Negative keys too.
+    std::uniform_int_distribution<int> percent{0, 99};
+    bool agreed{true};
+    for (int round = 0; round < rounds; ++round) {
+        auto snapshot = tree.snapshot();
+        auto snapshot_reference = reference;
+        for (int removals : {20, 90}) {  // Grow, then shrink.
+            for (int n = 0; n < 4 * keys; ++n) {
+                int k = key(rng);
+                if (percent(rng) < removals) {
+                    agreed &= tree.remove(k) == (reference.erase(k) > 0);
+                } else {
+                    agreed &= tree.upsert(k, n) == reference.insert_or_assign(k, n).second;
+                }
+                int probe = key(rng);
+                auto v = tree.find(probe);
+                auto iter = reference.find(probe);
+                agreed &= (nullptr == v) == (reference.end() == iter) && (nullptr == v || *v == iter->second);
+                auto bound = tree.lower_bound(probe);
+                auto reference_bound = reference.lower_bound(probe);
+                agreed &= (tree.end() == bound) == (reference.end() == reference_bound) &&
+                          (tree.end() == bound || bound.key() == reference_bound->first);
+                if (reference.begin() != reference_bound) {  // Step back, possibly into the previous leaf.
+                    agreed &= (--bound).key() == std::prev(reference_bound)->first;
+                }
+            }
+            agreed &= sameContents(tree, reference);
+        }
+        agreed &= sameContents(snapshot, snapshot_reference);
+    }
+    CHECK(agreed);
+    for (auto [k, v] : reference) { tree.remove(k); }  // Empty the tree completely.
+    CHECK(tree.begin() == tree.end());
+}
+
+/*!
+ * @brief This function checks `bulk_load` for trees of one leaf to several levels: the loaded tree holds the pairs,
+ * and random insertions and heavy removals afterwards keep it in step with a map.
+ * @tparam Degree is the minimum degree of the tree.
+ * @tparam OverflowSize is capacity of the overflow block of each leaf.
+ * @param seed seeds the random operations.
+ */
+template<int Degree, int OverflowSize>
+void testBulkLoad(unsigned seed) {
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> percent{0, 99};
+    bool agreed{true};
+    for (int n : {0, 1, 2 * Degree - 1, 2 * Degree, 4 * Degree * Degree + 1, 10000}) {
+        BPlusTree<int, int, Degree, OverflowSize> tree;
+        tree.insert(-1, -1);
+        auto snapshot = tree.snapshot();
+        std::vector<std::pair<int, int>> entries;
+        std::map<int, int> reference;
+        for (int i = 0; i < n; ++i) {
+            entries.emplace_back(3 * i - n, i);  // Gaps for later insertions.
+            reference.emplace(3 * i - n, i);
+        }
+        tree.bulk_load(entries);
+        agreed &= sameContents(tree, reference) && sameContents(snapshot, std::map<int, int>{{-1, -1}});
+        std::uniform_int_distribution<int> key{-n - 10, 2 * n + 10};
+        for (int i = 0; i < 4 * n; ++i) {
+            int k = key(rng);
+            if (percent(rng) < 70) {
+                agreed &= tree.remove(k) == (reference.erase(k) > 0);
+            } else {
+                agreed &= tree.upsert(k, i) == reference.insert_or_assign(k, i).second;
+            }
+        }
+        agreed &= sameContents(tree, reference);
+    }
+    CHECK(agreed);
+}
+
+int main() {
+    // A few keys per leaf keep the root at two leaves most of the time; more keys give deeper trees.
+    testAgainstMap<2, 0>(1, 200, 10);
+    testAgainstMap<2, 3>(2, 200, 10);
+    testAgainstMap<3, 2>(3, 10, 200);
+    testAgainstMap<3, 2>(4, 1000, 10);
+    testAgainstMap<4, 7>(5, 1000, 10);
+    testAgainstMap<8, 4>(6, 40, 200);
+    testAgainstMap<32, 16>(7, 150, 50);  // The default parameters.
+    testAgainstMap<32, 16>(8, 20000, 4);
+    testBulkLoad<2, 0>(9);
+    testBulkLoad<3, 2>(10);
+    testBulkLoad<32, 16>(11);
+    return checkSummary();
+}
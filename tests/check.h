@@ -0,0 +1,39 @@
+/*!
+ * @brief This file contains the helpers shared by the tests. A test is an executable that returns 0 if every check
+ * passed; failed checks are printed with their file and line.
+ */
+#ifndef CS225_SP22_C2_TESTS_CHECK_H_
+#define CS225_SP22_C2_TESTS_CHECK_H_
+
+#include <iostream>
+
+inline int checkFailures{};  // Number of failed checks so far.
+
+/*!
+ * @brief This function records the result of one check and prints it if it failed.
+ * @param passed is the result of the check.
+ * @param what is the checked expression.
+ * @param file is the file of the check.
+ * @param line is the line of the check.
+ * @return the result of the check.
+ */
+inline bool checkResult(bool passed, const char* what, const char* file, int line) {
+    if (!passed) {
+        ++checkFailures;
+        std::cerr << file << ":" << line << ": check failed: " << what << std::endl;
+    }
+    return passed;
+}
+
+#define CHECK(expression) checkResult(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+/*!
+ * @brief This function ends a test.
+ * @return the exit status of the test.
+ */
+inline int checkSummary() {
+    if (checkFailures) { std::cerr << checkFailures << " check(s) failed" << std::endl; }
+    return checkFailures ? 1 : 0;
+}
+
+#endif //CS225_SP22_C2_TESTS_CHECK_H_
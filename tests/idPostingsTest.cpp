@@ -0,0 +1,61 @@
+/*!
+ * @brief This file tests <em>IdPostings</em> against std::set: after random insertions and removals of IDs of any
+ * sign, a posting list must list the same IDs in the same (signed) order, also once it is encoded and decoded.
+ */
+#include "../config.h"
+#include "../databaseSchema.h"
+#include "check.h"
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+/*!
+ * @brief This function checks that a posting list holds exactly the IDs of a set.
+ * @param postings is the posting list.
+ * @param reference is the set.
+ * @return true if they agree, false otherwise.
+ */
+bool sameIds(const IdPostings& postings, const std::set<int>& reference) {
+    return postings.ids() == std::vector<int>{reference.begin(), reference.end()} &&
+           postings.size() == reference.size();
+}
+
+/*!
+ * @brief This function runs random insertions and removals of IDs drawn from `[lo, hi]`, with the smallest and
+ * largest `int` among them.
+ * @param seed seeds the random operations.
+ * @param lo is the smallest ID drawn.
+ * @param hi is the largest ID drawn.
+ */
+void testAgainstSet(unsigned seed, int lo, int hi) {
+    constexpr int kMin{std::numeric_limits<int>::min()}, kMax{std::numeric_limits<int>::max()};
+    IdPostings postings;
+    std::set<int> reference;
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> id{lo, hi};
+    std::uniform_int_distribution<int> percent{0, 99};
+    bool agreed{true};
+    for (int i = 0; i < 2000; ++i) {
+        int k = percent(rng) < 2 ? (percent(rng) < 50 ? kMin : kMax) : id(rng);
+        if (percent(rng) < 40) {
+            agreed &= postings.erase(k) == (reference.erase(k) > 0);
+        } else {
+            agreed &= postings.insert(k) == reference.insert(k).second;
+        }
+        agreed &= postings.contains(k) == (reference.count(k) > 0);
+    }
+    agreed &= sameIds(postings, reference);
+    std::string bytes;
+    Codec<IdPostings>::encode(postings, bytes);
+    agreed &= sameIds(Codec<IdPostings>::decode(bytes.data(), bytes.size()), reference);
+    CHECK(agreed);
+}
+
+int main() {
+    testAgainstSet(1, 0, 100);  // The usual, non-negative IDs.
+    testAgainstSet(2, -100, 100);
+    testAgainstSet(3, -1000000, 1000000);
+    testAgainstSet(4, std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    return checkSummary();
+}
@@ -0,0 +1,81 @@
+/*!
+ * @brief This file tests <em>ConcurrentCentralizedQueue</em>: keys re-prioritized by id through `updateKey` are
+ * found in whichever shard holds them, and concurrent workers pop every key exactly once.
+ */
+#include "../multiQueue.h"
+#include "../multiQueue.cpp"
+#include "check.h"
+#include <algorithm>
+#include <vector>
+
+/*!
+ * @brief This struct is a queued key with an id, like the records of the centralized queue.
+ */
+struct Item {
+    int id{};
+    long priority{};
+    [[nodiscard]] int GetId() const { return id; }
+};
+
+/*!
+ * @brief This functor orders items by priority (smaller first).
+ */
+struct ItemLess {
+    bool operator()(const Item& lhs, const Item& rhs) const { return lhs.priority < rhs.priority; }
+};
+
+std::ostream& operator<<(std::ostream& os, const Item& item) {
+    return os << item.id;
+}
+
+/*!
+ * @brief This function checks `updateKey` on one worker: raised keys come out first, lowered keys last, and ids
+ * not in the queue are reported.
+ */
+void testUpdateKey() {
+    ConcurrentCentralizedQueue<Item, ItemLess> queue{1, 4};  // Four shards.
+    for (int i = 0; i < 1000; ++i) { queue.push(Item{i, i}); }
+    CHECK(queue.updateKey(500, Item{500, -1}));  // Raised.
+    CHECK(queue.updateKey(0, Item{0, 5000}));  // Lowered.
+    CHECK(!queue.updateKey(1000, Item{1000, 0}));  // Not queued.
+    CHECK(1000 == queue.size());
+    std::vector<int> popped;
+    Item item;
+    while (queue.try_pop(item)) { popped.push_back(item.id); }
+    CHECK(1000 == popped.size());
+    CHECK(std::find(popped.begin(), popped.end(), 500) - popped.begin() < 40);  // Relaxed: near the front.
+    CHECK(std::find(popped.begin(), popped.end(), 0) - popped.begin() > 900);
+}
+
+/*!
+ * @brief This function checks concurrent updates and pops: every key is popped exactly once and every update of
+ * a key still queued finds it.
+ * @param threads is the number of workers.
+ */
+void testConcurrent(unsigned threads) {
+    const int n{1 << 16};
+    ConcurrentCentralizedQueue<Item, ItemLess> queue{threads};
+    for (int i = 0; i < n; ++i) { queue.push(Item{i, (i * 2654435761L) % (1L << 30)}); }
+    std::atomic<int> updated{0};
+    std::vector<std::atomic<int>> pops(n);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = static_cast<int>(t); i < n; i += static_cast<int>(threads) * 4) {
+                if (queue.updateKey(i, Item{i, -1L - i})) { updated++; }
+            }
+            Item item;
+            while (queue.try_pop(item)) { pops[item.id]++; }
+        });
+    }
+    for (auto& worker : workers) { worker.join(); }
+    CHECK(std::all_of(pops.begin(), pops.end(), [](const std::atomic<int>& p) { return 1 == p.load(); }));
+    CHECK(queue.empty());
+    CHECK(0 < updated);
+}
+
+int main() {
+    testUpdateKey();
+    for (unsigned threads : {1u, 2u, 4u}) { testConcurrent(threads); }
+    return checkSummary();
+}
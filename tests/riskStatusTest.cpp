@@ -0,0 +1,92 @@
+/*!
+ * @brief This file tests `updateRiskStatus`: raising and lowering the risk status of a record must both be applied,
+ * in the waiting list and in the centralized queue.
+ */
+#include "../config.h"
+#include "../eventDriver.h"
+#include "check.h"
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+
+/*!
+ * @brief This function makes a registration record.
+ * @param id is the ID of the record.
+ * @param risk is the risk status of the record.
+ * @return the record.
+ */
+RegistrationRecord makeRecord(int id, int risk) {
+    auto text = std::to_string(id);
+    return RegistrationRecord{std::vector<std::string>{text, "name" + text, "address", "10000000000", "wechat",
+                                                       "email", "3", "1990/1/1", std::to_string(risk), "0"}};
+}
+
+/*!
+ * @brief This function counts the records in the local queues.
+ * @param container is the crucial data structure.
+ * @return number of records in the local queues.
+ */
+unsigned localRecords(const Container& container) {
+    unsigned count{};
+    for (const auto& queue : container.localQueues) { count += queue.size(); }
+    return count;
+}
+
+/*!
+ * @brief This function checks risk updates of a record in the waiting list: a lowered priority gives the longer
+ * waiting time, and a raised one the shorter waiting time or a local queue.
+ */
+void testWaitingList() {
+    Container container{numReg, numLoc};
+    container.localQueues.resize(numReg);
+    container.waitingList.push_back(makeRecord(1, 2));
+    updateRiskStatus(1, 3, container);  // Lower the priority.
+    CHECK(1 == container.waitingList.size() && 3 == container.waitingList.front().GetRiskStatus());
+    CHECK(std::numeric_limits<int>::max() == container.waitingList.front().GetExtension());
+    updateRiskStatus(1, 2, container);  // Raise the priority.
+    CHECK(1 == container.waitingList.size() && 2 == container.waitingList.front().GetRiskStatus());
+    CHECK(60 == container.waitingList.front().GetExtension());
+    updateRiskStatus(1, 1, container);  // Raise it further: no more waiting.
+    CHECK(container.waitingList.empty() && 1 == localRecords(container));
+
+    container.waitingList.push_back(makeRecord(2, 0));  // Recovered after a withdrawal.
+    container.waitingList.back().applyPenalty();
+    updateRiskStatus(2, 2, container);  // Lower the priority.
+    CHECK(1 == container.waitingList.size() && 2 == container.waitingList.front().GetRiskStatus());
+    CHECK(60 == container.waitingList.front().GetExtension());
+    updateRiskStatus(2, 2, container);  // No effects.
+    CHECK(1 == container.waitingList.size() && 60 == container.waitingList.front().GetExtension());
+}
+
+/*!
+ * @brief This function checks risk updates of a record in the centralized queue, in both directions.
+ */
+void testCentralizedQueue() {
+    Container container{numReg, numLoc};
+    container.localQueues.resize(numReg);
+    container.centralizedQueue.push(makeRecord(1, 1));
+    container.centralizedQueue.push(makeRecord(2, 1));
+    updateRiskStatus(1, 3, container);  // Lower the priority.
+    auto node = container.centralizedQueue.find_by_id(1);
+    CHECK(nullptr != node && 3 == node->key.GetRiskStatus());
+    updateRiskStatus(1, 0, container);  // Raise the priority.
+    node = container.centralizedQueue.find_by_id(1);
+    CHECK(nullptr != node && 0 == node->key.GetRiskStatus());
+    CHECK(2 == container.centralizedQueue.size() && 0 == localRecords(container));
+    node = container.centralizedQueue.find_by_id(2);
+    CHECK(nullptr != node && 1 == node->key.GetRiskStatus());
+}
+
+int main() {
+    startingTime = std::time(nullptr);
+    auto directory = std::filesystem::temp_directory_path() / "rqrs_risk_status_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory / "data");  // The persistent indexes are opened in `data/`.
+    std::filesystem::current_path(directory);
+    testWaitingList();
+    testCentralizedQueue();
+    std::filesystem::current_path(directory.parent_path());
+    std::filesystem::remove_all(directory);
+    return checkSummary();
+}
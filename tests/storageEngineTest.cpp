@@ -0,0 +1,89 @@
+/*!
+ * @brief This file tests every <em>StorageEngine</em> against std::map: after a bulk load and after random upserts
+ * and removals, closed-range scans in both directions must visit the same keys, the smallest and largest `int`
+ * included.
+ */
+#include "../config.h"  // Must come first: BPlusTree.h relies on DEBUG for member access.
+#include "../storageEngine.h"
+#include "../BPlusTree.cpp"
+#include "../BTree.cpp"
+#include "../flatHashMap.cpp"
+#include "../adaptiveRadixTree.cpp"
+#include "../storageEngine.cpp"
+#include "check.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+/*!
+ * @brief This function checks a scan of `[lo, hi]` in both directions against a map.
+ * @param engine is the engine.
+ * @param reference is the map.
+ * @param lo is the inclusive lower bound.
+ * @param hi is the inclusive upper bound.
+ * @return true if they agree, false otherwise.
+ */
+bool sameScan(const StorageEngine<int, int>& engine, const std::map<int, int>& reference, int lo, int hi) {
+    std::vector<std::pair<int, int>> expected;
+    for (auto iter = reference.lower_bound(lo); reference.end() != iter && iter->first <= hi; ++iter) {
+        expected.emplace_back(*iter);
+    }
+    if (hi < lo) { expected.clear(); }
+    for (bool descending : {false, true}) {
+        std::vector<std::pair<int, int>> visited;
+        engine.scan(lo, hi, descending, [&visited](const int& k, const int& v) {
+            visited.emplace_back(k, v);
+            return true;
+        });
+        if (descending) { std::reverse(visited.begin(), visited.end()); }
+        if (visited != expected) { return false; }
+    }
+    return true;
+}
+
+/*!
+ * @brief This function bulk loads an engine, modifies it at random with heavy removals, and compares its scans
+ * with a map after each step.
+ * @param name is the name of the engine.
+ * @param n is the number of pairs to load.
+ * @param seed seeds the random operations.
+ */
+void testEngine(const char* name, int n, unsigned seed) {
+    constexpr int kMin{std::numeric_limits<int>::min()}, kMax{std::numeric_limits<int>::max()};
+    auto engine = makeStorageEngine<int>(name);
+    std::map<int, int> reference{{kMin, 0}, {kMax, 0}};
+    for (int i = 0; i < n; ++i) { reference.emplace(4 * i - 2 * n, i); }
+    engine->bulk_load({reference.begin(), reference.end()});
+    CHECK(reference.size() == engine->size());
+    CHECK(sameScan(*engine, reference, kMin, kMax));
+    CHECK(sameScan(*engine, reference, kMax, kMax));
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> key{-2 * n - 10, 2 * n + 10};
+    std::uniform_int_distribution<int> percent{0, 99};
+    for (int i = 0; i < 4 * n; ++i) {
+        int k = key(rng);
+        if (percent(rng) < 60) {
+            CHECK(engine->remove(k) == (reference.erase(k) > 0));
+        } else {
+            CHECK(engine->upsert(k, i) == reference.insert_or_assign(k, i).second);
+        }
+    }
+    CHECK(reference.size() == engine->size());
+    bool agreed = sameScan(*engine, reference, kMin, kMax) && sameScan(*engine, reference, kMin, kMin) &&
+                  sameScan(*engine, reference, 1, 0);
+    for (int i = 0; i < 200; ++i) {
+        int lo = key(rng), hi = key(rng);
+        agreed &= sameScan(*engine, reference, lo, hi);
+    }
+    CHECK(agreed);
+}
+
+int main() {
+    unsigned seed{1};
+    for (const char* name : kStorageEngineNames) {
+        for (int n : {0, 1, 100, 20000}) { testEngine(name, n, seed++); }
+    }
+    return checkSummary();
+}
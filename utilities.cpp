@@ -417,6 +417,16 @@ void showPrompt() {
               << "Remove a Database record by ID." << std::endl;
     std::cout << BOLDCYAN << "***\t13: " << RESET << CYAN
               << "Remove a Database record by NAME." << std::endl;
+    std::cout << BOLDCYAN << "***\t14: " << RESET << CYAN
+              << "Preview the next N appointments." << std::endl;
+    std::cout << BOLDCYAN << "***\t15: " << RESET << CYAN
+              << "Export Database records in an ID range." << std::endl;
+    std::cout << BOLDCYAN << "***\t16: " << RESET << CYAN
+              << "Search Database records by NAME prefix." << std::endl;
+    std::cout << BOLDCYAN << "***\t17: " << RESET << CYAN
+              << "List Database records by medical status." << std::endl;
+    std::cout << BOLDCYAN << "***\t18: " << RESET << CYAN
+              << "Query Database records (e.g. risk=1 AND status=queueing)." << std::endl;
     std::cout << BOLDCYAN << "***\t0: " << RESET << CYAN << "Exit!" << std::endl;
     std::cout << BOLDCYAN << std::string(40, '-') << RESET << std::endl;
 }
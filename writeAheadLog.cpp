@@ -0,0 +1,249 @@
+/*!
+ * @brief This file contains the implementation of <em>WriteAheadLog</em> and of the checkpoint file helpers.
+ */
+#include "writeAheadLog.h"
+#include "bufferPool.h"
+#include "codec.h"
+#include "utilities.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*!
+ * @brief This function writes a whole buffer to a file descriptor, resuming after partial writes.
+ * @param fd is the file descriptor.
+ * @param data is the buffer.
+ * @param n is number of bytes to write.
+ * @throw IOError if the bytes cannot be written.
+ */
+static void writeAll(int fd, const char* data, size_t n) {
+    while (n > 0) {
+        auto written = ::write(fd, data, n);
+        if (written < 0) { throw IOError(); }
+        data += written;
+        n -= static_cast<size_t>(written);
+    }
+}
+
+/*!
+ * @brief This function reads a whole file from a file descriptor.
+ * @param fd is the file descriptor.
+ * @param bytes receives the contents of the file.
+ * @throw IOError if the file cannot be read.
+ */
+static void readAll(int fd, std::string& bytes) {
+    struct stat st{};
+    if (0 != ::fstat(fd, &st)) { throw IOError(); }
+    bytes.resize(static_cast<size_t>(st.st_size));
+    size_t done{};
+    while (done < bytes.size()) {
+        auto n = ::pread(fd, bytes.data() + done, bytes.size() - done, static_cast<off_t>(done));
+        if (n <= 0) { throw IOError(); }
+        done += static_cast<size_t>(n);
+    }
+}
+
+/*!
+ * @brief This destructor commits the pending records and closes the file. Errors cannot be reported here,
+ * so owners should call `commit()` themselves first.
+ */
+WriteAheadLog::~WriteAheadLog() {
+    if (!isOpen()) { return; }
+    try {
+        commit();
+    } catch (const IOError& error) {
+        std::cerr << error.what() << std::endl;
+    }
+    ::close(fd_);
+}
+
+/*!
+ * @brief This method opens (or creates) the log file and replays its records in the order they were appended.
+ * A damaged tail is cut off, so that new records follow the last intact one.
+ * @param path is path to the file.
+ * @param replay is called on each intact record.
+ * @return the number of records replayed.
+ * @throw IOError if the file cannot be opened, is not a log, or cannot be repaired.
+ */
+size_t WriteAheadLog::open(const std::string& path, const Replayer& replay) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) { throw IOError(); }
+    std::string bytes;
+    size_t end{};
+    size_t replayed{};
+    try {
+        readAll(fd, bytes);
+        if (bytes.size() < sizeof(kMagic) - 1) {  // New file, or torn before the magic was written.
+            bytes.assign(kMagic, sizeof(kMagic) - 1);
+            if (0 != ::ftruncate(fd, 0) || ::pwrite(fd, kMagic, bytes.size(), 0) < 0) { throw IOError(); }
+            syncParentDirectory(path);
+        } else if (0 != std::memcmp(bytes.data(), kMagic, sizeof(kMagic) - 1)) {
+            throw IOError();
+        }
+        end = sizeof(kMagic) - 1;
+        while (bytes.size() - end >= kHeaderSize) {
+            const char* in = bytes.data() + end;
+            auto n = codecGet<uint32_t>(in);
+            auto checksum = codecGet<uint32_t>(in);
+            if (0 == n || n > bytes.size() - end - kHeaderSize || checksum != _checksum(in, n)) { break; }
+            replay(static_cast<uint8_t>(in[0]), std::string{in + 1, n - 1});
+            end += kHeaderSize + n;
+            ++replayed;
+        }
+        if (end != bytes.size() && 0 != ::ftruncate(fd, static_cast<off_t>(end))) { throw IOError(); }
+        if (0 != ::fsync(fd) || ::lseek(fd, static_cast<off_t>(end), SEEK_SET) < 0) { throw IOError(); }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (isOpen()) { ::close(fd_); }
+    fd_ = fd;
+    bytes_ = end;
+    pending_.clear();
+    pending_records_ = 0;
+    stats_ = Stats{};
+    stats_.replayed = replayed;
+    return replayed;
+}
+
+/*!
+ * @brief This method checks whether the log has been opened. Records appended to a closed log are dropped.
+ * @return true if it has, false otherwise.
+ */
+bool WriteAheadLog::isOpen() const {
+    return fd_ >= 0;
+}
+
+/*!
+ * @brief This method buffers a record until the next `commit()`.
+ * @param type is the type of the record.
+ * @param payload is the contents of the record.
+ */
+void WriteAheadLog::append(uint8_t type, const std::string& payload) {
+    if (!isOpen()) { return; }
+    size_t start = pending_.size();
+    codecPut(pending_, static_cast<uint32_t>(payload.size() + 1));
+    codecPut(pending_, uint32_t{});  // Checksum, filled in below.
+    pending_.push_back(static_cast<char>(type));
+    pending_.append(payload);
+    auto checksum = _checksum(pending_.data() + start + kHeaderSize, payload.size() + 1);
+    std::memcpy(pending_.data() + start + sizeof(uint32_t), &checksum, sizeof(checksum));
+    ++pending_records_;
+    ++stats_.appended;
+}
+
+/*!
+ * @brief This method writes the buffered records to the file with one write and forces them to stable storage
+ * with one fsync. Nothing is written if no record is pending.
+ * @return the number of records committed.
+ * @throw IOError if the records cannot be written.
+ */
+size_t WriteAheadLog::commit() {
+    if (!isOpen() || pending_.empty()) { return 0; }
+    writeAll(fd_, pending_.data(), pending_.size());
+    if (0 != ::fsync(fd_)) { throw IOError(); }
+    bytes_ += pending_.size();
+    size_t committed = pending_records_;
+    pending_.clear();
+    pending_records_ = 0;
+    ++stats_.commits;
+    return committed;
+}
+
+/*!
+ * @brief This method empties the log, pending records included, once a checkpoint holds every modification.
+ * @throw IOError if the file cannot be truncated.
+ */
+void WriteAheadLog::reset() {
+    if (!isOpen()) { return; }
+    pending_.clear();
+    pending_records_ = 0;
+    auto end = static_cast<off_t>(sizeof(kMagic) - 1);
+    if (0 != ::ftruncate(fd_, end) || 0 != ::fsync(fd_) || ::lseek(fd_, end, SEEK_SET) < 0) { throw IOError(); }
+    bytes_ = sizeof(kMagic) - 1;
+    ++stats_.resets;
+}
+
+/*!
+ * @brief This method returns the size of the committed log, which replay time is proportional to.
+ * @return the size in bytes.
+ */
+size_t WriteAheadLog::bytes() const {
+    return bytes_;
+}
+
+/*!
+ * @brief This method returns number of records appended since the last commit.
+ * @return the number of records.
+ */
+size_t WriteAheadLog::pending() const {
+    return pending_records_;
+}
+
+/*!
+ * @brief This method returns the statistics of the log.
+ * @return the statistics.
+ */
+const WriteAheadLog::Stats& WriteAheadLog::stats() const {
+    return stats_;
+}
+
+/*!
+ * @brief This function computes the 32-bit FNV-1a hash of a record, which is enough to detect a torn write.
+ * @param data is the record.
+ * @param n is size of the record.
+ * @return the checksum.
+ */
+uint32_t WriteAheadLog::_checksum(const char* data, size_t n) {
+    uint32_t hash{2166136261u};
+    for (size_t i = 0; i < n; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+/*!
+ * @brief This function replaces a file as a whole: the bytes are written to a temporary file, forced to stable
+ * storage and renamed over the old file, so a crash leaves either the old or the new contents. The directory is
+ * synchronized after the rename, so once this returns the new contents survive a crash.
+ * @param path is path to the file.
+ * @param bytes are the new contents.
+ * @throw IOError if the file cannot be written.
+ */
+void writeFileDurably(const std::string& path, const std::string& bytes) {
+    std::string temp{path + ".tmp"};
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) { throw IOError(); }
+    try {
+        writeAll(fd, bytes.data(), bytes.size());
+        if (0 != ::fsync(fd)) { throw IOError(); }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    if (0 != std::rename(temp.c_str(), path.c_str())) { throw IOError(); }
+    syncParentDirectory(path);
+}
+
+/*!
+ * @brief This function reads a whole file.
+ * @param path is path to the file.
+ * @param bytes receives the contents of the file.
+ * @return false if the file does not exist, true otherwise.
+ * @throw IOError if the file exists but cannot be read.
+ */
+bool readFile(const std::string& path, std::string& bytes) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { return false; }
+    try {
+        readAll(fd, bytes);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    return true;
+}
@@ -0,0 +1,64 @@
+/*!
+ * @brief This file contains the class definition of <em>WriteAheadLog</em> and the file helpers of database
+ * checkpoints.
+ */
+#ifndef CS225_SP22_C2_WRITEAHEADLOG_H_
+#define CS225_SP22_C2_WRITEAHEADLOG_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+/*!
+ * @brief This class appends database modifications to a log file, so that they survive a crash and can be replayed
+ * on top of the last checkpoint. Appended records are buffered in memory and reach the file on `commit()`, which
+ * writes the whole batch and forces it to stable storage once (group commit). Each record carries its length and
+ * a checksum; replay stops at the first incomplete or damaged record (a torn final write) and cuts it off.
+ * The log does not interpret records: each one is a type byte and an opaque payload.
+ */
+class WriteAheadLog {
+public:
+    using Replayer = std::function<void(uint8_t type, const std::string& payload)>;
+
+    /*!
+     * @brief This struct counts log events since the log was opened.
+     */
+    struct Stats {
+        size_t replayed{};
+        size_t appended{};
+        size_t commits{};  // One fsync each.
+        size_t resets{};
+    };
+
+    WriteAheadLog() = default;
+    WriteAheadLog(const WriteAheadLog& log) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog& log) = delete;
+    virtual ~WriteAheadLog();
+
+    size_t open(const std::string& path, const Replayer& replay);
+    [[nodiscard]] bool isOpen() const;
+    void append(uint8_t type, const std::string& payload);
+    size_t commit();
+    void reset();
+    [[nodiscard]] size_t bytes() const;
+    [[nodiscard]] size_t pending() const;
+    [[nodiscard]] const Stats& stats() const;
+
+private:
+    static constexpr char kMagic[9]{"RQRSWL01"};  // First bytes of the file.
+    static constexpr size_t kHeaderSize{8};  // Length and checksum of the type byte and payload.
+
+    static uint32_t _checksum(const char* data, size_t n);
+
+    int fd_{-1};
+    size_t bytes_{};  // Committed bytes, including the magic.
+    size_t pending_records_{};
+    std::string pending_{};  // Records appended since the last commit, encoded.
+    Stats stats_{};
+};
+
+void writeFileDurably(const std::string& path, const std::string& bytes);
+bool readFile(const std::string& path, std::string& bytes);
+
+#endif //CS225_SP22_C2_WRITEAHEADLOG_H_